@@ -62,6 +62,7 @@
 #include "filesystem/StackDirectory.h"
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/DllLibCurl.h"
+#include "filesystem/FilePrefetcher.h"
 #include "filesystem/PluginDirectory.h"
 #include "utils/SystemInfo.h"
 #include "utils/TimeUtils.h"
@@ -3886,6 +3887,7 @@ bool CApplication::OnMessage(CGUIMessage& message)
 
   case GUI_MSG_PLAYBACK_STOPPED:
     m_playerEvent.Set();
+    XFILE::CFilePrefetcher::GetInstance().Clear();
     m_itemCurrentFile->Reset();
     CServiceBroker::GetGUI()->GetInfoManager().ResetCurrentItem();
     PlaybackCleanup();
@@ -4138,6 +4140,12 @@ void CApplication::ProcessSlow()
   // check if we should restart the player
   CheckDelayedPlayerRestart();
 
+  // open the next playlist item before the current one ends
+  const unsigned int prefetchTime = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cachePrefetchNextTime;
+  if (prefetchTime > 0 && m_appPlayer.IsPlaying() && m_appPlayer.GetTotalTime() > 0 &&
+      m_appPlayer.GetTotalTime() - m_appPlayer.GetTime() < prefetchTime * 1000)
+    CServiceBroker::GetPlaylistPlayer().PrefetchNextItem();
+
   //  check if we can unload any unreferenced dlls or sections
   if (!m_appPlayer.IsPlayingVideo())
     CSectionLoader::UnloadDelayed();
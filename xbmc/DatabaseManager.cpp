@@ -11,6 +11,7 @@
 #include "ServiceBroker.h"
 #include "TextureDatabase.h"
 #include "addons/AddonDatabase.h"
+#include "dbwrappers/sqlitedataset.h"
 #include "music/MusicDatabase.h"
 #include "pvr/PVRDatabase.h"
 #include "pvr/epg/EpgDatabase.h"
@@ -38,6 +39,12 @@ void CDatabaseManager::Initialize()
 
   m_dbStatus.clear();
 
+  // pooled connections may belong to another profile or hold the old schema
+  {
+    CSingleLock readLock(m_readSection);
+    m_readConnections.clear();
+  }
+
   CLog::Log(LOGDEBUG, "%s, updating databases...", __FUNCTION__);
 
   const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
@@ -66,6 +73,58 @@ bool CDatabaseManager::CanOpen(const std::string &name)
   return false; // db isn't even attempted to update yet
 }
 
+std::unique_ptr<dbiplus::Database> CDatabaseManager::AcquireReadConnection(const std::string &host, const std::string &name)
+{
+  std::unique_ptr<dbiplus::SqliteDatabase> db(new dbiplus::SqliteDatabase());
+  db->setHostName(host.c_str());
+  db->setDatabase(name.c_str());
+  db->setReadOnly(true);
+
+  {
+    CSingleLock lock(m_readSection);
+    auto idle = m_readConnections.find(std::string(db->getHostName()) + db->getDatabase());
+    if (idle != m_readConnections.end() && !idle->second.empty())
+    {
+      std::unique_ptr<dbiplus::Database> pooled = std::move(idle->second.back());
+      idle->second.pop_back();
+      return pooled;
+    }
+  }
+
+  try
+  {
+    if (db->connect(false) != DB_CONNECTION_OK)
+      return nullptr;
+
+    std::unique_ptr<dbiplus::Dataset> ds(db->CreateDataset());
+    ds->exec("PRAGMA cache_size=4096\n");
+  }
+  catch (dbiplus::DbErrors &error)
+  {
+    CLog::Log(LOGERROR, "%s failed with '%s'", __FUNCTION__, error.getMsg());
+    return nullptr;
+  }
+
+  return std::move(db);
+}
+
+void CDatabaseManager::ReleaseReadConnection(std::unique_ptr<dbiplus::Database> db)
+{
+  if (!db)
+    return;
+
+  // a reader left in a transaction would pin its snapshot of the database
+  if (db->in_transaction())
+    db->rollback_transaction();
+
+  CSingleLock lock(m_readSection);
+  auto &idle = m_readConnections[std::string(db->getHostName()) + db->getDatabase()];
+  if (idle.size() < MAX_IDLE_READ_CONNECTIONS)
+    idle.push_back(std::move(db));
+  else
+    db->disconnect();
+}
+
 void CDatabaseManager::UpdateDatabase(CDatabase &db, DatabaseSettings *settings)
 {
   std::string name = db.GetBaseDBName();
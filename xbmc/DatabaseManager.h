@@ -12,11 +12,18 @@
 
 #include <atomic>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 class CDatabase;
 class DatabaseSettings;
 
+namespace dbiplus
+{
+class Database;
+}
+
 /*!
  \ingroup database
  \brief Database manager class for handling database updating
@@ -51,6 +58,23 @@ public:
 
   bool IsUpgrading() const { return m_bIsUpgrading; }
 
+  /*! \brief Get a read-only connection to a sqlite database.
+
+   Idle connections returned by ReleaseReadConnection() are reused, so their
+   page and statement caches stay warm. A new connection is opened otherwise.
+
+   \param host the folder of the database file.
+   \param name the name of the database, without extension.
+   \return the connected database, or nullptr if it can't be opened.
+   \sa ReleaseReadConnection
+   */
+  std::unique_ptr<dbiplus::Database> AcquireReadConnection(const std::string &host, const std::string &name);
+
+  /*! \brief Hand a connection from AcquireReadConnection() back to the pool.
+   \param db the connection, it is disconnected if enough idle connections are pooled already.
+   */
+  void ReleaseReadConnection(std::unique_ptr<dbiplus::Database> db);
+
 private:
   std::atomic<bool> m_bIsUpgrading;
 
@@ -62,4 +86,8 @@ private:
 
   CCriticalSection            m_section;     ///< Critical section protecting m_dbStatus.
   std::map<std::string, DB_STATUS> m_dbStatus;    ///< Our database status map.
+
+  static const size_t MAX_IDLE_READ_CONNECTIONS = 4; ///< Idle connections kept per database file.
+  CCriticalSection            m_readSection; ///< Critical section protecting m_readConnections.
+  std::map<std::string, std::vector<std::unique_ptr<dbiplus::Database>>> m_readConnections; ///< Idle read-only connections by database file.
 };
@@ -14,6 +14,7 @@
 #include "ServiceBroker.h"
 #include "URL.h"
 #include "dialogs/GUIDialogKaiToast.h"
+#include "filesystem/FilePrefetcher.h"
 #include "filesystem/PluginDirectory.h"
 #include "filesystem/VideoDatabaseFile.h"
 #include "guilib/GUIComponent.h"
@@ -139,6 +140,21 @@ int CPlayListPlayer::GetNextSong(int offset) const
   return song;
 }
 
+void CPlayListPlayer::PrefetchNextItem() const
+{
+  if (m_iCurrentPlayList == PLAYLIST_NONE)
+    return;
+
+  const CPlayList& playlist = GetPlaylist(m_iCurrentPlayList);
+  int iNextSong = GetNextSong(1);
+  if (iNextSong < 0 || iNextSong >= playlist.size() || iNextSong == m_iCurrentSong)
+    return;
+
+  const CFileItem& item = *playlist[iNextSong];
+  if (item.IsAudio() || item.IsVideo())
+    XFILE::CFilePrefetcher::GetInstance().Prefetch(item);
+}
+
 int CPlayListPlayer::GetNextSong()
 {
   if (m_iCurrentPlayList == PLAYLIST_NONE)
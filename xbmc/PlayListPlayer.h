@@ -92,6 +92,11 @@ public:
    */
   int GetNextSong(int offset) const;
 
+  /*! \brief Open the next item in the active playlist in the background, see XFILE::CFilePrefetcher.
+   Called periodically while the current item is close to its end.
+   */
+  void PrefetchNextItem() const;
+
   /*! \brief Set the active playlist
    \param playList Values can be PLAYLIST_NONE, PLAYLIST_MUSIC or PLAYLIST_VIDEO
    \sa GetCurrentPlaylist
@@ -8,6 +8,9 @@
 
 #include "AEResampleFactory.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResampleFFMPEG.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
 #if defined(TARGET_RASPBERRY_PI)
   #include "ServiceBroker.h"
   #include "settings/Settings.h"
@@ -15,9 +18,58 @@
   #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResamplePi.h"
 #endif
 
+#include <algorithm>
+#include <list>
+#include <memory>
+
 namespace ActiveAE
 {
 
+namespace
+{
+// idle resamplers kept, enough for the streams of a typical reconfiguration
+const size_t RESAMPLE_CACHE_SIZE = 8;
+
+struct ResampleKey
+{
+  SampleConfig dstConfig;
+  SampleConfig srcConfig;
+  bool upmix;
+  bool normalize;
+  double centerMix;
+  bool remap;
+  CAEChannelInfo remapLayout;
+  AEQuality quality;
+  bool forceResample;
+
+  bool operator==(const ResampleKey& other) const
+  {
+    return Equals(dstConfig, other.dstConfig) && Equals(srcConfig, other.srcConfig) &&
+           upmix == other.upmix && normalize == other.normalize &&
+           centerMix == other.centerMix && remap == other.remap &&
+           (!remap || remapLayout == other.remapLayout) && quality == other.quality &&
+           forceResample == other.forceResample;
+  }
+
+  static bool Equals(const SampleConfig& a, const SampleConfig& b)
+  {
+    return a.fmt == b.fmt && a.channel_layout == b.channel_layout && a.channels == b.channels &&
+           a.sample_rate == b.sample_rate && a.bits_per_sample == b.bits_per_sample &&
+           a.dither_bits == b.dither_bits;
+  }
+};
+
+struct ResampleEntry
+{
+  ResampleKey key;
+  std::unique_ptr<IAEResample> resampler;
+};
+
+CCriticalSection resampleCacheSection;
+std::list<ResampleEntry> idleResamplers; //!< most recently released first
+std::list<ResampleEntry> busyResamplers;
+}
+
 IAEResample *CAEResampleFactory::Create(uint32_t flags /* = 0 */)
 {
 #if defined(TARGET_RASPBERRY_PI)
@@ -27,4 +79,66 @@ IAEResample *CAEResampleFactory::Create(uint32_t flags /* = 0 */)
   return new CActiveAEResampleFFMPEG();
 }
 
+IAEResample *CAEResampleFactory::Acquire(SampleConfig dstConfig, SampleConfig srcConfig, bool upmix, bool normalize, double centerMix,
+                                         CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample)
+{
+  ResampleEntry entry;
+  entry.key.dstConfig = dstConfig;
+  entry.key.srcConfig = srcConfig;
+  entry.key.upmix = upmix;
+  entry.key.normalize = normalize;
+  entry.key.centerMix = centerMix;
+  entry.key.remap = remapLayout != nullptr;
+  if (remapLayout)
+    entry.key.remapLayout = *remapLayout;
+  entry.key.quality = quality;
+  entry.key.forceResample = force_resample;
+
+  CSingleLock lock(resampleCacheSection);
+
+  auto it = std::find_if(idleResamplers.begin(), idleResamplers.end(),
+                         [&entry](const ResampleEntry& idle) { return idle.key == entry.key; });
+  if (it != idleResamplers.end())
+  {
+    if (it->resampler->Reset())
+    {
+      busyResamplers.splice(busyResamplers.begin(), idleResamplers, it);
+      return busyResamplers.front().resampler.get();
+    }
+    idleResamplers.erase(it);
+  }
+
+  entry.resampler.reset(Create());
+  if (!entry.resampler->Init(dstConfig, srcConfig, upmix, normalize, centerMix, remapLayout, quality,
+                             force_resample))
+  {
+    // like a resampler from Create, it fails on use and is not reused
+    CLog::Log(LOGERROR, "CAEResampleFactory::Acquire - failed to init resampler");
+    return entry.resampler.release();
+  }
+
+  busyResamplers.push_front(std::move(entry));
+  return busyResamplers.front().resampler.get();
+}
+
+void CAEResampleFactory::Release(IAEResample *resampler)
+{
+  if (!resampler)
+    return;
+
+  CSingleLock lock(resampleCacheSection);
+
+  auto it = std::find_if(busyResamplers.begin(), busyResamplers.end(),
+                         [resampler](const ResampleEntry& busy) { return busy.resampler.get() == resampler; });
+  if (it == busyResamplers.end())
+  {
+    delete resampler;
+    return;
+  }
+
+  idleResamplers.splice(idleResamplers.begin(), busyResamplers, it);
+  if (idleResamplers.size() > RESAMPLE_CACHE_SIZE)
+    idleResamplers.pop_back();
+}
+
 }
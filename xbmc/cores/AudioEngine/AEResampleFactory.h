@@ -28,6 +28,15 @@ class CAEResampleFactory
 {
 public:
   static IAEResample *Create(uint32_t flags = 0U);
+
+  /*! \brief Get an initialized resampler, reusing a released one of the same configuration
+   */
+  static IAEResample *Acquire(SampleConfig dstConfig, SampleConfig srcConfig, bool upmix, bool normalize, double centerMix,
+                              CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample);
+
+  /*! \brief Hand a resampler from Acquire back, it is kept for the next Acquire
+   */
+  static void Release(IAEResample *resampler);
 };
 
 }
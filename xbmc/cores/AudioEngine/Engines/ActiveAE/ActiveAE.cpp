@@ -21,14 +21,27 @@ using namespace ActiveAE;
 #include "cores/AudioEngine/AEResampleFactory.h"
 #include "cores/AudioEngine/Encoders/AEEncoderFFmpeg.h"
 
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "windowing/WinSystem.h"
+#include "utils/StringUtils.h"
 #include "utils/log.h"
 
+#include <inttypes.h>
+
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
 #define MAX_BUFFER_TIME 0.1   // max time of a buffer in seconds
+#define LOW_LATENCY_CACHE_PERIODS 4 // cache level in sink periods in low latency mode
+#define LOW_LATENCY_WATER_PERIODS 2 // water level in sink periods in low latency mode
+
+CEngineStats::CEngineStats()
+{
+  m_maxCacheLevel = MAX_CACHE_LEVEL;
+  m_maxWaterLevel = MAX_WATER_LEVEL;
+  m_lowLatency = false;
+}
 
 void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
 {
@@ -205,12 +218,28 @@ float CEngineStats::GetCacheTime(CActiveAEStream *stream)
 
 float CEngineStats::GetCacheTotal()
 {
-  return MAX_CACHE_LEVEL;
+  return m_maxCacheLevel;
 }
 
 float CEngineStats::GetMaxDelay() const
 {
-  return MAX_CACHE_LEVEL + MAX_WATER_LEVEL + m_sinkCacheTotal;
+  return m_maxCacheLevel + m_maxWaterLevel + m_sinkCacheTotal;
+}
+
+void CEngineStats::SetBufferLevels(bool lowLatency, float periodTime)
+{
+  CSingleLock lock(m_lock);
+  m_lowLatency = lowLatency;
+  if (lowLatency)
+  {
+    m_maxCacheLevel = std::min(LOW_LATENCY_CACHE_PERIODS * periodTime, static_cast<float>(MAX_CACHE_LEVEL));
+    m_maxWaterLevel = std::min(LOW_LATENCY_WATER_PERIODS * periodTime, static_cast<float>(MAX_WATER_LEVEL));
+  }
+  else
+  {
+    m_maxCacheLevel = MAX_CACHE_LEVEL;
+    m_maxWaterLevel = MAX_WATER_LEVEL;
+  }
 }
 
 float CEngineStats::GetWaterLevel()
@@ -411,12 +440,7 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
         switch (signal)
         {
         case CSinkDataProtocol::RETURNSAMPLE:
-          CSampleBuffer **buffer;
-          buffer = (CSampleBuffer**)msg->data;
-          if (buffer)
-          {
-            (*buffer)->Return();
-          }
+          // the buffer was already returned to its pool
           return;
         default:
           break;
@@ -845,12 +869,7 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
         switch (signal)
         {
         case CSinkDataProtocol::RETURNSAMPLE:
-          CSampleBuffer **buffer;
-          buffer = (CSampleBuffer**)msg->data;
-          if (buffer)
-          {
-            (*buffer)->Return();
-          }
+          // the buffer was already returned to its pool
           m_extTimeout = 0;
           m_state = AE_TOP_CONFIGURED_PLAY;
           return;
@@ -906,12 +925,7 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
         switch (signal)
         {
         case CSinkDataProtocol::RETURNSAMPLE:
-          CSampleBuffer **buffer;
-          buffer = (CSampleBuffer**)msg->data;
-          if (buffer)
-          {
-            (*buffer)->Return();
-          }
+          // the buffer was already returned to its pool
           return;
         default:
           break;
@@ -1036,6 +1050,7 @@ void CActiveAE::Process()
 {
   Message *msg = NULL;
   Protocol *port = NULL;
+  CSampleBuffer *buffer = NULL;
   bool gotMsg;
   XbmcThreads::EndTime timer;
 
@@ -1072,6 +1087,13 @@ void CActiveAE::Process()
       gotMsg = true;
       port = &m_controlPort;
     }
+    // check samples returned by the sink
+    else if (m_sink.ReceiveReturnedSample(&buffer))
+    {
+      buffer->Return();
+      StateMachine(CSinkDataProtocol::RETURNSAMPLE, &m_sink.m_dataPort, nullptr);
+      continue;
+    }
     // check sink data port
     else if (m_sink.m_dataPort.ReceiveInMessage(&msg))
     {
@@ -1179,6 +1201,8 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
   m_sinkRequestFormat = inputFormat;
   ApplySettingsToFormat(m_sinkRequestFormat, m_settings, (int*)&m_mode);
+  bool lowLatency = NeedLowLatency(m_sinkRequestFormat);
+  m_sinkRequestFormat.m_periodTime = lowLatency ? m_settings.lowLatencyPeriod : 0;
   m_extKeepConfig = 0;
 
   std::string device = (m_sinkRequestFormat.m_dataFormat == AE_FMT_RAW) ? m_settings.passthroughdevice : m_settings.device;
@@ -1203,7 +1227,8 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   CAESinkFactory::ParseDevice(device, driver);
   if ((!CompareFormat(m_sinkRequestFormat, m_sinkFormat) && !CompareFormat(m_sinkRequestFormat, oldSinkRequestFormat)) ||
       m_currDevice.compare(device) != 0 ||
-      m_settings.driver.compare(driver) != 0)
+      m_settings.driver.compare(driver) != 0 ||
+      lowLatency != m_sinkLowLatency)
   {
     FlushEngine();
     if (!InitSink(driver + ":" + device))
@@ -1224,6 +1249,12 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         m_sinkFormat.m_frames = MAX_BUFFER_TIME * m_sinkFormat.m_sampleRate;
       }
     }
+
+    m_sinkLowLatency = lowLatency;
+    m_stats.SetBufferLevels(lowLatency, lowLatency ? (float)m_sinkFormat.m_frames / m_sinkFormat.m_sampleRate : 0);
+    if (lowLatency)
+      CLog::Log(LOGINFO, "ActiveAE::%s - low latency mode, sink period %d ms, max delay %d ms", __FUNCTION__,
+                (int)(m_sinkFormat.m_frames * 1000 / m_sinkFormat.m_sampleRate), (int)(m_stats.GetMaxDelay() * 1000));
   }
 
   if (m_silenceBuffers)
@@ -1245,7 +1276,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
     inputFormat.m_frameSize = inputFormat.m_channelLayout.Count() *
                               (CAEUtil::DataFormatToBits(inputFormat.m_dataFormat) >> 3);
     m_silenceBuffers = new CActiveAEBufferPool(inputFormat);
-    m_silenceBuffers->Create(MAX_WATER_LEVEL*1000);
+    m_silenceBuffers->Create(m_stats.GetMaxWaterLevel()*1000);
     sinkInputFormat = inputFormat;
     m_internalFormat = inputFormat;
 
@@ -1325,7 +1356,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         if (!m_encoderBuffers)
         {
           m_encoderBuffers = new CActiveAEBufferPool(format);
-          m_encoderBuffers->Create(MAX_WATER_LEVEL*1000);
+          m_encoderBuffers->Create(m_stats.GetMaxWaterLevel()*1000);
         }
       }
 
@@ -1367,7 +1398,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
         // create buffer pool
         (*it)->m_inputBuffers = new CActiveAEBufferPool((*it)->m_format);
-        (*it)->m_inputBuffers->Create(MAX_CACHE_LEVEL*1000);
+        (*it)->m_inputBuffers->Create(m_stats.GetCacheTotal()*1000);
         (*it)->m_streamSpace = (*it)->m_format.m_frameSize * (*it)->m_format.m_frames;
 
         // if input format does not follow ffmpeg channel mask, we may need to remap channels
@@ -1386,7 +1417,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         (*it)->m_processingBuffers = new CActiveAEStreamBuffers((*it)->m_inputBuffers->m_format, outputFormat, m_settings.resampleQuality);
         (*it)->m_processingBuffers->ForceResampler((*it)->m_forceResampler);
 
-        (*it)->m_processingBuffers->Create(MAX_CACHE_LEVEL*1000, false, m_settings.stereoupmix, m_settings.normalizelevels);
+        (*it)->m_processingBuffers->Create(m_stats.GetCacheTotal()*1000, false, m_settings.stereoupmix, m_settings.normalizelevels);
       }
       if (m_mode == MODE_TRANSCODE || m_streams.size() > 1)
         (*it)->m_processingBuffers->FillBuffer();
@@ -1444,7 +1475,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   if (!m_sinkBuffers)
   {
     m_sinkBuffers = new CActiveAEBufferPoolResample(sinkInputFormat, m_sinkFormat, m_settings.resampleQuality);
-    m_sinkBuffers->Create(MAX_WATER_LEVEL*1000, true, false);
+    m_sinkBuffers->Create(m_stats.GetMaxWaterLevel()*1000, true, false);
   }
 
   // reset gui sounds
@@ -1509,6 +1540,9 @@ CActiveAEStream* CActiveAE::CreateStream(MsgStreamNew *streamMsg)
   if (streamMsg->options & AESTREAM_FORCE_RESAMPLE)
     stream->m_forceResampler = true;
 
+  if (streamMsg->options & AESTREAM_LOW_LATENCY)
+    stream->m_lowLatency = true;
+
   stream->m_pClock = streamMsg->clock;
 
   m_streams.push_back(stream);
@@ -1794,7 +1828,21 @@ bool CActiveAE::NeedReconfigureSink()
 
   return !CompareFormat(newFormat, m_sinkFormat) ||
       m_currDevice.compare(device) != 0 ||
-      m_settings.driver.compare(driver) != 0;
+      m_settings.driver.compare(driver) != 0 ||
+      NeedLowLatency(newFormat) != m_sinkLowLatency;
+}
+
+bool CActiveAE::NeedLowLatency(const AEAudioFormat &format)
+{
+  if (m_settings.lowLatencyPeriod == 0 || format.m_dataFormat == AE_FMT_RAW)
+    return false;
+
+  for (auto stream : m_streams)
+  {
+    if (stream->m_lowLatency)
+      return true;
+  }
+  return false;
 }
 
 bool CActiveAE::InitSink(std::string sink)
@@ -1932,7 +1980,7 @@ bool CActiveAE::RunStages()
       float buftime = (float)(*it)->m_inputBuffers->m_format.m_frames / (*it)->m_inputBuffers->m_format.m_sampleRate;
       if ((*it)->m_inputBuffers->m_format.m_dataFormat == AE_FMT_RAW)
         buftime = (*it)->m_inputBuffers->m_format.m_streamInfo.GetDuration() / 1000;
-      while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
+      while ((time < m_stats.GetCacheTotal() || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
       {
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
         (*it)->m_processingSamples.push_back(buffer);
@@ -1971,7 +2019,7 @@ bool CActiveAE::RunStages()
     }
   }
 
-  if (m_stats.GetWaterLevel() < MAX_WATER_LEVEL &&
+  if (m_stats.GetWaterLevel() < m_stats.GetMaxWaterLevel() &&
      (m_mode != MODE_TRANSCODE || (m_encoderBuffers && !m_encoderBuffers->m_freeSamples.empty())))
   {
     // calculate sync error
@@ -2092,12 +2140,9 @@ bool CActiveAE::RunStages()
             // for stream amplification,
             // turned off downmix normalization,
             // or if sink format is float (in order to prevent from clipping)
-            // we need to run on a per sample basis
-            if ((*it)->m_amplify != 1.0 || !(*it)->m_processingBuffers->DoesNormalize() || (m_sinkFormat.m_dataFormat == AE_FMT_FLOAT))
-            {
-              nb_floats = out->pkt->config.channels / out->pkt->planes;
-              nb_loops = out->pkt->nb_samples;
-            }
+            // we need to run the limiter
+            if (nb_loops > 1 || (*it)->m_amplify != 1.0 || !(*it)->m_processingBuffers->DoesNormalize() || (m_sinkFormat.m_dataFormat == AE_FMT_FLOAT))
+              (*it)->m_limiter.Process((float**)out->pkt->data, out->pkt->config.channels, out->pkt->nb_samples, out->pkt->planes > 1);
 
             for(int i=0; i<nb_loops; i++)
             {
@@ -2116,20 +2161,10 @@ bool CActiveAE::RunStages()
 
               // volume for stream
               float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)out->pkt->data, out->pkt->config.channels, i*nb_floats, out->pkt->planes > 1);
 
               for(int j=0; j<out->pkt->planes; j++)
               {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
+                CAEUtil::MulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
               }
             }
           }
@@ -2159,12 +2194,9 @@ bool CActiveAE::RunStages()
             }
 
             // for streams amplification of turned off downmix normalization
-            // we need to run on a per sample basis
-            if ((*it)->m_amplify != 1.0 || !(*it)->m_processingBuffers->DoesNormalize())
-            {
-              nb_floats = out->pkt->config.channels / out->pkt->planes;
-              nb_loops = out->pkt->nb_samples;
-            }
+            // we need to run the limiter
+            if (nb_loops > 1 || (*it)->m_amplify != 1.0 || !(*it)->m_processingBuffers->DoesNormalize())
+              (*it)->m_limiter.Process((float**)mix->pkt->data, mix->pkt->config.channels, mix->pkt->nb_samples, mix->pkt->planes > 1);
 
             for(int i=0; i<nb_loops; i++)
             {
@@ -2183,31 +2215,14 @@ bool CActiveAE::RunStages()
 
               // volume for stream
               float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)mix->pkt->data, mix->pkt->config.channels, i*nb_floats, mix->pkt->planes > 1);
 
               for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
               {
                 float *dst = (float*)out->pkt->data[j]+i*nb_floats;
                 float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
+                CAEUtil::MulAddArray(dst, src, volume, nb_floats);
+                if (!needClamp)
+                  needClamp = CAEUtil::NeedsClamp(dst, nb_floats);
               }
             }
             mix->Return();
@@ -2344,9 +2359,10 @@ bool CActiveAE::RunStages()
   {
     CSampleBuffer *out = NULL;
     out = m_sinkBuffers->m_outputSamples.front();
+    // sink queue is full, keep the buffer until the sink returns one
+    if (!m_sink.SendSample(out))
+      break;
     m_sinkBuffers->m_outputSamples.pop_front();
-    m_sink.m_dataPort.SendOutMessage(CSinkDataProtocol::SAMPLE,
-        &out, sizeof(CSampleBuffer*));
     busy = true;
   }
 
@@ -2590,12 +2606,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEUtil::MulAddArray(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2620,13 +2631,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEUtil::MulArray(buffer, volume, nb_floats);
     }
   }
 }
@@ -2664,6 +2669,7 @@ void CActiveAE::LoadSettings()
   m_settings.atempoThreshold = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_ATEMPOTHRESHOLD) / 100.0;
   m_settings.streamNoise = settings->GetBool(CSettings::SETTING_AUDIOOUTPUT_STREAMNOISE);
   m_settings.silenceTimeout = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_STREAMSILENCE) * 60000;
+  m_settings.lowLatencyPeriod = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioLowLatencyPeriod;
 }
 
 void CActiveAE::Start()
@@ -3016,6 +3022,7 @@ bool CActiveAE::CompareFormat(AEAudioFormat &lhs, AEAudioFormat &rhs)
  * load sound from an audio file and store original format
  * register the sound in ActiveAE
  * later when the engine is idle it will convert the sound to sink format
+ * decoded and converted sounds are shared by all sounds of a file
  */
 
 IAESound *CActiveAE::MakeSound(const std::string& file)
@@ -3036,6 +3043,15 @@ IAESound *CActiveAE::MakeSound(const std::string& file)
   }
   int fileSize = sound->GetFileSize();
 
+  std::shared_ptr<CSoundPacket> cached = m_soundCache.GetDecoded(file, fileSize, sound->GetFileTime());
+  if (cached)
+  {
+    sound->Finish();
+    sound->SetSound(true, cached);
+    m_dataPort.SendOutMessage(CActiveAEDataProtocol::NEWSOUND, &sound, sizeof(CActiveAESound*));
+    return sound;
+  }
+
   int bufferSize = 4096;
   int blockSize = sound->GetChunkSize();
   if (blockSize > 1)
@@ -3168,13 +3184,15 @@ IAESound *CActiveAE::MakeSound(const std::string& file)
     av_freep(&io_ctx);
   }
 
-  if (error)
+  if (error || !sound->GetSound(true))
   {
     delete sound;
     return nullptr;
   }
 
   sound->Finish();
+  sound->SetSound(true, m_soundCache.AddDecoded(file, fileSize, sound->GetFileTime(),
+                                                sound->GetSoundPtr(true)));
 
   // register sound
   m_dataPort.SendOutMessage(CActiveAEDataProtocol::NEWSOUND, &sound, sizeof(CActiveAESound*));
@@ -3257,6 +3275,21 @@ bool CActiveAE::ResampleSound(CActiveAESound *sound)
     }
   }
 
+  // the conversion may be cached from another sound of the file or an earlier format
+  std::string format = StringUtils::Format("%" PRIu64 "/%d/%d/%d/%d/%d/%s/%d",
+                                           dst_config.channel_layout, dst_config.channels,
+                                           dst_config.sample_rate, static_cast<int>(dst_config.fmt),
+                                           dst_config.bits_per_sample, dst_config.dither_bits,
+                                           static_cast<std::string>(outChannels).c_str(),
+                                           static_cast<int>(m_settings.resampleQuality));
+  std::shared_ptr<CSoundPacket> cached = m_soundCache.GetConverted(sound->GetSoundPtr(true), format);
+  if (cached)
+  {
+    sound->SetSound(false, cached);
+    sound->SetConverted(true);
+    return true;
+  }
+
   IAEResample *resampler = CAEResampleFactory::Create(AERESAMPLEFACTORY_QUICK_RESAMPLE);
 
   resampler->Init(dst_config, orig_config,
@@ -3285,6 +3318,8 @@ bool CActiveAE::ResampleSound(CActiveAESound *sound)
   sound->GetSound(false)->nb_samples = samples;
 
   delete resampler;
+  sound->SetSound(false, m_soundCache.AddConverted(sound->GetSoundPtr(true), format,
+                                                   sound->GetSoundPtr(false)));
   sound->SetConverted(true);
   return true;
 }
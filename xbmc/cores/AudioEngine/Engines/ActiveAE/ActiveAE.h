@@ -18,6 +18,7 @@
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/AudioEngine/Interfaces/AESound.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAESoundCache.h"
 
 #include "guilib/DispResource.h"
 #include <queue>
@@ -61,6 +62,7 @@ struct AudioSettings
   double atempoThreshold;
   bool streamNoise;
   int silenceTimeout;
+  unsigned int lowLatencyPeriod;
 };
 
 class CActiveAEControlProtocol : public Protocol
@@ -175,6 +177,7 @@ struct MsgStreamFFmpegInfo
 class CEngineStats
 {
 public:
+  CEngineStats();
   void Reset(unsigned int sampleRate, bool pcm);
   void UpdateSinkDelay(const AEDelayStatus& status, int samples);
   void AddSamples(int samples, std::list<CActiveAEStream*> &streams);
@@ -188,6 +191,14 @@ public:
   float GetCacheTotal();
   float GetMaxDelay() const;
   float GetWaterLevel();
+  float GetMaxWaterLevel() const { return m_maxWaterLevel; }
+  /*!
+   * \brief Set the time buffered by the stream and engine stages
+   * \param lowLatency true for a few periods of the sink instead of the defaults
+   * \param periodTime the period time of the sink in seconds
+   */
+  void SetBufferLevels(bool lowLatency, float periodTime);
+  bool IsLowLatency() const { return m_lowLatency; }
   void SetSuspended(bool state);
   void SetCurrentSinkFormat(const AEAudioFormat& SinkFormat);
   void SetSinkCacheTotal(float time) { m_sinkCacheTotal = time; }
@@ -197,6 +208,9 @@ public:
 protected:
   float m_sinkCacheTotal;
   float m_sinkLatency;
+  float m_maxCacheLevel;
+  float m_maxWaterLevel;
+  bool m_lowLatency;
   int m_bufferedSamples;
   unsigned int m_sinkSampleRate;
   AEDelayStatus m_sinkDelay;
@@ -297,6 +311,7 @@ protected:
   void LoadSettings();
   bool NeedReconfigureBuffers();
   bool NeedReconfigureSink();
+  bool NeedLowLatency(const AEAudioFormat &format);
   void ApplySettingsToFormat(AEAudioFormat &format, AudioSettings &settings, int *mode = NULL);
   void Configure(AEAudioFormat *desiredFmt = NULL);
   AEAudioFormat GetInputFormat(AEAudioFormat *desiredFmt = NULL);
@@ -345,6 +360,7 @@ protected:
   CActiveAESink m_sink;
   AEAudioFormat m_sinkFormat;
   AEAudioFormat m_sinkRequestFormat;
+  bool m_sinkLowLatency = false;
   AEAudioFormat m_encoderFormat;
   AEAudioFormat m_internalFormat;
   AEAudioFormat m_inputFormat;
@@ -375,6 +391,7 @@ protected:
   };
   std::list<SoundState> m_sounds_playing;
   std::vector<CActiveAESound*> m_sounds;
+  CActiveAESoundCache m_soundCache;
 
   float m_volume; // volume on a 0..1 scale corresponding to a proportion along the dB scale
   float m_volumeScaled; // multiplier to scale samples in order to achieve the volume specified in m_volume
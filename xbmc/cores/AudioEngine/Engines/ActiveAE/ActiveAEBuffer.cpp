@@ -47,6 +47,52 @@ void CSampleBuffer::Return()
     pool->ReturnBuffer(this);
 }
 
+CSampleRing::CSampleRing(size_t size) : m_head(0), m_tail(0)
+{
+  size_t capacity = 1;
+  while (capacity < size)
+    capacity <<= 1;
+  m_slots.resize(capacity, nullptr);
+  m_mask = capacity - 1;
+}
+
+bool CSampleRing::Push(CSampleBuffer *buffer, bool *wasEmpty /* = nullptr */)
+{
+  size_t tail = m_tail.load(std::memory_order_relaxed);
+  // seq_cst, the consumer must not miss the buffer when it checks for an empty ring
+  // before going to sleep and the producer decides on wasEmpty whether to wake it up
+  size_t head = m_head.load(std::memory_order_seq_cst);
+  if (tail - head > m_mask)
+    return false;
+
+  m_slots[tail & m_mask] = buffer;
+  m_tail.store(tail + 1, std::memory_order_seq_cst);
+  if (wasEmpty)
+    *wasEmpty = m_head.load(std::memory_order_seq_cst) == tail;
+  return true;
+}
+
+bool CSampleRing::Pop(CSampleBuffer **buffer)
+{
+  size_t head = m_head.load(std::memory_order_relaxed);
+  if (head == m_tail.load(std::memory_order_seq_cst))
+    return false;
+
+  *buffer = m_slots[head & m_mask];
+  m_head.store(head + 1, std::memory_order_seq_cst);
+  return true;
+}
+
+bool CSampleRing::IsEmpty() const
+{
+  return m_head.load(std::memory_order_seq_cst) == m_tail.load(std::memory_order_seq_cst);
+}
+
+void CSampleRing::Clear()
+{
+  m_head.store(m_tail.load());
+}
+
 CActiveAEBufferPool::CActiveAEBufferPool(const AEAudioFormat& format)
 {
   m_format = format;
@@ -146,7 +192,7 @@ CActiveAEBufferPoolResample::~CActiveAEBufferPoolResample()
 {
   Flush();
 
-  delete m_resampler;
+  CAEResampleFactory::Release(m_resampler);
 }
 
 bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, bool upmix, bool normalize)
@@ -172,14 +218,14 @@ bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, boo
 
 void CActiveAEBufferPoolResample::ChangeResampler()
 {
+  // a released resampler of the same configuration comes straight back, reset
+  // instead of rebuilt
   if (m_resampler)
   {
-    delete m_resampler;
+    CAEResampleFactory::Release(m_resampler);
     m_resampler = NULL;
   }
 
-  m_resampler = CAEResampleFactory::Create();
-
   SampleConfig dstConfig, srcConfig;
   dstConfig.channel_layout = CAEUtil::GetAVChannelLayout(m_format.m_channelLayout);
   dstConfig.channels = m_format.m_channelLayout.Count();
@@ -195,13 +241,13 @@ void CActiveAEBufferPoolResample::ChangeResampler()
   srcConfig.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_inputFormat.m_dataFormat);
   srcConfig.dither_bits = CAEUtil::DataFormatToDitherBits(m_inputFormat.m_dataFormat);
 
-  m_resampler->Init(dstConfig, srcConfig,
-                    m_stereoUpmix,
-                    m_normalize,
-                    m_centerMixLevel,
-                    m_remap ? &m_format.m_channelLayout : nullptr,
-                    m_resampleQuality,
-                    m_forceResampler);
+  m_resampler = CAEResampleFactory::Acquire(dstConfig, srcConfig,
+                                            m_stereoUpmix,
+                                            m_normalize,
+                                            m_centerMixLevel,
+                                            m_remap ? &m_format.m_channelLayout : nullptr,
+                                            m_resampleQuality,
+                                            m_forceResampler);
 
   m_changeResampler = false;
 }
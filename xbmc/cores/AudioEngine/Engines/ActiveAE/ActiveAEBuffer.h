@@ -10,9 +10,11 @@
 
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
+#include <atomic>
 #include <cmath>
 #include <deque>
 #include <memory>
+#include <vector>
 
 extern "C" {
 #include <libavutil/avutil.h>
@@ -57,6 +59,26 @@ public:
   double centerMixLevel;
 };
 
+/**
+ * Fixed size lock free queue of sample buffers between exactly one producer
+ * and one consumer thread. Pushing and popping never allocate or block.
+ */
+class CSampleRing
+{
+public:
+  explicit CSampleRing(size_t size);
+  bool Push(CSampleBuffer *buffer, bool *wasEmpty = nullptr); // producer only, false if full
+  bool Pop(CSampleBuffer **buffer);                           // consumer only, false if empty
+  bool IsEmpty() const;
+  void Clear();                                               // only while no thread uses the ring
+protected:
+  std::vector<CSampleBuffer*> m_slots;
+  size_t m_mask;
+  std::atomic<size_t> m_head;                                 // next slot to pop, written by the consumer
+  char m_pad[64];                                             // keep head and tail on different cache lines
+  std::atomic<size_t> m_tail;                                 // next slot to push, written by the producer
+};
+
 class CActiveAEBufferPool
 {
 public:
@@ -275,3 +275,17 @@ int CActiveAEResampleFFMPEG::GetDstBufferSize(int samples)
 {
   return av_samples_get_buffer_size(NULL, m_dst_channels, samples, m_dst_fmt, 1);
 }
+
+bool CActiveAEResampleFFMPEG::Reset()
+{
+  if (!m_pContext)
+    return false;
+
+  // options and a custom matrix survive, swr keeps the filter bank if they didn't change
+  if (swr_init(m_pContext) < 0)
+  {
+    CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Reset - init resampler failed");
+    return false;
+  }
+  return true;
+}
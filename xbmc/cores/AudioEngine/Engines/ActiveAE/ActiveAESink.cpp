@@ -24,13 +24,19 @@
 using namespace AE;
 using namespace ActiveAE;
 
+// more than the buffers of the sink buffer pool, see MAX_WATER_LEVEL
+#define SAMPLE_RING_SIZE 512
+
 CActiveAESink::CActiveAESink(CEvent *inMsgEvent) :
   CThread("AESink"),
   m_controlPort("SinkControlPort", inMsgEvent, &m_outMsgEvent),
   m_dataPort("SinkDataPort", inMsgEvent, &m_outMsgEvent),
-  m_internalPort("SinkInternalPort", &m_outMsgEvent, &m_outMsgEvent)
+  m_internalPort("SinkInternalPort", &m_outMsgEvent, &m_outMsgEvent),
+  m_sampleRing(SAMPLE_RING_SIZE),
+  m_returnRing(SAMPLE_RING_SIZE)
 {
   m_inMsgEvent = inMsgEvent;
+  m_inSample = nullptr;
   m_sink = nullptr;
   m_stats = nullptr;
   m_volume = 0.0;
@@ -54,6 +60,9 @@ void CActiveAESink::Dispose()
   StopThread();
   m_controlPort.Purge();
   m_dataPort.Purge();
+  m_sampleRing.Clear();
+  m_returnRing.Clear();
+  m_returnBacklog.clear();
 
   if (m_sink)
   {
@@ -377,10 +386,10 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
         case CSinkDataProtocol::SAMPLE:
           CSampleBuffer *samples;
           int timeout;
-          samples = *((CSampleBuffer**)msg->data);
+          samples = m_inSample;
           timeout = 1000*samples->pkt->nb_samples/samples->pkt->config.sample_rate;
           Sleep(timeout);
-          msg->Reply(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+          ReturnSample(samples);
           m_extTimeout = 0;
           return;
         default:
@@ -406,7 +415,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
               CSampleBuffer *buffer = m_soundSamples.front();
               m_soundSamples.pop_front();
               samples += m_requestedFormat.m_dataFormat != AE_FMT_RAW ? buffer->pkt->nb_samples : 1;
-              m_dataPort.SendInMessage(CSinkDataProtocol::RETURNSAMPLE, &buffer, sizeof(CSampleBuffer*));
+              ReturnSample(buffer);
             }
             AEDelayStatus status;
             m_sink->GetDelay(status);
@@ -497,7 +506,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
           if (!m_extError)
           {
             CSampleBuffer *buffer;
-            buffer = *((CSampleBuffer**)msg->data);
+            buffer = m_inSample;
             m_soundSamples.push_back(buffer);
             m_state = S_TOP_CONFIGURED_PLAY;
             m_extTimeout = 0;
@@ -536,7 +545,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
         {
         case CSinkDataProtocol::SAMPLE:
           CSampleBuffer *buffer;
-          buffer = *((CSampleBuffer**)msg->data);
+          buffer = m_inSample;
           m_soundSamples.push_back(buffer);
           m_state = S_TOP_CONFIGURED_PLAY;
           m_extTimeout = 0;
@@ -571,7 +580,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
         {
         case CSinkDataProtocol::SAMPLE:
           CSampleBuffer *buffer;
-          buffer = *((CSampleBuffer**)msg->data);
+          buffer = m_inSample;
           m_soundSamples.push_back(buffer);
           return;
         default:
@@ -590,7 +599,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
             buffer = m_soundSamples.front();
             m_syncTime += 1000.0 * buffer->pkt->nb_samples / buffer->pkt->config.sample_rate;
             m_soundSamples.pop_front();
-            m_dataPort.SendOutMessage(CSinkDataProtocol::RETURNSAMPLE, &buffer, sizeof(CSampleBuffer*));
+            ReturnSample(buffer);
           }
           if (m_syncTime > 0)
           {
@@ -606,7 +615,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
             buffer = m_soundSamples.front();
             m_soundSamples.pop_front();
             delay = OutputSamples(buffer);
-            m_dataPort.SendInMessage(CSinkDataProtocol::RETURNSAMPLE, &buffer, sizeof(CSampleBuffer*));
+            ReturnSample(buffer);
           }
           if (m_extError)
           {
@@ -668,7 +677,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
         {
         case CSinkDataProtocol::SAMPLE:
           CSampleBuffer *buffer;
-          buffer = *((CSampleBuffer**)msg->data);
+          buffer = m_inSample;
           m_streamSamples.push_back(buffer);
           return;
         default:
@@ -714,8 +723,8 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
           {
             buffer = m_streamSamples.front();
             m_syncTime += 1000.0 * buffer->pkt->nb_samples / buffer->pkt->config.sample_rate;
-            m_soundSamples.pop_front();
-            m_dataPort.SendOutMessage(CSinkDataProtocol::RETURNSAMPLE, &buffer, sizeof(CSampleBuffer*));
+            m_streamSamples.pop_front();
+            ReturnSample(buffer);
           }
           if (m_syncTime > 0)
           {
@@ -731,7 +740,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
             buffer = m_streamSamples.front();
             m_streamSamples.pop_front();
             delay = OutputSamples(buffer);
-            m_dataPort.SendInMessage(CSinkDataProtocol::RETURNSAMPLE, &buffer, sizeof(CSampleBuffer*));
+            ReturnSample(buffer);
           }
           if (m_extError)
           {
@@ -776,6 +785,7 @@ void CActiveAESink::Process()
   {
     gotMsg = false;
     timer.Set(m_extTimeout);
+    FlushReturnBacklog();
 
     if (m_bStateMachineSelfTrigger)
     {
@@ -795,6 +805,13 @@ void CActiveAESink::Process()
       gotMsg = true;
       port = &m_controlPort;
     }
+    // check samples, ahead of the data port so DRAIN is handled after them
+    else if (m_sampleRing.Pop(&m_inSample))
+    {
+      StateMachine(CSinkDataProtocol::SAMPLE, &m_dataPort, nullptr);
+      m_inSample = nullptr;
+      continue;
+    }
     // check data port
     else if (m_dataPort.ReceiveOutMessage(&msg))
     {
@@ -1062,29 +1079,69 @@ void CActiveAESink::OpenSink()
 
 void CActiveAESink::ReturnBuffers()
 {
-  Message *msg = nullptr;
   CSampleBuffer *samples;
   while (!m_soundSamples.empty())
   {
     samples = m_soundSamples.front();
     m_soundSamples.pop_front();
-    m_dataPort.SendInMessage(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+    ReturnSample(samples);
   }
   while (!m_streamSamples.empty())
   {
     samples = m_streamSamples.front();
     m_streamSamples.pop_front();
-    m_dataPort.SendInMessage(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+    ReturnSample(samples);
   }
-  while (m_dataPort.ReceiveOutMessage(&msg))
+  while (m_sampleRing.Pop(&samples))
   {
-    if (msg->signal == CSinkDataProtocol::SAMPLE)
-    {
-      samples = *((CSampleBuffer**)msg->data);
-      msg->Reply(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
-    }
-    msg->Release();
+    ReturnSample(samples);
+  }
+}
+
+void CActiveAESink::ReturnSample(CSampleBuffer *samples)
+{
+  FlushReturnBacklog();
+
+  bool wasEmpty;
+  if (!m_returnBacklog.empty() || !m_returnRing.Push(samples, &wasEmpty))
+  {
+    m_returnBacklog.push_back(samples);
+    return;
+  }
+
+  // the engine only has to be woken up if it may have seen an empty ring
+  if (wasEmpty)
+    m_inMsgEvent->Set();
+}
+
+void CActiveAESink::FlushReturnBacklog()
+{
+  bool wasEmpty = false;
+  bool pushed = false;
+  while (!m_returnBacklog.empty() && m_returnRing.Push(m_returnBacklog.front(), &wasEmpty))
+  {
+    m_returnBacklog.pop_front();
+    pushed = true;
   }
+  if (pushed)
+    m_inMsgEvent->Set();
+}
+
+bool CActiveAESink::SendSample(CSampleBuffer *samples)
+{
+  bool wasEmpty;
+  if (!m_sampleRing.Push(samples, &wasEmpty))
+    return false;
+
+  // the sink only has to be woken up if it may have seen an empty ring
+  if (wasEmpty)
+    m_outMsgEvent.Set();
+  return true;
+}
+
+bool CActiveAESink::ReceiveReturnedSample(CSampleBuffer **samples)
+{
+  return m_returnRing.Pop(samples);
 }
 
 void CActiveAESink::RequestData()
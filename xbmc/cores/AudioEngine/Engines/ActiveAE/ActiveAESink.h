@@ -102,6 +102,19 @@ public:
   bool HasPassthroughDevice();
   bool SupportsFormat(const std::string &device, AEAudioFormat &format);
   bool DeviceExist(std::string driver, std::string device);
+
+  /*!
+   * \brief Hand a buffer to the sink, engine thread only
+   *
+   * Samples bypass m_dataPort, which is only used for control messages like
+   * DRAIN. The sink returns the buffers through ReceiveReturnedSample.
+   * \return false if the queue is full, try again later
+   */
+  bool SendSample(CSampleBuffer *samples);
+
+  //! get a buffer the sink is done with, engine thread only
+  bool ReceiveReturnedSample(CSampleBuffer **samples);
+
   CSinkControlProtocol m_controlPort;
   CSinkDataProtocol m_dataPort;
 
@@ -112,6 +125,8 @@ protected:
   void GetDeviceFriendlyName(std::string &device);
   void OpenSink();
   void ReturnBuffers();
+  void ReturnSample(CSampleBuffer *samples);
+  void FlushReturnBacklog();
   void SetSilenceTimer();
   bool NeedIECPacking();
 
@@ -158,6 +173,11 @@ protected:
   bool m_streamNoise;
   std::deque<CSampleBuffer*> m_soundSamples;
   std::deque<CSampleBuffer*> m_streamSamples;
+
+  CSampleRing m_sampleRing;                    //!< engine to sink
+  CSampleRing m_returnRing;                    //!< sink to engine
+  std::deque<CSampleBuffer*> m_returnBacklog;  //!< returned while m_returnRing was full
+  CSampleBuffer *m_inSample;                   //!< sample of the SAMPLE signal
 };
 
 }
@@ -12,6 +12,8 @@
 #include "cores/AudioEngine/Interfaces/AESound.h"
 #include "filesystem/File.h"
 
+#include <memory>
+
 class DllAvUtil;
 
 namespace ActiveAE
@@ -37,6 +39,8 @@ public:
   uint8_t** InitSound(bool orig, SampleConfig config, int nb_samples);
   bool StoreSound(bool orig, uint8_t **buffer, int samples, int linesize);
   CSoundPacket *GetSound(bool orig);
+  const std::shared_ptr<CSoundPacket>& GetSoundPtr(bool orig);
+  void SetSound(bool orig, std::shared_ptr<CSoundPacket> sound);
 
   bool IsConverted() { return m_isConverted; }
   void SetConverted(bool state) { m_isConverted = state; }
@@ -45,6 +49,7 @@ public:
   void Finish();
   int GetChunkSize();
   int GetFileSize() { return m_fileSize; }
+  int64_t GetFileTime() { return m_fileTime; }
   bool IsSeekPossible() { return m_isSeekPossible; }
 
   static int Read(void *h, uint8_t* buf, int size);
@@ -56,11 +61,13 @@ protected:
   XFILE::CFile *m_pFile;
   bool m_isSeekPossible;
   int m_fileSize;
+  int64_t m_fileTime;
   float m_volume;
   AEChannel m_channel;
 
-  CSoundPacket *m_orig_sound;
-  CSoundPacket *m_dst_sound;
+  // packets may be shared with other sounds of the same file, see CActiveAESoundCache
+  std::shared_ptr<CSoundPacket> m_orig_sound;
+  std::shared_ptr<CSoundPacket> m_dst_sound;
 
   bool m_isConverted;
 };
@@ -0,0 +1,211 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ActiveAESoundCache.h"
+
+#include "ActiveAEBuffer.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+
+using namespace ActiveAE;
+
+CActiveAESoundCache::CActiveAESoundCache(size_t maxBytes) : m_maxBytes(maxBytes)
+{
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESoundCache::GetDecoded(const std::string& file,
+                                                              int64_t size,
+                                                              int64_t mtime)
+{
+  CSingleLock lock(m_lock);
+
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->file != file)
+      continue;
+
+    // the file changed, the old version is useless
+    if (it->size != size || it->mtime != mtime)
+    {
+      m_entries.erase(it);
+      return nullptr;
+    }
+
+    Touch(it);
+    return m_entries.front().decoded;
+  }
+  return nullptr;
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESoundCache::AddDecoded(const std::string& file,
+                                                              int64_t size,
+                                                              int64_t mtime,
+                                                              std::shared_ptr<CSoundPacket> packet)
+{
+  if (!packet)
+    return packet;
+
+  CSingleLock lock(m_lock);
+
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->file == file)
+    {
+      if (it->size == size && it->mtime == mtime)
+      {
+        Touch(it);
+        return m_entries.front().decoded;
+      }
+      m_entries.erase(it);
+      break;
+    }
+  }
+
+  Entry entry;
+  entry.file = file;
+  entry.size = size;
+  entry.mtime = mtime;
+  entry.decoded = packet;
+  m_entries.push_front(std::move(entry));
+  Evict();
+  return packet;
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESoundCache::GetConverted(
+    const std::shared_ptr<CSoundPacket>& decoded, const std::string& format)
+{
+  CSingleLock lock(m_lock);
+
+  auto it = Find(decoded);
+  if (it == m_entries.end())
+    return nullptr;
+
+  auto& converted = it->converted;
+  auto match = std::find_if(converted.begin(), converted.end(),
+                            [&format](const std::pair<std::string, std::shared_ptr<CSoundPacket>>& c) {
+                              return c.first == format;
+                            });
+  if (match == converted.end())
+    return nullptr;
+
+  std::rotate(match, match + 1, converted.end());
+  Touch(it);
+  return converted.back().second;
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESoundCache::AddConverted(
+    const std::shared_ptr<CSoundPacket>& decoded,
+    const std::string& format,
+    std::shared_ptr<CSoundPacket> packet)
+{
+  if (!packet)
+    return packet;
+
+  CSingleLock lock(m_lock);
+
+  // the decoded sound was evicted, nothing to attach to
+  auto it = Find(decoded);
+  if (it == m_entries.end())
+    return packet;
+
+  auto& converted = it->converted;
+  for (auto& c : converted)
+  {
+    if (c.first == format)
+      return c.second;
+  }
+
+  // drop the oldest formats nobody plays in any more
+  for (auto c = converted.begin(); c != converted.end() && converted.size() >= MAX_FORMATS;)
+  {
+    if (c->second.use_count() == 1)
+      c = converted.erase(c);
+    else
+      ++c;
+  }
+
+  converted.emplace_back(format, std::move(packet));
+  std::shared_ptr<CSoundPacket> result = converted.back().second;
+  Touch(it);
+  Evict();
+  return result;
+}
+
+size_t CActiveAESoundCache::GetSize() const
+{
+  CSingleLock lock(m_lock);
+
+  size_t size = 0;
+  for (const auto& entry : m_entries)
+    size += GetEntrySize(entry);
+  return size;
+}
+
+void CActiveAESoundCache::Clear()
+{
+  CSingleLock lock(m_lock);
+  m_entries.clear();
+}
+
+size_t CActiveAESoundCache::GetPacketSize(const CSoundPacket& packet)
+{
+  return static_cast<size_t>(packet.max_nb_samples) * packet.bytes_per_sample *
+         packet.config.channels;
+}
+
+void CActiveAESoundCache::Touch(std::list<Entry>::iterator it)
+{
+  if (it != m_entries.begin())
+    m_entries.splice(m_entries.begin(), m_entries, it);
+}
+
+std::list<CActiveAESoundCache::Entry>::iterator CActiveAESoundCache::Find(
+    const std::shared_ptr<CSoundPacket>& decoded)
+{
+  return std::find_if(m_entries.begin(), m_entries.end(),
+                      [&decoded](const Entry& entry) { return entry.decoded == decoded; });
+}
+
+void CActiveAESoundCache::Evict()
+{
+  size_t size = 0;
+  for (const auto& entry : m_entries)
+    size += GetEntrySize(entry);
+
+  // sounds in use stay, they would be held in memory anyway
+  auto it = m_entries.end();
+  while (size > m_maxBytes && it != m_entries.begin())
+  {
+    --it;
+    if (InUse(*it))
+      continue;
+    size -= GetEntrySize(*it);
+    it = m_entries.erase(it);
+  }
+}
+
+bool CActiveAESoundCache::InUse(const Entry& entry)
+{
+  if (entry.decoded.use_count() > 1)
+    return true;
+  for (const auto& c : entry.converted)
+  {
+    if (c.second.use_count() > 1)
+      return true;
+  }
+  return false;
+}
+
+size_t CActiveAESoundCache::GetEntrySize(const Entry& entry)
+{
+  size_t size = GetPacketSize(*entry.decoded);
+  for (const auto& c : entry.converted)
+    size += GetPacketSize(*c.second);
+  return size;
+}
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ActiveAE
+{
+
+class CSoundPacket;
+
+/**
+ * Decoded gui sounds shared by all sound objects of a file, together with
+ * the sound converted to the output formats it was played in. Entries are
+ * kept after the last sound of a file is freed, so reloading a skin or a
+ * sound pack neither decodes nor resamples again. Unused entries are
+ * dropped, least recently used first, when the cache outgrows its limit.
+ */
+class CActiveAESoundCache
+{
+public:
+  explicit CActiveAESoundCache(size_t maxBytes = DEFAULT_MAX_BYTES);
+
+  /**
+   * returns the decoded sound of a file, nullptr if it is not cached
+   * size and mtime tell apart different versions of the file
+   */
+  std::shared_ptr<CSoundPacket> GetDecoded(const std::string& file, int64_t size, int64_t mtime);
+
+  /**
+   * caches a decoded sound and returns the packet to use, which is the
+   * cached one if another sound of the file got decoded meanwhile
+   */
+  std::shared_ptr<CSoundPacket> AddDecoded(const std::string& file, int64_t size, int64_t mtime,
+                                           std::shared_ptr<CSoundPacket> packet);
+
+  /**
+   * returns a decoded sound converted to an output format, nullptr if it is not cached
+   * format is a key for everything the conversion depends on
+   */
+  std::shared_ptr<CSoundPacket> GetConverted(const std::shared_ptr<CSoundPacket>& decoded,
+                                             const std::string& format);
+  std::shared_ptr<CSoundPacket> AddConverted(const std::shared_ptr<CSoundPacket>& decoded,
+                                             const std::string& format,
+                                             std::shared_ptr<CSoundPacket> packet);
+
+  size_t GetSize() const;
+  void Clear();
+
+  static size_t GetPacketSize(const CSoundPacket& packet);
+
+  static const size_t DEFAULT_MAX_BYTES = 32 * 1024 * 1024;
+  static const size_t MAX_FORMATS = 4; //!< converted versions kept per sound
+
+protected:
+  struct Entry
+  {
+    std::string file;
+    int64_t size;
+    int64_t mtime;
+    std::shared_ptr<CSoundPacket> decoded;
+    //! by output format, most recently used last
+    std::vector<std::pair<std::string, std::shared_ptr<CSoundPacket>>> converted;
+  };
+
+  //! moves an entry to the front of the lru list
+  void Touch(std::list<Entry>::iterator it);
+  std::list<Entry>::iterator Find(const std::shared_ptr<CSoundPacket>& decoded);
+  void Evict();
+  static bool InUse(const Entry& entry);
+  static size_t GetEntrySize(const Entry& entry);
+
+  mutable CCriticalSection m_lock;
+  std::list<Entry> m_entries; //!< most recently used first
+  size_t m_maxBytes;
+};
+}
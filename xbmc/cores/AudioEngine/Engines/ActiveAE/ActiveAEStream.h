@@ -243,6 +243,7 @@ protected:
   enum AVMatrixEncoding m_matrixEncoding;
   enum AVAudioServiceType m_audioServiceType;
   bool m_forceResampler;
+  bool m_lowLatency;
   IAEClockCallback *m_pClock;
   CSyncError m_syncError;
   double m_lastSyncError;
@@ -0,0 +1,179 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAESink.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace AE;
+using namespace ActiveAE;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct LatencyResult
+{
+  unsigned int periodFrames = 0;
+  double average = 0.0; //!< seconds
+  double max = 0.0;     //!< seconds
+  double maxDelay = 0.0; //!< CEngineStats::GetMaxDelay(), seconds
+  unsigned int underruns = 0;
+};
+
+/* Drives CActiveAESink with the null sink the way CActiveAE does while a
+ * stream plays, keeping the buffers between engine and sink at the water
+ * level, and samples the delay CEngineStats reports to the streams.
+ */
+bool MeasureLatency(bool lowLatency, LatencyResult& result)
+{
+  // a real time null sink with the default buffer of 4 periods
+  CAESinkNULL::Register();
+  CAESinkNULL::SetOptions(CAESinkNULL::Options());
+  CAESinkNULL::ResetStats();
+
+  CEvent inMsgEvent;
+  CEngineStats stats;
+  CActiveAESink sink(&inMsgEvent);
+  sink.Start();
+
+  std::string device = "NULL:default";
+  SinkConfig config;
+  config.format.m_dataFormat = AE_FMT_FLOAT;
+  config.format.m_sampleRate = 48000;
+  config.format.m_channelLayout = AE_CH_LAYOUT_2_0;
+  config.format.m_periodTime = lowLatency ? 5 : 0;
+  config.stats = &stats;
+  config.device = &device;
+
+  AEAudioFormat sinkFormat;
+  Message* reply;
+  if (!sink.m_controlPort.SendOutMessageSync(CSinkControlProtocol::CONFIGURE, &reply, 5000,
+                                             &config, sizeof(config)))
+  {
+    sink.Dispose();
+    return false;
+  }
+  bool success = reply->signal == CSinkControlProtocol::ACC;
+  if (success)
+  {
+    SinkReply* data = reinterpret_cast<SinkReply*>(reply->data);
+    sinkFormat = data->format;
+    stats.SetSinkCacheTotal(data->cacheTotal);
+    stats.SetSinkLatency(data->latency);
+  }
+  reply->Release();
+  if (!success)
+  {
+    sink.Dispose();
+    return false;
+  }
+
+  stats.Reset(sinkFormat.m_sampleRate, true);
+  stats.SetCurrentSinkFormat(sinkFormat);
+  stats.SetBufferLevels(lowLatency, static_cast<float>(sinkFormat.m_frames) / sinkFormat.m_sampleRate);
+
+  bool streaming = true;
+  sink.m_controlPort.SendOutMessage(CSinkControlProtocol::STREAMING, &streaming, sizeof(bool));
+
+  CActiveAEBufferPool pool(sinkFormat);
+  pool.Create(stats.GetMaxWaterLevel() * 1000);
+
+  std::list<CActiveAEStream*> streams;
+  unsigned int samples = 0;
+  double total = 0.0;
+
+  const Clock::duration warmup = std::chrono::milliseconds(250);
+  const Clock::duration duration = std::chrono::seconds(1);
+  Clock::time_point start = Clock::now();
+  Clock::time_point now;
+  while ((now = Clock::now()) - start < warmup + duration)
+  {
+    CSampleBuffer* buffer;
+    while (sink.ReceiveReturnedSample(&buffer))
+      buffer->Return();
+
+    if (stats.GetWaterLevel() < stats.GetMaxWaterLevel() && !pool.m_freeSamples.empty())
+    {
+      buffer = pool.GetFreeBuffer();
+      buffer->pkt->nb_samples = buffer->pkt->max_nb_samples;
+      memset(buffer->pkt->data[0], 0, buffer->pkt->linesize);
+      if (sink.SendSample(buffer))
+        stats.AddSamples(buffer->pkt->nb_samples, streams);
+      else
+        buffer->Return();
+      continue;
+    }
+
+    if (now - start >= warmup)
+    {
+      AEDelayStatus status;
+      stats.GetDelay(status);
+      double delay = status.GetDelay();
+      total += delay;
+      result.max = std::max(result.max, delay);
+      samples++;
+    }
+    inMsgEvent.WaitMSec(1);
+  }
+
+  result.periodFrames = sinkFormat.m_frames;
+  result.average = samples ? total / samples : 0.0;
+  result.maxDelay = stats.GetMaxDelay();
+  result.underruns = CAESinkNULL::GetStats().underruns;
+
+  // the buffers are owned by the pool, the sink only has to let go of them
+  if (sink.m_controlPort.SendOutMessageSync(CSinkControlProtocol::FLUSH, &reply, 5000))
+    reply->Release();
+  sink.Dispose();
+
+  return true;
+}
+
+void PrintResult(const std::string& mode, const LatencyResult& result)
+{
+  std::cout << StringUtils::Format("%s: period %u frames, latency average %.1f ms max %.1f ms, "
+                                   "reported max delay %.1f ms, underruns %u",
+                                   mode.c_str(), result.periodFrames, result.average * 1000,
+                                   result.max * 1000, result.maxDelay * 1000, result.underruns)
+            << std::endl;
+}
+}
+
+/* Plays a stream of silence through the sink thread into a null sink in real
+ * time, once with the default buffering and once in low latency mode, and
+ * reports the end to end latency the engine measures. Disabled in regular runs
+ * as it takes seconds of real time and the measured delays depend on the load
+ * of the machine, run it with --gtest_also_run_disabled_tests.
+ */
+TEST(TestActiveAELatency, DISABLED_NullSink)
+{
+  LatencyResult normal;
+  ASSERT_TRUE(MeasureLatency(false, normal));
+  PrintResult("default", normal);
+
+  LatencyResult lowLatency;
+  ASSERT_TRUE(MeasureLatency(true, lowLatency));
+  PrintResult("low latency", lowLatency);
+
+  EXPECT_LT(lowLatency.periodFrames, normal.periodFrames);
+  EXPECT_LT(lowLatency.maxDelay, normal.maxDelay);
+  EXPECT_LT(lowLatency.average, normal.average);
+}
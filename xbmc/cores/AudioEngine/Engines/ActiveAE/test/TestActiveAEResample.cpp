@@ -0,0 +1,111 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/AEResampleFactory.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const unsigned int FRAMES = 1024;
+const unsigned int CHANNELS = 2;
+
+SampleConfig MakeConfig(int sampleRate)
+{
+  CAEChannelInfo layout(AE_CH_LAYOUT_2_0);
+  SampleConfig config;
+  config.channel_layout = CAEUtil::GetAVChannelLayout(layout);
+  config.channels = layout.Count();
+  config.sample_rate = sampleRate;
+  config.fmt = CAEUtil::GetAVSampleFormat(AE_FMT_FLOAT);
+  config.bits_per_sample = CAEUtil::DataFormatToUsedBits(AE_FMT_FLOAT);
+  config.dither_bits = CAEUtil::DataFormatToDitherBits(AE_FMT_FLOAT);
+  return config;
+}
+
+ActiveAE::IAEResample* Acquire(AEQuality quality)
+{
+  return ActiveAE::CAEResampleFactory::Acquire(MakeConfig(48000), MakeConfig(44100), false, true,
+                                               M_SQRT1_2, nullptr, quality, false);
+}
+
+//! resample a few blocks of a sine, the way CActiveAEBufferPoolResample feeds a resampler
+std::vector<float> Resample(ActiveAE::IAEResample* resampler, unsigned int blocks)
+{
+  std::vector<float> in(FRAMES * CHANNELS);
+  std::vector<float> out(FRAMES * 2 * CHANNELS);
+  std::vector<float> result;
+  unsigned int frame = 0;
+  for (unsigned int block = 0; block < blocks; block++)
+  {
+    for (unsigned int i = 0; i < FRAMES; i++, frame++)
+      in[i * CHANNELS] = in[i * CHANNELS + 1] = static_cast<float>(sin(frame * 0.05));
+
+    uint8_t* src = reinterpret_cast<uint8_t*>(in.data());
+    uint8_t* dst = reinterpret_cast<uint8_t*>(out.data());
+    int samples = resampler->Resample(&dst, FRAMES * 2, &src, FRAMES, 1.0);
+    if (samples < 0)
+      return std::vector<float>();
+    result.insert(result.end(), out.begin(), out.begin() + samples * CHANNELS);
+  }
+  return result;
+}
+}
+
+TEST(TestActiveAEResample, ReuseByConfiguration)
+{
+  ActiveAE::IAEResample* resampler = Acquire(AE_QUALITY_MID);
+  ASSERT_NE(nullptr, resampler);
+  ActiveAE::CAEResampleFactory::Release(resampler);
+
+  // the same configuration gets the released one back
+  ActiveAE::IAEResample* reused = Acquire(AE_QUALITY_MID);
+  EXPECT_EQ(resampler, reused);
+
+  // busy resamplers are not shared
+  ActiveAE::IAEResample* second = Acquire(AE_QUALITY_MID);
+  EXPECT_NE(reused, second);
+
+  // other configurations get their own
+  ActiveAE::IAEResample* other = Acquire(AE_QUALITY_HIGH);
+  EXPECT_NE(reused, other);
+  EXPECT_NE(second, other);
+
+  ActiveAE::CAEResampleFactory::Release(other);
+  ActiveAE::CAEResampleFactory::Release(second);
+  ActiveAE::CAEResampleFactory::Release(reused);
+}
+
+/* A reused resampler must not carry samples or filter state over from its
+ * previous user, it has to behave like a freshly created one.
+ */
+TEST(TestActiveAEResample, ReusedMatchesFresh)
+{
+  ActiveAE::IAEResample* fresh = Acquire(AE_QUALITY_HIGH);
+  ASSERT_NE(nullptr, fresh);
+  std::vector<float> expected = Resample(fresh, 8);
+  ASSERT_FALSE(expected.empty());
+
+  // leave samples buffered in the filter
+  Resample(fresh, 3);
+  EXPECT_GT(fresh->GetBufferedSamples(), 0);
+  ActiveAE::CAEResampleFactory::Release(fresh);
+
+  ActiveAE::IAEResample* reused = Acquire(AE_QUALITY_HIGH);
+  ASSERT_EQ(fresh, reused);
+  std::vector<float> output = Resample(reused, 8);
+  ActiveAE::CAEResampleFactory::Release(reused);
+
+  ASSERT_EQ(expected.size(), output.size());
+  for (size_t i = 0; i < expected.size(); i++)
+    ASSERT_EQ(expected[i], output[i]) << "at sample " << i;
+}
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAESoundCache.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const int SAMPLES = 1000;
+
+std::shared_ptr<ActiveAE::CSoundPacket> MakePacket(int sampleRate = 44100)
+{
+  CAEChannelInfo layout(AE_CH_LAYOUT_2_0);
+  SampleConfig config;
+  config.channel_layout = CAEUtil::GetAVChannelLayout(layout);
+  config.channels = layout.Count();
+  config.sample_rate = sampleRate;
+  config.fmt = CAEUtil::GetAVSampleFormat(AE_FMT_S16NE);
+  config.bits_per_sample = 16;
+  config.dither_bits = 0;
+  return std::make_shared<ActiveAE::CSoundPacket>(config, SAMPLES);
+}
+}
+
+TEST(TestActiveAESoundCache, SharedDecoded)
+{
+  ActiveAE::CActiveAESoundCache cache;
+  EXPECT_EQ(nullptr, cache.GetDecoded("click.wav", 100, 1));
+
+  std::shared_ptr<ActiveAE::CSoundPacket> packet = MakePacket();
+  EXPECT_EQ(packet, cache.AddDecoded("click.wav", 100, 1, packet));
+  EXPECT_EQ(packet, cache.GetDecoded("click.wav", 100, 1));
+
+  // a second decode of the file gets the cached packet
+  EXPECT_EQ(packet, cache.AddDecoded("click.wav", 100, 1, MakePacket()));
+
+  // sounds are kept when nobody uses them, e.g. over a skin reload
+  ActiveAE::CSoundPacket* raw = packet.get();
+  packet.reset();
+  EXPECT_EQ(raw, cache.GetDecoded("click.wav", 100, 1).get());
+}
+
+TEST(TestActiveAESoundCache, ChangedFile)
+{
+  ActiveAE::CActiveAESoundCache cache;
+  cache.AddDecoded("click.wav", 100, 1, MakePacket());
+
+  EXPECT_EQ(nullptr, cache.GetDecoded("click.wav", 100, 2));
+  EXPECT_EQ(nullptr, cache.GetDecoded("click.wav", 100, 1));
+}
+
+TEST(TestActiveAESoundCache, Converted)
+{
+  ActiveAE::CActiveAESoundCache cache;
+  std::shared_ptr<ActiveAE::CSoundPacket> decoded = cache.AddDecoded("click.wav", 100, 1, MakePacket());
+  EXPECT_EQ(nullptr, cache.GetConverted(decoded, "48000"));
+
+  std::shared_ptr<ActiveAE::CSoundPacket> converted = MakePacket(48000);
+  EXPECT_EQ(converted, cache.AddConverted(decoded, "48000", converted));
+  EXPECT_EQ(converted, cache.GetConverted(decoded, "48000"));
+  EXPECT_EQ(nullptr, cache.GetConverted(decoded, "96000"));
+
+  // switching formats back and forth converts only once per format
+  std::shared_ptr<ActiveAE::CSoundPacket> other = MakePacket(96000);
+  cache.AddConverted(decoded, "96000", other);
+  EXPECT_EQ(converted, cache.GetConverted(decoded, "48000"));
+  EXPECT_EQ(other, cache.GetConverted(decoded, "96000"));
+
+  // unused formats beyond the limit are dropped
+  converted.reset();
+  other.reset();
+  for (size_t i = 0; i < ActiveAE::CActiveAESoundCache::MAX_FORMATS; i++)
+    cache.AddConverted(decoded, std::to_string(i), MakePacket());
+  EXPECT_EQ(nullptr, cache.GetConverted(decoded, "48000"));
+}
+
+TEST(TestActiveAESoundCache, Eviction)
+{
+  std::shared_ptr<ActiveAE::CSoundPacket> packet = MakePacket();
+  const size_t packetSize = ActiveAE::CActiveAESoundCache::GetPacketSize(*packet);
+  ActiveAE::CActiveAESoundCache cache(packetSize * 2);
+
+  // in use, kept even if the cache is full
+  cache.AddDecoded("a.wav", 100, 1, packet);
+  cache.AddDecoded("b.wav", 100, 1, MakePacket());
+  cache.AddDecoded("c.wav", 100, 1, MakePacket());
+  EXPECT_EQ(packetSize * 2, cache.GetSize());
+  EXPECT_EQ(packet, cache.GetDecoded("a.wav", 100, 1));
+  EXPECT_EQ(nullptr, cache.GetDecoded("b.wav", 100, 1));
+  EXPECT_NE(nullptr, cache.GetDecoded("c.wav", 100, 1));
+
+  // the least recently used unused one goes first
+  packet.reset();
+  cache.GetDecoded("a.wav", 100, 1);
+  cache.AddDecoded("d.wav", 100, 1, MakePacket());
+  EXPECT_NE(nullptr, cache.GetDecoded("a.wav", 100, 1));
+  EXPECT_EQ(nullptr, cache.GetDecoded("c.wav", 100, 1));
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.GetSize());
+}
@@ -29,6 +29,11 @@ public:
   virtual int CalcDstSampleCount(int src_samples, int dst_rate, int src_rate) = 0;
   virtual int GetSrcBufferSize(int samples) = 0;
   virtual int GetDstBufferSize(int samples) = 0;
+
+  /*! \brief Drop buffered samples and compensation but keep the configuration
+   * \return false if the resampler has to be initialized again
+   */
+  virtual bool Reset() { return false; }
 };
 
 }
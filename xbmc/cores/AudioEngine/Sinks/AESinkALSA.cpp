@@ -480,6 +480,7 @@ bool CAESinkALSA::Initialize(AEAudioFormat &format, std::string &device)
   ALSAConfig inconfig, outconfig;
   inconfig.format = format.m_dataFormat;
   inconfig.sampleRate = format.m_sampleRate;
+  inconfig.periodTime = format.m_dataFormat == AE_FMT_RAW ? 0 : format.m_periodTime;
 
   /*
    * We can't use the better GetChannelLayout() at this point as the device
@@ -640,6 +641,7 @@ bool CAESinkALSA::InitializeHW(const ALSAConfig &inconfig, ALSAConfig &outconfig
 
   /* update outconfig */
   outconfig.channels = channelCount;
+  outconfig.periodTime = inconfig.periodTime;
 
   snd_pcm_format_t fmt = AEFormatToALSAFormat(inconfig.format);
   outconfig.format = inconfig.format;
@@ -718,8 +720,20 @@ bool CAESinkALSA::InitializeHW(const ALSAConfig &inconfig, ALSAConfig &outconfig
    will cause problems with menu sounds. Buffer will be increased
    after those are fixed.
   */
-  periodSize  = std::min(periodSize, (snd_pcm_uframes_t) sampleRate / 20);
-  bufferSize  = std::min(bufferSize, (snd_pcm_uframes_t) sampleRate / 5);
+  if (inconfig.periodTime > 0)
+  {
+    /*
+     Low latency was requested, use a period of the requested time
+     and the smallest buffer that still holds 4 periods.
+    */
+    periodSize = std::min(periodSize, (snd_pcm_uframes_t) sampleRate * inconfig.periodTime / 1000);
+    bufferSize = std::min(bufferSize, periodSize * 4);
+  }
+  else
+  {
+    periodSize  = std::min(periodSize, (snd_pcm_uframes_t) sampleRate / 20);
+    bufferSize  = std::min(bufferSize, (snd_pcm_uframes_t) sampleRate / 5);
+  }
 
   /*
    According to upstream we should set buffer size first - so make sure it is always at least
@@ -794,9 +808,10 @@ bool CAESinkALSA::InitializeHW(const ALSAConfig &inconfig, ALSAConfig &outconfig
   /* if periodSize is too small Audio Engine might starve */
   m_fragmented = false;
   unsigned int fragments = 1;
-  if (periodSize < AE_MIN_PERIODSIZE)
+  unsigned int minPeriodSize = inconfig.periodTime > 0 ? AE_MIN_PERIODSIZE_LOW_LATENCY : AE_MIN_PERIODSIZE;
+  if (periodSize < minPeriodSize)
   {
-    fragments = std::ceil((double) AE_MIN_PERIODSIZE / periodSize);
+    fragments = std::ceil((double) minPeriodSize / periodSize);
     CLog::Log(LOGDEBUG, "Audio Driver reports too low periodSize %d - will use %d fragments", (int) periodSize, (int) fragments);
     m_fragmented = true;
   }
@@ -23,6 +23,7 @@
 #include "platform/linux/FDEventMonitor.h"
 
 #define AE_MIN_PERIODSIZE 256
+#define AE_MIN_PERIODSIZE_LOW_LATENCY 64
 
 class CAESinkALSA : public IAESink
 {
@@ -87,6 +88,7 @@ private:
     unsigned int periodSize;
     unsigned int frameSize;
     unsigned int channels;
+    unsigned int periodTime; // requested period in ms, 0 for default
     AEDataFormat format;
   };
 
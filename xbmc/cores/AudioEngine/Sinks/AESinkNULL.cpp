@@ -0,0 +1,275 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AESinkNULL.h"
+
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "filesystem/File.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+CCriticalSection nullSinkSection;
+CAESinkNULL::Options nullSinkOptions;
+CAESinkNULL::Stats nullSinkStats;
+double nullSinkDelaySum = 0.0;
+uint64_t nullSinkDelayCount = 0;
+
+void PutLE(std::vector<uint8_t>& out, uint32_t value, unsigned int bytes)
+{
+  for (unsigned int i = 0; i < bytes; i++)
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+}
+
+CAESinkNULL::~CAESinkNULL()
+{
+  Deinitialize();
+}
+
+void CAESinkNULL::Register()
+{
+  AE::AESinkRegEntry entry;
+  entry.sinkName = "NULL";
+  entry.createFunc = CAESinkNULL::Create;
+  entry.enumerateFunc = CAESinkNULL::EnumerateDevicesEx;
+  AE::CAESinkFactory::RegisterSink(entry);
+}
+
+IAESink* CAESinkNULL::Create(std::string &device, AEAudioFormat& desiredFormat)
+{
+  IAESink* sink = new CAESinkNULL();
+  if (sink->Initialize(desiredFormat, device))
+    return sink;
+
+  delete sink;
+  return nullptr;
+}
+
+void CAESinkNULL::EnumerateDevicesEx(AEDeviceInfoList &list, bool force)
+{
+  CAEDeviceInfo info;
+  info.m_deviceName = "default";
+  info.m_displayName = "Null";
+  info.m_displayNameExtra = "no output";
+  info.m_deviceType = AE_DEVTYPE_HDMI;
+  info.m_channels = AE_CH_LAYOUT_7_1;
+  info.m_sampleRates = {44100, 48000, 88200, 96000, 176400, 192000};
+  info.m_dataFormats = {AE_FMT_FLOAT, AE_FMT_S32NE, AE_FMT_S16NE, AE_FMT_RAW};
+  info.m_streamTypes = {CAEStreamInfo::STREAM_TYPE_AC3,        CAEStreamInfo::STREAM_TYPE_EAC3,
+                        CAEStreamInfo::STREAM_TYPE_DTSHD,      CAEStreamInfo::STREAM_TYPE_DTSHD_MA,
+                        CAEStreamInfo::STREAM_TYPE_DTSHD_CORE, CAEStreamInfo::STREAM_TYPE_DTS_512,
+                        CAEStreamInfo::STREAM_TYPE_DTS_1024,   CAEStreamInfo::STREAM_TYPE_DTS_2048,
+                        CAEStreamInfo::STREAM_TYPE_TRUEHD};
+  info.m_wantsIECPassthrough = true;
+  list.push_back(info);
+}
+
+void CAESinkNULL::SetOptions(const Options& options)
+{
+  CSingleLock lock(nullSinkSection);
+  nullSinkOptions = options;
+}
+
+CAESinkNULL::Stats CAESinkNULL::GetStats()
+{
+  CSingleLock lock(nullSinkSection);
+  Stats stats = nullSinkStats;
+  stats.averageDelay = nullSinkDelayCount ? nullSinkDelaySum / nullSinkDelayCount : 0.0;
+  return stats;
+}
+
+void CAESinkNULL::ResetStats()
+{
+  CSingleLock lock(nullSinkSection);
+  nullSinkStats = Stats();
+  nullSinkDelaySum = 0.0;
+  nullSinkDelayCount = 0;
+}
+
+bool CAESinkNULL::Initialize(AEAudioFormat &format, std::string &device)
+{
+  {
+    CSingleLock lock(nullSinkSection);
+    m_options = nullSinkOptions;
+  }
+
+  // passthrough arrives packed into IEC 61937 frames of 16 bit words
+  if (format.m_dataFormat == AE_FMT_RAW)
+    format.m_frameSize = 2 * format.m_channelLayout.Count();
+  else
+  {
+    if (format.m_dataFormat != AE_FMT_S16NE && format.m_dataFormat != AE_FMT_S32NE)
+      format.m_dataFormat = AE_FMT_FLOAT;
+    format.m_frameSize = (CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3) *
+                         format.m_channelLayout.Count();
+  }
+
+  unsigned int periodTime = format.m_periodTime ? format.m_periodTime : m_options.periodTime;
+  format.m_frames = std::max(format.m_sampleRate * periodTime / 1000, 1u);
+
+  if (!format.m_frameSize || !format.m_sampleRate)
+    return false;
+
+  m_format = format;
+  m_bufferFrames = std::max(m_options.periods, 1u) * format.m_frames;
+  m_buffered = 0.0;
+  m_start = m_lastUpdate = Clock::now();
+  m_wavAudio.clear();
+  m_initialized = true;
+
+  {
+    CSingleLock lock(nullSinkSection);
+    nullSinkStats.format = format;
+    nullSinkStats.initializations++;
+  }
+
+  CLog::Log(LOGDEBUG, "CAESinkNULL::Initialize - %s, %u Hz, %u channels, period %u frames, speed %.2f",
+            CAEUtil::DataFormatToStr(format.m_dataFormat), format.m_sampleRate,
+            format.m_channelLayout.Count(), format.m_frames, m_options.speed);
+  return true;
+}
+
+void CAESinkNULL::Deinitialize()
+{
+  if (!m_initialized)
+    return;
+
+  m_initialized = false;
+  if (!m_options.wavFile.empty() && !WriteWav(m_options.wavFile, m_wavAudio))
+    CLog::Log(LOGERROR, "CAESinkNULL::Deinitialize - failed to write %s", m_options.wavFile.c_str());
+  m_wavAudio.clear();
+}
+
+double CAESinkNULL::GetCacheTotal()
+{
+  if (m_options.speed <= 0.0)
+    return 0.0;
+  return static_cast<double>(m_bufferFrames) / m_format.m_sampleRate / m_options.speed;
+}
+
+unsigned int CAESinkNULL::AddPackets(uint8_t **data, unsigned int frames, unsigned int offset)
+{
+  if (!m_initialized)
+    return 0;
+
+  double blocked = 0.0;
+  if (m_options.speed > 0.0)
+  {
+    // block until there is room, like a device would
+    frames = std::min(frames, m_bufferFrames);
+    Update();
+    while (m_buffered + frames > m_bufferFrames)
+    {
+      double wait = (m_buffered + frames - m_bufferFrames) / m_format.m_sampleRate / m_options.speed;
+      std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+      blocked += wait;
+      Update();
+    }
+    m_buffered += frames;
+  }
+
+  const uint8_t* buffer = data[0] + offset * m_format.m_frameSize;
+  const size_t size = static_cast<size_t>(frames) * m_format.m_frameSize;
+  if (!m_options.wavFile.empty())
+    m_wavAudio.insert(m_wavAudio.end(), buffer, buffer + size);
+
+  CSingleLock lock(nullSinkSection);
+  nullSinkStats.packets++;
+  nullSinkStats.frames += frames;
+  nullSinkStats.blockedTime += blocked;
+  if (m_options.capture)
+  {
+    nullSinkStats.audio.insert(nullSinkStats.audio.end(), buffer, buffer + size);
+    Delivery delivery;
+    delivery.time = std::chrono::duration<double>(Clock::now() - m_start).count();
+    delivery.frames = frames;
+    nullSinkStats.deliveries.push_back(delivery);
+  }
+  return frames;
+}
+
+void CAESinkNULL::GetDelay(AEDelayStatus& status)
+{
+  Update();
+  double delay = 0.0;
+  if (m_options.speed > 0.0 && m_format.m_sampleRate)
+    delay = m_buffered / m_format.m_sampleRate / m_options.speed;
+  status.SetDelay(delay);
+
+  CSingleLock lock(nullSinkSection);
+  nullSinkStats.maxDelay = std::max(nullSinkStats.maxDelay, delay);
+  nullSinkDelaySum += delay;
+  nullSinkDelayCount++;
+}
+
+void CAESinkNULL::Drain()
+{
+  if (m_options.speed > 0.0 && m_buffered > 0.0)
+  {
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(m_buffered / m_format.m_sampleRate / m_options.speed));
+  }
+  m_buffered = 0.0;
+  m_lastUpdate = Clock::now();
+}
+
+void CAESinkNULL::Update()
+{
+  Clock::time_point now = Clock::now();
+  double played = std::chrono::duration<double>(now - m_lastUpdate).count() *
+                  m_format.m_sampleRate * m_options.speed;
+  m_lastUpdate = now;
+
+  if (m_buffered > 0.0 && played > m_buffered)
+  {
+    CSingleLock lock(nullSinkSection);
+    nullSinkStats.underruns++;
+  }
+  m_buffered = std::max(m_buffered - played, 0.0);
+}
+
+bool CAESinkNULL::WriteWav(const std::string& file, const std::vector<uint8_t>& audio)
+{
+  // float is stored as IEEE float, passthrough as the 16 bit stereo an S/PDIF receiver gets
+  const bool isFloat = m_format.m_dataFormat == AE_FMT_FLOAT;
+  const unsigned int channels = m_format.m_channelLayout.Count();
+  const unsigned int blockAlign = m_format.m_frameSize;
+  const unsigned int bits = blockAlign * 8 / channels;
+  const uint32_t dataSize = static_cast<uint32_t>(audio.size());
+
+  std::vector<uint8_t> header;
+  header.insert(header.end(), {'R', 'I', 'F', 'F'});
+  PutLE(header, 36 + dataSize, 4);
+  header.insert(header.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+  PutLE(header, 16, 4);
+  PutLE(header, isFloat ? 3 : 1, 2);
+  PutLE(header, channels, 2);
+  PutLE(header, m_format.m_sampleRate, 4);
+  PutLE(header, m_format.m_sampleRate * blockAlign, 4);
+  PutLE(header, blockAlign, 2);
+  PutLE(header, bits, 2);
+  header.insert(header.end(), {'d', 'a', 't', 'a'});
+  PutLE(header, dataSize, 4);
+
+  XFILE::CFile out;
+  if (!out.OpenForWrite(file, true))
+    return false;
+
+  bool success = out.Write(header.data(), header.size()) == static_cast<ssize_t>(header.size());
+  if (success && !audio.empty())
+    success = out.Write(audio.data(), audio.size()) == static_cast<ssize_t>(audio.size());
+  out.Close();
+  return success;
+}
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AESink.h"
+#include "cores/AudioEngine/Utils/AEDeviceInfo.h"
+
+#include <chrono>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Sink without hardware, for running the engine headless, e.g. in tests and
+ * benchmarks. It consumes audio at a given speed relative to real time, keeps
+ * statistics about what it got and can capture the audio to memory or a wav file.
+ *
+ * The sink is created by the engine, options and statistics are therefore
+ * shared by all instances and accessed through static methods.
+ */
+class CAESinkNULL : public IAESink
+{
+public:
+  const char *GetName() override { return "NULL"; }
+
+  struct Options
+  {
+    double speed = 1.0;               //!< playback speed, 1.0 is real time, 0 never blocks
+    unsigned int periods = 4;         //!< buffer size in periods
+    unsigned int periodTime = 50;     //!< ms, used if the format requests none
+    bool capture = false;             //!< keep delivered audio and timing in memory
+    std::string wavFile;              //!< write delivered audio to this file on deinitialize
+  };
+
+  struct Delivery
+  {
+    double time;                      //!< seconds since initialize
+    unsigned int frames;
+  };
+
+  struct Stats
+  {
+    AEAudioFormat format;             //!< format of the last initialize
+    unsigned int initializations = 0;
+    uint64_t packets = 0;             //!< calls of AddPackets
+    uint64_t frames = 0;              //!< frames consumed
+    unsigned int underruns = 0;       //!< times the buffer ran dry while playing
+    double maxDelay = 0.0;            //!< seconds, highest delay reported
+    double averageDelay = 0.0;        //!< seconds, of all delays reported
+    double blockedTime = 0.0;         //!< seconds AddPackets waited for room in the buffer
+    std::vector<uint8_t> audio;       //!< captured audio, interleaved
+    std::vector<Delivery> deliveries; //!< captured packets
+  };
+
+  CAESinkNULL() = default;
+  ~CAESinkNULL() override;
+
+  static void Register();
+  static IAESink* Create(std::string &device, AEAudioFormat &desiredFormat);
+  static void EnumerateDevicesEx(AEDeviceInfoList &list, bool force = false);
+
+  static void SetOptions(const Options& options);
+  static Stats GetStats();
+  static void ResetStats();
+
+  bool Initialize(AEAudioFormat &format, std::string &device) override;
+  void Deinitialize() override;
+
+  double GetCacheTotal() override;
+  unsigned int AddPackets(uint8_t **data, unsigned int frames, unsigned int offset) override;
+  void GetDelay(AEDelayStatus& status) override;
+  void Drain() override;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  //! consume the frames due since the last update
+  void Update();
+  bool WriteWav(const std::string& file, const std::vector<uint8_t>& audio);
+
+  Options m_options;
+  AEAudioFormat m_format;
+  bool m_initialized = false;
+  unsigned int m_bufferFrames = 0;
+  double m_buffered = 0.0; //!< frames
+  Clock::time_point m_start;
+  Clock::time_point m_lastUpdate;
+  std::vector<uint8_t> m_wavAudio;
+};
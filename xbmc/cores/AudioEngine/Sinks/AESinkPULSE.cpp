@@ -934,6 +934,13 @@ bool CAESinkPULSE::Initialize(AEAudioFormat &format, std::string &device)
     process_time = latency / 4;
   }
 
+  // low latency: packets of the requested period time, 4 of them buffered
+  if (format.m_periodTime > 0 && !m_passthrough)
+  {
+    process_time = frameSize * (m_BytesPerSecond / frameSize * format.m_periodTime / 1000);
+    latency = process_time * 4;
+  }
+
   pa_buffer_attr buffer_attr;
   buffer_attr.fragsize = latency;
   buffer_attr.maxlength = (uint32_t) -1;
@@ -0,0 +1,203 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const unsigned int SAMPLE_RATE = 48000;
+const unsigned int CHANNELS = 2;
+
+AEAudioFormat MakeFormat(unsigned int periodTime = 10)
+{
+  AEAudioFormat format;
+  format.m_dataFormat = AE_FMT_FLOAT;
+  format.m_sampleRate = SAMPLE_RATE;
+  format.m_channelLayout = AE_CH_LAYOUT_2_0;
+  format.m_periodTime = periodTime;
+  return format;
+}
+
+std::unique_ptr<IAESink> Open(const CAESinkNULL::Options& options, AEAudioFormat& format)
+{
+  CAESinkNULL::SetOptions(options);
+  CAESinkNULL::ResetStats();
+  std::string device = "default";
+  return std::unique_ptr<IAESink>(CAESinkNULL::Create(device, format));
+}
+
+//! add whole periods of a ramp, returns the seconds it took
+double Play(IAESink& sink, const AEAudioFormat& format, unsigned int periods)
+{
+  std::vector<float> samples(format.m_frames * CHANNELS);
+  auto start = std::chrono::steady_clock::now();
+  unsigned int frame = 0;
+  for (unsigned int period = 0; period < periods; period++)
+  {
+    for (unsigned int i = 0; i < format.m_frames; i++, frame++)
+      samples[i * CHANNELS] = samples[i * CHANNELS + 1] = static_cast<float>(frame);
+
+    uint8_t* data = reinterpret_cast<uint8_t*>(samples.data());
+    unsigned int offset = 0;
+    while (offset < format.m_frames)
+      offset += sink.AddPackets(&data, format.m_frames - offset, offset);
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+TEST(TestAESinkNULL, Enumerate)
+{
+  AEDeviceInfoList list;
+  CAESinkNULL::EnumerateDevicesEx(list);
+  ASSERT_EQ(1u, list.size());
+  EXPECT_EQ("default", list[0].m_deviceName);
+
+  CAESinkNULL::Register();
+  std::string device = "NULL:default";
+  AEAudioFormat format = MakeFormat();
+  std::unique_ptr<IAESink> sink(AE::CAESinkFactory::Create(device, format));
+  ASSERT_NE(nullptr, sink);
+  EXPECT_STREQ("NULL", sink->GetName());
+}
+
+TEST(TestAESinkNULL, Format)
+{
+  AEAudioFormat format = MakeFormat();
+  format.m_dataFormat = AE_FMT_S24NE4MSB;
+  std::unique_ptr<IAESink> sink = Open(CAESinkNULL::Options(), format);
+  ASSERT_NE(nullptr, sink);
+
+  EXPECT_EQ(AE_FMT_FLOAT, format.m_dataFormat);
+  EXPECT_EQ(CHANNELS * sizeof(float), format.m_frameSize);
+  EXPECT_EQ(SAMPLE_RATE / 100, format.m_frames);
+  EXPECT_EQ(1u, CAESinkNULL::GetStats().initializations);
+}
+
+// one buffer is taken at once, the rest at the pace of the output
+TEST(TestAESinkNULL, RealTime)
+{
+  CAESinkNULL::Options options;
+  options.periods = 4;
+  AEAudioFormat format = MakeFormat(10);
+  std::unique_ptr<IAESink> sink = Open(options, format);
+  ASSERT_NE(nullptr, sink);
+
+  double seconds = Play(*sink, format, 24);
+  EXPECT_GT(seconds, 0.18);
+  EXPECT_LT(seconds, 0.5);
+
+  AEDelayStatus status;
+  sink->GetDelay(status);
+  EXPECT_GT(status.GetDelay(), 0.0);
+  EXPECT_LE(status.GetDelay(), sink->GetCacheTotal() + 0.001);
+
+  CAESinkNULL::Stats stats = CAESinkNULL::GetStats();
+  EXPECT_EQ(24u * format.m_frames, stats.frames);
+  EXPECT_GT(stats.blockedTime, 0.1);
+  EXPECT_EQ(0u, stats.underruns);
+}
+
+TEST(TestAESinkNULL, FasterThanRealTime)
+{
+  CAESinkNULL::Options options;
+  options.speed = 0.0;
+  AEAudioFormat format = MakeFormat(10);
+  std::unique_ptr<IAESink> sink = Open(options, format);
+  ASSERT_NE(nullptr, sink);
+
+  // ten seconds of audio
+  EXPECT_LT(Play(*sink, format, 1000), 1.0);
+  EXPECT_EQ(1000u * format.m_frames, CAESinkNULL::GetStats().frames);
+}
+
+TEST(TestAESinkNULL, Underrun)
+{
+  AEAudioFormat format = MakeFormat(10);
+  std::unique_ptr<IAESink> sink = Open(CAESinkNULL::Options(), format);
+  ASSERT_NE(nullptr, sink);
+
+  Play(*sink, format, 2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  Play(*sink, format, 1);
+  EXPECT_EQ(1u, CAESinkNULL::GetStats().underruns);
+}
+
+TEST(TestAESinkNULL, Capture)
+{
+  CAESinkNULL::Options options;
+  options.speed = 0.0;
+  options.capture = true;
+  AEAudioFormat format = MakeFormat(10);
+  std::unique_ptr<IAESink> sink = Open(options, format);
+  ASSERT_NE(nullptr, sink);
+
+  Play(*sink, format, 3);
+
+  CAESinkNULL::Stats stats = CAESinkNULL::GetStats();
+  ASSERT_EQ(3u * format.m_frames * format.m_frameSize, stats.audio.size());
+  const float* samples = reinterpret_cast<const float*>(stats.audio.data());
+  for (unsigned int i = 0; i < 3 * format.m_frames; i++)
+  {
+    ASSERT_EQ(static_cast<float>(i), samples[i * CHANNELS]);
+    ASSERT_EQ(static_cast<float>(i), samples[i * CHANNELS + 1]);
+  }
+
+  ASSERT_EQ(3u, stats.deliveries.size());
+  for (const auto& delivery : stats.deliveries)
+    EXPECT_EQ(format.m_frames, delivery.frames);
+  EXPECT_LE(stats.deliveries[0].time, stats.deliveries[2].time);
+}
+
+TEST(TestAESinkNULL, WavFile)
+{
+  XFILE::CFile* file = XBMC_CREATETEMPFILE(".wav");
+  ASSERT_NE(nullptr, file);
+  std::string path = XBMC_TEMPFILEPATH(file);
+  file->Close();
+
+  CAESinkNULL::Options options;
+  options.speed = 0.0;
+  options.wavFile = path;
+  AEAudioFormat format = MakeFormat(10);
+  std::unique_ptr<IAESink> sink = Open(options, format);
+  ASSERT_NE(nullptr, sink);
+  Play(*sink, format, 2);
+  sink->Deinitialize();
+
+  const size_t dataSize = 2 * format.m_frames * format.m_frameSize;
+  XFILE::CFile in;
+  ASSERT_TRUE(in.Open(path));
+  std::vector<uint8_t> wav(static_cast<size_t>(in.GetLength()));
+  ASSERT_EQ(44 + dataSize, wav.size());
+  ASSERT_EQ(static_cast<ssize_t>(wav.size()), in.Read(wav.data(), wav.size()));
+  in.Close();
+
+  EXPECT_EQ(0, memcmp(wav.data(), "RIFF", 4));
+  EXPECT_EQ(0, memcmp(wav.data() + 8, "WAVEfmt ", 8));
+  EXPECT_EQ(3, wav[20]); // IEEE float
+  EXPECT_EQ(CHANNELS, wav[22]);
+  EXPECT_EQ(0, memcmp(wav.data() + 36, "data", 4));
+
+  float last;
+  memcpy(&last, wav.data() + wav.size() - sizeof(float), sizeof(float));
+  EXPECT_EQ(static_cast<float>(2 * format.m_frames - 1), last);
+
+  XBMC_DELETETEMPFILE(file);
+}
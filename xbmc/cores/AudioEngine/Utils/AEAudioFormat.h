@@ -48,12 +48,19 @@ struct AEAudioFormat
    */
   CAEStreamInfo m_streamInfo;
 
+  /**
+   * The period time in ms a sink is asked for, 0 for the sink's default.
+   * Only a request, sinks report what they got in m_frames.
+   */
+  unsigned int m_periodTime;
+
   AEAudioFormat()
   {
     m_dataFormat = AE_FMT_INVALID;
     m_sampleRate = 0;
     m_frames = 0;
     m_frameSize = 0;
+    m_periodTime = 0;
   }
 
   bool operator==(const AEAudioFormat& fmt) const
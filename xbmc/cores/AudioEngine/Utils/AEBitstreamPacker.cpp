@@ -21,12 +21,37 @@
 #define MAT_MIDDLE_CODE_OFFSET -4
 #define MAT_FRAME_SIZE          61424
 #define EAC3_MAX_BURST_PAYLOAD_SIZE (24576 - BURST_HEADER_SIZE)
+#define DTSHD_MAX_SIZE          (MAX_IEC61937_PACKET - BURST_HEADER_SIZE)
 
-CAEBitstreamPacker::CAEBitstreamPacker() :
-  m_trueHD   (NULL),
-  m_dtsHD    (NULL),
-  m_eac3     (NULL)
+namespace
 {
+/* magic MAT format values, meaning is unknown at this point */
+const uint8_t mat_start_code [20] = { 0x07, 0x9E, 0x00, 0x03, 0x84, 0x01, 0x01, 0x01, 0x80, 0x00, 0x56, 0xA5, 0x3B, 0xF4, 0x81, 0x83, 0x49, 0x80, 0x77, 0xE0 };
+const uint8_t mat_middle_code[12] = { 0xC3, 0xC1, 0x42, 0x49, 0x3B, 0xFA, 0x82, 0x83, 0x49, 0x80, 0x77, 0xE0 };
+const uint8_t mat_end_code   [16] = { 0xC3, 0xC2, 0xC0, 0xC4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x97, 0x11 };
+
+const uint8_t dtshd_start_code[10] = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xfe };
+
+/* where a TrueHD unit goes in the MAT frame */
+size_t MATUnitOffset(unsigned int pos)
+{
+  if (pos == 0)
+    return sizeof(mat_start_code);
+  else if (pos == 12)
+    return (pos * TRUEHD_FRAME_OFFSET) + sizeof(mat_middle_code) - BURST_HEADER_SIZE + MAT_MIDDLE_CODE_OFFSET;
+  else
+    return (pos * TRUEHD_FRAME_OFFSET) - BURST_HEADER_SIZE;
+}
+}
+
+CAEBitstreamPacker::CAEBitstreamPacker()
+{
+  /* allocate for the largest frames up front, the pack functions run for every packet */
+  m_trueHD    = new uint8_t[MAT_FRAME_SIZE]();
+  m_dtsHDSize = DTSHD_MAX_SIZE;
+  m_dtsHD     = new uint8_t[m_dtsHDSize];
+  memcpy(m_dtsHD, dtshd_start_code, sizeof(dtshd_start_code));
+  m_eac3      = new uint8_t[EAC3_MAX_BURST_PAYLOAD_SIZE];
   Reset();
 }
 
@@ -135,39 +160,24 @@ void CAEBitstreamPacker::Reset()
 /* we need to pack 24 TrueHD audio units into the unknown MAT format before packing into IEC61937 */
 void CAEBitstreamPacker::PackTrueHD(CAEStreamInfo &info, uint8_t* data, int size)
 {
-  /* magic MAT format values, meaning is unknown at this point */
-  static const uint8_t mat_start_code [20] = { 0x07, 0x9E, 0x00, 0x03, 0x84, 0x01, 0x01, 0x01, 0x80, 0x00, 0x56, 0xA5, 0x3B, 0xF4, 0x81, 0x83, 0x49, 0x80, 0x77, 0xE0 };
-  static const uint8_t mat_middle_code[12] = { 0xC3, 0xC1, 0x42, 0x49, 0x3B, 0xFA, 0x82, 0x83, 0x49, 0x80, 0x77, 0xE0 };
-  static const uint8_t mat_end_code   [16] = { 0xC3, 0xC2, 0xC0, 0xC4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x97, 0x11 };
-
-  /* create the buffer if it doesnt already exist */
-  if (!m_trueHD)
-  {
-    m_trueHD    = new uint8_t[MAT_FRAME_SIZE];
-    m_trueHDPos = 0;
-  }
-
-  /* setup the frame for the data */
+  /* setup the frame for the data, everything but the units of the last frame is still zero */
   if (m_trueHDPos == 0)
   {
-    memset(m_trueHD, 0, MAT_FRAME_SIZE);
+    for (unsigned int i = 0; i < TRUEHD_UNITS; ++i)
+    {
+      memset(m_trueHD + MATUnitOffset(i), 0, m_trueHDUnitSize[i]);
+      m_trueHDUnitSize[i] = 0;
+    }
     memcpy(m_trueHD, mat_start_code, sizeof(mat_start_code));
     memcpy(m_trueHD + (12 * TRUEHD_FRAME_OFFSET) - BURST_HEADER_SIZE + MAT_MIDDLE_CODE_OFFSET, mat_middle_code, sizeof(mat_middle_code));
     memcpy(m_trueHD + MAT_FRAME_SIZE - sizeof(mat_end_code), mat_end_code, sizeof(mat_end_code));
   }
 
-  size_t offset;
-  if (m_trueHDPos == 0 )
-    offset = (m_trueHDPos * TRUEHD_FRAME_OFFSET) + sizeof(mat_start_code);
-  else if (m_trueHDPos == 12)
-    offset = (m_trueHDPos * TRUEHD_FRAME_OFFSET) + sizeof(mat_middle_code) - BURST_HEADER_SIZE + MAT_MIDDLE_CODE_OFFSET;
-  else
-    offset = (m_trueHDPos * TRUEHD_FRAME_OFFSET) - BURST_HEADER_SIZE;
-
-  memcpy(m_trueHD + offset, data, size);
+  memcpy(m_trueHD + MATUnitOffset(m_trueHDPos), data, size);
+  m_trueHDUnitSize[m_trueHDPos] = size;
 
   /* if we have a full frame */
-  if (++m_trueHDPos == 24)
+  if (++m_trueHDPos == TRUEHD_UNITS)
   {
     m_trueHDPos = 0;
     m_dataSize  = CAEPackIEC61937::PackTrueHD(m_trueHD, MAT_FRAME_SIZE, m_packedBuffer);
@@ -176,7 +186,6 @@ void CAEBitstreamPacker::PackTrueHD(CAEStreamInfo &info, uint8_t* data, int size
 
 void CAEBitstreamPacker::PackDTSHD(CAEStreamInfo &info, uint8_t* data, int size)
 {
-  static const uint8_t dtshd_start_code[10] = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xfe };
   unsigned int dataSize = sizeof(dtshd_start_code) + 2 + size;
 
   if (dataSize > m_dtsHDSize)
@@ -214,9 +223,6 @@ void CAEBitstreamPacker::PackEAC3(CAEStreamInfo &info, uint8_t* data, int size)
   {
     /* multiple frames needed to achieve 6 blocks as required by IEC 61937-3:2007 */
 
-    if (m_eac3 == NULL)
-      m_eac3 = new uint8_t[EAC3_MAX_BURST_PAYLOAD_SIZE];
-
     unsigned int newsize = m_eac3Size + size;
     bool overrun = newsize > EAC3_MAX_BURST_PAYLOAD_SIZE;
 
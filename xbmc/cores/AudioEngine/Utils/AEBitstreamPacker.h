@@ -35,9 +35,14 @@ private:
   void PackDTSHD(CAEStreamInfo &info, uint8_t* data, int size);
   void PackEAC3(CAEStreamInfo &info, uint8_t* data, int size);
 
+  /* number of TrueHD access units packed into one MAT frame */
+  static constexpr unsigned int TRUEHD_UNITS = 24;
+
   /* we keep the trueHD and dtsHD buffers separate so that we can handle a fast stream switch */
   uint8_t      *m_trueHD;
   unsigned int  m_trueHDPos = 0;
+  /* bytes written per unit into the MAT frame, these are cleared for the next frame */
+  unsigned int  m_trueHDUnitSize[TRUEHD_UNITS] = {};
 
   uint8_t      *m_dtsHD;
   unsigned int  m_dtsHDSize = 0;
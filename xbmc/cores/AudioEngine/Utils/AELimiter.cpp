@@ -8,6 +8,7 @@
 
 #include "AELimiter.h"
 
+#include "AEMixKernels.h"
 #include "ServiceBroker.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
@@ -23,53 +24,139 @@ CAELimiter::CAELimiter()
   m_samplerate = 48000.0f;
   m_holdcounter = 0;
   m_increase = 0.0f;
+  m_lookahead = 96;
 }
 
-float CAELimiter::Run(float* frame[AE_CH_MAX], int channels, int offset /*= 0*/, bool planar /*= false*/)
+void CAELimiter::Process(float* data[AE_CH_MAX], int channels, int frames, bool planar /*= false*/)
 {
+  if (frames <= 0 || channels <= 0)
+    return;
+
+  const CAEMixKernels& kernels = CAEMixKernels::Get();
+  const int planes = planar ? channels : 1;
+  const uint32_t count = planar ? frames : frames * channels;
+
   float highest = 0.0f;
-  if (!planar)
+  for (int i = 0; i < planes; i++)
+    highest = std::max(highest, kernels.MaxAbsArray(data[i], count));
+
+  // not limiting and no peak in this buffer, amplify as a whole
+  if (m_attenuation >= 1.0f && highest * m_amplify <= 1.0f)
   {
-    for(int i=0; i<channels; i++)
+    if (m_amplify != 1.0f)
     {
-      highest = std::max(highest, fabsf(*(frame[0]+offset+i)));
+      for (int i = 0; i < planes; i++)
+        kernels.MulArray(data[i], m_amplify, count);
     }
+    return;
+  }
+
+  m_peaks.assign(frames, 0.0f);
+  if (planar)
+  {
+    for (int i = 0; i < planes; i++)
+      kernels.PeakArray(m_peaks.data(), data[i], frames);
   }
   else
   {
-    for(int i=0; i<channels; i++)
+    // too few samples per frame for the kernels to pay off
+    const float* frame = data[0];
+    for (int i = 0; i < frames; i++, frame += channels)
     {
-      highest = std::max(highest, fabsf(*(frame[i]+offset)));
+      float highest = 0.0f;
+      for (int j = 0; j < channels; j++)
+        highest = std::max(highest, fabsf(frame[j]));
+      m_peaks[i] = highest;
     }
   }
 
-  float sample = highest * m_amplify;
-  if (sample * m_attenuation > 1.0f)
+  // gain each frame needs to stay at full scale
+  m_gains.resize(frames);
+  for (int i = 0; i < frames; i++)
   {
-    m_attenuation = 1.0f / sample;
-    m_holdcounter = MathUtils::round_int(m_samplerate * CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_limiterHold);
-    m_increase = powf(std::min(sample, 10000.0f), 1.0f / (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_limiterRelease * m_samplerate));
+    float sample = m_peaks[i] * m_amplify;
+    m_gains[i] = sample > 1.0f ? 1.0f / sample : 1.0f;
   }
 
-  float attenuation = m_attenuation;
+  // lookahead, lowest gain needed within the next m_lookahead frames
+  m_minima.resize(frames);
+  m_window.resize(frames);
+  int head = 0;
+  int tail = 0;
+  for (int i = frames - 1; i >= 0; i--)
+  {
+    while (tail > head && m_gains[m_window[tail - 1]] >= m_gains[i])
+      tail--;
+    m_window[tail++] = i;
+    if (m_window[head] > i + m_lookahead)
+      head++;
+    m_minima[i] = m_gains[m_window[head]];
+  }
 
-  if (m_holdcounter > 0)
+  // the mean of the minima of all windows containing a frame ramps down
+  // ahead of a peak and is never above the gain the peak needs
+  const int length = m_lookahead + 1;
+  double sum = 0.0;
+  for (int i = 0; i < frames; i++)
   {
-    m_holdcounter--;
+    sum += m_minima[i];
+    if (i >= length)
+      sum -= m_minima[i - length];
+    m_gains[i] = static_cast<float>(sum / std::min(i + 1, length));
   }
-  else
+
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  const int hold = MathUtils::round_int(m_samplerate * advancedSettings->m_limiterHold);
+  const float release = 1.0f / (advancedSettings->m_limiterRelease * m_samplerate);
+
+  for (int i = 0; i < frames; i++)
   {
-    if (m_increase > 0.0f)
+    float sample = m_peaks[i] * m_amplify;
+    if (sample * m_attenuation > 1.0f)
+    {
+      m_attenuation = 1.0f / sample;
+      m_holdcounter = hold;
+      m_increase = powf(std::min(sample, 10000.0f), release);
+    }
+
+    float attenuation = std::min(m_attenuation, m_gains[i]);
+
+    if (m_holdcounter > 0)
+    {
+      m_holdcounter--;
+    }
+    else
     {
-      m_attenuation *= m_increase;
-      if (m_attenuation > 1.0f)
+      if (m_increase > 0.0f)
       {
-        m_increase = 0.0f;
-        m_attenuation = 1.0f;
+        m_attenuation *= m_increase;
+        if (m_attenuation > 1.0f)
+        {
+          m_increase = 0.0f;
+          m_attenuation = 1.0f;
+        }
       }
     }
+
+    m_gains[i] = attenuation * m_amplify;
   }
 
-  return attenuation * m_amplify;
+  if (planar)
+  {
+    for (int i = 0; i < planes; i++)
+    {
+      float* plane = data[i];
+      for (int j = 0; j < frames; j++)
+        plane[j] *= m_gains[j];
+    }
+  }
+  else
+  {
+    float* frame = data[0];
+    for (int i = 0; i < frames; i++, frame += channels)
+    {
+      for (int j = 0; j < channels; j++)
+        frame[j] *= m_gains[i];
+    }
+  }
 }
-
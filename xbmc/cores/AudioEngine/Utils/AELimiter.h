@@ -11,7 +11,17 @@
 #include "AEAudioFormat.h"
 
 #include <algorithm>
+#include <vector>
 
+/*!
+ * \brief Amplifies a stream and keeps it below full scale
+ *
+ * Works on whole buffers. The gain is lowered ahead of a peak within a short
+ * lookahead window, so it ramps down instead of stepping down at the peak.
+ * The window does not reach into the next buffer, peaks at the start of a
+ * buffer are attenuated instantly. After a peak the gain is held, then
+ * released, see advancedsettings limiterhold and limiterrelease.
+ */
 class CAELimiter
 {
   private:
@@ -20,6 +30,12 @@ class CAELimiter
     float m_samplerate;
     int   m_holdcounter;
     float m_increase;
+    int   m_lookahead;
+
+    std::vector<float> m_peaks;  //!< peak of each frame over all channels
+    std::vector<float> m_gains;  //!< gain of each frame
+    std::vector<float> m_minima; //!< lowest gain needed within the lookahead of a frame
+    std::vector<int>   m_window; //!< frames of the sliding minimum
 
   public:
     CAELimiter();
@@ -37,7 +53,15 @@ class CAELimiter
     void SetSamplerate(int samplerate)
     {
       m_samplerate = (float)samplerate;
+      m_lookahead = samplerate / 500; // 2ms
     }
 
-    float Run(float* frame[AE_CH_MAX], int channels, int offset = 0, bool planar = false);
+    /*!
+     * \brief Amplify and limit a buffer in place
+     * \param data the planes of the buffer, a single one if not planar
+     * \param channels number of channels
+     * \param frames number of frames
+     * \param planar true if there is one plane per channel
+     */
+    void Process(float* data[AE_CH_MAX], int channels, int frames, bool planar = false);
 };
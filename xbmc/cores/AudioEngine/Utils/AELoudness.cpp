@@ -0,0 +1,235 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AELoudness.h"
+
+#include "AEMixKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+const unsigned int CHUNK_FRAMES = 1024;
+const unsigned int TAPS_PER_PHASE = 12;
+
+const double ABSOLUTE_GATE = -70.0; // LUFS
+const double RELATIVE_GATE = -10.0; // LU
+}
+
+CAELoudnessMeter::CAELoudnessMeter(unsigned int sampleRate, const CAEChannelInfo& layout)
+  : m_kernels(CAEMixKernels::Get())
+{
+  m_channels = layout.Count();
+
+  // BS.1770 channel weights, surrounds count +1.5 dB and the LFE is ignored
+  for (unsigned int i = 0; i < m_channels; i++)
+  {
+    switch (layout[i])
+    {
+      case AE_CH_LFE:
+        m_weights.push_back(0.0);
+        break;
+      case AE_CH_BL:
+      case AE_CH_BR:
+      case AE_CH_SL:
+      case AE_CH_SR:
+        m_weights.push_back(1.41);
+        break;
+      default:
+        m_weights.push_back(1.0);
+        break;
+    }
+  }
+
+  // K-weighting, a high shelf for the head followed by a high pass, designed
+  // for the sample rate so they match the 48 kHz coefficients of BS.1770
+  const double rate = static_cast<double>(sampleRate);
+  double f0 = 1681.974450955533;
+  double gain = 3.999843853973347;
+  double q = 0.7071752369554196;
+  double k = tan(M_PI * f0 / rate);
+  double vh = pow(10.0, gain / 20.0);
+  double vb = pow(vh, 0.4996667741545416);
+  double a0 = 1.0 + k / q + k * k;
+  m_shelf.b0 = (vh + vb * k / q + k * k) / a0;
+  m_shelf.b1 = 2.0 * (k * k - vh) / a0;
+  m_shelf.b2 = (vh - vb * k / q + k * k) / a0;
+  m_shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+  m_shelf.a2 = (1.0 - k / q + k * k) / a0;
+
+  f0 = 38.13547087602444;
+  q = 0.5003270373238773;
+  k = tan(M_PI * f0 / rate);
+  a0 = 1.0 + k / q + k * k;
+  m_highpass.b0 = 1.0;
+  m_highpass.b1 = -2.0;
+  m_highpass.b2 = 1.0;
+  m_highpass.a1 = 2.0 * (k * k - 1.0) / a0;
+  m_highpass.a2 = (1.0 - k / q + k * k) / a0;
+
+  m_state.assign(4 * m_channels, 0.0);
+
+  m_subBlockFrames = std::max(sampleRate / 10, 1u);
+  m_subBlocks.assign(4, 0.0);
+
+  // polyphase interpolator, a Hann windowed sinc
+  if (sampleRate < 96000)
+    m_oversample = 4;
+  else if (sampleRate < 192000)
+    m_oversample = 2;
+  else
+    m_oversample = 1;
+
+  m_taps = m_oversample > 1 ? TAPS_PER_PHASE : 1;
+  const unsigned int length = m_taps * m_oversample;
+  m_coefs.resize(length);
+  for (unsigned int n = 0; n < length; n++)
+  {
+    double m = (n - (length - 1) / 2.0) / m_oversample;
+    double sinc = m == 0.0 ? 1.0 : sin(M_PI * m) / (M_PI * m);
+    double window = 0.5 * (1.0 - cos(2.0 * M_PI * (n + 1) / (length + 1)));
+    unsigned int phase = n % m_oversample;
+    unsigned int tap = n / m_oversample;
+    m_coefs[phase * m_taps + tap] = static_cast<float>(sinc * window);
+  }
+
+  m_planes.assign(m_channels, std::vector<float>(m_taps - 1 + CHUNK_FRAMES, 0.0f));
+  m_interpolated.resize(CHUNK_FRAMES);
+}
+
+void CAELoudnessMeter::AddFrames(const float* data, unsigned int frames)
+{
+  while (frames)
+  {
+    unsigned int count = std::min(frames, CHUNK_FRAMES);
+    ProcessChunk(data, count);
+    data += count * m_channels;
+    frames -= count;
+  }
+}
+
+void CAELoudnessMeter::ProcessChunk(const float* data, unsigned int frames)
+{
+  float* planes[AE_CH_MAX];
+  for (unsigned int c = 0; c < m_channels; c++)
+    planes[c] = m_planes[c].data() + m_taps - 1;
+  m_kernels.Deinterleave(planes, data, m_channels, frames);
+
+  unsigned int pos = 0;
+  while (pos < frames)
+  {
+    unsigned int count = std::min(frames - pos, m_subBlockFrames - m_subBlockPos);
+    for (unsigned int c = 0; c < m_channels; c++)
+    {
+      if (m_weights[c] == 0.0)
+        continue;
+
+      // transposed direct form II, both filters in a row
+      double* state = &m_state[4 * c];
+      const float* in = planes[c] + pos;
+      double sum = 0.0;
+      for (unsigned int i = 0; i < count; i++)
+      {
+        double x = in[i];
+        double y = m_shelf.b0 * x + state[0];
+        state[0] = m_shelf.b1 * x - m_shelf.a1 * y + state[1];
+        state[1] = m_shelf.b2 * x - m_shelf.a2 * y;
+
+        double z = m_highpass.b0 * y + state[2];
+        state[2] = m_highpass.b1 * y - m_highpass.a1 * z + state[3];
+        state[3] = m_highpass.b2 * y - m_highpass.a2 * z;
+
+        sum += z * z;
+      }
+      m_subBlockSum += m_weights[c] * sum;
+    }
+
+    pos += count;
+    m_subBlockPos += count;
+    if (m_subBlockPos == m_subBlockFrames)
+    {
+      m_subBlocks[m_subBlockCount % 4] = m_subBlockSum;
+      m_subBlockCount++;
+      m_subBlockPos = 0;
+      m_subBlockSum = 0.0;
+
+      // a gating block spans the last 4 sub blocks
+      if (m_subBlockCount >= 4)
+      {
+        double sum = m_subBlocks[0] + m_subBlocks[1] + m_subBlocks[2] + m_subBlocks[3];
+        m_blocks.push_back(sum / (4.0 * m_subBlockFrames));
+      }
+    }
+  }
+
+  for (unsigned int c = 0; c < m_channels; c++)
+    MeasurePeak(c, frames);
+}
+
+void CAELoudnessMeter::MeasurePeak(unsigned int channel, unsigned int frames)
+{
+  float* plane = m_planes[channel].data();
+  const float* samples = plane + m_taps - 1;
+
+  m_truePeak = std::max(m_truePeak, m_kernels.MaxAbsArray(samples, frames));
+
+  if (m_oversample > 1)
+  {
+    // every phase is a short FIR over the history and the chunk
+    float* out = m_interpolated.data();
+    for (unsigned int phase = 0; phase < m_oversample; phase++)
+    {
+      const float* coefs = &m_coefs[phase * m_taps];
+      memset(out, 0, frames * sizeof(float));
+      for (unsigned int tap = 0; tap < m_taps; tap++)
+        m_kernels.MulAddArray(out, samples - tap, coefs[tap], frames);
+      m_truePeak = std::max(m_truePeak, m_kernels.MaxAbsArray(out, frames));
+    }
+  }
+
+  // keep the end of the chunk as history for the next one
+  memmove(plane, plane + frames, (m_taps - 1) * sizeof(float));
+}
+
+double CAELoudnessMeter::GetIntegratedLoudness(const std::vector<double>& blocks)
+{
+  const double absoluteGate = pow(10.0, (ABSOLUTE_GATE + 0.691) / 10.0);
+
+  double sum = 0.0;
+  size_t count = 0;
+  for (double block : blocks)
+  {
+    if (block > absoluteGate)
+    {
+      sum += block;
+      count++;
+    }
+  }
+  if (!count)
+    return -std::numeric_limits<double>::infinity();
+
+  const double relativeGate = std::max(sum / count * pow(10.0, RELATIVE_GATE / 10.0), absoluteGate);
+
+  sum = 0.0;
+  count = 0;
+  for (double block : blocks)
+  {
+    if (block > relativeGate)
+    {
+      sum += block;
+      count++;
+    }
+  }
+  if (!count)
+    return -std::numeric_limits<double>::infinity();
+
+  return -0.691 + 10.0 * log10(sum / count);
+}
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "AEChannelInfo.h"
+
+#include <vector>
+
+struct CAEMixKernels;
+
+/*!
+ * \brief Measures integrated loudness and true peak as of EBU R128 / ITU-R BS.1770
+ *
+ * Audio is K-weighted and split into gating blocks of 400 ms overlapping by
+ * 75%, blocks are gated at -70 LUFS and 10 LU below the ungated loudness.
+ * True peak is taken from a 4x oversampled signal (2x from 96 kHz on).
+ */
+class CAELoudnessMeter
+{
+public:
+  CAELoudnessMeter(unsigned int sampleRate, const CAEChannelInfo& layout);
+
+  /*!
+   * \brief Measure interleaved float audio
+   * \param data frames * channels samples
+   * \param frames number of frames
+   */
+  void AddFrames(const float* data, unsigned int frames);
+
+  /*!
+   * \brief Integrated loudness in LUFS, -infinity if everything was gated
+   */
+  double GetIntegratedLoudness() const { return GetIntegratedLoudness(m_blocks); }
+
+  /*!
+   * \brief Highest absolute value of the reconstructed signal, 1.0 is full scale
+   */
+  float GetTruePeak() const { return m_truePeak; }
+
+  /*!
+   * \brief Mean square of each complete gating block, channel weights applied
+   */
+  const std::vector<double>& GetBlocks() const { return m_blocks; }
+
+  /*!
+   * \brief Integrated loudness of the gating blocks of one or more measurements,
+   * e.g. the tracks of an album
+   */
+  static double GetIntegratedLoudness(const std::vector<double>& blocks);
+
+private:
+  struct Biquad
+  {
+    double b0, b1, b2, a1, a2;
+  };
+
+  void ProcessChunk(const float* data, unsigned int frames);
+  void MeasurePeak(unsigned int channel, unsigned int frames);
+
+  unsigned int m_channels;
+  std::vector<double> m_weights;
+  Biquad m_shelf;
+  Biquad m_highpass;
+  std::vector<double> m_state; //!< 2 per filter, 4 per channel
+
+  unsigned int m_subBlockFrames;
+  unsigned int m_subBlockPos = 0;
+  double m_subBlockSum = 0.0;
+  std::vector<double> m_subBlocks; //!< the last 4 sub blocks of 100 ms
+  unsigned int m_subBlockCount = 0;
+  std::vector<double> m_blocks;
+
+  const CAEMixKernels& m_kernels;
+  unsigned int m_oversample;
+  unsigned int m_taps; //!< per phase
+  std::vector<float> m_coefs; //!< m_taps per phase
+  std::vector<std::vector<float>> m_planes; //!< history of m_taps - 1 samples followed by the chunk
+  std::vector<float> m_interpolated;
+  float m_truePeak = 0.0f;
+};
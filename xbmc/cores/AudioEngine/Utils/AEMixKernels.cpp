@@ -0,0 +1,717 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEMixKernels.h"
+
+#include "ServiceBroker.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AE_MIX_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define AE_MIX_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define AE_MIX_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(AE_MIX_AVX2) && defined(__GNUC__)
+// compiled for avx2 regardless of the compiler flags, only called if the cpu supports it.
+// the functions clear the upper halves of the registers before falling back to the
+// sse2 ones for the tail, mixing dirty avx state and sse code is slow.
+#define AE_MIX_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define AE_MIX_TARGET_AVX2
+#endif
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// scalar
+//-----------------------------------------------------------------------------
+
+/*
+   This is a rational function to approximate a tanh-like soft clipper.
+   It is based on the pade-approximation of the tanh function with tweaked coefficients.
+   See: http://www.musicdsp.org/showone.php?id=238
+*/
+inline float SoftClip(float x)
+{
+  if (x < -3.0f)
+    return -1.0f;
+  else if (x > 3.0f)
+    return 1.0f;
+  float y = x * x;
+  return x * (27.0f + y) / (27.0f + 9.0f * y);
+}
+
+void MulArrayScalar(float* data, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] *= mul;
+}
+
+void MulAddArrayScalar(float* data, const float* add, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] += add[i] * mul;
+}
+
+void ClampArrayScalar(float* data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] = std::min(std::max(data[i], -1.0f), 1.0f);
+}
+
+void SoftClipArrayScalar(float* data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] = SoftClip(data[i]);
+}
+
+bool NeedsClampScalar(const float* data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+  {
+    if (std::fabs(data[i]) > 1.0f)
+      return true;
+  }
+  return false;
+}
+
+float MaxAbsArrayScalar(const float* data, uint32_t count)
+{
+  float highest = 0.0f;
+  for (uint32_t i = 0; i < count; i++)
+    highest = std::max(highest, std::fabs(data[i]));
+  return highest;
+}
+
+void PeakArrayScalar(float* peak, const float* data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    peak[i] = std::max(peak[i], std::fabs(data[i]));
+}
+
+void InterleaveScalar(float* dst, const float* const* src, unsigned int channels, uint32_t frames)
+{
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    for (unsigned int j = 0; j < channels; j++)
+      *dst++ = src[j][i];
+  }
+}
+
+void DeinterleaveScalar(float* const* dst, const float* src, unsigned int channels, uint32_t frames)
+{
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    for (unsigned int j = 0; j < channels; j++)
+      dst[j][i] = *src++;
+  }
+}
+
+void SwapEndian16Scalar(uint16_t* dst, const uint16_t* src, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    dst[i] = static_cast<uint16_t>((src[i] >> 8) | (src[i] << 8));
+}
+
+const CAEMixKernels scalarKernels =
+{
+  "scalar",
+  MulArrayScalar,
+  MulAddArrayScalar,
+  ClampArrayScalar,
+  SoftClipArrayScalar,
+  NeedsClampScalar,
+  MaxAbsArrayScalar,
+  PeakArrayScalar,
+  InterleaveScalar,
+  DeinterleaveScalar,
+  SwapEndian16Scalar
+};
+
+//-----------------------------------------------------------------------------
+// SSE2
+//-----------------------------------------------------------------------------
+
+#if defined(AE_MIX_SSE2)
+void MulArraySSE2(float* data, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+  MulArrayScalar(data + i, mul, count - i);
+}
+
+void MulAddArraySSE2(float* data, const float* add, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 ad = _mm_mul_ps(_mm_loadu_ps(add + i), m);
+    _mm_storeu_ps(data + i, _mm_add_ps(_mm_loadu_ps(data + i), ad));
+  }
+  MulAddArrayScalar(data + i, add + i, mul, count - i);
+}
+
+void ClampArraySSE2(float* data, uint32_t count)
+{
+  const __m128 lo = _mm_set1_ps(-1.0f);
+  const __m128 hi = _mm_set1_ps(1.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), lo), hi));
+  ClampArrayScalar(data + i, count - i);
+}
+
+void SoftClipArraySSE2(float* data, uint32_t count)
+{
+  const __m128 lo = _mm_set1_ps(-3.0f);
+  const __m128 hi = _mm_set1_ps(3.0f);
+  const __m128 c27 = _mm_set1_ps(27.0f);
+  const __m128 c9 = _mm_set1_ps(9.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    // the curve reaches +-1 at +-3, clamping the input matches the scalar version
+    __m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), lo), hi);
+    __m128 y = _mm_mul_ps(x, x);
+    __m128 num = _mm_mul_ps(x, _mm_add_ps(c27, y));
+    __m128 den = _mm_add_ps(c27, _mm_mul_ps(c9, y));
+    _mm_storeu_ps(data + i, _mm_div_ps(num, den));
+  }
+  SoftClipArrayScalar(data + i, count - i);
+}
+
+bool NeedsClampSSE2(const float* data, uint32_t count)
+{
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  const __m128 one = _mm_set1_ps(1.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 x = _mm_and_ps(_mm_loadu_ps(data + i), absMask);
+    if (_mm_movemask_ps(_mm_cmpgt_ps(x, one)))
+      return true;
+  }
+  return NeedsClampScalar(data + i, count - i);
+}
+
+float MaxAbsArraySSE2(const float* data, uint32_t count)
+{
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  __m128 highest = _mm_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    highest = _mm_max_ps(highest, _mm_and_ps(_mm_loadu_ps(data + i), absMask));
+  highest = _mm_max_ps(highest, _mm_movehl_ps(highest, highest));
+  highest = _mm_max_ss(highest, _mm_shuffle_ps(highest, highest, _MM_SHUFFLE(1, 1, 1, 1)));
+  return std::max(_mm_cvtss_f32(highest), MaxAbsArrayScalar(data + i, count - i));
+}
+
+void PeakArraySSE2(float* peak, const float* data, uint32_t count)
+{
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 x = _mm_and_ps(_mm_loadu_ps(data + i), absMask);
+    _mm_storeu_ps(peak + i, _mm_max_ps(_mm_loadu_ps(peak + i), x));
+  }
+  PeakArrayScalar(peak + i, data + i, count - i);
+}
+
+void InterleaveSSE2(float* dst, const float* const* src, unsigned int channels, uint32_t frames)
+{
+  if (channels != 2)
+  {
+    InterleaveScalar(dst, src, channels, frames);
+    return;
+  }
+
+  const float* left = src[0];
+  const float* right = src[1];
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    __m128 l = _mm_loadu_ps(left + i);
+    __m128 r = _mm_loadu_ps(right + i);
+    _mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(l, r));
+  }
+  const float* rest[2] = { left + i, right + i };
+  InterleaveScalar(dst + 2 * i, rest, 2, frames - i);
+}
+
+void DeinterleaveSSE2(float* const* dst, const float* src, unsigned int channels, uint32_t frames)
+{
+  if (channels != 2)
+  {
+    DeinterleaveScalar(dst, src, channels, frames);
+    return;
+  }
+
+  float* left = dst[0];
+  float* right = dst[1];
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    __m128 a = _mm_loadu_ps(src + 2 * i);
+    __m128 b = _mm_loadu_ps(src + 2 * i + 4);
+    _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  float* const rest[2] = { left + i, right + i };
+  DeinterleaveScalar(rest, src + 2 * i, 2, frames - i);
+}
+
+void SwapEndian16SSE2(uint16_t* dst, const uint16_t* src, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+  }
+  SwapEndian16Scalar(dst + i, src + i, count - i);
+}
+
+const CAEMixKernels sse2Kernels =
+{
+  "sse2",
+  MulArraySSE2,
+  MulAddArraySSE2,
+  ClampArraySSE2,
+  SoftClipArraySSE2,
+  NeedsClampSSE2,
+  MaxAbsArraySSE2,
+  PeakArraySSE2,
+  InterleaveSSE2,
+  DeinterleaveSSE2,
+  SwapEndian16SSE2
+};
+#endif
+
+//-----------------------------------------------------------------------------
+// AVX2
+//-----------------------------------------------------------------------------
+
+#if defined(AE_MIX_AVX2)
+AE_MIX_TARGET_AVX2 void MulArrayAVX2(float* data, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+  _mm256_zeroupper();
+  MulArraySSE2(data + i, mul, count - i);
+}
+
+AE_MIX_TARGET_AVX2 void MulAddArrayAVX2(float* data, const float* add, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    // no fma, results have to match the other kernels
+    __m256 ad = _mm256_mul_ps(_mm256_loadu_ps(add + i), m);
+    _mm256_storeu_ps(data + i, _mm256_add_ps(_mm256_loadu_ps(data + i), ad));
+  }
+  _mm256_zeroupper();
+  MulAddArraySSE2(data + i, add + i, mul, count - i);
+}
+
+AE_MIX_TARGET_AVX2 void ClampArrayAVX2(float* data, uint32_t count)
+{
+  const __m256 lo = _mm256_set1_ps(-1.0f);
+  const __m256 hi = _mm256_set1_ps(1.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i), lo), hi));
+  _mm256_zeroupper();
+  ClampArraySSE2(data + i, count - i);
+}
+
+AE_MIX_TARGET_AVX2 void SoftClipArrayAVX2(float* data, uint32_t count)
+{
+  const __m256 lo = _mm256_set1_ps(-3.0f);
+  const __m256 hi = _mm256_set1_ps(3.0f);
+  const __m256 c27 = _mm256_set1_ps(27.0f);
+  const __m256 c9 = _mm256_set1_ps(9.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i), lo), hi);
+    __m256 y = _mm256_mul_ps(x, x);
+    __m256 num = _mm256_mul_ps(x, _mm256_add_ps(c27, y));
+    __m256 den = _mm256_add_ps(c27, _mm256_mul_ps(c9, y));
+    _mm256_storeu_ps(data + i, _mm256_div_ps(num, den));
+  }
+  _mm256_zeroupper();
+  SoftClipArraySSE2(data + i, count - i);
+}
+
+AE_MIX_TARGET_AVX2 bool NeedsClampAVX2(const float* data, uint32_t count)
+{
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  const __m256 one = _mm256_set1_ps(1.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 x = _mm256_and_ps(_mm256_loadu_ps(data + i), absMask);
+    if (_mm256_movemask_ps(_mm256_cmp_ps(x, one, _CMP_GT_OQ)))
+    {
+      _mm256_zeroupper();
+      return true;
+    }
+  }
+  _mm256_zeroupper();
+  return NeedsClampSSE2(data + i, count - i);
+}
+
+AE_MIX_TARGET_AVX2 float MaxAbsArrayAVX2(const float* data, uint32_t count)
+{
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  __m256 highest = _mm256_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    highest = _mm256_max_ps(highest, _mm256_and_ps(_mm256_loadu_ps(data + i), absMask));
+  __m128 half = _mm_max_ps(_mm256_castps256_ps128(highest), _mm256_extractf128_ps(highest, 1));
+  half = _mm_max_ps(half, _mm_movehl_ps(half, half));
+  half = _mm_max_ss(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(1, 1, 1, 1)));
+  float result = _mm_cvtss_f32(half);
+  _mm256_zeroupper();
+  return std::max(result, MaxAbsArraySSE2(data + i, count - i));
+}
+
+AE_MIX_TARGET_AVX2 void PeakArrayAVX2(float* peak, const float* data, uint32_t count)
+{
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 x = _mm256_and_ps(_mm256_loadu_ps(data + i), absMask);
+    _mm256_storeu_ps(peak + i, _mm256_max_ps(_mm256_loadu_ps(peak + i), x));
+  }
+  _mm256_zeroupper();
+  PeakArraySSE2(peak + i, data + i, count - i);
+}
+
+AE_MIX_TARGET_AVX2 void InterleaveAVX2(float* dst, const float* const* src, unsigned int channels, uint32_t frames)
+{
+  if (channels != 2)
+  {
+    InterleaveScalar(dst, src, channels, frames);
+    return;
+  }
+
+  const float* left = src[0];
+  const float* right = src[1];
+  uint32_t i = 0;
+  for (; i + 8 <= frames; i += 8)
+  {
+    __m256 l = _mm256_loadu_ps(left + i);
+    __m256 r = _mm256_loadu_ps(right + i);
+    // unpack works per 128 bit lane: lo = frames 0,1,4,5 hi = frames 2,3,6,7
+    __m256 lo = _mm256_unpacklo_ps(l, r);
+    __m256 hi = _mm256_unpackhi_ps(l, r);
+    _mm256_storeu_ps(dst + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(dst + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+  }
+  const float* rest[2] = { left + i, right + i };
+  _mm256_zeroupper();
+  InterleaveSSE2(dst + 2 * i, rest, 2, frames - i);
+}
+
+AE_MIX_TARGET_AVX2 void DeinterleaveAVX2(float* const* dst, const float* src, unsigned int channels, uint32_t frames)
+{
+  if (channels != 2)
+  {
+    DeinterleaveScalar(dst, src, channels, frames);
+    return;
+  }
+
+  float* left = dst[0];
+  float* right = dst[1];
+  uint32_t i = 0;
+  for (; i + 8 <= frames; i += 8)
+  {
+    __m256 a = _mm256_loadu_ps(src + 2 * i);
+    __m256 b = _mm256_loadu_ps(src + 2 * i + 8);
+    // shuffle works per 128 bit lane, the result holds frames 0,1,4,5,2,3,6,7
+    __m256 l = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    __m256 r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    l = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3, 1, 2, 0)));
+    r = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0)));
+    _mm256_storeu_ps(left + i, l);
+    _mm256_storeu_ps(right + i, r);
+  }
+  float* const rest[2] = { left + i, right + i };
+  _mm256_zeroupper();
+  DeinterleaveSSE2(rest, src + 2 * i, 2, frames - i);
+}
+
+AE_MIX_TARGET_AVX2 void SwapEndian16AVX2(uint16_t* dst, const uint16_t* src, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    v = _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+  }
+  _mm256_zeroupper();
+  SwapEndian16SSE2(dst + i, src + i, count - i);
+}
+
+const CAEMixKernels avx2Kernels =
+{
+  "avx2",
+  MulArrayAVX2,
+  MulAddArrayAVX2,
+  ClampArrayAVX2,
+  SoftClipArrayAVX2,
+  NeedsClampAVX2,
+  MaxAbsArrayAVX2,
+  PeakArrayAVX2,
+  InterleaveAVX2,
+  DeinterleaveAVX2,
+  SwapEndian16AVX2
+};
+#endif
+
+//-----------------------------------------------------------------------------
+// NEON
+//-----------------------------------------------------------------------------
+
+#if defined(AE_MIX_NEON)
+void MulArrayNEON(float* data, float mul, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), mul));
+  MulArrayScalar(data + i, mul, count - i);
+}
+
+void MulAddArrayNEON(float* data, const float* add, float mul, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t ad = vmulq_n_f32(vld1q_f32(add + i), mul);
+    vst1q_f32(data + i, vaddq_f32(vld1q_f32(data + i), ad));
+  }
+  MulAddArrayScalar(data + i, add + i, mul, count - i);
+}
+
+void ClampArrayNEON(float* data, uint32_t count)
+{
+  const float32x4_t lo = vdupq_n_f32(-1.0f);
+  const float32x4_t hi = vdupq_n_f32(1.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vminq_f32(vmaxq_f32(vld1q_f32(data + i), lo), hi));
+  ClampArrayScalar(data + i, count - i);
+}
+
+#if defined(__aarch64__)
+void SoftClipArrayNEON(float* data, uint32_t count)
+{
+  const float32x4_t lo = vdupq_n_f32(-3.0f);
+  const float32x4_t hi = vdupq_n_f32(3.0f);
+  const float32x4_t c27 = vdupq_n_f32(27.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t x = vminq_f32(vmaxq_f32(vld1q_f32(data + i), lo), hi);
+    float32x4_t y = vmulq_f32(x, x);
+    float32x4_t num = vmulq_f32(x, vaddq_f32(c27, y));
+    float32x4_t den = vaddq_f32(c27, vmulq_n_f32(y, 9.0f));
+    vst1q_f32(data + i, vdivq_f32(num, den));
+  }
+  SoftClipArrayScalar(data + i, count - i);
+}
+#else
+// armv7 neon has no division, a reciprocal estimate would not match the scalar result
+#define SoftClipArrayNEON SoftClipArrayScalar
+#endif
+
+bool NeedsClampNEON(const float* data, uint32_t count)
+{
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    uint32x4_t gt = vcagtq_f32(vld1q_f32(data + i), one);
+    uint32x2_t any = vorr_u32(vget_low_u32(gt), vget_high_u32(gt));
+    if (vget_lane_u32(vpmax_u32(any, any), 0))
+      return true;
+  }
+  return NeedsClampScalar(data + i, count - i);
+}
+
+float MaxAbsArrayNEON(const float* data, uint32_t count)
+{
+  float32x4_t highest = vdupq_n_f32(0.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    highest = vmaxq_f32(highest, vabsq_f32(vld1q_f32(data + i)));
+  float32x2_t half = vmax_f32(vget_low_f32(highest), vget_high_f32(highest));
+  half = vpmax_f32(half, half);
+  return std::max(vget_lane_f32(half, 0), MaxAbsArrayScalar(data + i, count - i));
+}
+
+void PeakArrayNEON(float* peak, const float* data, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(peak + i, vmaxq_f32(vld1q_f32(peak + i), vabsq_f32(vld1q_f32(data + i))));
+  PeakArrayScalar(peak + i, data + i, count - i);
+}
+
+void InterleaveNEON(float* dst, const float* const* src, unsigned int channels, uint32_t frames)
+{
+  if (channels != 2)
+  {
+    InterleaveScalar(dst, src, channels, frames);
+    return;
+  }
+
+  const float* left = src[0];
+  const float* right = src[1];
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    float32x4x2_t lr;
+    lr.val[0] = vld1q_f32(left + i);
+    lr.val[1] = vld1q_f32(right + i);
+    vst2q_f32(dst + 2 * i, lr);
+  }
+  const float* rest[2] = { left + i, right + i };
+  InterleaveScalar(dst + 2 * i, rest, 2, frames - i);
+}
+
+void DeinterleaveNEON(float* const* dst, const float* src, unsigned int channels, uint32_t frames)
+{
+  if (channels != 2)
+  {
+    DeinterleaveScalar(dst, src, channels, frames);
+    return;
+  }
+
+  float* left = dst[0];
+  float* right = dst[1];
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    float32x4x2_t lr = vld2q_f32(src + 2 * i);
+    vst1q_f32(left + i, lr.val[0]);
+    vst1q_f32(right + i, lr.val[1]);
+  }
+  float* const rest[2] = { left + i, right + i };
+  DeinterleaveScalar(rest, src + 2 * i, 2, frames - i);
+}
+
+void SwapEndian16NEON(uint16_t* dst, const uint16_t* src, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), vrev16q_u8(v));
+  }
+  SwapEndian16Scalar(dst + i, src + i, count - i);
+}
+
+const CAEMixKernels neonKernels =
+{
+  "neon",
+  MulArrayNEON,
+  MulAddArrayNEON,
+  ClampArrayNEON,
+  SoftClipArrayNEON,
+  NeedsClampNEON,
+  MaxAbsArrayNEON,
+  PeakArrayNEON,
+  InterleaveNEON,
+  DeinterleaveNEON,
+  SwapEndian16NEON
+};
+#endif
+
+unsigned int GetCPUFeatures()
+{
+  std::shared_ptr<CCPUInfo> cpuInfo = CServiceBroker::GetCPUInfo();
+  if (!cpuInfo)
+    cpuInfo = CCPUInfo::GetCPUInfo();
+  return cpuInfo ? cpuInfo->GetCPUFeatures() : 0;
+}
+
+const CAEMixKernels& SelectKernels()
+{
+  std::vector<const CAEMixKernels*> available = CAEMixKernels::GetAvailable();
+  const CAEMixKernels* kernels = available.back();
+  CLog::Log(LOGDEBUG, "CAEMixKernels::Get - using %s kernels", kernels->name);
+  return *kernels;
+}
+
+}
+
+const CAEMixKernels& CAEMixKernels::Get()
+{
+  static const CAEMixKernels& kernels = SelectKernels();
+  return kernels;
+}
+
+const CAEMixKernels& CAEMixKernels::GetScalar()
+{
+  return scalarKernels;
+}
+
+std::vector<const CAEMixKernels*> CAEMixKernels::GetAvailable()
+{
+  std::vector<const CAEMixKernels*> available;
+  available.push_back(&scalarKernels);
+
+  unsigned int features = GetCPUFeatures();
+  (void)features;
+
+#if defined(AE_MIX_SSE2)
+  // part of the baseline the file is compiled for
+  available.push_back(&sse2Kernels);
+#endif
+#if defined(AE_MIX_AVX2)
+  if (features & CPU_FEATURE_AVX2)
+    available.push_back(&avx2Kernels);
+#endif
+#if defined(AE_MIX_NEON)
+#if defined(__aarch64__)
+  available.push_back(&neonKernels);
+#else
+  if (features & CPU_FEATURE_NEON)
+    available.push_back(&neonKernels);
+#endif
+#endif
+
+  return available;
+}
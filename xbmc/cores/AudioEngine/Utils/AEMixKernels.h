@@ -0,0 +1,55 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ * \brief Set of kernels used by the ActiveAE mix and passthrough paths.
+ *
+ * There is one set per instruction set, a scalar one that works everywhere and
+ * SSE2, AVX2 and NEON ones where the compiler and the cpu support them. Get()
+ * picks the best set for the cpu at runtime, CAEUtil forwards to it. All sets
+ * produce the same results as the scalar one, up to rounding.
+ */
+struct CAEMixKernels
+{
+  const char* name;
+
+  //! data[i] *= mul
+  void (*MulArray)(float* data, float mul, uint32_t count);
+  //! data[i] += add[i] * mul
+  void (*MulAddArray)(float* data, const float* add, float mul, uint32_t count);
+  //! clamp to [-1, 1]
+  void (*ClampArray)(float* data, uint32_t count);
+  //! tanh like soft clipping to [-1, 1], inputs beyond +-3 map to +-1
+  void (*SoftClipArray)(float* data, uint32_t count);
+  //! true if any sample is outside of [-1, 1]
+  bool (*NeedsClamp)(const float* data, uint32_t count);
+  //! largest absolute value of data, 0 for an empty array
+  float (*MaxAbsArray)(const float* data, uint32_t count);
+  //! peak[i] = max(peak[i], |data[i]|)
+  void (*PeakArray)(float* peak, const float* data, uint32_t count);
+  //! planar to interleaved, dst holds frames * channels samples
+  void (*Interleave)(float* dst, const float* const* src, unsigned int channels, uint32_t frames);
+  //! interleaved to planar, each plane of dst holds frames samples
+  void (*Deinterleave)(float* const* dst, const float* src, unsigned int channels, uint32_t frames);
+  //! swaps the bytes of each 16 bit word, dst may be src
+  void (*SwapEndian16)(uint16_t* dst, const uint16_t* src, uint32_t count);
+
+  //! the best set for the cpu Kodi runs on
+  static const CAEMixKernels& Get();
+
+  //! the scalar reference set
+  static const CAEMixKernels& GetScalar();
+
+  //! all sets the cpu can run, the scalar set first
+  static std::vector<const CAEMixKernels*> GetAvailable();
+};
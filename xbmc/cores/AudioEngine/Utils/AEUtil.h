@@ -111,8 +111,6 @@ private:
     static __m128i m_sseSeed;
   #endif
 
-  static float SoftClamp(const float x);
-
 public:
   static CAEChannelInfo          GuessChLayout     (const unsigned int channels);
   static const char*             GetStdChLayoutName(const enum AEStdChLayout layout);
@@ -180,11 +178,15 @@ public:
     return 20*log10(scale);
   }
 
-  #if defined(HAVE_SSE) && defined(__SSE__)
-  static void SSEMulArray     (float *data, const float mul, uint32_t count);
-  static void SSEMulAddArray  (float *data, float *add, const float mul, uint32_t count);
-  #endif
-  static void ClampArray(float *data, uint32_t count);
+  /*! \brief Mix path kernels, dispatched to the best instruction set at runtime
+   \sa CAEMixKernels
+   */
+  static void MulArray        (float *data, const float mul, uint32_t count);
+  static void MulAddArray     (float *data, const float *add, const float mul, uint32_t count);
+  //! soft clipping to [-1, 1]
+  static void ClampArray      (float *data, uint32_t count);
+  static void HardClampArray  (float *data, uint32_t count);
+  static bool NeedsClamp      (const float *data, uint32_t count);
 
   static bool S16NeedsByteSwap(AEDataFormat in, AEDataFormat out);
 
@@ -0,0 +1,201 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AEBitstreamPacker.h"
+#include "cores/AudioEngine/Utils/AEPackIEC61937.h"
+#include "cores/AudioEngine/Utils/AEStreamInfo.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+/* The expected output is built the way the packer did before it used the
+ * vector kernels and reused the MAT frame: byte by byte, with a frame that is
+ * cleared completely for every burst.
+ */
+namespace
+{
+const size_t MAT_FRAME_SIZE = 61424;
+
+std::vector<uint8_t> RandomBytes(size_t count, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<uint8_t> bytes(count);
+  for (auto& byte : bytes)
+    byte = static_cast<uint8_t>(dist(gen));
+  return bytes;
+}
+
+void PutWord(std::vector<uint8_t>& out, size_t pos, uint16_t word)
+{
+  memcpy(out.data() + pos, &word, sizeof(word));
+}
+
+//! header, payload with swapped bytes if needed and zero padding up to burst
+std::vector<uint8_t> RefBurst(uint16_t type, uint16_t length, const uint8_t* data, size_t size,
+                              size_t burst, bool swap = true)
+{
+  std::vector<uint8_t> out(burst, 0);
+  PutWord(out, 0, 0xF872);
+  PutWord(out, 2, 0x4E1F);
+  PutWord(out, 4, type);
+  PutWord(out, 6, length);
+  if (!swap)
+  {
+    memcpy(out.data() + 8, data, size);
+    return out;
+  }
+  // odd sizes take the byte after the payload into the last word
+  for (size_t i = 0; i < size; i += 2)
+  {
+    out[8 + i] = data[i + 1];
+    out[8 + i + 1] = data[i];
+  }
+  return out;
+}
+
+std::vector<uint8_t> RefMAT(const std::vector<std::vector<uint8_t>>& units)
+{
+  static const uint8_t start[20] = { 0x07, 0x9E, 0x00, 0x03, 0x84, 0x01, 0x01, 0x01, 0x80, 0x00, 0x56, 0xA5, 0x3B, 0xF4, 0x81, 0x83, 0x49, 0x80, 0x77, 0xE0 };
+  static const uint8_t middle[12] = { 0xC3, 0xC1, 0x42, 0x49, 0x3B, 0xFA, 0x82, 0x83, 0x49, 0x80, 0x77, 0xE0 };
+  static const uint8_t end[16] = { 0xC3, 0xC2, 0xC0, 0xC4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x97, 0x11 };
+
+  std::vector<uint8_t> mat(MAT_FRAME_SIZE, 0);
+  memcpy(mat.data(), start, sizeof(start));
+  memcpy(mat.data() + 12 * 2560 - 8 - 4, middle, sizeof(middle));
+  memcpy(mat.data() + MAT_FRAME_SIZE - sizeof(end), end, sizeof(end));
+  for (size_t pos = 0; pos < units.size(); pos++)
+  {
+    size_t offset = pos * 2560 - 8;
+    if (pos == 0)
+      offset = sizeof(start);
+    else if (pos == 12)
+      offset = pos * 2560 + sizeof(middle) - 8 - 4;
+    memcpy(mat.data() + offset, units[pos].data(), units[pos].size());
+  }
+  return RefBurst(0x16, MAT_FRAME_SIZE, mat.data(), mat.size(), 61440);
+}
+
+void ExpectPacked(const std::vector<uint8_t>& expected, CAEBitstreamPacker& packer)
+{
+  ASSERT_EQ(expected.size(), packer.GetSize());
+  EXPECT_EQ(0, memcmp(expected.data(), packer.GetBuffer(), expected.size()));
+}
+}
+
+TEST(TestAEBitstreamPacker, AC3)
+{
+  CAEStreamInfo info;
+  info.m_type = CAEStreamInfo::STREAM_TYPE_AC3;
+  CAEBitstreamPacker packer;
+
+  for (unsigned int size : { 6u, 7u, 33u, 1001u, 1536u, 6136u })
+  {
+    std::vector<uint8_t> frame = RandomBytes(size + 1, size);
+    packer.Pack(info, frame.data(), size);
+    uint16_t type = 0x01 | ((frame[5] & 0x7) << 8);
+    ExpectPacked(RefBurst(type, size << 3, frame.data(), size, 6144), packer);
+  }
+}
+
+TEST(TestAEBitstreamPacker, EAC3)
+{
+  CAEStreamInfo info;
+  info.m_type = CAEStreamInfo::STREAM_TYPE_EAC3;
+  info.m_repeat = 1;
+  CAEBitstreamPacker packer;
+
+  std::vector<uint8_t> frame = RandomBytes(1793, 1);
+  packer.Pack(info, frame.data(), 1791);
+  ExpectPacked(RefBurst(0x15, 1791, frame.data(), 1791, 24576), packer);
+
+  // three frames make a burst
+  info.m_repeat = 3;
+  std::vector<uint8_t> burst;
+  for (unsigned int i = 0; i < 3; i++)
+  {
+    frame = RandomBytes(500 + 2 * i, 10 + i);
+    packer.Pack(info, frame.data(), frame.size());
+    burst.insert(burst.end(), frame.begin(), frame.end());
+  }
+  ExpectPacked(RefBurst(0x15, burst.size(), burst.data(), burst.size(), 24576), packer);
+}
+
+TEST(TestAEBitstreamPacker, DTS)
+{
+  CAEStreamInfo info;
+  info.m_type = CAEStreamInfo::STREAM_TYPE_DTS_512;
+  CAEBitstreamPacker packer;
+
+  for (bool littleEndian : { true, false })
+  {
+    info.m_dataIsLE = littleEndian;
+    std::vector<uint8_t> frame = RandomBytes(1006, littleEndian);
+    packer.Pack(info, frame.data(), 1006);
+    ExpectPacked(RefBurst(0x0B, 1006 << 3, frame.data(), 1006, 2048, !littleEndian), packer);
+  }
+}
+
+TEST(TestAEBitstreamPacker, DTSHD)
+{
+  CAEStreamInfo info;
+  info.m_type = CAEStreamInfo::STREAM_TYPE_DTSHD_MA;
+  info.m_dtsPeriod = 2048;
+  CAEBitstreamPacker packer;
+
+  for (unsigned int size : { 4000u, 2000u, 8000u })
+  {
+    std::vector<uint8_t> frame = RandomBytes(size, size);
+    packer.Pack(info, frame.data(), size);
+
+    std::vector<uint8_t> payload = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xfe };
+    payload.push_back(static_cast<uint8_t>(size >> 8));
+    payload.push_back(static_cast<uint8_t>(size & 0xFF));
+    payload.insert(payload.end(), frame.begin(), frame.end());
+    uint16_t length = ((payload.size() + 0x17) & ~0x0f) - 0x08;
+    ExpectPacked(RefBurst(0x11 | (2 << 8), length, payload.data(), payload.size(), 2048 << 2), packer);
+  }
+}
+
+// units of varying size, a frame with small units has to be clean of the large ones before
+TEST(TestAEBitstreamPacker, TrueHD)
+{
+  CAEStreamInfo info;
+  info.m_type = CAEStreamInfo::STREAM_TYPE_TRUEHD;
+  CAEBitstreamPacker packer;
+
+  std::mt19937 gen(42);
+  for (unsigned int maxSize : { 2500u, 100u, 1800u, 0u })
+  {
+    std::uniform_int_distribution<unsigned int> dist(0, maxSize);
+    std::vector<std::vector<uint8_t>> units;
+    for (unsigned int pos = 0; pos < 24; pos++)
+    {
+      units.push_back(RandomBytes(dist(gen), pos + maxSize));
+      packer.Pack(info, units.back().data(), units.back().size());
+    }
+    ExpectPacked(RefMAT(units), packer);
+  }
+}
+
+TEST(TestAEBitstreamPacker, InPlace)
+{
+  for (unsigned int size : { 0u, 1u, 2u, 15u, 4096u })
+  {
+    std::vector<uint8_t> data = RandomBytes(size + 1, size);
+    std::vector<uint8_t> packet(OUT_FRAMESTOBYTES(EAC3_FRAME_SIZE), 0xAA);
+    memcpy(packet.data() + IEC61937_DATA_OFFSET, data.data(), data.size());
+
+    ASSERT_EQ(static_cast<int>(packet.size()), CAEPackIEC61937::PackEAC3(nullptr, size, packet.data()));
+    std::vector<uint8_t> expected = RefBurst(0x15, size, data.data(), size, packet.size());
+    EXPECT_EQ(expected, packet) << "size " << size;
+  }
+}
@@ -0,0 +1,127 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AELimiter.h"
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const int sampleRate = 48000;
+const int frames = 1024;
+const float fullScale = 1.0f + 1e-6f;
+
+std::vector<float> Sine(int count, float amplitude, float frequency, int channels = 1)
+{
+  std::vector<float> samples(count * channels);
+  for (int i = 0; i < count; i++)
+  {
+    for (int j = 0; j < channels; j++)
+      samples[i * channels + j] = amplitude * std::sin(2.0f * static_cast<float>(M_PI) * frequency * (i + j * 10) / sampleRate);
+  }
+  return samples;
+}
+
+float MaxAbs(const std::vector<float>& samples)
+{
+  float highest = 0.0f;
+  for (float sample : samples)
+    highest = std::max(highest, std::fabs(sample));
+  return highest;
+}
+}
+
+TEST(TestAELimiter, BelowFullScalePlanar)
+{
+  CAELimiter limiter;
+  limiter.SetSamplerate(sampleRate);
+  limiter.SetAmplification(8.0f);
+
+  for (int block = 0; block < 20; block++)
+  {
+    std::vector<float> left = Sine(frames, 0.9f, 440.0f);
+    std::vector<float> right = Sine(frames, 0.5f, 1000.0f);
+    float* data[AE_CH_MAX] = { left.data(), right.data() };
+    limiter.Process(data, 2, frames, true);
+    EXPECT_LE(MaxAbs(left), fullScale) << "block " << block;
+    EXPECT_LE(MaxAbs(right), fullScale) << "block " << block;
+  }
+}
+
+TEST(TestAELimiter, BelowFullScaleInterleaved)
+{
+  CAELimiter limiter;
+  limiter.SetSamplerate(sampleRate);
+  limiter.SetAmplification(8.0f);
+
+  for (int block = 0; block < 20; block++)
+  {
+    std::vector<float> samples = Sine(frames, 0.9f, 440.0f, 6);
+    float* data[AE_CH_MAX] = { samples.data() };
+    limiter.Process(data, 6, frames, false);
+    EXPECT_LE(MaxAbs(samples), fullScale) << "block " << block;
+  }
+}
+
+TEST(TestAELimiter, AmplifiesQuietSignal)
+{
+  CAELimiter limiter;
+  limiter.SetSamplerate(sampleRate);
+  limiter.SetAmplification(2.0f);
+
+  std::vector<float> samples = Sine(frames, 0.25f, 440.0f);
+  std::vector<float> expected = samples;
+  float* data[AE_CH_MAX] = { samples.data() };
+  limiter.Process(data, 1, frames, true);
+
+  for (int i = 0; i < frames; i++)
+    EXPECT_FLOAT_EQ(expected[i] * 2.0f, samples[i]);
+}
+
+TEST(TestAELimiter, LookaheadRampsDown)
+{
+  CAELimiter limiter;
+  limiter.SetSamplerate(sampleRate);
+  limiter.SetAmplification(1.0f);
+
+  const int peak = 500;
+  std::vector<float> samples(frames, 0.5f);
+  samples[peak] = 4.0f;
+  float* data[AE_CH_MAX] = { samples.data() };
+  limiter.Process(data, 1, frames, true);
+
+  EXPECT_LE(samples[peak], fullScale);
+  // frames before the peak are attenuated less the further away they are
+  EXPECT_LT(samples[peak - 1], 0.5f);
+  EXPECT_LT(samples[peak - 10], samples[peak - 40]);
+  EXPECT_FLOAT_EQ(0.5f, samples[0]);
+}
+
+TEST(TestAELimiter, ReleasesAfterPeak)
+{
+  CAELimiter limiter;
+  limiter.SetSamplerate(sampleRate);
+  limiter.SetAmplification(1.0f);
+
+  std::vector<float> samples(frames, 0.5f);
+  samples[0] = 2.0f;
+  float* data[AE_CH_MAX] = { samples.data() };
+  limiter.Process(data, 1, frames, true);
+  EXPECT_LT(samples[frames - 1], 0.5f);
+
+  // default hold and release are 25ms and 100ms, 1 second is plenty
+  for (int block = 0; block < sampleRate / frames; block++)
+  {
+    std::fill(samples.begin(), samples.end(), 0.5f);
+    limiter.Process(data, 1, frames, true);
+  }
+  EXPECT_FLOAT_EQ(0.5f, samples[frames - 1]);
+}
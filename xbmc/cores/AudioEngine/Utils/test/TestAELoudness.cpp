@@ -0,0 +1,123 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AELoudness.h"
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const unsigned int sampleRate = 48000;
+
+//! stereo sine of the given peak level in dBFS, in both channels
+std::vector<float> Sine(double seconds, double level, double frequency = 1000.0, double phase = 0.0)
+{
+  unsigned int frames = static_cast<unsigned int>(seconds * sampleRate);
+  float amplitude = static_cast<float>(pow(10.0, level / 20.0));
+  std::vector<float> samples(frames * 2);
+  for (unsigned int i = 0; i < frames; i++)
+    samples[i * 2] = samples[i * 2 + 1] =
+        amplitude * static_cast<float>(sin(2.0 * M_PI * frequency * i / sampleRate + phase));
+  return samples;
+}
+
+double Measure(const std::vector<float>& samples)
+{
+  CAELoudnessMeter meter(sampleRate, CAEChannelInfo(AE_CH_LAYOUT_2_0));
+  meter.AddFrames(samples.data(), samples.size() / 2);
+  return meter.GetIntegratedLoudness();
+}
+}
+
+// EBU Tech 3341 case 1 and 2, a 1 kHz sine in both channels
+TEST(TestAELoudness, Sine)
+{
+  EXPECT_NEAR(-23.0, Measure(Sine(20.0, -23.0)), 0.1);
+  EXPECT_NEAR(-33.0, Measure(Sine(20.0, -33.0)), 0.1);
+}
+
+// EBU Tech 3341 case 3, quiet parts are gated
+TEST(TestAELoudness, RelativeGate)
+{
+  std::vector<float> samples = Sine(10.0, -36.0);
+  std::vector<float> loud = Sine(60.0, -23.0);
+  samples.insert(samples.end(), loud.begin(), loud.end());
+  std::vector<float> quiet = Sine(10.0, -36.0);
+  samples.insert(samples.end(), quiet.begin(), quiet.end());
+
+  EXPECT_NEAR(-23.0, Measure(samples), 0.1);
+}
+
+TEST(TestAELoudness, Silence)
+{
+  std::vector<float> samples(sampleRate * 2 * 5, 0.0f);
+  EXPECT_TRUE(std::isinf(Measure(samples)));
+
+  // below the absolute gate
+  EXPECT_TRUE(std::isinf(Measure(Sine(5.0, -80.0))));
+}
+
+TEST(TestAELoudness, LfeIgnored)
+{
+  CAEChannelInfo layout(AE_CH_LAYOUT_2_1);
+  ASSERT_EQ(AE_CH_LFE, layout[2]);
+
+  std::vector<float> stereo = Sine(10.0, -23.0);
+  std::vector<float> samples;
+  for (size_t i = 0; i < stereo.size(); i += 2)
+  {
+    samples.push_back(stereo[i]);
+    samples.push_back(stereo[i + 1]);
+    samples.push_back(0.9f);
+  }
+
+  CAELoudnessMeter meter(sampleRate, layout);
+  meter.AddFrames(samples.data(), samples.size() / 3);
+  EXPECT_NEAR(-23.0, meter.GetIntegratedLoudness(), 0.1);
+}
+
+/* A sine at a quarter of the sample rate shifted by 45 degrees never has a
+ * sample at its crest, the true peak is 3 dB above the sample peak.
+ */
+TEST(TestAELoudness, TruePeak)
+{
+  std::vector<float> samples = Sine(1.0, -6.0, sampleRate / 4.0, M_PI / 4.0);
+  float samplePeak = 0.0f;
+  for (float sample : samples)
+    samplePeak = std::max(samplePeak, std::fabs(sample));
+
+  CAELoudnessMeter meter(sampleRate, CAEChannelInfo(AE_CH_LAYOUT_2_0));
+  meter.AddFrames(samples.data(), samples.size() / 2);
+
+  float expected = static_cast<float>(pow(10.0, -6.0 / 20.0));
+  EXPECT_NEAR(expected * M_SQRT1_2, samplePeak, 1e-3);
+  EXPECT_NEAR(20.0 * log10(expected), 20.0 * log10(meter.GetTruePeak()), 0.3);
+}
+
+// the blocks of several tracks give the loudness of them played in a row
+TEST(TestAELoudness, Album)
+{
+  std::vector<float> first = Sine(10.0, -20.0);
+  std::vector<float> second = Sine(30.0, -30.0);
+
+  CAELoudnessMeter meter1(sampleRate, CAEChannelInfo(AE_CH_LAYOUT_2_0));
+  meter1.AddFrames(first.data(), first.size() / 2);
+  CAELoudnessMeter meter2(sampleRate, CAEChannelInfo(AE_CH_LAYOUT_2_0));
+  meter2.AddFrames(second.data(), second.size() / 2);
+
+  std::vector<double> blocks = meter1.GetBlocks();
+  blocks.insert(blocks.end(), meter2.GetBlocks().begin(), meter2.GetBlocks().end());
+
+  std::vector<float> both = first;
+  both.insert(both.end(), second.begin(), second.end());
+
+  EXPECT_NEAR(Measure(both), CAELoudnessMeter::GetIntegratedLoudness(blocks), 0.1);
+}
@@ -0,0 +1,276 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AEMixKernels.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// lengths that are not a multiple of any vector width, to exercise the tails
+const uint32_t lengths[] = { 0, 1, 3, 4, 7, 8, 15, 17, 33, 1023 };
+const float tolerance = 1e-6f;
+
+std::vector<float> RandomSamples(size_t count, float range, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> dist(-range, range);
+  std::vector<float> samples(count);
+  for (auto& sample : samples)
+    sample = dist(gen);
+  return samples;
+}
+
+void ExpectNear(const std::vector<float>& expected, const std::vector<float>& actual, const char* name)
+{
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); i++)
+    ASSERT_NEAR(expected[i], actual[i], tolerance) << name << " at " << i;
+}
+}
+
+TEST(TestAEMixKernels, ScalarFirst)
+{
+  std::vector<const CAEMixKernels*> available = CAEMixKernels::GetAvailable();
+  ASSERT_FALSE(available.empty());
+  EXPECT_EQ(&CAEMixKernels::GetScalar(), available.front());
+  EXPECT_NE(nullptr, CAEMixKernels::Get().name);
+}
+
+TEST(TestAEMixKernels, MulArray)
+{
+  const CAEMixKernels& scalar = CAEMixKernels::GetScalar();
+  for (const CAEMixKernels* kernels : CAEMixKernels::GetAvailable())
+  {
+    for (uint32_t length : lengths)
+    {
+      // offset by one sample so the data is not aligned to the vector width
+      std::vector<float> expected = RandomSamples(length + 1, 2.0f, length);
+      std::vector<float> actual = expected;
+      scalar.MulArray(expected.data() + 1, 0.75f, length);
+      kernels->MulArray(actual.data() + 1, 0.75f, length);
+      ExpectNear(expected, actual, kernels->name);
+    }
+  }
+}
+
+TEST(TestAEMixKernels, MulAddArray)
+{
+  const CAEMixKernels& scalar = CAEMixKernels::GetScalar();
+  for (const CAEMixKernels* kernels : CAEMixKernels::GetAvailable())
+  {
+    for (uint32_t length : lengths)
+    {
+      std::vector<float> add = RandomSamples(length + 3, 1.0f, length + 100);
+      std::vector<float> expected = RandomSamples(length + 1, 1.0f, length);
+      std::vector<float> actual = expected;
+      scalar.MulAddArray(expected.data() + 1, add.data() + 3, 0.5f, length);
+      kernels->MulAddArray(actual.data() + 1, add.data() + 3, 0.5f, length);
+      ExpectNear(expected, actual, kernels->name);
+    }
+  }
+}
+
+TEST(TestAEMixKernels, ClampArray)
+{
+  const CAEMixKernels& scalar = CAEMixKernels::GetScalar();
+  for (const CAEMixKernels* kernels : CAEMixKernels::GetAvailable())
+  {
+    for (uint32_t length : lengths)
+    {
+      std::vector<float> expected = RandomSamples(length, 4.0f, length);
+      std::vector<float> actual = expected;
+      scalar.ClampArray(expected.data(), length);
+      kernels->ClampArray(actual.data(), length);
+      ExpectNear(expected, actual, kernels->name);
+      for (float sample : actual)
+      {
+        EXPECT_LE(sample, 1.0f);
+        EXPECT_GE(sample, -1.0f);
+      }
+    }
+  }
+}
+
+TEST(TestAEMixKernels, SoftClipArray)
+{
+  const CAEMixKernels& scalar = CAEMixKernels::GetScalar();
+  for (const CAEMixKernels* kernels : CAEMixKernels::GetAvailable())
+  {
+    for (uint32_t length : lengths)
+    {
+      std::vector<float> expected = RandomSamples(length, 5.0f, length);
+      std::vector<float> actual = expected;
+      scalar.SoftClipArray(expected.data(), length);
+      kernels->SoftClipArray(actual.data(), length);
+      ExpectNear(expected, actual, kernels->name);
+      // the curve reaches 1 at 3, rounding may overshoot by an ulp close to it
+      for (float sample : actual)
+      {
+        EXPECT_LE(sample, 1.0f + tolerance);
+        EXPECT_GE(sample, -1.0f - tolerance);
+      }
+    }
+  }
+}
+
+TEST(TestAEMixKernels, NeedsClamp)
+{
+  for (const CAEMixKernels* kernels : CAEMixKernels::GetAvailable())
+  {
+    for (uint32_t length : lengths)
+    {
+      std::vector<float> samples = RandomSamples(length, 1.0f, length);
+      EXPECT_FALSE(kernels->NeedsClamp(samples.data(), length)) << kernels->name;
+
+      // a single sample out of range, at every position to hit body and tail
+      for (uint32_t i = 0; i < length && i < 40; i++)
+      {
+        std::vector<float> clipped = samples;
+        clipped[i] = (i & 1) ? -1.5f : 1.5f;
+        EXPECT_TRUE(kernels->NeedsClamp(clipped.data(), length)) << kernels->name << " at " << i;
+      }
+    }
+  }
+}
+
+TEST(TestAEMixKernels, MaxAbsArray)
+{
+  for (const CAEMixKernels* kernels : CAEMixKernels::GetAvailable())
+  {
+    for (uint32_t length : lengths)
+    {
+      std::vector<float> samples = RandomSamples(length + 1, 1.0f, length);
+      EXPECT_EQ(CAEMixKernels::GetScalar().MaxAbsArray(samples.data() + 1, length),
+                kernels->MaxAbsArray(samples.data() + 1, length)) << kernels->name;
+
+      // the peak at every position, negative to check the absolute value is taken
+      for (uint32_t i = 0; i < length && i < 40; i++)
+      {
+        std::vector<float> peaked = samples;
+        peaked[i + 1] = -2.0f;
+        EXPECT_EQ(2.0f, kernels->MaxAbsArray(peaked.data() + 1, length)) << kernels->name << " at " << i;
+      }
+    }
+  }
+}
+
+TEST(TestAEMixKernels, PeakArray)
+{
+  const CAEMixKernels& scalar = CAEMixKernels::GetScalar();
+  for (const CAEMixKernels* kernels : CAEMixKernels::GetAvailable())
+  {
+    for (uint32_t length : lengths)
+    {
+      std::vector<float> data = RandomSamples(length + 1, 2.0f, length);
+      std::vector<float> expected = RandomSamples(length, 1.0f, length + 100);
+      for (auto& sample : expected)
+        sample = std::fabs(sample);
+      std::vector<float> actual = expected;
+      scalar.PeakArray(expected.data(), data.data() + 1, length);
+      kernels->PeakArray(actual.data(), data.data() + 1, length);
+      EXPECT_EQ(expected, actual) << kernels->name;
+    }
+  }
+}
+
+TEST(TestAEMixKernels, InterleaveDeinterleave)
+{
+  const CAEMixKernels& scalar = CAEMixKernels::GetScalar();
+  for (const CAEMixKernels* kernels : CAEMixKernels::GetAvailable())
+  {
+    for (unsigned int channels : { 1u, 2u, 6u, 8u })
+    {
+      for (uint32_t frames : lengths)
+      {
+        std::vector<std::vector<float>> planes;
+        std::vector<const float*> src;
+        for (unsigned int ch = 0; ch < channels; ch++)
+          planes.push_back(RandomSamples(frames, 1.0f, frames * 10 + ch));
+        for (auto& plane : planes)
+          src.push_back(plane.data());
+
+        std::vector<float> expected(frames * channels);
+        std::vector<float> actual(frames * channels);
+        scalar.Interleave(expected.data(), src.data(), channels, frames);
+        kernels->Interleave(actual.data(), src.data(), channels, frames);
+        EXPECT_EQ(expected, actual) << kernels->name << " channels " << channels;
+
+        std::vector<std::vector<float>> output(channels, std::vector<float>(frames));
+        std::vector<float*> dst;
+        for (auto& plane : output)
+          dst.push_back(plane.data());
+        kernels->Deinterleave(dst.data(), actual.data(), channels, frames);
+        EXPECT_EQ(planes, output) << kernels->name << " channels " << channels;
+      }
+    }
+  }
+}
+
+TEST(TestAEMixKernels, SwapEndian16)
+{
+  for (const CAEMixKernels* kernels : CAEMixKernels::GetAvailable())
+  {
+    for (uint32_t length : lengths)
+    {
+      std::vector<uint16_t> src(length + 1);
+      for (size_t i = 0; i < src.size(); i++)
+        src[i] = static_cast<uint16_t>(i * 0x0103 + length);
+
+      std::vector<uint16_t> expected(src);
+      for (uint32_t i = 0; i < length; i++)
+        expected[i + 1] = static_cast<uint16_t>((src[i + 1] >> 8) | ((src[i + 1] & 0xFF) << 8));
+
+      std::vector<uint16_t> actual(src);
+      kernels->SwapEndian16(actual.data() + 1, src.data() + 1, length);
+      EXPECT_EQ(expected, actual) << kernels->name;
+
+      // in place, like the iec packer does for data that is already in the packet
+      kernels->SwapEndian16(src.data() + 1, src.data() + 1, length);
+      EXPECT_EQ(expected, src) << kernels->name;
+    }
+  }
+}
+
+/* Not a correctness test, prints the time of each set relative to the scalar
+ * one for a stereo period of the mix path. Disabled in regular runs, run it
+ * with --gtest_also_run_disabled_tests.
+ */
+TEST(TestAEMixKernels, DISABLED_Benchmark)
+{
+  using Clock = std::chrono::steady_clock;
+  const uint32_t frames = 1024;
+  const uint32_t count = frames * 2;
+  const int iterations = 2000;
+
+  std::vector<float> data = RandomSamples(count, 1.0f, 1);
+  std::vector<float> add = RandomSamples(count, 1.0f, 2);
+  std::vector<float> planar(count);
+  float* dst[2] = { planar.data(), planar.data() + frames };
+
+  for (const CAEMixKernels* kernels : CAEMixKernels::GetAvailable())
+  {
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+      kernels->MulAddArray(data.data(), add.data(), 0.5f, count);
+      kernels->MulArray(data.data(), 0.5f, count);
+      if (kernels->NeedsClamp(data.data(), count))
+        kernels->SoftClipArray(data.data(), count);
+      kernels->Deinterleave(dst, data.data(), 2, frames);
+    }
+    double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    std::cout << "TestAEMixKernels " << kernels->name << ": " << us / iterations << " us per period" << std::endl;
+  }
+}
@@ -12,6 +12,7 @@
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/AudioEngine/Utils/AEChannelInfo.h"
+#include "cores/AudioEngine/Utils/AEStreamData.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/RetroPlayer/audio/AudioTranslator.h"
 #include "cores/RetroPlayer/process/RPProcessInfo.h"
@@ -90,7 +91,7 @@ bool CRetroPlayerAudio::OpenStream(const StreamProperties& properties)
   audioFormat.m_dataFormat = pcmFormat;
   audioFormat.m_sampleRate = iSampleRate;
   audioFormat.m_channelLayout = channelLayout;
-  m_pAudioStream = audioEngine->MakeStream(audioFormat);
+  m_pAudioStream = audioEngine->MakeStream(audioFormat, AESTREAM_LOW_LATENCY);
 
   if (m_pAudioStream == nullptr)
   {
@@ -98,6 +99,8 @@ bool CRetroPlayerAudio::OpenStream(const StreamProperties& properties)
     return false;
   }
 
+  CLog::Log(LOGDEBUG, "RetroPlayer[AUDIO]: Maximum audio latency is %0.1f ms", m_pAudioStream->GetMaxDelay() * 1000);
+
   m_processInfo.SetAudioChannels(audioFormat.m_channelLayout);
   m_processInfo.SetAudioSampleRate(audioFormat.m_sampleRate);
   m_processInfo.SetAudioBitsPerSample(CAEUtil::DataFormatToUsedBits(audioFormat.m_dataFormat));
@@ -19,6 +19,7 @@
 #include "DVDAudioCodecPassthrough.h"
 #include "DVDCodecs/DVDCodecs.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
+#include "cores/VideoPlayer/DVDDemuxers/DemuxPacketPool.h"
 #include "ServiceBroker.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
@@ -428,7 +429,7 @@ bool CDVDAudioCodecAndroidMediaCodec::AddData(const DemuxPacket &packet)
 
   if (m_decryptCodec)
   {
-    DemuxPacket newPkt;
+    DemuxPacketEntry newPkt;
     newPkt.iSize = GetData(&newPkt.pData);
     newPkt.pts = m_currentPts;
     newPkt.iStreamId = packet.iStreamId;
@@ -8,6 +8,8 @@
 
 #include "DVDDemux.h"
 
+#include "DVDDemuxUtils.h"
+
 std::string CDemuxStreamAudio::GetStreamType()
 {
   std::string strInfo;
@@ -94,3 +96,8 @@ std::string CDemuxStream::GetStreamName()
 {
   return name;
 }
+
+DemuxPacket* CDVDDemux::AllocateDemuxPacket(int iDataSize)
+{
+  return CDVDDemuxUtils::AllocateDemuxPacket(m_packetPool.get(), iDataSize);
+}
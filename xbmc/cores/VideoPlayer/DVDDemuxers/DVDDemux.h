@@ -17,6 +17,7 @@
 struct DemuxPacket;
 struct DemuxCryptoSession;
 
+class CDemuxPacketPool;
 class CDVDInputStream;
 
 namespace ADDON
@@ -354,6 +355,11 @@ public:
   */
   int64_t GetDemuxerId() { return m_demuxerId; };
 
+  /*
+   * set a pool to allocate demux packets from, nullptr disables pooling
+   */
+  void SetPacketPool(std::shared_ptr<CDemuxPacketPool> pool) { m_packetPool = pool; };
+
 protected:
   virtual void EnableStream(int id, bool enable){};
   virtual void OpenStream(int id){};
@@ -362,7 +368,13 @@ protected:
 
   int GetNrOfStreams(StreamType streamType);
 
+  /*
+   * allocate a packet, from the packet pool if one is set
+   */
+  DemuxPacket* AllocateDemuxPacket(int iDataSize);
+
   int64_t m_demuxerId;
+  std::shared_ptr<CDemuxPacketPool> m_packetPool;
 
 private:
   int64_t NewGuid()
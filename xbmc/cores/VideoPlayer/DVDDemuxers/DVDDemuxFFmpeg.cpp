@@ -15,6 +15,7 @@
 #include "cores/FFmpeg.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h" // for DVD_TIME_BASE
 #include "DVDDemuxUtils.h"
+#include "DemuxProbeCache.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DVDInputStreams/DVDInputStreamFFmpeg.h"
 #include "ServiceBroker.h"
@@ -211,6 +212,7 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
   m_speed = DVD_PLAYSPEED_NORMAL;
   m_program = UINT_MAX;
   m_seekToKeyFrame = false;
+  m_zeroCopy = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoDemuxZeroCopy;
 
   const AVIOInterruptCB int_cb = { interrupt_cb, this };
 
@@ -487,8 +489,21 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
     if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
       av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
 
-    CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
-    int iErr = avformat_find_stream_info(m_pFormatContext, NULL);
+    // only plain files can be identified by size and modification time
+    const bool probeCache = m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) &&
+                            CDemuxProbeCache::CanCache(m_pFormatContext, strFile);
+    int iErr = 0;
+    if (probeCache && CDemuxProbeCache::GetInstance().Restore(m_pFormatContext, strFile))
+    {
+      CLog::Log(LOGDEBUG, "%s - skipping avformat_find_stream_info, stream info is cached", __FUNCTION__);
+    }
+    else
+    {
+      CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
+      iErr = avformat_find_stream_info(m_pFormatContext, NULL);
+      if (iErr >= 0 && probeCache)
+        CDemuxProbeCache::GetInstance().Store(m_pFormatContext, strFile);
+    }
     if (iErr < 0)
     {
       CLog::Log(LOGWARNING,"could not find codec parameters for %s", CURL::GetRedacted(strFile).c_str());
@@ -1020,6 +1035,10 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
 
       AVStream* stream = m_pFormatContext->streams[m_pkt.pkt.stream_index];
 
+      // share the payload with ffmpeg's buffer instead of copying it
+      bool zeroCopy = m_zeroCopy && m_pkt.pkt.buf && m_pkt.pkt.data;
+      int payloadSize = zeroCopy ? 0 : m_pkt.pkt.size;
+
       if (IsVideoReady())
       {
         if (m_program != UINT_MAX)
@@ -1029,7 +1048,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           {
             if (m_pkt.pkt.stream_index == (int)m_pFormatContext->programs[m_program]->stream_index[i])
             {
-              pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+              pPacket = AllocateDemuxPacket(payloadSize);
               break;
             }
           }
@@ -1038,7 +1057,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
             bReturnEmpty = true;
         }
         else
-          pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+          pPacket = AllocateDemuxPacket(payloadSize);
       }
       else
         bReturnEmpty = true;
@@ -1052,13 +1071,24 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           m_pkt.pkt.pts = AV_NOPTS_VALUE;
         }
 
-        // copy contents into our own packet
-        pPacket->iSize = m_pkt.pkt.size;
+        if (zeroCopy && !CDVDDemuxUtils::StoreBufferRef(pPacket, &m_pkt.pkt))
+        {
+          CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+          pPacket = AllocateDemuxPacket(m_pkt.pkt.size);
+          zeroCopy = false;
+        }
 
-        // maybe we can avoid a memcpy here by detecting where pkt.destruct is pointing too?
-        if (m_pkt.pkt.data)
-          memcpy(pPacket->pData, m_pkt.pkt.data, pPacket->iSize);
+        // copy contents into our own packet
+        if (pPacket)
+        {
+          pPacket->iSize = m_pkt.pkt.size;
+          if (!zeroCopy && m_pkt.pkt.data)
+            memcpy(pPacket->pData, m_pkt.pkt.data, pPacket->iSize);
+        }
+      }
 
+      if (pPacket)
+      {
         pPacket->pts = ConvertTimestamp(m_pkt.pkt.pts, stream->time_base.den, stream->time_base.num);
         pPacket->dts = ConvertTimestamp(m_pkt.pkt.dts, stream->time_base.den, stream->time_base.num);
         pPacket->duration =  DVD_SEC_TO_TIME((double)m_pkt.pkt.duration * stream->time_base.num / stream->time_base.den);
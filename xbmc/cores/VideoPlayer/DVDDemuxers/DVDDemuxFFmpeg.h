@@ -165,5 +165,6 @@ protected:
   int m_displayTime = 0;
   double m_dtsAtDisplayTime;
   bool m_seekToKeyFrame = false;
+  bool m_zeroCopy = false;
   double m_startTime = 0;
 };
@@ -7,6 +7,7 @@
  */
 
 #include "DVDDemuxUtils.h"
+#include "DemuxPacketPool.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxCrypto.h"
 #include "utils/log.h"
 #include "utils/MemUtils.h"
@@ -19,23 +20,42 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
-    if (pPacket->pData)
-      KODI::MEMORY::AlignedFree(pPacket->pData);
-    if (pPacket->iSideDataElems)
+    // every packet is allocated by us, see AllocateDemuxPacket
+    DemuxPacketEntry* entry = static_cast<DemuxPacketEntry*>(pPacket);
+
+    if (entry->iSideDataElems)
     {
       AVPacket avPkt;
       av_init_packet(&avPkt);
-      avPkt.side_data = static_cast<AVPacketSideData*>(pPacket->pSideData);
-      avPkt.side_data_elems = pPacket->iSideDataElems;
+      avPkt.side_data = static_cast<AVPacketSideData*>(entry->pSideData);
+      avPkt.side_data_elems = entry->iSideDataElems;
       av_packet_free_side_data(&avPkt);
     }
-    delete pPacket;
+
+    if (entry->bufferRef)
+    {
+      av_buffer_unref(&entry->bufferRef);
+      // the payload belonged to the buffer
+      entry->pData = nullptr;
+    }
+
+    if (entry->pool)
+    {
+      // the pool may only be referenced by this packet
+      std::shared_ptr<CDemuxPacketPool> pool = std::move(entry->pool);
+      pool->Recycle(entry);
+      return;
+    }
+
+    if (entry->pData)
+      KODI::MEMORY::AlignedFree(entry->pData);
+    delete entry;
   }
 }
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket();
+  DemuxPacketEntry* pPacket = new DemuxPacketEntry();
 
   if (iDataSize > 0)
   {
@@ -48,7 +68,8 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
      * MPEG bitstreams could cause overread and segfault
      */
-    pPacket->pData = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16));
+    pPacket->capacity = iDataSize + AV_INPUT_BUFFER_PADDING_SIZE;
+    pPacket->pData = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(pPacket->capacity, 16));
     if (!pPacket->pData)
     {
       FreeDemuxPacket(pPacket);
@@ -62,6 +83,14 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
   return pPacket;
 }
 
+DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(CDemuxPacketPool* pool, int iDataSize)
+{
+  if (pool)
+    return pool->AllocateDemuxPacket(iDataSize);
+
+  return AllocateDemuxPacket(iDataSize);
+}
+
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount)
 {
   DemuxPacket *ret(AllocateDemuxPacket(iDataSize));
@@ -78,3 +107,31 @@ void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
   pkt->pSideData = avPkt.side_data;
   pkt->iSideDataElems = avPkt.side_data_elems;
 }
+
+bool CDVDDemuxUtils::StoreBufferRef(DemuxPacket *pkt, AVPacket *src)
+{
+  DemuxPacketEntry* entry = static_cast<DemuxPacketEntry*>(pkt);
+  if (!src->buf || !src->data || entry->pData)
+    return false;
+
+  // the payload has to be followed by AV_INPUT_BUFFER_PADDING_SIZE zeroed bytes,
+  // see AllocateDemuxPacket. Packets allocated by ffmpeg end with them, but laced
+  // frames (e.g. from mkv) share one buffer and are followed by the next frame.
+  static const uint8_t padding[AV_INPUT_BUFFER_PADDING_SIZE] = {};
+  const uint8_t* end = src->data + src->size;
+  if (end + AV_INPUT_BUFFER_PADDING_SIZE > src->buf->data + src->buf->size ||
+      memcmp(end, padding, AV_INPUT_BUFFER_PADDING_SIZE) != 0)
+    return false;
+
+  entry->bufferRef = av_buffer_ref(src->buf);
+  if (!entry->bufferRef)
+    return false;
+
+  entry->pData = src->data;
+  return true;
+}
+
+AVBufferRef* CDVDDemuxUtils::GetBufferRef(const DemuxPacket& packet)
+{
+  return static_cast<const DemuxPacketEntry&>(packet).bufferRef;
+}
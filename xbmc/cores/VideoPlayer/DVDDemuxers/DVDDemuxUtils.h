@@ -13,12 +13,30 @@ extern "C" {
 #include <libavcodec/avcodec.h>
 }
 
+class CDemuxPacketPool;
+
 class CDVDDemuxUtils
 {
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
+  /*!
+   * \brief Allocate from the given pool, falls back to a plain allocation if pool is null
+   */
+  static DemuxPacket* AllocateDemuxPacket(CDemuxPacketPool* pool, int iDataSize);
   static DemuxPacket* AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount);
   static void StoreSideData(DemuxPacket *pkt, AVPacket *src);
+  /*!
+   * \brief Let pkt share the reference counted payload of src instead of copying it.
+   * pkt must have been allocated without payload. Returns false if src is not
+   * reference counted or its payload is not followed by zeroed padding, in that
+   * case the data has to be copied.
+   */
+  static bool StoreBufferRef(DemuxPacket *pkt, AVPacket *src);
+  /*!
+   * \brief The buffer the payload of packet belongs to, null if the payload was copied.
+   * packet has to be allocated by AllocateDemuxPacket or be a DemuxPacketEntry.
+   */
+  static AVBufferRef* GetBufferRef(const DemuxPacket& packet);
 };
 
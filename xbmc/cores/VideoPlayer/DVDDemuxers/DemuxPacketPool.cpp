@@ -0,0 +1,159 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxPacketPool.h"
+
+#include "threads/SingleLock.h"
+#include "utils/MemUtils.h"
+
+#include <algorithm>
+#include <cstring>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+namespace
+{
+// four size classes per power of two between 256 bytes and 7 MiB, this
+// limits the slack per buffer to 25%
+constexpr int POOL_MIN_SHIFT = 8;
+constexpr int POOL_MAX_SHIFT = 22;
+
+// upper bounds for what the pool keeps around for reuse
+constexpr size_t POOL_MAX_ENTRIES_PER_CLASS = 512;
+constexpr uint64_t POOL_MAX_CACHED_BYTES = 64 * 1024 * 1024;
+
+void FreeEntry(DemuxPacketEntry* entry)
+{
+  if (entry->pData)
+    KODI::MEMORY::AlignedFree(entry->pData);
+  delete entry;
+}
+}
+
+CDemuxPacketPool::CDemuxPacketPool()
+{
+  // class 0 holds packets without payload
+  m_classSizes.push_back(0);
+  for (int shift = POOL_MIN_SHIFT; shift <= POOL_MAX_SHIFT; shift++)
+  {
+    for (unsigned int i = 4; i < 8; i++)
+      m_classSizes.push_back(i << (shift - 2));
+  }
+  m_freeLists.resize(m_classSizes.size());
+}
+
+CDemuxPacketPool::~CDemuxPacketPool()
+{
+  Clear();
+}
+
+DemuxPacket* CDemuxPacketPool::AllocateDemuxPacket(int iDataSize)
+{
+  unsigned int needed = 0;
+  if (iDataSize > 0)
+    needed = static_cast<unsigned int>(iDataSize) + AV_INPUT_BUFFER_PADDING_SIZE;
+
+  int sizeClass = GetSizeClass(needed);
+  DemuxPacketEntry* entry = nullptr;
+
+  {
+    CSingleLock lock(m_critSection);
+    if (sizeClass < 0)
+      m_stats.oversized++;
+    else if (m_freeLists[sizeClass].empty())
+      m_stats.misses++;
+    else
+    {
+      entry = m_freeLists[sizeClass].back();
+      m_freeLists[sizeClass].pop_back();
+      m_stats.cachedBytes -= entry->capacity;
+      m_stats.hits++;
+    }
+  }
+
+  if (!entry)
+  {
+    entry = new DemuxPacketEntry();
+    entry->capacity = sizeClass < 0 ? needed : m_classSizes[sizeClass];
+    if (entry->capacity > 0)
+    {
+      entry->pData = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(entry->capacity, 16));
+      if (!entry->pData)
+      {
+        delete entry;
+        return nullptr;
+      }
+    }
+  }
+
+  // see CDVDDemuxUtils::AllocateDemuxPacket, the padding has to be zeroed
+  if (iDataSize > 0)
+    memset(entry->pData + iDataSize, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+
+  entry->pool = shared_from_this();
+  return entry;
+}
+
+void CDemuxPacketPool::Recycle(DemuxPacketEntry* entry)
+{
+  // reset everything but the payload buffer
+  uint8_t* data = entry->pData;
+  static_cast<DemuxPacket&>(*entry) = DemuxPacket();
+  entry->pData = data;
+
+  int sizeClass = GetSizeClass(entry->capacity);
+
+  {
+    CSingleLock lock(m_critSection);
+    if (sizeClass >= 0 && m_classSizes[sizeClass] == entry->capacity &&
+        m_freeLists[sizeClass].size() < POOL_MAX_ENTRIES_PER_CLASS &&
+        m_stats.cachedBytes + entry->capacity <= POOL_MAX_CACHED_BYTES)
+    {
+      m_freeLists[sizeClass].push_back(entry);
+      m_stats.cachedBytes += entry->capacity;
+      m_stats.recycled++;
+      return;
+    }
+    m_stats.dropped++;
+  }
+
+  FreeEntry(entry);
+}
+
+CDemuxPacketPool::Stats CDemuxPacketPool::GetStats() const
+{
+  CSingleLock lock(m_critSection);
+  return m_stats;
+}
+
+void CDemuxPacketPool::Clear()
+{
+  std::vector<std::vector<DemuxPacketEntry*>> freeLists(m_classSizes.size());
+  {
+    CSingleLock lock(m_critSection);
+    m_freeLists.swap(freeLists);
+    m_stats.cachedBytes = 0;
+  }
+
+  for (auto& list : freeLists)
+  {
+    for (auto entry : list)
+      FreeEntry(entry);
+  }
+}
+
+int CDemuxPacketPool::GetSizeClass(unsigned int size) const
+{
+  auto it = std::lower_bound(m_classSizes.begin(), m_classSizes.end(), size);
+  if (it == m_classSizes.end())
+    return -1;
+
+  return static_cast<int>(it - m_classSizes.begin());
+}
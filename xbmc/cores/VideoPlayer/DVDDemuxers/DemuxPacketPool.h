@@ -0,0 +1,82 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+#include "threads/CriticalSection.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class CDemuxPacketPool;
+struct AVBufferRef;
+
+/*!
+ * \brief Heap representation of every DemuxPacket handed out by CDVDDemuxUtils.
+ * Carries the owning pool (if any) and the usable size of pData, including
+ * the input padding, so that CDVDDemuxUtils::FreeDemuxPacket can hand the
+ * packet back to its pool instead of freeing it.
+ * Kodi internal, DemuxPacket itself is part of the add-on ABI.
+ */
+struct DemuxPacketEntry : public DemuxPacket
+{
+  std::shared_ptr<CDemuxPacketPool> pool;
+  unsigned int capacity = 0;
+  //! buffer pData points into if the demuxer handed the payload over without a copy
+  AVBufferRef* bufferRef = nullptr;
+};
+
+/*!
+ * \brief Size-classed pool of demux packets and their payload buffers.
+ * Owned by a player and shared with its demuxer. Packets keep their pool
+ * alive, so they may be freed after the player has gone. Thread safe.
+ */
+class CDemuxPacketPool : public std::enable_shared_from_this<CDemuxPacketPool>
+{
+public:
+  struct Stats
+  {
+    uint64_t hits = 0; //!< allocations served from the pool
+    uint64_t misses = 0; //!< allocations that needed a new buffer
+    uint64_t oversized = 0; //!< allocations too large to be pooled
+    uint64_t recycled = 0; //!< packets returned to the pool
+    uint64_t dropped = 0; //!< packets freed because the pool was full
+    uint64_t cachedBytes = 0; //!< payload bytes currently held by the pool
+  };
+
+  CDemuxPacketPool();
+  ~CDemuxPacketPool();
+
+  CDemuxPacketPool(const CDemuxPacketPool&) = delete;
+  CDemuxPacketPool& operator=(const CDemuxPacketPool&) = delete;
+
+  DemuxPacket* AllocateDemuxPacket(int iDataSize);
+  Stats GetStats() const;
+
+  /*!
+   * \brief Release all cached packets, outstanding packets are not affected
+   */
+  void Clear();
+
+private:
+  friend class CDVDDemuxUtils;
+
+  /*!
+   * \brief Return a packet to the pool, called by CDVDDemuxUtils::FreeDemuxPacket
+   * after side data and crypto info have been released
+   */
+  void Recycle(DemuxPacketEntry* entry);
+  int GetSizeClass(unsigned int size) const;
+
+  mutable CCriticalSection m_critSection;
+  std::vector<unsigned int> m_classSizes;
+  std::vector<std::vector<DemuxPacketEntry*>> m_freeLists;
+  Stats m_stats;
+};
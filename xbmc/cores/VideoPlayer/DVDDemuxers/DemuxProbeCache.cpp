@@ -0,0 +1,491 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxProbeCache.h"
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "utils/Crc32.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/auto_buffer.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace
+{
+constexpr size_t PROBE_CACHE_MAX_ENTRIES = 64;
+constexpr size_t PROBE_CACHE_MAX_FILES = 2000;
+constexpr uint64_t PROBE_CACHE_MAX_DISK_SIZE = 64 * 1024 * 1024;
+constexpr uint32_t PROBE_CACHE_MAGIC = 0x4b504331; // "KPC1", bump when the layout changes
+constexpr uint32_t PROBE_CACHE_MAX_EXTRADATA = 16 * 1024 * 1024;
+const char* PROBE_CACHE_FOLDER = "special://userdata/cache/probe/";
+
+class CProbeWriter
+{
+public:
+  template<typename T>
+  void Put(T value)
+  {
+    m_data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void PutBytes(const void* data, uint32_t size)
+  {
+    Put(size);
+    if (size > 0)
+      m_data.append(static_cast<const char*>(data), size);
+  }
+
+  const std::string& GetData() const { return m_data; }
+
+private:
+  std::string m_data;
+};
+
+class CProbeReader
+{
+public:
+  CProbeReader(const char* data, size_t size) : m_data(data), m_size(size) {}
+
+  template<typename T>
+  bool Get(T& value)
+  {
+    if (m_size - m_pos < sizeof(T))
+      return false;
+    memcpy(&value, m_data + m_pos, sizeof(T));
+    m_pos += sizeof(T);
+    return true;
+  }
+
+  template<typename T>
+  bool GetEnum(T& value)
+  {
+    int32_t raw;
+    if (!Get(raw))
+      return false;
+    value = static_cast<T>(raw);
+    return true;
+  }
+
+  bool GetString(std::string& value)
+  {
+    uint32_t size;
+    if (!Get(size) || m_size - m_pos < size)
+      return false;
+    value.assign(m_data + m_pos, size);
+    m_pos += size;
+    return true;
+  }
+
+  const char* GetBytes(uint32_t& size)
+  {
+    if (!Get(size) || m_size - m_pos < size)
+      return nullptr;
+    const char* bytes = m_data + m_pos;
+    m_pos += size;
+    return bytes;
+  }
+
+private:
+  const char* m_data;
+  size_t m_size;
+  size_t m_pos = 0;
+};
+
+void FreeCodecParameters(AVCodecParameters* params)
+{
+  avcodec_parameters_free(&params);
+}
+}
+
+struct CDemuxProbeCache::Entry
+{
+  struct Stream
+  {
+    std::shared_ptr<AVCodecParameters> params;
+    int64_t startTime;
+    int64_t duration;
+    int64_t nbFrames;
+    AVRational avgFrameRate;
+    AVRational rFrameRate;
+  };
+
+  std::string path;
+  int64_t size;
+  int64_t mtime;
+  int64_t startTime;
+  int64_t duration;
+  int64_t bitRate;
+  std::vector<Stream> streams;
+};
+
+CDemuxProbeCache& CDemuxProbeCache::GetInstance()
+{
+  static CDemuxProbeCache instance(PROBE_CACHE_FOLDER, PROBE_CACHE_MAX_FILES, PROBE_CACHE_MAX_DISK_SIZE);
+  return instance;
+}
+
+CDemuxProbeCache::CDemuxProbeCache(const std::string& folder, size_t maxFiles, uint64_t maxDiskSize)
+  : m_folder(URIUtils::AddFileToFolder(folder, "")),
+    m_maxFiles(std::max<size_t>(maxFiles, 1)),
+    m_maxDiskSize(maxDiskSize)
+{
+}
+
+bool CDemuxProbeCache::CanCache(const AVFormatContext* context, const std::string& path)
+{
+  if (!CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoProbeCache)
+    return false;
+
+  // streams of formats without header only show up while probing
+  if (!context || (context->ctx_flags & AVFMTCTX_NOHEADER) || context->nb_streams == 0)
+    return false;
+
+  return !URIUtils::IsInternetStream(path);
+}
+
+bool CDemuxProbeCache::Restore(AVFormatContext* context, const std::string& path)
+{
+  int64_t size, mtime;
+  if (!GetIdentity(path, size, mtime))
+    return false;
+
+  std::shared_ptr<Entry> entry = Find(path);
+  const bool loaded = !entry;
+  if (loaded)
+  {
+    entry = Load(path);
+    if (!entry)
+      return false;
+  }
+
+  // the file changed or avformat sees other streams than were probed, probe
+  // again and let Store() replace the entry
+  bool matches = entry->size == size && entry->mtime == mtime &&
+                 entry->streams.size() == context->nb_streams;
+  for (unsigned int i = 0; matches && i < context->nb_streams; i++)
+  {
+    const AVCodecParameters* cached = entry->streams[i].params.get();
+    const AVCodecParameters* opened = context->streams[i]->codecpar;
+    matches = cached->codec_type == opened->codec_type && cached->codec_id == opened->codec_id;
+  }
+
+  if (!matches)
+  {
+    CLog::Log(LOGDEBUG, "CDemuxProbeCache::Restore - cached stream info for %s is outdated", CURL::GetRedacted(path).c_str());
+    Remove(path);
+    return false;
+  }
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const Entry::Stream& cached = entry->streams[i];
+    AVStream* stream = context->streams[i];
+    if (avcodec_parameters_copy(stream->codecpar, cached.params.get()) < 0)
+    {
+      Remove(path);
+      return false;
+    }
+
+    stream->start_time = cached.startTime;
+    stream->duration = cached.duration;
+    stream->nb_frames = cached.nbFrames;
+    stream->avg_frame_rate = cached.avgFrameRate;
+    stream->r_frame_rate = cached.rFrameRate;
+  }
+
+  context->start_time = entry->startTime;
+  context->duration = entry->duration;
+  context->bit_rate = entry->bitRate;
+
+  if (loaded)
+  {
+    Insert(entry);
+    // rewrite the file so its modification time tells when it was used last
+    Save(*entry);
+  }
+
+  CLog::Log(LOGDEBUG, "CDemuxProbeCache::Restore - using cached stream info for %s", CURL::GetRedacted(path).c_str());
+  return true;
+}
+
+void CDemuxProbeCache::Store(const AVFormatContext* context, const std::string& path)
+{
+  auto entry = std::make_shared<Entry>();
+  if (!GetIdentity(path, entry->size, entry->mtime))
+    return;
+
+  entry->path = path;
+  entry->startTime = context->start_time;
+  entry->duration = context->duration;
+  entry->bitRate = context->bit_rate;
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const AVStream* stream = context->streams[i];
+    Entry::Stream cached;
+    cached.params.reset(avcodec_parameters_alloc(), FreeCodecParameters);
+    if (!cached.params || avcodec_parameters_copy(cached.params.get(), stream->codecpar) < 0)
+      return;
+
+    cached.startTime = stream->start_time;
+    cached.duration = stream->duration;
+    cached.nbFrames = stream->nb_frames;
+    cached.avgFrameRate = stream->avg_frame_rate;
+    cached.rFrameRate = stream->r_frame_rate;
+    entry->streams.push_back(cached);
+  }
+
+  Insert(entry);
+  Save(*entry);
+  CleanUp(GetCacheFile(path));
+}
+
+bool CDemuxProbeCache::GetIdentity(const std::string& path, int64_t& size, int64_t& mtime)
+{
+  struct __stat64 buffer;
+  if (XFILE::CFile::Stat(path, &buffer) != 0)
+    return false;
+
+  // without a modification time changes of the file could not be detected
+  if (buffer.st_mtime == 0 || buffer.st_size <= 0)
+    return false;
+
+  size = buffer.st_size;
+  mtime = buffer.st_mtime;
+  return true;
+}
+
+std::string CDemuxProbeCache::GetCacheFile(const std::string& path) const
+{
+  return StringUtils::Format("%s%08x.bin", m_folder.c_str(), Crc32::Compute(path));
+}
+
+std::shared_ptr<CDemuxProbeCache::Entry> CDemuxProbeCache::Load(const std::string& path)
+{
+  const std::string cacheFile = GetCacheFile(path);
+
+  XUTILS::auto_buffer buffer;
+  {
+    CSingleLock lock(m_diskSection);
+    if (!XFILE::CFile::Exists(cacheFile))
+      return nullptr;
+
+    XFILE::CFile file;
+    if (file.LoadFile(cacheFile, buffer) <= 0)
+      return nullptr;
+  }
+
+  CProbeReader reader(buffer.get(), buffer.size());
+  auto entry = std::make_shared<Entry>();
+  uint32_t magic, streams;
+  if (!reader.Get(magic) || magic != PROBE_CACHE_MAGIC ||
+      !reader.GetString(entry->path) || entry->path != path ||
+      !reader.Get(entry->size) || !reader.Get(entry->mtime) ||
+      !reader.Get(entry->startTime) || !reader.Get(entry->duration) || !reader.Get(entry->bitRate) ||
+      !reader.Get(streams))
+    return nullptr;
+
+  for (uint32_t i = 0; i < streams; i++)
+  {
+    Entry::Stream cached;
+    cached.params.reset(avcodec_parameters_alloc(), FreeCodecParameters);
+    if (!cached.params)
+      return nullptr;
+
+    AVCodecParameters* params = cached.params.get();
+    uint32_t extradataSize;
+    const char* extradata;
+    if (!reader.GetEnum(params->codec_type) || !reader.GetEnum(params->codec_id) ||
+        !reader.Get(params->codec_tag) || !reader.Get(params->format) ||
+        !reader.Get(params->bit_rate) || !reader.Get(params->bits_per_coded_sample) ||
+        !reader.Get(params->bits_per_raw_sample) || !reader.Get(params->profile) ||
+        !reader.Get(params->level) || !reader.Get(params->width) || !reader.Get(params->height) ||
+        !reader.Get(params->sample_aspect_ratio) || !reader.GetEnum(params->field_order) ||
+        !reader.GetEnum(params->color_range) || !reader.GetEnum(params->color_primaries) ||
+        !reader.GetEnum(params->color_trc) || !reader.GetEnum(params->color_space) ||
+        !reader.GetEnum(params->chroma_location) || !reader.Get(params->video_delay) ||
+        !reader.Get(params->channel_layout) || !reader.Get(params->channels) ||
+        !reader.Get(params->sample_rate) || !reader.Get(params->block_align) ||
+        !reader.Get(params->frame_size) || !reader.Get(params->initial_padding) ||
+        !reader.Get(params->trailing_padding) || !reader.Get(params->seek_preroll) ||
+        !reader.Get(cached.startTime) || !reader.Get(cached.duration) || !reader.Get(cached.nbFrames) ||
+        !reader.Get(cached.avgFrameRate) || !reader.Get(cached.rFrameRate) ||
+        !(extradata = reader.GetBytes(extradataSize)) || extradataSize > PROBE_CACHE_MAX_EXTRADATA)
+      return nullptr;
+
+    if (extradataSize > 0)
+    {
+      params->extradata = static_cast<uint8_t*>(av_mallocz(extradataSize + AV_INPUT_BUFFER_PADDING_SIZE));
+      if (!params->extradata)
+        return nullptr;
+      memcpy(params->extradata, extradata, extradataSize);
+      params->extradata_size = static_cast<int>(extradataSize);
+    }
+
+    entry->streams.push_back(cached);
+  }
+
+  return entry;
+}
+
+void CDemuxProbeCache::Save(const Entry& entry)
+{
+  CProbeWriter writer;
+  writer.Put(PROBE_CACHE_MAGIC);
+  writer.PutBytes(entry.path.data(), static_cast<uint32_t>(entry.path.size()));
+  writer.Put(entry.size);
+  writer.Put(entry.mtime);
+  writer.Put(entry.startTime);
+  writer.Put(entry.duration);
+  writer.Put(entry.bitRate);
+  writer.Put(static_cast<uint32_t>(entry.streams.size()));
+
+  for (const auto& cached : entry.streams)
+  {
+    const AVCodecParameters* params = cached.params.get();
+    writer.Put(static_cast<int32_t>(params->codec_type));
+    writer.Put(static_cast<int32_t>(params->codec_id));
+    writer.Put(params->codec_tag);
+    writer.Put(params->format);
+    writer.Put(params->bit_rate);
+    writer.Put(params->bits_per_coded_sample);
+    writer.Put(params->bits_per_raw_sample);
+    writer.Put(params->profile);
+    writer.Put(params->level);
+    writer.Put(params->width);
+    writer.Put(params->height);
+    writer.Put(params->sample_aspect_ratio);
+    writer.Put(static_cast<int32_t>(params->field_order));
+    writer.Put(static_cast<int32_t>(params->color_range));
+    writer.Put(static_cast<int32_t>(params->color_primaries));
+    writer.Put(static_cast<int32_t>(params->color_trc));
+    writer.Put(static_cast<int32_t>(params->color_space));
+    writer.Put(static_cast<int32_t>(params->chroma_location));
+    writer.Put(params->video_delay);
+    writer.Put(params->channel_layout);
+    writer.Put(params->channels);
+    writer.Put(params->sample_rate);
+    writer.Put(params->block_align);
+    writer.Put(params->frame_size);
+    writer.Put(params->initial_padding);
+    writer.Put(params->trailing_padding);
+    writer.Put(params->seek_preroll);
+    writer.Put(cached.startTime);
+    writer.Put(cached.duration);
+    writer.Put(cached.nbFrames);
+    writer.Put(cached.avgFrameRate);
+    writer.Put(cached.rFrameRate);
+    writer.PutBytes(params->extradata, params->extradata_size > 0 ? params->extradata_size : 0);
+  }
+
+  CSingleLock lock(m_diskSection);
+  if (!XFILE::CDirectory::Exists(m_folder))
+    XFILE::CDirectory::Create(m_folder);
+
+  XFILE::CFile file;
+  const std::string& data = writer.GetData();
+  if (!file.OpenForWrite(GetCacheFile(entry.path), true) ||
+      file.Write(data.data(), data.size()) != static_cast<ssize_t>(data.size()))
+    CLog::Log(LOGDEBUG, "CDemuxProbeCache::Save - failed to write %s", GetCacheFile(entry.path).c_str());
+}
+
+void CDemuxProbeCache::Remove(const std::string& path)
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_entries.remove_if([&path](const std::shared_ptr<Entry>& entry) { return entry->path == path; });
+  }
+
+  CSingleLock lock(m_diskSection);
+  const std::string cacheFile = GetCacheFile(path);
+  if (XFILE::CFile::Exists(cacheFile))
+    XFILE::CFile::Delete(cacheFile);
+}
+
+void CDemuxProbeCache::CleanUp(const std::string& keepFile)
+{
+  CSingleLock lock(m_diskSection);
+
+  CFileItemList items;
+  if (!XFILE::CDirectory::GetDirectory(m_folder, items, ".bin", XFILE::DIR_FLAG_NO_FILE_DIRS | XFILE::DIR_FLAG_BYPASS_CACHE))
+    return;
+
+  std::vector<CFileItemPtr> files;
+  uint64_t diskSize = 0;
+  for (const auto& item : items)
+  {
+    if (item->m_bIsFolder)
+      continue;
+    files.push_back(item);
+    diskSize += item->m_dwSize;
+  }
+
+  if (files.size() <= m_maxFiles && diskSize <= m_maxDiskSize)
+    return;
+
+  // least recently used first
+  std::sort(files.begin(), files.end(),
+            [](const CFileItemPtr& a, const CFileItemPtr& b) { return a->m_dateTime < b->m_dateTime; });
+
+  const std::string keepName = URIUtils::GetFileName(keepFile);
+  size_t count = files.size();
+  for (const auto& file : files)
+  {
+    if (count <= m_maxFiles && diskSize <= m_maxDiskSize)
+      break;
+
+    if (URIUtils::GetFileName(file->GetPath()) == keepName)
+      continue;
+
+    if (XFILE::CFile::Delete(file->GetPath()))
+    {
+      count--;
+      diskSize -= std::min<uint64_t>(file->m_dwSize, diskSize);
+    }
+  }
+
+  CLog::Log(LOGDEBUG, "CDemuxProbeCache::CleanUp - %zu cached stream infos left", count);
+}
+
+std::shared_ptr<CDemuxProbeCache::Entry> CDemuxProbeCache::Find(const std::string& path)
+{
+  CSingleLock lock(m_critSection);
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if ((*it)->path == path)
+    {
+      m_entries.splice(m_entries.begin(), m_entries, it);
+      return m_entries.front();
+    }
+  }
+  return nullptr;
+}
+
+void CDemuxProbeCache::Insert(const std::shared_ptr<Entry>& entry)
+{
+  CSingleLock lock(m_critSection);
+  m_entries.remove_if([&entry](const std::shared_ptr<Entry>& other) { return other->path == entry->path; });
+  m_entries.push_front(entry);
+  if (m_entries.size() > PROBE_CACHE_MAX_ENTRIES)
+    m_entries.pop_back();
+}
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+struct AVFormatContext;
+
+/*!
+ * \brief Cache of avformat_find_stream_info results.
+ *
+ * Keeps the codec parameters, frame rates and timings found by probing a file,
+ * keyed by path, size and modification time. Entries live in memory and are
+ * persisted to special://userdata/cache/probe/, so later opens of the same,
+ * unchanged file can skip probing, including opens after a restart. The files
+ * used least recently are removed once the folder holds too many or too large
+ * files. Only formats that create all streams from the file header are
+ * supported, since the cached parameters are applied to the streams found by
+ * avformat_open_input. Thread safe.
+ */
+class CDemuxProbeCache
+{
+public:
+  static CDemuxProbeCache& GetInstance();
+
+  /*!
+   * \param folder where the entries are persisted
+   * \param maxFiles number of entries kept on disk
+   * \param maxDiskSize size in bytes of all entries kept on disk
+   */
+  CDemuxProbeCache(const std::string& folder, size_t maxFiles, uint64_t maxDiskSize);
+
+  /*!
+   * \brief Apply the cached probe result for a file to a freshly opened context
+   * \return true if the result was applied and probing can be skipped. An entry
+   *         that does not match the file or its streams anymore is dropped.
+   */
+  bool Restore(AVFormatContext* context, const std::string& path);
+
+  /*!
+   * \brief Remember the probe result of a context after avformat_find_stream_info
+   */
+  void Store(const AVFormatContext* context, const std::string& path);
+
+  /*!
+   * \brief Whether the probe result of a context may be cached at all
+   */
+  static bool CanCache(const AVFormatContext* context, const std::string& path);
+
+private:
+  struct Entry;
+
+  CDemuxProbeCache(const CDemuxProbeCache&) = delete;
+  CDemuxProbeCache& operator=(const CDemuxProbeCache&) = delete;
+
+  static bool GetIdentity(const std::string& path, int64_t& size, int64_t& mtime);
+  std::string GetCacheFile(const std::string& path) const;
+  std::shared_ptr<Entry> Load(const std::string& path);
+  void Save(const Entry& entry);
+  void Remove(const std::string& path);
+  void CleanUp(const std::string& keepFile);
+
+  std::shared_ptr<Entry> Find(const std::string& path);
+  void Insert(const std::shared_ptr<Entry>& entry);
+
+  const std::string m_folder;
+  const size_t m_maxFiles;
+  const uint64_t m_maxDiskSize;
+
+  CCriticalSection m_critSection;
+  std::list<std::shared_ptr<Entry>> m_entries; //!< most recently used first
+  CCriticalSection m_diskSection; //!< serializes writes to and clean ups of the folder
+};
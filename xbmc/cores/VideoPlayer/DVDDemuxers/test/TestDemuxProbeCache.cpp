@@ -0,0 +1,206 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "cores/VideoPlayer/DVDDemuxers/DemuxProbeCache.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace
+{
+const char* CACHE_FOLDER = "special://temp/probecache/";
+
+struct FormatContextDeleter
+{
+  void operator()(AVFormatContext* context) const { avformat_free_context(context); }
+};
+using FormatContextPtr = std::unique_ptr<AVFormatContext, FormatContextDeleter>;
+
+// a context as avformat_open_input leaves it, with codec ids but no details
+FormatContextPtr OpenContext(AVCodecID videoCodec = AV_CODEC_ID_H264)
+{
+  FormatContextPtr context(avformat_alloc_context());
+  AVStream* video = avformat_new_stream(context.get(), nullptr);
+  video->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+  video->codecpar->codec_id = videoCodec;
+  AVStream* audio = avformat_new_stream(context.get(), nullptr);
+  audio->codecpar->codec_type = AVMEDIA_TYPE_AUDIO;
+  audio->codecpar->codec_id = AV_CODEC_ID_AAC;
+  return context;
+}
+
+// a context after avformat_find_stream_info
+FormatContextPtr ProbeContext()
+{
+  FormatContextPtr context = OpenContext();
+  context->duration = 60 * AV_TIME_BASE;
+  context->bit_rate = 4000000;
+  context->streams[0]->codecpar->width = 1920;
+  context->streams[0]->codecpar->height = 1080;
+  context->streams[0]->avg_frame_rate = AVRational{ 24000, 1001 };
+  context->streams[1]->codecpar->sample_rate = 48000;
+  context->streams[1]->codecpar->channels = 2;
+  return context;
+}
+}
+
+class TestDemuxProbeCache : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    XFILE::CDirectory::RemoveRecursive(CACHE_FOLDER);
+    for (auto& file : m_files)
+    {
+      file = XBMC_CREATETEMPFILE(".mkv");
+      ASSERT_NE(nullptr, file);
+      WriteFile(file, "media");
+    }
+  }
+
+  void TearDown() override
+  {
+    for (auto& file : m_files)
+      XBMC_DELETETEMPFILE(file);
+    XFILE::CDirectory::RemoveRecursive(CACHE_FOLDER);
+  }
+
+  void WriteFile(XFILE::CFile* file, const std::string& content)
+  {
+    file->Close();
+    ASSERT_TRUE(file->OpenForWrite(XBMC_TEMPFILEPATH(file), true));
+    ASSERT_EQ(static_cast<ssize_t>(content.size()), file->Write(content.c_str(), content.size()));
+    file->Close();
+  }
+
+  std::string GetPath(unsigned int index) const { return XBMC_TEMPFILEPATH(m_files[index]); }
+
+  size_t CountCacheFiles() const
+  {
+    CFileItemList items;
+    XFILE::CDirectory::GetDirectory(CACHE_FOLDER, items, ".bin", XFILE::DIR_FLAG_NO_FILE_DIRS | XFILE::DIR_FLAG_BYPASS_CACHE);
+    return items.Size();
+  }
+
+  XFILE::CFile* m_files[3] = {};
+};
+
+TEST_F(TestDemuxProbeCache, StoreAndRestore)
+{
+  CDemuxProbeCache cache(CACHE_FOLDER, 10, 1024 * 1024);
+
+  FormatContextPtr context = OpenContext();
+  EXPECT_FALSE(cache.Restore(context.get(), GetPath(0)));
+
+  cache.Store(ProbeContext().get(), GetPath(0));
+  EXPECT_EQ(1u, CountCacheFiles());
+
+  ASSERT_TRUE(cache.Restore(context.get(), GetPath(0)));
+  EXPECT_EQ(60 * AV_TIME_BASE, context->duration);
+  EXPECT_EQ(4000000, context->bit_rate);
+  EXPECT_EQ(1920, context->streams[0]->codecpar->width);
+  EXPECT_EQ(1080, context->streams[0]->codecpar->height);
+  EXPECT_EQ(24000, context->streams[0]->avg_frame_rate.num);
+  EXPECT_EQ(1001, context->streams[0]->avg_frame_rate.den);
+  EXPECT_EQ(48000, context->streams[1]->codecpar->sample_rate);
+  EXPECT_EQ(2, context->streams[1]->codecpar->channels);
+
+  EXPECT_FALSE(cache.Restore(OpenContext().get(), GetPath(1)));
+}
+
+TEST_F(TestDemuxProbeCache, RestoreAfterRestart)
+{
+  {
+    CDemuxProbeCache cache(CACHE_FOLDER, 10, 1024 * 1024);
+    cache.Store(ProbeContext().get(), GetPath(0));
+  }
+
+  CDemuxProbeCache cache(CACHE_FOLDER, 10, 1024 * 1024);
+  FormatContextPtr context = OpenContext();
+  ASSERT_TRUE(cache.Restore(context.get(), GetPath(0)));
+  EXPECT_EQ(1920, context->streams[0]->codecpar->width);
+}
+
+TEST_F(TestDemuxProbeCache, DropsEntryOfChangedSize)
+{
+  CDemuxProbeCache cache(CACHE_FOLDER, 10, 1024 * 1024);
+  cache.Store(ProbeContext().get(), GetPath(0));
+
+  WriteFile(m_files[0], "changed media");
+  EXPECT_FALSE(cache.Restore(OpenContext().get(), GetPath(0)));
+  EXPECT_EQ(0u, CountCacheFiles());
+}
+
+TEST_F(TestDemuxProbeCache, DropsEntryOfChangedModificationTime)
+{
+  CDemuxProbeCache cache(CACHE_FOLDER, 10, 1024 * 1024);
+  cache.Store(ProbeContext().get(), GetPath(0));
+
+  // same size, modification times have a resolution of a second
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  WriteFile(m_files[0], "MEDIA");
+  EXPECT_FALSE(cache.Restore(OpenContext().get(), GetPath(0)));
+  EXPECT_EQ(0u, CountCacheFiles());
+}
+
+TEST_F(TestDemuxProbeCache, FallsBackOnOtherStreams)
+{
+  CDemuxProbeCache cache(CACHE_FOLDER, 10, 1024 * 1024);
+  cache.Store(ProbeContext().get(), GetPath(0));
+
+  // avformat found another codec than was probed, the caller has to probe again
+  FormatContextPtr context = OpenContext(AV_CODEC_ID_HEVC);
+  EXPECT_FALSE(cache.Restore(context.get(), GetPath(0)));
+  EXPECT_EQ(0, context->streams[0]->codecpar->width);
+
+  FormatContextPtr oneStream(avformat_alloc_context());
+  AVStream* video = avformat_new_stream(oneStream.get(), nullptr);
+  video->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+  video->codecpar->codec_id = AV_CODEC_ID_H264;
+  cache.Store(ProbeContext().get(), GetPath(0));
+  EXPECT_FALSE(cache.Restore(oneStream.get(), GetPath(0)));
+}
+
+TEST_F(TestDemuxProbeCache, EvictsFilesOverLimit)
+{
+  CDemuxProbeCache cache(CACHE_FOLDER, 2, 1024 * 1024);
+  cache.Store(ProbeContext().get(), GetPath(0));
+  cache.Store(ProbeContext().get(), GetPath(1));
+  EXPECT_EQ(2u, CountCacheFiles());
+
+  cache.Store(ProbeContext().get(), GetPath(2));
+  EXPECT_EQ(2u, CountCacheFiles());
+
+  // the entry written last is never evicted
+  CDemuxProbeCache restarted(CACHE_FOLDER, 2, 1024 * 1024);
+  EXPECT_TRUE(restarted.Restore(OpenContext().get(), GetPath(2)));
+}
+
+TEST_F(TestDemuxProbeCache, EvictsFilesOverDiskSize)
+{
+  CDemuxProbeCache cache(CACHE_FOLDER, 10, 1);
+  cache.Store(ProbeContext().get(), GetPath(0));
+  cache.Store(ProbeContext().get(), GetPath(1));
+  EXPECT_EQ(1u, CountCacheFiles());
+
+  CDemuxProbeCache restarted(CACHE_FOLDER, 10, 1);
+  EXPECT_TRUE(restarted.Restore(OpenContext().get(), GetPath(1)));
+  EXPECT_FALSE(restarted.Restore(OpenContext().get(), GetPath(0)));
+}
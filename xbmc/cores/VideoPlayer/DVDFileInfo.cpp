@@ -8,6 +8,7 @@
 
 #include "DVDFileInfo.h"
 #include "ServiceBroker.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "FileItem.h"
 #include "settings/AdvancedSettings.h"
@@ -15,6 +16,8 @@
 #include "pictures/Picture.h"
 #include "video/VideoInfoTag.h"
 #include "filesystem/StackDirectory.h"
+#include "utils/CPUInfo.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 
@@ -41,7 +44,9 @@
 #include "Util.h"
 #include "utils/LangCodeExpander.h"
 
+#include <atomic>
 #include <cstdlib>
+#include <deque>
 #include <memory>
 
 extern "C" {
@@ -86,6 +91,233 @@ int DegreeToOrientation(int degrees)
   }
 }
 
+namespace
+{
+// video packets collected per position by CDVDFileInfo::ExtractThumbs, enough
+// to get a picture out of the decoder after a seek to a keyframe
+constexpr unsigned int BATCH_THUMB_MAX_PACKETS = 24;
+
+// decoders running at once per batch, including the calling thread. Batches
+// run next to playback, so they get half of the cpus at most.
+constexpr unsigned int BATCH_THUMB_MAX_DECODERS = 4;
+
+// scale a decoded picture to thumb size and write it to the cached path of details.file
+bool CacheThumbPicture(VideoPicture& picture, const CDVDStreamInfo& hint, CTextureDetails& details)
+{
+  bool bOk = false;
+  unsigned int nWidth = std::min(picture.iDisplayWidth, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
+  double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+  if(hint.forced_aspect && hint.aspect != 0)
+    aspect = hint.aspect;
+  unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
+
+  uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
+  struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
+        AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+
+  if (context)
+  {
+    uint8_t *planes[YuvImage::MAX_PLANES];
+    int stride[YuvImage::MAX_PLANES];
+    picture.videoBuffer->GetPlanes(planes);
+    picture.videoBuffer->GetStrides(stride);
+    uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
+    int srcStride[] = { stride[0], stride[1], stride[2], 0 };
+    uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+    int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
+    int orientation = DegreeToOrientation(hint.orientation);
+    sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
+    sws_freeContext(context);
+
+    details.width = nWidth;
+    details.height = nHeight;
+    CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
+    bOk = true;
+  }
+  av_free(pOutBuf);
+  return bOk;
+}
+
+// packets of one position of a batch, decoded by a separate codec instance
+struct ThumbTask
+{
+  std::vector<DemuxPacket*> packets;
+  CDVDFileInfo::ThumbRequest* request;
+
+  ~ThumbTask()
+  {
+    for (auto packet : packets)
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+};
+
+// hint is taken by value, the codec factory may adjust it
+bool DecodeThumb(CDVDStreamInfo hint, ThumbTask& task)
+{
+  std::unique_ptr<CProcessInfo> pProcessInfo(CProcessInfo::CreateInstance());
+  std::vector<AVPixelFormat> pixFmts;
+  pixFmts.push_back(AV_PIX_FMT_YUV420P);
+  pProcessInfo->SetPixFormats(pixFmts);
+
+  std::unique_ptr<CDVDVideoCodec> pVideoCodec(CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo));
+  if (!pVideoCodec)
+    return false;
+
+  CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
+  VideoPicture picture = {};
+  auto hasPicture = [&]() {
+    return iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED);
+  };
+
+  for (auto packet : task.packets)
+  {
+    pVideoCodec->AddData(*packet);
+
+    iDecoderState = CDVDVideoCodec::VC_NONE;
+    while (iDecoderState == CDVDVideoCodec::VC_NONE)
+      iDecoderState = pVideoCodec->GetPicture(&picture);
+
+    if (hasPicture())
+      break;
+  }
+
+  if (!hasPicture())
+  {
+    // squeeze out the pictures the decoder still holds back
+    pVideoCodec->SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+    for (unsigned int i = 0; i < BATCH_THUMB_MAX_PACKETS && !hasPicture(); i++)
+    {
+      iDecoderState = pVideoCodec->GetPicture(&picture);
+      if (iDecoderState == CDVDVideoCodec::VC_EOF || iDecoderState == CDVDVideoCodec::VC_ERROR)
+        break;
+    }
+  }
+
+  if (!hasPicture())
+    return false;
+
+  CTextureDetails details;
+  details.file = CTextureCache::GetCacheFile(task.request->url) + ".jpg";
+  if (!CacheThumbPicture(picture, hint, details))
+    return false;
+
+  CTextureCache::GetInstance().AddCachedTexture(task.request->url, details);
+  return true;
+}
+
+/*!
+ \brief Decode queue of a batch, shared with the helper jobs.
+ Helpers that start after the batch finished find the queue empty and leave.
+ */
+class CThumbDecodeQueue
+{
+public:
+  CThumbDecodeQueue(const CDVDStreamInfo& hint,
+                    unsigned int maxHelpers,
+                    const CDVDFileInfo::ThumbCallback& callback)
+    : m_hint(hint), m_maxHelpers(maxHelpers), m_callback(callback), m_cancelled(false) {}
+
+  void Push(std::unique_ptr<ThumbTask> task, const std::shared_ptr<CThumbDecodeQueue>& self)
+  {
+    bool startHelper = false;
+    {
+      CSingleLock lock(m_section);
+      m_tasks.push_back(std::move(task));
+      m_pending++;
+      if (m_helpers < m_maxHelpers)
+      {
+        m_helpers++;
+        startHelper = true;
+      }
+    }
+
+    if (startHelper)
+    {
+      CJobManager::GetInstance().Submit([self]() {
+        while (self->ProcessOne())
+          ;
+        self->HelperDone();
+      }, CJob::PRIORITY_HIGH);
+    }
+  }
+
+  //! decode the next task, returns false if there was none
+  bool ProcessOne()
+  {
+    std::unique_ptr<ThumbTask> task;
+    {
+      CSingleLock lock(m_section);
+      if (m_tasks.empty())
+        return false;
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+
+    if (!m_cancelled)
+    {
+      task->request->extracted = DecodeThumb(m_hint, *task);
+      if (!task->request->extracted)
+      {
+        // remember the failure, like CDVDFileInfo::ExtractThumb
+        XFILE::CFile file;
+        if (file.OpenForWrite(CTextureCache::GetCachedPath(CTextureCache::GetCacheFile(task->request->url) + ".jpg")))
+          file.Close();
+      }
+
+      // publish every thumb as soon as it is done
+      if (m_callback && !m_callback(*task->request))
+        m_cancelled = true;
+    }
+    task.reset();
+
+    CSingleLock lock(m_section);
+    m_pending--;
+    m_done.Set();
+    return true;
+  }
+
+  bool IsCancelled() const { return m_cancelled; }
+
+  size_t GetQueued()
+  {
+    CSingleLock lock(m_section);
+    return m_tasks.size();
+  }
+
+  //! decode on the calling thread as well until all tasks are finished
+  void Finish()
+  {
+    while (ProcessOne())
+      ;
+
+    CSingleLock lock(m_section);
+    while (m_pending > 0)
+    {
+      lock.Leave();
+      m_done.WaitMSec(100);
+      lock.Enter();
+    }
+  }
+
+private:
+  void HelperDone()
+  {
+    CSingleLock lock(m_section);
+    m_helpers--;
+  }
+
+  const CDVDStreamInfo m_hint;
+  const unsigned int m_maxHelpers;
+  const CDVDFileInfo::ThumbCallback m_callback;
+  std::atomic<bool> m_cancelled;
+  CCriticalSection m_section;
+  CEvent m_done;
+  std::deque<std::unique_ptr<ThumbTask>> m_tasks;
+  unsigned int m_pending = 0; //!< tasks queued or being decoded
+  unsigned int m_helpers = 0;
+};
+}
+
 bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
                                 CTextureDetails &details,
                                 CStreamDetails *pStreamDetails,
@@ -243,38 +475,7 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
 
         if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
         {
-          {
-            unsigned int nWidth = std::min(picture.iDisplayWidth, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
-            double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
-            if(hint.forced_aspect && hint.aspect != 0)
-              aspect = hint.aspect;
-            unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
-
-            uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
-            struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
-                  AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-
-            if (context)
-            {
-              uint8_t *planes[YuvImage::MAX_PLANES];
-              int stride[YuvImage::MAX_PLANES];
-              picture.videoBuffer->GetPlanes(planes);
-              picture.videoBuffer->GetStrides(stride);
-              uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
-              int srcStride[] = { stride[0], stride[1], stride[2], 0 };
-              uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-              int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
-              int orientation = DegreeToOrientation(hint.orientation);
-              sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              sws_freeContext(context);
-
-              details.width = nWidth;
-              details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
-              bOk = true;
-            }
-            av_free(pOutBuf);
-          }
+          bOk = CacheThumbPicture(picture, hint, details);
         }
         else
         {
@@ -300,6 +501,133 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
   return bOk;
 }
 
+unsigned int CDVDFileInfo::ExtractThumbs(const CFileItem& fileItem,
+                                         std::vector<ThumbRequest>& requests,
+                                         const ThumbCallback& callback /* = nullptr */)
+{
+  const std::string redactPath = CURL::GetRedacted(fileItem.GetPath());
+  unsigned int nTime = XbmcThreads::SystemClockMillis();
+
+  for (auto& request : requests)
+    request.extracted = false;
+
+  if (requests.empty())
+    return 0;
+
+  CFileItem item(fileItem);
+  item.SetMimeTypeForInternetFile();
+  auto pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, item);
+  if (!pInputStream)
+  {
+    CLog::Log(LOGERROR, "InputStream: Error creating stream for %s", redactPath.c_str());
+    return 0;
+  }
+
+  if (!pInputStream->Open())
+  {
+    CLog::Log(LOGERROR, "InputStream: Error opening, %s", redactPath.c_str());
+    return 0;
+  }
+
+  std::unique_ptr<CDVDDemux> pDemuxer;
+  try
+  {
+    pDemuxer.reset(CDVDFactoryDemuxer::CreateDemuxer(pInputStream, true));
+    if (!pDemuxer)
+    {
+      CLog::Log(LOGERROR, "%s - Error creating demuxer", __FUNCTION__);
+      return 0;
+    }
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - Exception thrown when opening demuxer", __FUNCTION__);
+    return 0;
+  }
+
+  int nVideoStream = -1;
+  int64_t demuxerId = -1;
+  for (CDemuxStream* pStream : pDemuxer->GetStreams())
+  {
+    if (pStream)
+    {
+      // ignore if it's a picture attachment (e.g. jpeg artwork)
+      if (pStream->type == STREAM_VIDEO && !(pStream->flags & AV_DISPOSITION_ATTACHED_PIC))
+      {
+        nVideoStream = pStream->uniqueId;
+        demuxerId = pStream->demuxerId;
+      }
+      else
+        pDemuxer->EnableStream(pStream->demuxerId, pStream->uniqueId, false);
+    }
+  }
+
+  if (nVideoStream == -1)
+  {
+    CLog::Log(LOGDEBUG, "%s - no video stream in %s", __FUNCTION__, redactPath.c_str());
+    return 0;
+  }
+
+  CDVDStreamInfo hint(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
+  hint.codecOptions = CODEC_FORCE_SOFTWARE;
+
+  // demuxing is sequential, decoding and scaling of the positions runs on
+  // job manager workers and on this thread
+  const unsigned int decoders = std::min(std::max(CServiceBroker::GetCPUInfo()->GetCPUCount() / 2, 1),
+                                         static_cast<int>(BATCH_THUMB_MAX_DECODERS));
+  const unsigned int maxHelpers = decoders - 1;
+  auto queue = std::make_shared<CThumbDecodeQueue>(hint, maxHelpers, callback);
+
+  for (auto& request : requests)
+  {
+    if (queue->IsCancelled())
+      break;
+
+    std::unique_ptr<ThumbTask> task(new ThumbTask); // C++14 - Replace with std::make_unique
+    task->request = &request;
+
+    if (pDemuxer->SeekTime(static_cast<double>(request.pos), true))
+    {
+      // num streams * 160 frames, like ExtractThumb
+      int abort_index = pDemuxer->GetNrOfStreams() * 160;
+      while (task->packets.size() < BATCH_THUMB_MAX_PACKETS && abort_index--)
+      {
+        DemuxPacket* pPacket = pDemuxer->Read();
+        if (!pPacket)
+          break;
+
+        if (pPacket->iStreamId != nVideoStream)
+          CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+        else
+          task->packets.push_back(pPacket);
+      }
+    }
+    else
+      CLog::Log(LOGDEBUG, "%s - seeking to pos %lldms failed in %s", __FUNCTION__, request.pos, redactPath.c_str());
+
+    queue->Push(std::move(task), queue);
+
+    // don't let the demuxer run too far ahead of the decoders
+    while (queue->GetQueued() > maxHelpers + 1 && queue->ProcessOne())
+      ;
+  }
+
+  pDemuxer.reset();
+  queue->Finish();
+
+  unsigned int extracted = 0;
+  for (const auto& request : requests)
+  {
+    if (request.extracted)
+      extracted++;
+  }
+
+  unsigned int nTotalTime = XbmcThreads::SystemClockMillis() - nTime;
+  CLog::Log(LOGDEBUG, "%s - measured %u ms to extract %u of %u thumbs from file <%s>", __FUNCTION__,
+            nTotalTime, extracted, static_cast<unsigned int>(requests.size()), redactPath.c_str());
+  return extracted;
+}
+
 /**
  * \brief Open the item pointed to by pItem and extract streamdetails
  * \return true if the stream details have changed
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -28,6 +29,30 @@ public:
                            CStreamDetails *pStreamDetails,
                            int64_t pos);
 
+  struct ThumbRequest
+  {
+    int64_t pos; //!< position in ms
+    std::string url; //!< url the thumb is cached for in the texture cache
+    bool extracted = false; //!< set by ExtractThumbs
+  };
+
+  /*! \brief Called for every finished request, from the thread that decoded it.
+   Returns false to skip the requests that are not finished yet.
+   */
+  using ThumbCallback = std::function<bool(const ThumbRequest& request)>;
+
+  /*! \brief Extract thumbnails at several positions of the media referenced by fileItem.
+   The media is opened and demuxed once, the pictures are decoded and scaled in parallel
+   on job manager workers, on half of the cpus at most. Extracted thumbs are added to the
+   texture cache, failures are remembered as an empty cached file like with ExtractThumb.
+   \param requests the positions to extract, extracted is set for every successful request
+   \param callback optional, told about every request as soon as it is finished
+   \return number of thumbs extracted
+   */
+  static unsigned int ExtractThumbs(const CFileItem& fileItem,
+                                    std::vector<ThumbRequest>& requests,
+                                    const ThumbCallback& callback = nullptr);
+
   // Probe the files streams and store the info in the VideoInfoTag
   static bool GetFileStreamDetails(CFileItem *pItem);
   static bool DemuxerToStreamDetails(std::shared_ptr<CDVDInputStream> pInputStream, CDVDDemux *pDemux, CStreamDetails &details, const std::string &path = "");
@@ -15,7 +15,80 @@
 
 #include <math.h>
 
-CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
+namespace
+{
+// initial number of slots of the data lane, enough for a few seconds of
+// high bitrate video without growing
+constexpr size_t MSGQ_RING_CAPACITY = 1024;
+}
+
+CDVDMessageRing::CDVDMessageRing(size_t capacity) : m_slots(std::max<size_t>(capacity, 2), nullptr)
+{
+}
+
+CDVDMessageRing::~CDVDMessageRing()
+{
+  remove(CDVDMsg::NONE);
+}
+
+void CDVDMessageRing::push_front(CDVDMsg* msg)
+{
+  if (m_count == m_slots.size())
+    Grow();
+
+  m_slots[Index(m_count)] = msg;
+  m_count++;
+}
+
+void CDVDMessageRing::push_back(CDVDMsg* msg)
+{
+  if (m_count == m_slots.size())
+    Grow();
+
+  m_head = (m_head + m_slots.size() - 1) % m_slots.size();
+  m_slots[m_head] = msg;
+  m_count++;
+}
+
+CDVDMsg* CDVDMessageRing::pop_back()
+{
+  CDVDMsg* msg = m_slots[m_head];
+  m_slots[m_head] = nullptr;
+  m_head = (m_head + 1) % m_slots.size();
+  m_count--;
+  return msg;
+}
+
+void CDVDMessageRing::remove(CDVDMsg::Message type)
+{
+  // compact the remaining messages towards the back, keeping their order
+  size_t kept = 0;
+  for (size_t i = 0; i < m_count; i++)
+  {
+    CDVDMsg* msg = m_slots[Index(i)];
+    m_slots[Index(i)] = nullptr;
+    if (type == CDVDMsg::NONE || msg->IsType(type))
+      msg->Release();
+    else
+      m_slots[Index(kept++)] = msg;
+  }
+  m_count = kept;
+  if (m_count == 0)
+    m_head = 0;
+}
+
+void CDVDMessageRing::Grow()
+{
+  std::vector<CDVDMsg*> slots(m_slots.size() * 2, nullptr);
+  for (size_t i = 0; i < m_count; i++)
+    slots[i] = m_slots[Index(i)];
+
+  m_slots.swap(slots);
+  m_head = 0;
+}
+
+CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner),
+  m_messages(MSGQ_RING_CAPACITY)
 {
   m_iDataSize     = 0;
   m_bAbortRequest = false;
@@ -47,9 +120,7 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
 
-  m_messages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
-  });
+  m_messages.remove(type);
 
   m_prioMessages.remove_if([type](const DVDMessageListItem &item){
     return type == CDVDMsg::NONE || item.message->IsType(type);
@@ -132,9 +203,9 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
     }
 
     if (front)
-      m_messages.emplace_front(pMsg, priority);
+      m_messages.push_front(pMsg->Acquire());
     else
-      m_messages.emplace_back(pMsg, priority);
+      m_messages.push_back(pMsg->Acquire());
   }
 
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
@@ -174,29 +245,42 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
+    if (priority > 0 || !m_prioMessages.empty())
+    {
+      if (!m_prioMessages.empty() && (m_prioMessages.back().priority >= priority || m_drain))
+      {
+        DVDMessageListItem& item(m_prioMessages.back());
+        priority = item.priority;
 
-    if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
+        *pMsg = item.message->Acquire();
+        m_prioMessages.pop_back();
+        UpdateTimeBack();
+        ret = MSGQ_OK;
+        break;
+      }
+    }
+    else if (!m_messages.empty())
     {
-      DVDMessageListItem& item(msgs.back());
-      priority = item.priority;
+      // the data lane only holds messages with priority 0
+      CDVDMsg* msg = m_messages.pop_back();
+      priority = 0;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      if (msg->IsType(CDVDMsg::DEMUXER_PACKET))
       {
-        DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
+        DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
         if (packet)
         {
           m_iDataSize -= packet->iSize;
         }
       }
 
-      *pMsg = item.message->Acquire();
-      msgs.pop_back();
+      *pMsg = msg;
       UpdateTimeBack();
       ret = MSGQ_OK;
       break;
     }
-    else if (!iTimeoutInMilliSeconds)
+
+    if (!iTimeoutInMilliSeconds)
     {
       ret = MSGQ_TIMEOUT;
       break;
@@ -224,10 +308,10 @@ void CDVDMessageQueue::UpdateTimeFront()
 {
   if (!m_messages.empty())
   {
-    auto &item = m_messages.front();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+    CDVDMsg* msg = m_messages.front();
+    if (msg->IsType(CDVDMsg::DEMUXER_PACKET))
     {
-      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
+      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
       if (packet)
       {
         if (packet->dts != DVD_NOPTS_VALUE)
@@ -246,10 +330,10 @@ void CDVDMessageQueue::UpdateTimeBack()
 {
   if (!m_messages.empty())
   {
-    auto &item = m_messages.back();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+    CDVDMsg* msg = m_messages.back();
+    if (msg->IsType(CDVDMsg::DEMUXER_PACKET))
     {
-      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
+      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
       if (packet)
       {
         if (packet->dts != DVD_NOPTS_VALUE)
@@ -272,9 +356,9 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     return 0;
 
   unsigned count = 0;
-  for (const auto &item : m_messages)
+  for (size_t i = 0; i < m_messages.size(); i++)
   {
-    if(item.message->IsType(type))
+    if (m_messages.at(i)->IsType(type))
       count++;
   }
   for (const auto &item : m_prioMessages)
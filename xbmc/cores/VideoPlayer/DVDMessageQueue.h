@@ -16,6 +16,7 @@
 #include <atomic>
 #include <list>
 #include <string>
+#include <vector>
 
 struct DVDMessageListItem
 {
@@ -54,6 +55,56 @@ enum MsgQueueReturnCode
 
 #define MSGQ_IS_ERROR(c)    (c < 0)
 
+/**
+ * Bounded ring of message slots for the data lane of CDVDMessageQueue.
+ * Front is the most recently queued message, back is the next one to be
+ * returned. Slots are preallocated and reused, so queueing a packet does not
+ * allocate. The ring only grows when the queue holds more messages than it
+ * has slots, it never shrinks.
+ * Not thread safe, the owning queue serializes access.
+ */
+class CDVDMessageRing
+{
+public:
+  explicit CDVDMessageRing(size_t capacity);
+  ~CDVDMessageRing();
+
+  CDVDMessageRing(const CDVDMessageRing&) = delete;
+  CDVDMessageRing& operator=(const CDVDMessageRing&) = delete;
+
+  bool empty() const { return m_count == 0; }
+  size_t size() const { return m_count; }
+  size_t capacity() const { return m_slots.size(); }
+
+  CDVDMsg* front() const { return m_slots[Index(m_count - 1)]; }
+  CDVDMsg* back() const { return m_slots[m_head]; }
+  CDVDMsg* at(size_t i) const { return m_slots[Index(i)]; } // 0 is back
+
+  /**
+   * the ring takes over the reference held by the caller
+   */
+  void push_front(CDVDMsg* msg);
+  void push_back(CDVDMsg* msg);
+
+  /**
+   * returns the back message, ownership of the reference goes to the caller
+   */
+  CDVDMsg* pop_back();
+
+  /**
+   * releases all messages of the given type, NONE releases all
+   */
+  void remove(CDVDMsg::Message type);
+
+private:
+  size_t Index(size_t i) const { return (m_head + i) % m_slots.size(); }
+  void Grow();
+
+  std::vector<CDVDMsg*> m_slots;
+  size_t m_head = 0;
+  size_t m_count = 0;
+};
+
 class CDVDMessageQueue
 {
 public:
@@ -118,7 +169,7 @@ private:
   int m_iMaxDataSize;
   std::string m_owner;
 
-  std::list<DVDMessageListItem> m_messages;
+  CDVDMessageRing m_messages;
   std::list<DVDMessageListItem> m_prioMessages;
 };
 
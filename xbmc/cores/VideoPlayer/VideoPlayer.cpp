@@ -23,8 +23,10 @@
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
 #include "DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "DVDDemuxers/DemuxPacketPool.h"
 
 #include "DVDFileInfo.h"
+#include "VideoPlayerTracer.h"
 
 #include "utils/LangCodeExpander.h"
 #include "input/Key.h"
@@ -605,6 +607,7 @@ CVideoPlayer::CVideoPlayer(IPlayerCallback& callback)
   m_outboundEvents.reset(new CJobQueue(false, 1, CJob::PRIORITY_NORMAL));
   m_players_created = false;
   m_pDemuxer = nullptr;
+  m_packetPool = std::make_shared<CDemuxPacketPool>();
   m_pSubtitleDemuxer = nullptr;
   m_pCCDemuxer = nullptr;
   m_pInputStream = nullptr;
@@ -838,6 +841,8 @@ bool CVideoPlayer::OpenDemuxStream()
     return false;
   }
 
+  m_pDemuxer->SetPacketPool(m_packetPool);
+
   m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_DEMUX);
   m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NAV);
   m_SelectionStreams.Update(m_pInputStream, m_pDemuxer);
@@ -860,6 +865,12 @@ void CVideoPlayer::CloseDemuxer()
 {
   delete m_pDemuxer;
   m_pDemuxer = nullptr;
+
+  CDemuxPacketPool::Stats stats = m_packetPool->GetStats();
+  if (stats.hits || stats.misses || stats.oversized)
+    CLog::Log(LOGDEBUG, "CVideoPlayer::CloseDemuxer - packet pool: %" PRIu64 " hits, %" PRIu64
+              " misses, %" PRIu64 " oversized, %" PRIu64 " dropped, %" PRIu64 " bytes cached",
+              stats.hits, stats.misses, stats.oversized, stats.dropped, stats.cachedBytes);
   m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_DEMUX);
 
   CServiceBroker::GetDataCacheCore().SignalAudioInfoChange();
@@ -1307,6 +1318,12 @@ void CVideoPlayer::Process()
 {
   CServiceBroker::GetWinSystem()->RegisterRenderLoop(this);
 
+  if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoPlayerTrace)
+  {
+    CVideoPlayerTracer::GetInstance().Reset();
+    CVideoPlayerTracer::GetInstance().SetEnabled(true);
+  }
+
   Prepare();
 
   while (!m_bAbortRequest)
@@ -1415,7 +1432,10 @@ void CVideoPlayer::Process()
 
     DemuxPacket* pPacket = NULL;
     CDemuxStream *pStream = NULL;
-    ReadPacket(pPacket, pStream);
+    {
+      CVideoPlayerTraceScope trace(CVideoPlayerTracer::Stage::DEMUX_READ);
+      ReadPacket(pPacket, pStream);
+    }
     if (pPacket && !pStream)
     {
       /* probably a empty packet, just free it and move on */
@@ -2421,6 +2441,10 @@ void CVideoPlayer::OnExit()
 
   CServiceBroker::GetWinSystem()->UnregisterRenderLoop(this);
 
+  if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoPlayerTrace)
+    CVideoPlayerTracer::GetInstance().WriteChromeTrace("special://temp/videoplayer-trace.json");
+  CVideoPlayerTracer::GetInstance().SetEnabled(false);
+
   IPlayerCallback *cb = &m_callback;
   CVideoSettings vs = m_processInfo->GetVideoSettings();
   m_outboundEvents->Submit([=]() {
@@ -91,6 +91,7 @@ struct SPlayerState
 class CDVDInputStream;
 
 class CDVDDemux;
+class CDemuxPacketPool;
 class CDemuxStreamVideo;
 class CDemuxStreamAudio;
 class CStreamInfo;
@@ -497,6 +498,7 @@ protected:
 
   std::shared_ptr<CDVDInputStream> m_pInputStream;
   CDVDDemux* m_pDemuxer;
+  std::shared_ptr<CDemuxPacketPool> m_packetPool;
   std::shared_ptr<CDVDDemux> m_pSubtitleDemuxer;
   std::unordered_map<int64_t, std::shared_ptr<CDVDDemux>> m_subtitleDemuxerMap;
   CDVDDemuxCC* m_pCCDemuxer;
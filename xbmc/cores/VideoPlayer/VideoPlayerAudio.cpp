@@ -11,6 +11,7 @@
 #include "ServiceBroker.h"
 #include "DVDCodecs/Audio/DVDAudioCodec.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
+#include "VideoPlayerTracer.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
@@ -251,7 +252,11 @@ void CVideoPlayerAudio::Process()
       timeout = 0;
     }
 
-    MsgQueueReturnCode ret = m_messageQueue.Get(&pMsg, timeout, priority);
+    MsgQueueReturnCode ret;
+    {
+      CVideoPlayerTraceScope trace(CVideoPlayerTracer::Stage::AUDIO_QUEUE_WAIT);
+      ret = m_messageQueue.Get(&pMsg, timeout, priority);
+    }
 
     onlyPrioMsgs = false;
 
@@ -396,7 +401,12 @@ void CVideoPlayerAudio::Process()
         continue;
       }
 
-      if (!m_pAudioCodec->AddData(*pPacket))
+      bool added;
+      {
+        CVideoPlayerTraceScope trace(CVideoPlayerTracer::Stage::AUDIO_DECODE);
+        added = m_pAudioCodec->AddData(*pPacket);
+      }
+      if (!added)
       {
         m_messageQueue.PutBack(pMsg->Acquire());
         onlyPrioMsgs = true;
@@ -424,7 +434,10 @@ bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe)
   {
     audioframe.hasDownmix = false;
 
-    m_pAudioCodec->GetData(audioframe);
+    {
+      CVideoPlayerTraceScope trace(CVideoPlayerTracer::Stage::AUDIO_DECODE);
+      m_pAudioCodec->GetData(audioframe);
+    }
 
     if (audioframe.nb_frames == 0)
     {
@@ -0,0 +1,202 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoPlayerTracer.h"
+
+#include "filesystem/File.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+struct StageInfo
+{
+  const char* name; //!< event name in the trace
+  const char* label; //!< short label for the debug overlay
+  int thread; //!< trace thread the stage is shown on
+};
+
+const StageInfo stageInfo[] =
+{
+  { "demux read",        "dmx",  1 },
+  { "video queue wait",  "vq",   2 },
+  { "video decode",      "vdec", 2 },
+  { "render queue wait", "rq",   2 },
+  { "render present",    "pres", 3 },
+  { "audio queue wait",  "aq",   4 },
+  { "audio decode",      "adec", 4 },
+};
+
+static_assert(sizeof(stageInfo) / sizeof(stageInfo[0]) == static_cast<size_t>(CVideoPlayerTracer::Stage::COUNT),
+              "stageInfo does not match CVideoPlayerTracer::Stage");
+
+const char* threadNames[] = { "", "VideoPlayer", "VideoPlayerVideo", "RenderManager", "VideoPlayerAudio" };
+
+double Percentile(std::vector<int64_t>& values, double fraction)
+{
+  size_t index = static_cast<size_t>(fraction * (values.size() - 1));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index] / 1000.0;
+}
+}
+
+CVideoPlayerTracer& CVideoPlayerTracer::GetInstance()
+{
+  static CVideoPlayerTracer instance;
+  return instance;
+}
+
+void CVideoPlayerTracer::SetEnabled(bool enabled)
+{
+  if (m_enabled.exchange(enabled) != enabled)
+    CLog::Log(LOGDEBUG, "CVideoPlayerTracer::SetEnabled - tracing %s", enabled ? "enabled" : "disabled");
+}
+
+int64_t CVideoPlayerTracer::Now()
+{
+  return static_cast<int64_t>(static_cast<double>(CurrentHostCounter()) * 1000000.0 / CurrentHostFrequency());
+}
+
+void CVideoPlayerTracer::Record(Stage stage, int64_t start, int64_t end)
+{
+  if (!IsEnabled())
+    return;
+
+  const uint64_t index = m_head.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = m_ring[index & (RING_SIZE - 1)];
+
+  // readers ignore the slot until seq is set to the even value of this index
+  const uint64_t seq = index * 2 + 1;
+  slot.seq.store(seq, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.start.store(start, std::memory_order_relaxed);
+  slot.duration.store(end - start, std::memory_order_relaxed);
+  slot.stage.store(static_cast<uint8_t>(stage), std::memory_order_relaxed);
+  slot.seq.store(seq + 1, std::memory_order_release);
+}
+
+void CVideoPlayerTracer::Reset()
+{
+  m_first.store(m_head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+template<typename F>
+void CVideoPlayerTracer::ForEachSample(F&& func) const
+{
+  const uint64_t head = m_head.load(std::memory_order_acquire);
+  uint64_t first = std::max(m_first.load(std::memory_order_acquire), head > RING_SIZE ? head - RING_SIZE : 0);
+
+  for (uint64_t index = first; index < head; index++)
+  {
+    const Slot& slot = m_ring[index & (RING_SIZE - 1)];
+    const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq != index * 2 + 2)
+      continue; // still being written or already overwritten
+
+    Sample sample;
+    sample.start = slot.start.load(std::memory_order_relaxed);
+    sample.duration = slot.duration.load(std::memory_order_relaxed);
+    sample.stage = static_cast<Stage>(slot.stage.load(std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != seq)
+      continue;
+
+    func(sample);
+  }
+}
+
+std::string CVideoPlayerTracer::GetSummary() const
+{
+  std::vector<int64_t> durations[static_cast<size_t>(Stage::COUNT)];
+  ForEachSample([&durations](const Sample& sample) {
+    durations[static_cast<size_t>(sample.stage)].push_back(sample.duration);
+  });
+
+  std::string summary = "Trace ms p50/p95/p99:";
+  for (size_t i = 0; i < static_cast<size_t>(Stage::COUNT); i++)
+  {
+    std::vector<int64_t>& values = durations[i];
+    if (values.empty())
+      continue;
+
+    double p50 = Percentile(values, 0.5);
+    double p95 = Percentile(values, 0.95);
+    double p99 = Percentile(values, 0.99);
+    summary += StringUtils::Format(" %s %.1f/%.1f/%.1f", stageInfo[i].label, p50, p95, p99);
+  }
+  return summary;
+}
+
+std::string CVideoPlayerTracer::ExportChromeTrace() const
+{
+  CVariant events(CVariant::VariantTypeArray);
+
+  for (size_t i = 1; i < sizeof(threadNames) / sizeof(threadNames[0]); i++)
+  {
+    CVariant event(CVariant::VariantTypeObject);
+    event["name"] = "thread_name";
+    event["ph"] = "M";
+    event["pid"] = 1;
+    event["tid"] = static_cast<int>(i);
+    event["args"]["name"] = threadNames[i];
+    events.push_back(event);
+  }
+
+  ForEachSample([&events](const Sample& sample) {
+    const StageInfo& info = stageInfo[static_cast<size_t>(sample.stage)];
+    CVariant event(CVariant::VariantTypeObject);
+    event["name"] = info.name;
+    event["cat"] = "videoplayer";
+    event["ph"] = "X";
+    event["ts"] = sample.start;
+    event["dur"] = sample.duration;
+    event["pid"] = 1;
+    event["tid"] = info.thread;
+    events.push_back(event);
+  });
+
+  CVariant trace(CVariant::VariantTypeObject);
+  trace["traceEvents"] = events;
+  trace["displayTimeUnit"] = "ms";
+
+  std::string json;
+  if (!CJSONVariantWriter::Write(trace, json, true))
+    return "";
+  return json;
+}
+
+bool CVideoPlayerTracer::WriteChromeTrace(const std::string& path) const
+{
+  std::string json = ExportChromeTrace();
+  if (json.empty())
+    return false;
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) ||
+      file.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CVideoPlayerTracer::WriteChromeTrace - failed to write %s", path.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGNOTICE, "CVideoPlayerTracer::WriteChromeTrace - wrote trace to %s", path.c_str());
+  return true;
+}
+
+const char* CVideoPlayerTracer::GetStageName(Stage stage)
+{
+  if (stage >= Stage::COUNT)
+    return "";
+  return stageInfo[static_cast<size_t>(stage)].name;
+}
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+/*!
+ * \brief Low overhead timing of the VideoPlayer hot paths.
+ *
+ * The player threads record how long each stage of a frame took, from
+ * demuxing over decoding to presentation, into a fixed size ring. Recording is
+ * lock free and wait free, many threads may record at the same time, the
+ * oldest samples are overwritten. While disabled, recording costs a single
+ * relaxed atomic load.
+ *
+ * The samples can be exported in the Chrome trace event format, to be
+ * viewed in chrome://tracing or Perfetto, and summarized as percentiles for
+ * the debug overlay.
+ */
+class CVideoPlayerTracer
+{
+public:
+  enum class Stage : uint8_t
+  {
+    DEMUX_READ,        //!< CVideoPlayer reading a packet from the demuxer
+    VIDEO_QUEUE_WAIT,  //!< CVideoPlayerVideo waiting for a message
+    VIDEO_DECODE,      //!< CVideoPlayerVideo feeding and draining the decoder
+    RENDER_QUEUE_WAIT, //!< CVideoPlayerVideo waiting for a free render buffer
+    RENDER_PRESENT,    //!< CRenderManager presenting a frame
+    AUDIO_QUEUE_WAIT,  //!< CVideoPlayerAudio waiting for a message
+    AUDIO_DECODE,      //!< CVideoPlayerAudio feeding and draining the decoder
+    COUNT
+  };
+
+  static CVideoPlayerTracer& GetInstance();
+
+  void SetEnabled(bool enabled);
+  bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+  //! timestamp in microseconds for Record()
+  static int64_t Now();
+
+  /*!
+   * \brief Record a stage, does nothing while disabled
+   * \param start time the stage started, see Now()
+   * \param end time the stage ended, see Now()
+   */
+  void Record(Stage stage, int64_t start, int64_t end);
+
+  //! drop all samples
+  void Reset();
+
+  /*!
+   * \brief Percentiles of the recorded durations per stage, one line
+   */
+  std::string GetSummary() const;
+
+  /*!
+   * \brief The recorded samples as Chrome trace event JSON
+   */
+  std::string ExportChromeTrace() const;
+  bool WriteChromeTrace(const std::string& path) const;
+
+  static const char* GetStageName(Stage stage);
+
+private:
+  struct Sample
+  {
+    Stage stage;
+    int64_t start;
+    int64_t duration;
+  };
+
+  //! slot of the ring, seq is odd while a writer fills the slot
+  struct Slot
+  {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<int64_t> start{0};
+    std::atomic<int64_t> duration{0};
+    std::atomic<uint8_t> stage{0};
+  };
+
+  static const size_t RING_SIZE = 16384; //!< power of two
+
+  CVideoPlayerTracer() = default;
+  CVideoPlayerTracer(const CVideoPlayerTracer&) = delete;
+  CVideoPlayerTracer& operator=(const CVideoPlayerTracer&) = delete;
+
+  template<typename F>
+  void ForEachSample(F&& func) const;
+
+  std::atomic<bool> m_enabled{false};
+  std::atomic<uint64_t> m_head{0}; //!< number of samples recorded so far
+  std::atomic<uint64_t> m_first{0}; //!< first sample after the last Reset()
+  Slot m_ring[RING_SIZE];
+};
+
+/*!
+ * \brief Records the time from construction to destruction as a stage
+ */
+class CVideoPlayerTraceScope
+{
+public:
+  explicit CVideoPlayerTraceScope(CVideoPlayerTracer::Stage stage)
+    : m_stage(stage),
+      m_start(CVideoPlayerTracer::GetInstance().IsEnabled() ? CVideoPlayerTracer::Now() : -1)
+  {
+  }
+
+  ~CVideoPlayerTraceScope()
+  {
+    if (m_start >= 0)
+      CVideoPlayerTracer::GetInstance().Record(m_stage, m_start, CVideoPlayerTracer::Now());
+  }
+
+  CVideoPlayerTraceScope(const CVideoPlayerTraceScope&) = delete;
+  CVideoPlayerTraceScope& operator=(const CVideoPlayerTraceScope&) = delete;
+
+private:
+  const CVideoPlayerTracer::Stage m_stage;
+  const int64_t m_start;
+};
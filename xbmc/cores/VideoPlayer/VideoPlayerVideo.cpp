@@ -11,6 +11,7 @@
 #include "DVDCodecs/DVDCodecUtils.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "VideoPlayerTracer.h"
 #include "ServiceBroker.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
@@ -331,7 +332,11 @@ void CVideoPlayerVideo::Process()
     }
 
     CDVDMsg* pMsg;
-    MsgQueueReturnCode ret = GetMessage(&pMsg, iQueueTimeOut, iPriority);
+    MsgQueueReturnCode ret;
+    {
+      CVideoPlayerTraceScope trace(CVideoPlayerTracer::Stage::VIDEO_QUEUE_WAIT);
+      ret = GetMessage(&pMsg, iQueueTimeOut, iPriority);
+    }
 
     onlyPrioMsgs = false;
 
@@ -559,7 +564,12 @@ void CVideoPlayerVideo::Process()
         codecControl |= DVD_CODEC_CTRL_ROTATE;
       m_pVideoCodec->SetCodecControl(codecControl);
 
-      if (m_pVideoCodec->AddData(*pPacket))
+      bool added;
+      {
+        CVideoPlayerTraceScope trace(CVideoPlayerTracer::Stage::VIDEO_DECODE);
+        added = m_pVideoCodec->AddData(*pPacket);
+      }
+      if (added)
       {
         // buffer packets so we can recover should decoder flush for some reason
         if (m_pVideoCodec->GetConvergeCount() > 0)
@@ -591,7 +601,11 @@ void CVideoPlayerVideo::Process()
 
 bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
 {
-  CDVDVideoCodec::VCReturn decoderState = m_pVideoCodec->GetPicture(&m_picture);
+  CDVDVideoCodec::VCReturn decoderState;
+  {
+    CVideoPlayerTraceScope trace(CVideoPlayerTracer::Stage::VIDEO_DECODE);
+    decoderState = m_pVideoCodec->GetPicture(&m_picture);
+  }
 
   if (decoderState == CDVDVideoCodec::VC_BUFFER)
   {
@@ -909,7 +923,11 @@ CVideoPlayerVideo::EOutputState CVideoPlayerVideo::OutputPicture(const VideoPict
   // don't wait when going ff
   if (m_speed > DVD_PLAYSPEED_NORMAL)
     maxWaitTime = std::max(timeToDisplay, 0);
-  int buffer = m_renderManager.WaitForBuffer(m_bAbortOutput, maxWaitTime);
+  int buffer;
+  {
+    CVideoPlayerTraceScope trace(CVideoPlayerTracer::Stage::RENDER_QUEUE_WAIT);
+    buffer = m_renderManager.WaitForBuffer(m_bAbortOutput, maxWaitTime);
+  }
   if (buffer < 0)
   {
     return OUTPUT_AGAIN;
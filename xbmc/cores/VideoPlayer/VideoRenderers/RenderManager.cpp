@@ -10,6 +10,7 @@
 #include "RenderFlags.h"
 #include "RenderFactory.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "cores/VideoPlayer/VideoPlayerTracer.h"
 #include "windowing/GraphicContext.h"
 #include "utils/MathUtils.h"
 #include "threads/SingleLock.h"
@@ -701,6 +702,7 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 
   if (!gui || m_pRenderer->IsGuiLayer())
   {
+    CVideoPlayerTraceScope trace(CVideoPlayerTracer::Stage::RENDER_PRESENT);
     SPresent& m = m_Queue[m_presentsource];
 
     if( m.presentmethod == PRESENT_METHOD_BOB )
@@ -739,7 +741,11 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
                                      clockspeed * 100);
       }
 
-      m_debugRenderer.SetInfo(audio, video, player, vsync);
+      std::string trace;
+      if (CVideoPlayerTracer::GetInstance().IsEnabled())
+        trace = CVideoPlayerTracer::GetInstance().GetSummary();
+
+      m_debugRenderer.SetInfo(audio, video, player, vsync, trace);
       m_debugRenderer.Render(src, dst, view);
 
       m_debugTimer.Set(1000);
@@ -898,6 +904,13 @@ void CRenderManager::ToggleDebug()
 {
   m_renderDebug = !m_renderDebug;
   m_debugTimer.SetExpired();
+
+  // trace while the debug info is shown, it reports the percentiles
+  if (!CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoPlayerTrace)
+  {
+    CVideoPlayerTracer::GetInstance().Reset();
+    CVideoPlayerTracer::GetInstance().SetEnabled(m_renderDebug);
+  }
 }
 
 bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::atomic_bool& bStop, EINTERLACEMETHOD deintMethod, bool wait)
@@ -0,0 +1,192 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class TestDVDMessageRing : public ::testing::Test
+{
+protected:
+  // the test keeps a reference of its own to every message, so releases by the
+  // ring show in the reference count
+  std::vector<CDVDMsg*> m_messages;
+
+  void TearDown() override
+  {
+    for (CDVDMsg* msg : m_messages)
+      msg->Release();
+  }
+
+  CDVDMsg* Create(CDVDMsg::Message type = CDVDMsg::DEMUXER_PACKET)
+  {
+    CDVDMsg* msg = new CDVDMsg(type);
+    m_messages.push_back(msg);
+    return msg->Acquire();
+  }
+
+  static std::vector<CDVDMsg*> Contents(const CDVDMessageRing& ring)
+  {
+    std::vector<CDVDMsg*> contents;
+    for (size_t i = 0; i < ring.size(); i++)
+      contents.push_back(ring.at(i));
+    return contents;
+  }
+
+  static CDVDMsg* PopBack(CDVDMessageRing& ring)
+  {
+    CDVDMsg* msg = ring.pop_back();
+    msg->Release();
+    return msg;
+  }
+};
+
+TEST_F(TestDVDMessageRing, FifoAcrossWrapAround)
+{
+  CDVDMessageRing ring(4);
+
+  for (int i = 0; i < 3; i++)
+    ring.push_front(Create());
+  EXPECT_EQ(m_messages[0], PopBack(ring));
+  EXPECT_EQ(m_messages[1], PopBack(ring));
+
+  // these wrap around the end of the slots
+  for (int i = 0; i < 3; i++)
+    ring.push_front(Create());
+  EXPECT_EQ(4u, ring.size());
+  EXPECT_EQ(4u, ring.capacity());
+  EXPECT_EQ(m_messages[5], ring.front());
+  EXPECT_EQ(m_messages[2], ring.back());
+
+  for (int i = 2; i < 6; i++)
+    EXPECT_EQ(m_messages[i], PopBack(ring));
+  EXPECT_TRUE(ring.empty());
+
+  for (CDVDMsg* msg : m_messages)
+    EXPECT_EQ(1, msg->m_refs);
+}
+
+TEST_F(TestDVDMessageRing, PushBackIsReturnedFirst)
+{
+  CDVDMessageRing ring(4);
+
+  ring.push_front(Create());
+  ring.push_front(Create());
+  EXPECT_EQ(m_messages[0], PopBack(ring));
+
+  // a message that was put back goes before the queued ones
+  ring.push_back(Create());
+  ring.push_back(Create());
+  EXPECT_EQ(std::vector<CDVDMsg*>({m_messages[3], m_messages[2], m_messages[1]}), Contents(ring));
+}
+
+TEST_F(TestDVDMessageRing, GrowWhileWrapped)
+{
+  CDVDMessageRing ring(4);
+
+  for (int i = 0; i < 3; i++)
+    ring.push_front(Create());
+  PopBack(ring);
+  PopBack(ring);
+  for (int i = 0; i < 3; i++)
+    ring.push_front(Create());
+  ASSERT_EQ(ring.capacity(), ring.size());
+
+  // full and wrapped, both ends grow the ring
+  ring.push_front(Create());
+  EXPECT_EQ(8u, ring.capacity());
+  ring.push_back(Create());
+
+  EXPECT_EQ(std::vector<CDVDMsg*>({m_messages[7], m_messages[2], m_messages[3], m_messages[4],
+                                   m_messages[5], m_messages[6]}),
+            Contents(ring));
+  EXPECT_EQ(m_messages[6], ring.front());
+  EXPECT_EQ(m_messages[7], ring.back());
+
+  for (int i = 0; i < 4; i++)
+    ring.push_front(Create());
+  EXPECT_EQ(16u, ring.capacity());
+  EXPECT_EQ(10u, ring.size());
+  EXPECT_EQ(m_messages[7], PopBack(ring));
+  for (int i = 2; i < 7; i++)
+    EXPECT_EQ(m_messages[i], PopBack(ring));
+  for (int i = 8; i < 12; i++)
+    EXPECT_EQ(m_messages[i], PopBack(ring));
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST_F(TestDVDMessageRing, RemoveTypeKeepsOrder)
+{
+  CDVDMessageRing ring(4);
+
+  // start wrapped so the compaction crosses the end of the slots
+  ring.push_front(Create(CDVDMsg::GENERAL_RESYNC));
+  ring.push_front(Create(CDVDMsg::GENERAL_RESYNC));
+  PopBack(ring);
+  PopBack(ring);
+
+  ring.push_front(Create(CDVDMsg::DEMUXER_PACKET));
+  ring.push_front(Create(CDVDMsg::GENERAL_RESET));
+  ring.push_front(Create(CDVDMsg::DEMUXER_PACKET));
+  ring.push_front(Create(CDVDMsg::GENERAL_EOF));
+  ASSERT_EQ(4u, ring.capacity());
+
+  ring.remove(CDVDMsg::DEMUXER_PACKET);
+
+  EXPECT_EQ(std::vector<CDVDMsg*>({m_messages[3], m_messages[5]}), Contents(ring));
+  EXPECT_EQ(m_messages[5], ring.front());
+  EXPECT_EQ(m_messages[3], ring.back());
+  EXPECT_EQ(1, m_messages[2]->m_refs);
+  EXPECT_EQ(2, m_messages[3]->m_refs);
+  EXPECT_EQ(1, m_messages[4]->m_refs);
+  EXPECT_EQ(2, m_messages[5]->m_refs);
+
+  // the ring stays usable after the compaction
+  ring.push_front(Create(CDVDMsg::DEMUXER_PACKET));
+  ring.push_back(Create(CDVDMsg::GENERAL_RESYNC));
+  EXPECT_EQ(m_messages[7], PopBack(ring));
+  EXPECT_EQ(m_messages[3], PopBack(ring));
+  EXPECT_EQ(m_messages[5], PopBack(ring));
+  EXPECT_EQ(m_messages[6], PopBack(ring));
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST_F(TestDVDMessageRing, RemoveNoneReleasesAll)
+{
+  CDVDMessageRing ring(4);
+
+  ring.push_front(Create(CDVDMsg::DEMUXER_PACKET));
+  PopBack(ring);
+  for (int i = 0; i < 6; i++)
+    ring.push_front(Create(i % 2 ? CDVDMsg::DEMUXER_PACKET : CDVDMsg::GENERAL_RESYNC));
+
+  ring.remove(CDVDMsg::NONE);
+
+  EXPECT_TRUE(ring.empty());
+  for (CDVDMsg* msg : m_messages)
+    EXPECT_EQ(1, msg->m_refs);
+
+  ring.push_front(Create());
+  EXPECT_EQ(m_messages.back(), ring.back());
+}
+
+TEST_F(TestDVDMessageRing, DestructorReleasesAll)
+{
+  {
+    CDVDMessageRing ring(2);
+    for (int i = 0; i < 5; i++)
+      ring.push_front(Create());
+    PopBack(ring);
+    ring.push_back(Create());
+  }
+
+  for (CDVDMsg* msg : m_messages)
+    EXPECT_EQ(1, msg->m_refs);
+}
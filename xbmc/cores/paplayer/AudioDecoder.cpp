@@ -13,12 +13,25 @@
 #include "FileItem.h"
 #include "ServiceBroker.h"
 #include "music/tags/MusicInfoTag.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <math.h>
+#include <vector>
+
+namespace
+{
+// released pcm buffers kept for the next tracks, enough for the current,
+// the queued and a crossfading stream
+const size_t PCM_BUFFER_POOL_SIZE = 3;
+
+CCriticalSection pcmBufferPoolSection;
+std::vector<std::unique_ptr<CRingBuffer>> pcmBufferPool;
+}
 
 CAudioDecoder::CAudioDecoder()
 {
@@ -48,7 +61,8 @@ void CAudioDecoder::Destroy()
   CSingleLock lock(m_critSection);
   m_status = STATUS_NO_FILE;
 
-  m_pcmBuffer.Destroy();
+  if (m_pcmBuffer)
+    ReleaseBuffer(std::move(m_pcmBuffer));
 
   if ( m_codec )
     delete m_codec;
@@ -61,11 +75,6 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
 {
   Destroy();
 
-  CSingleLock lock(m_critSection);
-
-  // reset our playback timing variables
-  m_eof = false;
-
   // get correct cache size
   const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
   unsigned int filecache = settings->GetInt(CSettings::SETTING_CACHEAUDIO_INTERNET);
@@ -77,14 +86,29 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     filecache = settings->GetInt(CSettings::SETTING_CACHEAUDIO_LAN);
 
   // create our codec
-  m_codec=CodecFactory::CreateCodecDemux(file, filecache * 1024);
+  ICodec* codec = CodecFactory::CreateCodecDemux(file, filecache * 1024);
 
-  if (!m_codec || !m_codec->Init(file, filecache * 1024))
+  if (!codec || !codec->Init(file, filecache * 1024))
   {
     CLog::Log(LOGERROR, "CAudioDecoder: Unable to Init Codec while loading file %s", file.GetDynPath().c_str());
+    delete codec;
     Destroy();
     return false;
   }
+
+  return Create(codec, file, seekOffset);
+}
+
+bool CAudioDecoder::Create(ICodec* codec, const CFileItem &file, int64_t seekOffset)
+{
+  Destroy();
+
+  CSingleLock lock(m_critSection);
+
+  // reset our playback timing variables
+  m_eof = false;
+
+  m_codec = codec;
   unsigned int blockSize = (m_codec->m_bitsPerSample >> 3) * m_codec->m_format.m_channelLayout.Count();
 
   if (blockSize == 0)
@@ -94,8 +118,16 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_format.m_sampleRate);
+  // allocate the pcmBuffer for the decode-ahead window
+  const unsigned int decodeAhead = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioDecodeAheadTime;
+  const uint64_t frames = static_cast<uint64_t>(m_codec->m_format.m_sampleRate) * decodeAhead / 1000;
+  m_pcmBuffer = AcquireBuffer(blockSize * static_cast<unsigned int>(frames));
+  if (!m_pcmBuffer)
+  {
+    CLog::Log(LOGERROR, "CAudioDecoder: Unable to allocate a pcm buffer of %u ms", decodeAhead);
+    Destroy();
+    return false;
+  }
 
   if (file.HasMusicInfoTag())
   {
@@ -142,7 +174,8 @@ AEAudioFormat CAudioDecoder::GetFormat()
 
 int64_t CAudioDecoder::Seek(int64_t time)
 {
-  m_pcmBuffer.Clear();
+  if (m_pcmBuffer)
+    m_pcmBuffer->Clear();
   m_rawBufferSize = 0;
   if (!m_codec)
     return 0;
@@ -164,7 +197,7 @@ int64_t CAudioDecoder::TotalTime()
   return 0;
 }
 
-unsigned int CAudioDecoder::GetDataSize(bool checkPktSize)
+unsigned int CAudioDecoder::GetDataSize()
 {
   if (m_status == STATUS_QUEUING || m_status == STATUS_NO_FILE)
     return 0;
@@ -174,12 +207,10 @@ unsigned int CAudioDecoder::GetDataSize(bool checkPktSize)
     // check for end of file and end of buffer
     if (m_status == STATUS_ENDING)
     {
-      if (m_pcmBuffer.getMaxReadSize() == 0)
-        m_status = STATUS_ENDED;
-      else if (checkPktSize && m_pcmBuffer.getMaxReadSize() < PACKET_SIZE)
+      if (m_pcmBuffer->getMaxReadSize() == 0)
         m_status = STATUS_ENDED;
     }
-    return std::min(m_pcmBuffer.getMaxReadSize() / (m_codec->m_bitsPerSample >> 3), (unsigned int)OUTPUT_SAMPLES);
+    return std::min(m_pcmBuffer->getMaxReadSize() / (m_codec->m_bitsPerSample >> 3), (unsigned int)OUTPUT_SAMPLES);
   }
   else
   {
@@ -198,15 +229,15 @@ void *CAudioDecoder::GetData(unsigned int samples)
     return NULL;
   }
 
-  if (size > m_pcmBuffer.getMaxReadSize())
+  if (size > m_pcmBuffer->getMaxReadSize())
   {
-    CLog::Log(LOGWARNING, "CAudioDecoder::GetData() more bytes/samples (%i) requested than we have to give (%i)!", size, m_pcmBuffer.getMaxReadSize());
-    size = m_pcmBuffer.getMaxReadSize();
+    CLog::Log(LOGWARNING, "CAudioDecoder::GetData() more bytes/samples (%i) requested than we have to give (%i)!", size, m_pcmBuffer->getMaxReadSize());
+    size = m_pcmBuffer->getMaxReadSize();
   }
 
-  if (m_pcmBuffer.ReadData((char *)m_outputBuffer, size))
+  if (m_pcmBuffer->ReadData((char *)m_outputBuffer, size))
   {
-    if (m_status == STATUS_ENDING && m_pcmBuffer.getMaxReadSize() == 0)
+    if (m_status == STATUS_ENDING && m_pcmBuffer->getMaxReadSize() == 0)
       m_status = STATUS_ENDED;
 
     return m_outputBuffer;
@@ -216,6 +247,19 @@ void *CAudioDecoder::GetData(unsigned int samples)
   return NULL;
 }
 
+unsigned int CAudioDecoder::GetBufferedTime()
+{
+  CSingleLock lock(m_critSection);
+  if (!m_codec || !m_pcmBuffer || m_codec->m_format.m_dataFormat == AE_FMT_RAW)
+    return 0;
+
+  unsigned int blockSize = (m_codec->m_bitsPerSample >> 3) * m_codec->m_format.m_channelLayout.Count();
+  if (blockSize == 0 || m_codec->m_format.m_sampleRate == 0)
+    return 0;
+
+  return static_cast<unsigned int>(static_cast<uint64_t>(m_pcmBuffer->getMaxReadSize() / blockSize) * 1000 / m_codec->m_format.m_sampleRate);
+}
+
 uint8_t *CAudioDecoder::GetRawData(int &size)
 {
   if (m_status == STATUS_ENDING)
@@ -245,7 +289,7 @@ int CAudioDecoder::ReadSamples(int numsamples)
   if (m_codec->m_format.m_dataFormat != AE_FMT_RAW)
   {
     // Read in more data
-    int maxsize = std::min<int>(INPUT_SAMPLES, m_pcmBuffer.getMaxWriteSize() / (m_codec->m_bitsPerSample >> 3));
+    int maxsize = std::min<int>(INPUT_SAMPLES, m_pcmBuffer->getMaxWriteSize() / (m_codec->m_bitsPerSample >> 3));
     numsamples = std::min<int>(numsamples, maxsize);
     numsamples -= (numsamples % GetFormat().m_channelLayout.Count());  // make sure it's divisible by our number of channels
     if (numsamples)
@@ -256,10 +300,10 @@ int CAudioDecoder::ReadSamples(int numsamples)
       if (result != READ_ERROR && readSize)
       {
         // move it into our buffer
-        m_pcmBuffer.WriteData((char *)m_pcmInputBuffer, readSize);
+        m_pcmBuffer->WriteData((char *)m_pcmInputBuffer, readSize);
 
         // update status
-        if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() > m_pcmBuffer.getSize() * 0.9)
+        if (m_status == STATUS_QUEUING && m_pcmBuffer->getMaxReadSize() > m_pcmBuffer->getSize() * 0.9)
         {
           CLog::Log(LOGINFO, "AudioDecoder: File is queued");
           m_status = STATUS_QUEUED;
@@ -322,6 +366,46 @@ int CAudioDecoder::ReadSamples(int numsamples)
   return RET_SLEEP; // nothing to do
 }
 
+std::unique_ptr<CRingBuffer> CAudioDecoder::AcquireBuffer(unsigned int size)
+{
+  std::unique_ptr<CRingBuffer> buffer;
+  {
+    CSingleLock lock(pcmBufferPoolSection);
+    if (!pcmBufferPool.empty())
+    {
+      // tracks of an album usually share their format, prefer a buffer that fits
+      auto it = std::find_if(pcmBufferPool.begin(), pcmBufferPool.end(),
+                             [size](const std::unique_ptr<CRingBuffer>& buf) { return buf->getSize() == size; });
+      if (it == pcmBufferPool.end())
+        it = pcmBufferPool.begin();
+      buffer = std::move(*it);
+      pcmBufferPool.erase(it);
+    }
+  }
+
+  if (buffer && buffer->getSize() == size)
+    return buffer;
+
+  if (!buffer)
+    buffer.reset(new CRingBuffer()); // C++14 - Replace with std::make_unique
+  else
+    buffer->Destroy();
+
+  if (!buffer->Create(size))
+    return nullptr;
+
+  return buffer;
+}
+
+void CAudioDecoder::ReleaseBuffer(std::unique_ptr<CRingBuffer> buffer)
+{
+  buffer->Clear();
+
+  CSingleLock lock(pcmBufferPoolSection);
+  if (pcmBufferPool.size() < PCM_BUFFER_POOL_SIZE)
+    pcmBufferPool.push_back(std::move(buffer));
+}
+
 float CAudioDecoder::GetReplayGain(float &peakVal)
 {
 #define REPLAY_GAIN_DEFAULT_LEVEL 89.0f
@@ -13,9 +13,11 @@
 #include "threads/CriticalSection.h"
 #include "utils/RingBuffer.h"
 
+#include <memory>
+
 class CFileItem;
 
-#define PACKET_SIZE 3840    // audio packet size - we keep 1 in reserve for gapless playback
+#define PACKET_SIZE 3840    // audio packet size
                             // using a multiple of 1, 2, 3, 4, 5, 6 to guarantee track alignment
                             // note that 7 or higher channels won't work too well.
 
@@ -44,6 +46,11 @@ public:
   ~CAudioDecoder();
 
   bool Create(const CFileItem &file, int64_t seekOffset);
+
+  /*! \brief Decode from an initialized codec, takes ownership of it
+   */
+  bool Create(ICodec* codec, const CFileItem &file, int64_t seekOffset);
+
   void Destroy();
 
   int ReadSamples(int numsamples);
@@ -59,15 +66,27 @@ public:
   AEAudioFormat GetFormat();
   unsigned int GetChannels() { return GetFormat().m_channelLayout.Count(); }
   // Data management
-  unsigned int GetDataSize(bool checkPktSize);
+  unsigned int GetDataSize();
   void *GetData(unsigned int samples);
   uint8_t* GetRawData(int &size);
   ICodec *GetCodec() const { return m_codec; }
   float GetReplayGain(float &peakVal);
 
+  /*! \brief Time of audio decoded ahead in ms
+   */
+  unsigned int GetBufferedTime();
+
 private:
-  // pcm buffer
-  CRingBuffer m_pcmBuffer;
+  /*! \brief Get a pcm buffer of the given size, reusing a released one if possible
+   */
+  static std::unique_ptr<CRingBuffer> AcquireBuffer(unsigned int size);
+
+  /*! \brief Return a pcm buffer to the pool
+   */
+  static void ReleaseBuffer(std::unique_ptr<CRingBuffer> buffer);
+
+  // pcm buffer, holds the decode-ahead window
+  std::unique_ptr<CRingBuffer> m_pcmBuffer;
 
   // output buffer (for transferring data from the Pcm Buffer to the rest of the audio chain)
   float m_outputBuffer[OUTPUT_SAMPLES];
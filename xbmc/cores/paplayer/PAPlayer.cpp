@@ -26,6 +26,7 @@
 #include "video/Bookmark.h"
 
 #define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
+#define TIME_TO_OPEN_NEXT_FILE  3000 /* time left to open the next song on top of its decode-ahead window */
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
 #define MAX_SKIP_XFADE_TIME     2000 /* max 2 seconds crossfade on track skip */
 
@@ -333,9 +334,9 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
     return false;
   }
 
-  /* decode until there is data-available */
+  /* decode ahead, the decoder holds back data until its window is filled */
   si->m_decoder.Start();
-  while (si->m_decoder.GetDataSize(true) == 0)
+  while (si->m_decoder.GetDataSize() == 0)
   {
     int status = si->m_decoder.GetStatus();
     if (status == STATUS_ENDED   ||
@@ -356,6 +357,8 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
     CThread::Sleep(1);
   }
 
+  CLog::Log(LOGDEBUG, "PAPlayer::QueueNextFileEx - Decoded %u ms ahead", si->m_decoder.GetBufferedTime());
+
   // set m_upcomingCrossfadeMS depending on type of file and user settings
   UpdateCrossfadeTime(si->m_fileItem);
 
@@ -386,10 +389,7 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   si->m_prepareNextAtFrame = 0;
   // cd drives don't really like it to be crossfaded or prepared
   if(!file.IsCDDA())
-  {
-    if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-      si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
-  }
+    UpdateStreamInfoPrepareNextAtFrame(si, streamTotalTime);
 
   if (m_currentStream && ((m_currentStream->m_audioFormat.m_dataFormat == AE_FMT_RAW) || (si->m_audioFormat.m_dataFormat == AE_FMT_RAW)))
   {
@@ -427,6 +427,17 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   return true;
 }
 
+void PAPlayer::UpdateStreamInfoPrepareNextAtFrame(StreamInfo *si, int64_t streamTotalTime)
+{
+  // the next song has to be opened and fill its whole decode-ahead window
+  // before this one drains, so start early enough for larger windows
+  const int64_t decodeAhead = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioDecodeAheadTime;
+  const int64_t prepareTime = std::max<int64_t>(TIME_TO_CACHE_NEXT_FILE, decodeAhead + TIME_TO_OPEN_NEXT_FILE);
+
+  if (streamTotalTime >= prepareTime + m_defaultCrossfadeMS)
+    si->m_prepareNextAtFrame = (int)((streamTotalTime - prepareTime - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
+}
+
 void PAPlayer::UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime)
 {
   // if no crossfading or cue sheet, wait for eof
@@ -786,8 +797,7 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
 
       // calculate time when to prepare next stream
       si->m_prepareNextAtFrame = 0;
-      if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-        si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
+      UpdateStreamInfoPrepareNextAtFrame(si, streamTotalTime);
 
       si->m_prepareTriggered = false;
       si->m_playNextAtFrame = 0;
@@ -839,7 +849,7 @@ bool PAPlayer::QueueData(StreamInfo *si)
 
   if (si->m_audioFormat.m_dataFormat != AE_FMT_RAW)
   {
-    unsigned int samples = std::min(si->m_decoder.GetDataSize(false), space / si->m_bytesPerSample);
+    unsigned int samples = std::min(si->m_decoder.GetDataSize(), space / si->m_bytesPerSample);
     if (!samples)
       return true;
 
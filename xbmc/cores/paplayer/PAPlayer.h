@@ -141,6 +141,7 @@ private:
   bool QueueData(StreamInfo *si);
   int64_t GetTotalTime64();
   void UpdateCrossfadeTime(const CFileItem& file);
+  void UpdateStreamInfoPrepareNextAtFrame(StreamInfo *si, int64_t streamTotalTime);
   void UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime);
   void UpdateGUIData(StreamInfo *si);
   int64_t GetTimeInternal();
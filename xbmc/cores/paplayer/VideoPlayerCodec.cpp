@@ -529,12 +529,17 @@ CAEStreamInfo::DataType VideoPlayerCodec::GetPassthroughStreamType(AVCodecID cod
       format.m_streamInfo.m_type = CAEStreamInfo::STREAM_TYPE_NULL;
   }
 
-  bool supports = CServiceBroker::GetActiveAE()->SupportsRaw(format);
+  // without an engine, e.g. when analysing files, there is no passthrough
+  IAE* ae = CServiceBroker::GetActiveAE();
+  if (!ae)
+    return CAEStreamInfo::DataType::STREAM_TYPE_NULL;
+
+  bool supports = ae->SupportsRaw(format);
 
   if (!supports && codecId == AV_CODEC_ID_DTS)
   {
     format.m_streamInfo.m_type = CAEStreamInfo::STREAM_TYPE_DTSHD_CORE;
-    supports = CServiceBroker::GetActiveAE()->SupportsRaw(format);
+    supports = ae->SupportsRaw(format);
   }
 
   if (supports)
@@ -0,0 +1,242 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "cores/paplayer/AudioDecoder.h"
+#include "cores/paplayer/ICodec.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const unsigned int SAMPLE_RATE = 48000;
+const unsigned int CHANNELS = 2;
+
+/* Codec producing a ramp that identifies every sample of every track, handed
+ * out in chunks that don't line up with the decoder's packets.
+ */
+class CRampCodec : public ICodec
+{
+public:
+  CRampCodec(unsigned int track, unsigned int frames) : m_track(track), m_frames(frames)
+  {
+    m_format.m_dataFormat = AE_FMT_FLOAT;
+    m_format.m_sampleRate = SAMPLE_RATE;
+    m_format.m_channelLayout = AE_CH_LAYOUT_2_0;
+    m_bitsPerSample = 32;
+    m_TotalTime = static_cast<int64_t>(frames) * 1000 / SAMPLE_RATE;
+  }
+
+  bool Init(const CFileItem& file, unsigned int filecache) override { return true; }
+  bool CanInit() override { return true; }
+
+  bool Seek(int64_t iSeekTime) override
+  {
+    m_position = std::min(static_cast<unsigned int>(iSeekTime * SAMPLE_RATE / 1000), m_frames);
+    return true;
+  }
+
+  int ReadPCM(unsigned char* pBuffer, int size, int* actualsize) override
+  {
+    *actualsize = 0;
+    if (m_position == m_frames)
+      return READ_EOF;
+
+    unsigned int frames = std::min<unsigned int>(size / (CHANNELS * sizeof(float)), m_frames - m_position);
+    frames = std::min(frames, 1001u);
+    float* samples = reinterpret_cast<float*>(pBuffer);
+    for (unsigned int i = 0; i < frames * CHANNELS; i++)
+      samples[i] = Sample(m_track, m_position * CHANNELS + i);
+    m_position += frames;
+    *actualsize = frames * CHANNELS * sizeof(float);
+    return READ_SUCCESS;
+  }
+
+  static float Sample(unsigned int track, unsigned int index)
+  {
+    return static_cast<float>((track + 1) * 1000000 + index);
+  }
+
+private:
+  unsigned int m_track;
+  unsigned int m_frames;
+  unsigned int m_position = 0;
+};
+
+class TestAudioDecoder : public ::testing::Test
+{
+protected:
+  TestAudioDecoder()
+  {
+    m_advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    m_decodeAheadTime = m_advancedSettings->m_audioDecodeAheadTime;
+  }
+
+  ~TestAudioDecoder() override { m_advancedSettings->m_audioDecodeAheadTime = m_decodeAheadTime; }
+
+  bool Queue(CAudioDecoder& decoder, unsigned int track, unsigned int frames)
+  {
+    if (!decoder.Create(new CRampCodec(track, frames), CFileItem("ramp.pcm", false), 0))
+      return false;
+
+    // like PAPlayer::QueueNextFileEx
+    decoder.Start();
+    while (decoder.GetDataSize() == 0)
+    {
+      int status = decoder.GetStatus();
+      if (status == STATUS_ENDED || status == STATUS_NO_FILE ||
+          decoder.ReadSamples(PACKET_SIZE) == RET_ERROR)
+        return false;
+    }
+    return true;
+  }
+
+  //! the stream accepts a varying amount of data, like an AE stream does
+  unsigned int Space()
+  {
+    static const unsigned int spaces[] = {1, 7, 480, 1024, 4095, 64, 2};
+    m_spaceIndex = (m_spaceIndex + 1) % (sizeof(spaces) / sizeof(spaces[0]));
+    return spaces[m_spaceIndex] * CHANNELS;
+  }
+
+  //! like PAPlayer::QueueData, returns false once the decoder has finished
+  bool Feed(CAudioDecoder& decoder, std::vector<float>& output)
+  {
+    int status = decoder.GetStatus();
+    if (status == STATUS_ENDED || status == STATUS_NO_FILE ||
+        decoder.ReadSamples(PACKET_SIZE) == RET_ERROR)
+      return false;
+
+    unsigned int samples = std::min(decoder.GetDataSize(), Space());
+    samples -= samples % CHANNELS;
+    if (!samples)
+      return true;
+
+    float* data = static_cast<float*>(decoder.GetData(samples));
+    if (!data)
+      return false;
+
+    output.insert(output.end(), data, data + samples);
+    return true;
+  }
+
+  static void Expect(std::vector<float>& expected, unsigned int track, unsigned int frames)
+  {
+    for (unsigned int i = 0; i < frames * CHANNELS; i++)
+      expected.push_back(CRampCodec::Sample(track, i));
+  }
+
+  static void ExpectEqual(const std::vector<float>& expected, const std::vector<float>& output)
+  {
+    ASSERT_EQ(expected.size(), output.size());
+    auto mismatch = std::mismatch(expected.begin(), expected.end(), output.begin());
+    EXPECT_TRUE(mismatch.first == expected.end())
+        << "first wrong sample at " << (mismatch.first - expected.begin());
+  }
+
+  std::shared_ptr<CAdvancedSettings> m_advancedSettings;
+  int m_decodeAheadTime;
+  unsigned int m_spaceIndex = 0;
+};
+}
+
+/* Plays a few tracks back to back, the next one decoded ahead while the
+ * current one plays, and checks that not a sample is lost or repeated at
+ * the joins. The second track is shorter than a packet.
+ */
+TEST_F(TestAudioDecoder, GaplessJoin)
+{
+  const unsigned int frames[] = {30011, 100, 12000, 48000};
+  const unsigned int tracks = sizeof(frames) / sizeof(frames[0]);
+
+  for (int decodeAhead : {500, 2000})
+  {
+    m_advancedSettings->m_audioDecodeAheadTime = decodeAhead;
+
+    std::vector<float> expected;
+    for (unsigned int track = 0; track < tracks; track++)
+      Expect(expected, track, frames[track]);
+
+    CAudioDecoder decoders[2];
+    ASSERT_TRUE(Queue(decoders[0], 0, frames[0]));
+
+    std::vector<float> output;
+    unsigned int current = 0;
+    unsigned int next = 0;
+    while (current < tracks)
+    {
+      CAudioDecoder& decoder = decoders[current % 2];
+      if (next == current && next + 1 < tracks)
+      {
+        next++;
+        ASSERT_TRUE(Queue(decoders[next % 2], next, frames[next]));
+      }
+      else if (next != current)
+      {
+        // the queued track keeps decoding ahead while waiting
+        decoders[next % 2].ReadSamples(PACKET_SIZE);
+      }
+
+      if (!Feed(decoder, output))
+      {
+        decoder.Destroy();
+        current++;
+      }
+    }
+
+    ExpectEqual(expected, output);
+  }
+}
+
+/* A pcm buffer handed back to the pool still holds decoded audio of the old
+ * track, none of it may leak into the next one.
+ */
+TEST_F(TestAudioDecoder, PooledBufferReuse)
+{
+  m_advancedSettings->m_audioDecodeAheadTime = 500;
+
+  CAudioDecoder decoder;
+  ASSERT_TRUE(Queue(decoder, 0, SAMPLE_RATE));
+  EXPECT_GT(decoder.GetBufferedTime(), 0u);
+  decoder.Destroy();
+
+  std::vector<float> expected;
+  Expect(expected, 1, 20000);
+
+  ASSERT_TRUE(Queue(decoder, 1, 20000));
+  std::vector<float> output;
+  while (Feed(decoder, output))
+    ;
+
+  ExpectEqual(expected, output);
+}
+
+/* The next track is decoded ahead by the configured window before it is
+ * handed to the engine.
+ */
+TEST_F(TestAudioDecoder, DecodeAheadWindow)
+{
+  for (int decodeAhead : {500, 3000})
+  {
+    m_advancedSettings->m_audioDecodeAheadTime = decodeAhead;
+
+    CAudioDecoder decoder;
+    ASSERT_TRUE(Queue(decoder, 0, 10 * SAMPLE_RATE));
+
+    unsigned int buffered = decoder.GetBufferedTime();
+    EXPECT_GE(buffered, decodeAhead * 9u / 10);
+    EXPECT_LE(buffered, static_cast<unsigned int>(decodeAhead));
+  }
+}
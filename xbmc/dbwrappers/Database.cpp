@@ -11,6 +11,7 @@
 #include "filesystem/SpecialProtocol.h"
 #include "profiles/ProfileManager.h"
 #include "settings/SettingsComponent.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
@@ -27,9 +28,12 @@
 #include "platform/posix/ConvUtils.h"
 #endif
 
+#include <algorithm>
+
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
+#define MAX_ROWS_PER_INSERT 200
 
 void CDatabase::Filter::AppendField(const std::string &strField)
 {
@@ -221,6 +225,13 @@ CDatabase::CDatabase() :
   m_sqlite = true;
   m_bMultiWrite = false;
   m_multipleExecute = false;
+  m_readOnly = false;
+  m_pooled = false;
+  m_batchSize = 0;
+  m_batchItems = 0;
+  m_batchStart = 0;
+  m_savepoints = 0;
+  m_failedSavepoint = -1;
 }
 
 CDatabase::~CDatabase(void)
@@ -278,6 +289,28 @@ std::string CDatabase::GetSingleValue(const std::string &query, std::unique_ptr<
   return ret;
 }
 
+std::string CDatabase::GetSingleValue(const std::string &query,
+                                      const std::vector<field_value> &params,
+                                      std::unique_ptr<Dataset> &ds)
+{
+  std::string ret;
+  try
+  {
+    if (!m_pDB || !ds)
+      return ret;
+
+    if (ds->query_prepared(query, params) && ds->num_rows() > 0)
+      ret = ds->fv(0).get_asString();
+
+    ds->close();
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - failed on query '%s'", __FUNCTION__, query.c_str());
+  }
+  return ret;
+}
+
 std::string CDatabase::GetSingleValue(const std::string &strTable, const std::string &strColumn, const std::string &strWhereClause /* = std::string() */, const std::string &strOrderBy /* = std::string() */)
 {
   std::string query = PrepareSQL("SELECT %s FROM %s", strColumn.c_str(), strTable.c_str());
@@ -352,6 +385,140 @@ bool CDatabase::ExecuteQuery(const std::string &strQuery)
   return bReturn;
 }
 
+bool CDatabase::QueueInsertRow(const std::string &strInsert, const std::string &strValues, const std::string &strKey /* = std::string() */)
+{
+  if (nullptr == m_pDB)
+    return false;
+
+  if (!m_pDB->in_transaction())
+    return ExecuteQuery(strInsert + " VALUES (" + strValues + ")");
+
+  auto pending = m_pendingInserts.begin();
+  while (pending != m_pendingInserts.end() && pending->insert != strInsert)
+    ++pending;
+  if (pending == m_pendingInserts.end())
+  {
+    m_pendingInserts.emplace_back();
+    pending = m_pendingInserts.end() - 1;
+    pending->insert = strInsert;
+  }
+
+  const std::string &key = strKey.empty() ? strValues : strKey;
+  auto row = pending->keys.find(key);
+  if (row == pending->keys.end())
+  {
+    pending->keys.insert(std::make_pair(key, pending->rows.size()));
+    pending->rows.push_back(strValues);
+  }
+  else if (StringUtils::StartsWithNoCase(strInsert, "replace"))
+    pending->rows[row->second] = strValues;
+
+  return true;
+}
+
+bool CDatabase::FlushInsertRows()
+{
+  if (m_pendingInserts.empty())
+    return true;
+
+  std::vector<PendingInsert> pendingInserts;
+  pendingInserts.swap(m_pendingInserts);
+
+  for (const auto &pending : pendingInserts)
+  {
+    for (size_t first = 0; first < pending.rows.size(); first += MAX_ROWS_PER_INSERT)
+    {
+      size_t last = std::min(first + MAX_ROWS_PER_INSERT, pending.rows.size());
+      std::string sql = pending.insert + " VALUES ";
+      for (size_t i = first; i < last; i++)
+      {
+        if (i > first)
+          sql += ", ";
+        sql += "(" + pending.rows[i] + ")";
+      }
+      if (!ExecuteBatchQuery(sql))
+      {
+        // the rows are lost, so the transaction or savepoint they belong to must not be committed
+        if (m_pDB->in_transaction() && (m_failedSavepoint < 0 || m_failedSavepoint > static_cast<int>(m_savepoints)))
+          m_failedSavepoint = m_savepoints;
+        return false;
+      }
+
+      m_batchStats.rows += last - first;
+      m_batchStats.statements++;
+    }
+  }
+  return true;
+}
+
+bool CDatabase::ExecuteBatchQuery(const std::string &strQuery)
+{
+  // a dataset of its own, the callers may be in the middle of reading m_pDS
+  try
+  {
+    std::unique_ptr<Dataset> ds(m_pDB->CreateDataset());
+    ds->exec(strQuery);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'", __FUNCTION__, strQuery.c_str());
+  }
+  return false;
+}
+
+void CDatabase::BeginBatch(unsigned int itemsPerCommit)
+{
+  if (m_batchSize > 0 || nullptr == m_pDB)
+    return;
+
+  m_batchStats = BatchStats();
+  m_batchStart = XbmcThreads::SystemClockMillis();
+  m_batchSize = std::max(itemsPerCommit, 1u);
+  m_batchItems = 0;
+  m_savepoints = 0;
+  m_failedSavepoint = -1;
+  BeginTransaction();
+}
+
+bool CDatabase::CommitBatchItem()
+{
+  if (m_batchSize == 0)
+    return true;
+
+  m_batchStats.items++;
+  if (++m_batchItems < m_batchSize)
+    return true;
+
+  // savepoints an item didn't release are committed along with the transaction,
+  // if one of them lost queued rows the whole transaction is rolled back
+  m_batchItems = 0;
+  m_savepoints = 0;
+  if (m_failedSavepoint > 0)
+    m_failedSavepoint = 0;
+  bool bReturn = CommitTransaction();
+  BeginTransaction();
+  return bReturn;
+}
+
+bool CDatabase::CommitBatch()
+{
+  if (m_batchSize == 0)
+    return true;
+
+  m_batchSize = 0;
+  m_savepoints = 0;
+  if (m_failedSavepoint > 0)
+    m_failedSavepoint = 0;
+  bool bReturn = CommitTransaction();
+
+  m_batchStats.milliseconds = XbmcThreads::SystemClockMillis() - m_batchStart;
+  CLog::Log(LOGDEBUG, LOGDATABASE, "%s - %u items, %u rows in %u statements, %u commits in %u ms (%.0f rows/s)",
+            __FUNCTION__, m_batchStats.items, m_batchStats.rows, m_batchStats.statements, m_batchStats.commits,
+            m_batchStats.milliseconds, m_batchStats.rows * 1000.0 / std::max(m_batchStats.milliseconds, 1u));
+  return bReturn;
+}
+
 bool CDatabase::ResultQuery(const std::string &strQuery)
 {
   bool bReturn = false;
@@ -446,6 +613,17 @@ bool CDatabase::Open(const DatabaseSettings &settings)
   return Connect(dbName, dbSettings, false);
 }
 
+bool CDatabase::OpenForRead()
+{
+  if (IsOpen())
+    return Open();
+
+  m_readOnly = true;
+  bool opened = Open();
+  m_readOnly = false;
+  return opened;
+}
+
 void CDatabase::InitSettings(DatabaseSettings &dbSettings)
 {
   m_sqlite = true;
@@ -488,6 +666,20 @@ void CDatabase::DropAnalytics()
 
 bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSettings, bool create)
 {
+  // readers share pooled connections, these are set up already
+  if (m_readOnly && !create && dbSettings.type == "sqlite3")
+  {
+    m_pDB = CServiceBroker::GetDatabaseManager().AcquireReadConnection(dbSettings.host, dbName);
+    if (nullptr == m_pDB)
+      return false;
+
+    m_pDS.reset(m_pDB->CreateDataset());
+    m_pDS2.reset(m_pDB->CreateDataset());
+    m_pooled = true;
+    m_openCount = 1;
+    return true;
+  }
+
   // create the appropriate database structure
   if (dbSettings.type == "sqlite3")
   {
@@ -561,6 +753,8 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
       m_pDS->exec("PRAGMA cache_size=4096\n");
       m_pDS->exec("PRAGMA synchronous='NORMAL'\n");
       m_pDS->exec("PRAGMA count_changes='OFF'\n");
+      // readers don't block the writer and the writer doesn't block readers
+      m_pDS->exec("PRAGMA journal_mode=WAL\n");
     }
   }
   catch (DbErrors &error)
@@ -601,11 +795,24 @@ void CDatabase::Close()
 
   m_openCount = 0;
   m_multipleExecute = false;
+  m_pendingInserts.clear();
+  m_batchSize = 0;
+  m_savepoints = 0;
+  m_failedSavepoint = -1;
 
   if (nullptr == m_pDB)
     return;
   if (nullptr != m_pDS)
     m_pDS->close();
+  if (m_pooled)
+  {
+    // the datasets refer to the connection, they go first
+    m_pDS.reset();
+    m_pDS2.reset();
+    m_pooled = false;
+    CServiceBroker::GetDatabaseManager().ReleaseReadConnection(std::move(m_pDB));
+    return;
+  }
   m_pDB->disconnect();
   m_pDB.reset();
   m_pDS.reset();
@@ -657,6 +864,15 @@ void CDatabase::Interrupt()
 
 void CDatabase::BeginTransaction()
 {
+  // inside a batch the transactions of the items are savepoints
+  if (m_batchSize > 0 && nullptr != m_pDB && m_pDB->in_transaction())
+  {
+    // rows queued so far belong to the enclosing savepoint, which fails on commit if they are lost
+    FlushInsertRows();
+    ExecuteBatchQuery(StringUtils::Format("SAVEPOINT batch%u", ++m_savepoints));
+    return;
+  }
+
   try
   {
     if (nullptr != m_pDB)
@@ -670,6 +886,15 @@ void CDatabase::BeginTransaction()
 
 bool CDatabase::CommitTransaction()
 {
+  if (!FlushInsertRows() || m_failedSavepoint == static_cast<int>(m_savepoints))
+  {
+    RollbackTransaction();
+    return false;
+  }
+
+  if (m_savepoints > 0)
+    return ExecuteBatchQuery(StringUtils::Format("RELEASE SAVEPOINT batch%u", m_savepoints--));
+
   try
   {
     if (nullptr != m_pDB)
@@ -680,11 +905,24 @@ bool CDatabase::CommitTransaction()
     CLog::Log(LOGERROR, "database:committransaction failed");
     return false;
   }
+  m_batchStats.commits++;
   return true;
 }
 
 void CDatabase::RollbackTransaction()
 {
+  m_pendingInserts.clear();
+
+  if (m_savepoints > 0)
+  {
+    if (m_failedSavepoint >= static_cast<int>(m_savepoints))
+      m_failedSavepoint = -1;
+    ExecuteBatchQuery(StringUtils::Format("ROLLBACK TO SAVEPOINT batch%u", m_savepoints));
+    ExecuteBatchQuery(StringUtils::Format("RELEASE SAVEPOINT batch%u", m_savepoints--));
+    return;
+  }
+
+  m_failedSavepoint = -1;
   try
   {
     if (nullptr != m_pDB)
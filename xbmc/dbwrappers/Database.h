@@ -11,8 +11,10 @@
 namespace dbiplus {
   class Database;
   class Dataset;
+  class field_value;
 }
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -101,6 +103,14 @@ public:
 
   bool Open(const DatabaseSettings &db);
 
+  /*! \brief Open the database for reading only.
+   A sqlite database then gets a pooled read-only connection which doesn't wait
+   for writers. Write statements fail on it. If the database is open already
+   the open connection is used.
+   \return true if the database is open.
+   */
+  bool OpenForRead();
+
   void BeginTransaction();
   virtual bool CommitTransaction();
   void RollbackTransaction();
@@ -128,6 +138,17 @@ public:
    */
   std::string GetSingleValue(const std::string &query, std::unique_ptr<dbiplus::Dataset> &ds);
 
+  /*! \brief Get a single value from a query with ? placeholders on a dataset.
+   The statement is prepared once per connection and reused, see Dataset::query_prepared.
+   \param query the query in question.
+   \param params the values for the placeholders, in order.
+   \param ds the dataset to use for the query.
+   \return the value from the query, empty on failure.
+   */
+  std::string GetSingleValue(const std::string &query,
+                             const std::vector<dbiplus::field_value> &params,
+                             std::unique_ptr<dbiplus::Dataset> &ds);
+
   /*!
    * @brief Delete values from a table.
    * @param strTable The table to delete the values from.
@@ -187,6 +208,74 @@ public:
    */
   bool CommitInsertQueries();
 
+  /*!
+   * @brief Put a row in the queue of a multi-row INSERT or REPLACE.
+   *        Inside a transaction the rows are collected per statement and
+   *        written with as few statements as possible before the transaction
+   *        or savepoint is committed, or on FlushInsertRows(). Outside of a
+   *        transaction the row is written straight away.
+   *          NOTE: Queued rows are not visible to queries before they are
+   *                flushed, and they are dropped on RollbackTransaction().
+   * @param strInsert The statement up to VALUES, e.g. "INSERT INTO t (a, b)".
+   * @param strValues The formatted values of the row, without parentheses.
+   * @param strKey Rows of a statement with the same key are written once, the
+   *               first one for INSERT and the last one for REPLACE. Defaults
+   *               to the values.
+   * @return True if the row was queued or written successfully, false otherwise.
+   * @sa FlushInsertRows
+   */
+  bool QueueInsertRow(const std::string &strInsert, const std::string &strValues, const std::string &strKey = std::string());
+
+  /*!
+   * @brief Write the rows queued by QueueInsertRow().
+   *          NOTE: If the rows can't be written, the transaction or savepoint
+   *                they were queued in is rolled back on its commit, which
+   *                then fails.
+   * @return True if the rows were written successfully, false otherwise.
+   */
+  bool FlushInsertRows();
+
+  /*!
+   * @brief Start a batch of writes. The items written during the batch share
+   *        one transaction which is committed every itemsPerCommit items.
+   *        Transactions of the items become savepoints in it, so an item
+   *        that is rolled back doesn't take the others with it.
+   *          NOTE: The batch holds the write lock of the database between the
+   *                items, don't do slow work between them.
+   * @param itemsPerCommit The number of items per transaction.
+   * @sa CommitBatchItem, CommitBatch
+   */
+  void BeginBatch(unsigned int itemsPerCommit);
+
+  /*!
+   * @brief Mark an item of the batch as written, commits the transaction of
+   *        the batch after itemsPerCommit items.
+   * @return True if there was nothing to commit or the commit succeeded.
+   */
+  bool CommitBatchItem();
+
+  /*!
+   * @brief Commit the remaining items and end the batch.
+   * @return True if there was nothing to commit or the commit succeeded.
+   */
+  bool CommitBatch();
+
+  bool InBatch() const { return m_batchSize > 0; }
+
+  struct BatchStats
+  {
+    unsigned int items = 0; ///< items marked by CommitBatchItem()
+    unsigned int rows = 0; ///< rows written by FlushInsertRows()
+    unsigned int statements = 0; ///< statements the rows were written with
+    unsigned int commits = 0; ///< transactions committed
+    unsigned int milliseconds = 0; ///< duration of the last batch
+  };
+
+  /*!
+   * @brief Get the counters of the current or last batch.
+   */
+  const BatchStats& GetBatchStats() const { return m_batchStats; }
+
   virtual bool GetFilter(CDbUrl &dbUrl, Filter &filter, SortDescription &sorting) { return true; }
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl);
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl, SortDescription &sorting);
@@ -253,4 +342,24 @@ private:
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  bool m_readOnly; /*!< True if the next connect should take a read-only connection */
+  bool m_pooled; /*!< True if m_pDB goes back to the read connection pool on close */
+
+  bool ExecuteBatchQuery(const std::string &strQuery);
+
+  struct PendingInsert
+  {
+    std::string insert;
+    std::vector<std::string> rows;
+    std::map<std::string, size_t> keys;
+  };
+  std::vector<PendingInsert> m_pendingInserts; /*!< Rows queued by QueueInsertRow() */
+
+  unsigned int m_batchSize; /*!< Items per commit of the current batch, 0 if there is none */
+  unsigned int m_batchItems; /*!< Items since the last commit of the batch */
+  unsigned int m_batchStart; /*!< Start time of the batch */
+  unsigned int m_savepoints; /*!< Savepoints open in the transaction of the batch */
+  int m_failedSavepoint; /*!< Savepoint that lost queued rows, 0 for the transaction, -1 if none */
+  BatchStats m_batchStats;
 };
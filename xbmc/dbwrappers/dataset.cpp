@@ -188,6 +188,64 @@ void Dataset::parse_sql(std::string &sql) {
 }
 
 
+std::string Dataset::bind_params(const std::string &sql, const ParamValues &params) {
+  if (db == NULL) throw DbErrors("No Database Connection");
+
+  std::string result;
+  result.reserve(sql.size());
+  size_t param = 0;
+  bool quoted = false;
+  for (char c : sql)
+  {
+    if (c == '\'')
+      quoted = !quoted;
+    if (c != '?' || quoted)
+    {
+      result += c;
+      continue;
+    }
+    if (param == params.size())
+      throw DbErrors("Missing parameter %u for query: %s", static_cast<unsigned int>(param + 1), sql.c_str());
+
+    const field_value &value = params[param++];
+    if (value.get_isNull())
+      result += "NULL";
+    else
+    {
+      switch (value.get_fType())
+      {
+      case ft_String:
+      case ft_Char:
+      case ft_WChar:
+      case ft_WideString:
+      case ft_Object:
+        result += db->prepare("'%s'", value.get_asString().c_str());
+        break;
+      case ft_Float:
+      case ft_Double:
+      case ft_LongDouble:
+        result += db->prepare("%.17g", value.get_asDouble());
+        break;
+      default:
+        result += std::to_string(value.get_asInt64());
+        break;
+      }
+    }
+  }
+  if (param != params.size())
+    throw DbErrors("Too many parameters for query: %s", sql.c_str());
+  return result;
+}
+
+bool Dataset::query_prepared(const std::string &sql, const ParamValues &params) {
+  return query(bind_params(sql, params));
+}
+
+int Dataset::exec_prepared(const std::string &sql, const ParamValues &params) {
+  return exec(bind_params(sql, params));
+}
+
+
 void Dataset::close(void) {
   haveError  = false;
   frecno = 0;
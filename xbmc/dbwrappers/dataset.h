@@ -168,6 +168,7 @@ enum sqlType {sqlSelect,sqlUpdate,sqlInsert,sqlDelete,sqlExec};
 
 typedef std::list<std::string> StringList;
 typedef std::map<std::string,field_value> ParamList;
+typedef std::vector<field_value> ParamValues;
 
 
 class Dataset  {
@@ -248,6 +249,9 @@ protected:
 /* Returns old field value (for :OLD) */
   virtual const field_value f_old(const char *f);
 
+/* Returns sql with each ? outside of quotes replaced by the escaped value of the next parameter */
+  std::string bind_params(const std::string &sql, const ParamValues &params);
+
 public:
 
  virtual int str_compare(const char * s1, const char * s2);
@@ -293,6 +297,17 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as query and exec, but with ? placeholders in sql bound to params in order.
+   Backends that support it keep the prepared statement of each sql text for the
+   connection, so these are cheap to repeat with different values. */
+  virtual bool query_prepared(const std::string &sql, const ParamValues &params);
+  virtual int  exec_prepared(const std::string &sql, const ParamValues &params);
+/* Forward-only cursor over the rows of a select sql. The rows are fetched one at a
+   time instead of being stored in the result set, values keep the type of their column. */
+  virtual bool open_cursor(const std::string &sql) = 0;
+/* Returns the next row of the cursor, or NULL after the last one. The record is reused
+   for every row and only valid until the next call. close() ends the cursor. */
+  virtual const sql_record *fetch_row() = 0;
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
@@ -1352,6 +1352,7 @@ std::string MysqlDatabase::mysql_vmprintf(const char *zFormat, va_list ap) {
 //************* MysqlDataset implementation ***************
 
 MysqlDataset::MysqlDataset():Dataset() {
+  cursor = NULL;
   haveError = false;
   db = NULL;
   errmsg = NULL;
@@ -1359,6 +1360,7 @@ MysqlDataset::MysqlDataset():Dataset() {
 }
 
 MysqlDataset::MysqlDataset(MysqlDatabase *newDb):Dataset(newDb) {
+  cursor = NULL;
   haveError = false;
   db = newDb;
   errmsg = NULL;
@@ -1366,6 +1368,7 @@ MysqlDataset::MysqlDataset(MysqlDatabase *newDb):Dataset(newDb) {
 }
 
 MysqlDataset::~MysqlDataset() {
+   close_cursor();
    if (errmsg) free(errmsg);
  }
 
@@ -1547,7 +1550,7 @@ const void* MysqlDataset::getExecRes() {
   return &exec_res;
 }
 
-bool MysqlDataset::query(const std::string &query) {
+MYSQL_RES *MysqlDataset::store_result(const std::string &query) {
   if(!handle()) throw DbErrors("No Database Connection");
   std::string qry = query;
   int fs = qry.find("select");
@@ -1576,67 +1579,78 @@ bool MysqlDataset::query(const std::string &query) {
   // column headers
   const unsigned int numColumns = mysql_num_fields(stmt);
   MYSQL_FIELD *fields = mysql_fetch_fields(stmt);
-  MYSQL_ROW row;
   result.record_header.resize(numColumns);
   for (unsigned int i = 0; i < numColumns; i++)
     result.record_header[i].name = fields[i].name;
 
+  return stmt;
+}
+
+void MysqlDataset::read_row(MYSQL_RES *stmt, MYSQL_ROW row, sql_record &rec) {
+  const unsigned int numColumns = mysql_num_fields(stmt);
+  MYSQL_FIELD *fields = mysql_fetch_fields(stmt);
+  rec.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    field_value &v = rec[i];
+    v.set_isNull(false);
+    switch (fields[i].type)
+    {
+      case MYSQL_TYPE_LONGLONG:
+      case MYSQL_TYPE_DECIMAL:
+      case MYSQL_TYPE_NEWDECIMAL:
+      case MYSQL_TYPE_TINY:
+      case MYSQL_TYPE_SHORT:
+      case MYSQL_TYPE_INT24:
+      case MYSQL_TYPE_LONG:
+        if (row[i] != NULL)
+        {
+          v.set_asInt(atoi(row[i]));
+        }
+        else
+        {
+          v.set_asInt(0);
+        }
+        break;
+      case MYSQL_TYPE_FLOAT:
+      case MYSQL_TYPE_DOUBLE:
+        if (row[i] != NULL)
+        {
+          v.set_asDouble(atof(row[i]));
+        }
+        else
+        {
+          v.set_asDouble(0);
+        }
+        break;
+      case MYSQL_TYPE_STRING:
+      case MYSQL_TYPE_VAR_STRING:
+      case MYSQL_TYPE_VARCHAR:
+      case MYSQL_TYPE_TINY_BLOB:
+      case MYSQL_TYPE_MEDIUM_BLOB:
+      case MYSQL_TYPE_LONG_BLOB:
+      case MYSQL_TYPE_BLOB:
+        v.set_asString(row[i] != NULL ? (const char *)row[i] : "");
+        break;
+      case MYSQL_TYPE_NULL:
+      default:
+        CLog::Log(LOGDEBUG,"MYSQL: Unknown field type: %u", fields[i].type);
+        v.set_asString("");
+        v.set_isNull();
+        break;
+    }
+  }
+}
+
+bool MysqlDataset::query(const std::string &query) {
+  MYSQL_RES *stmt = store_result(query);
+
   // returned rows
+  MYSQL_ROW row;
   while ((row = mysql_fetch_row(stmt)))
   { // have a row of data
     sql_record *res = new sql_record;
-    res->resize(numColumns);
-    for (unsigned int i = 0; i < numColumns; i++)
-    {
-      field_value &v = res->at(i);
-      switch (fields[i].type)
-      {
-        case MYSQL_TYPE_LONGLONG:
-        case MYSQL_TYPE_DECIMAL:
-        case MYSQL_TYPE_NEWDECIMAL:
-        case MYSQL_TYPE_TINY:
-        case MYSQL_TYPE_SHORT:
-        case MYSQL_TYPE_INT24:
-        case MYSQL_TYPE_LONG:
-          if (row[i] != NULL)
-          {
-            v.set_asInt(atoi(row[i]));
-          }
-          else
-          {
-            v.set_asInt(0);
-          }
-          break;
-        case MYSQL_TYPE_FLOAT:
-        case MYSQL_TYPE_DOUBLE:
-          if (row[i] != NULL)
-          {
-            v.set_asDouble(atof(row[i]));
-          }
-          else
-          {
-            v.set_asDouble(0);
-          }
-          break;
-        case MYSQL_TYPE_STRING:
-        case MYSQL_TYPE_VAR_STRING:
-        case MYSQL_TYPE_VARCHAR:
-          if (row[i] != NULL) v.set_asString((const char *)row[i] );
-          break;
-        case MYSQL_TYPE_TINY_BLOB:
-        case MYSQL_TYPE_MEDIUM_BLOB:
-        case MYSQL_TYPE_LONG_BLOB:
-        case MYSQL_TYPE_BLOB:
-          if (row[i] != NULL) v.set_asString((const char *)row[i]);
-          break;
-        case MYSQL_TYPE_NULL:
-        default:
-          CLog::Log(LOGDEBUG,"MYSQL: Unknown field type: %u", fields[i].type);
-          v.set_asString("");
-          v.set_isNull();
-          break;
-      }
-    }
+    read_row(stmt, row, *res);
     result.records.push_back(res);
   }
   mysql_free_result(stmt);
@@ -1646,6 +1660,36 @@ bool MysqlDataset::query(const std::string &query) {
   return true;
 }
 
+/* The rows are stored on the client with mysql_store_result rather than streamed with
+   mysql_use_result, which would block other queries on the connection until the last
+   row is read. They are kept as the raw row data and only converted one at a time. */
+bool MysqlDataset::open_cursor(const std::string &sql) {
+  cursor = store_result(sql);
+  active = true;
+  ds_state = dsSelect;
+  return true;
+}
+
+const sql_record *MysqlDataset::fetch_row() {
+  if (!cursor)
+    return NULL;
+
+  MYSQL_ROW row = mysql_fetch_row(cursor);
+  if (!row)
+  {
+    close_cursor();
+    return NULL;
+  }
+  read_row(cursor, row, cursor_row);
+  return &cursor_row;
+}
+
+void MysqlDataset::close_cursor() {
+  if (cursor)
+    mysql_free_result(cursor);
+  cursor = NULL;
+}
+
 void MysqlDataset::open(const std::string &sql) {
    set_select_sql(sql);
    open();
@@ -1664,6 +1708,7 @@ void MysqlDataset::open() {
 
 void MysqlDataset::close() {
   Dataset::close();
+  close_cursor();
   result.clear();
   edit_object->clear();
   fields_object->clear();
@@ -120,6 +120,17 @@ protected:
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
 
+/* Runs the select query and returns its stored result, the column headers are set */
+  MYSQL_RES *store_result(const std::string &query);
+/* Reads row of stmt into rec, reusing its values */
+  void read_row(MYSQL_RES *stmt, MYSQL_ROW row, sql_record &rec);
+
+/* result and current row of the cursor */
+  MYSQL_RES *cursor;
+  sql_record cursor_row;
+/* frees the result of the cursor */
+  void close_cursor();
+
 public:
 /* constructor */
   MysqlDataset();
@@ -141,6 +152,9 @@ or insert() operations default = false) */
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+/* forward-only cursor, see Dataset */
+  bool open_cursor(const std::string &sql) override;
+  const sql_record *fetch_row() override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -43,6 +43,13 @@ field_value::field_value(const char *s):
   is_null = false;
 }
 
+field_value::field_value(const std::string &s):
+  str_value(s)
+{
+  field_type = ft_String;
+  is_null = false;
+}
+
 field_value::field_value(const bool b) {
   bool_value = b;
   field_type = ft_Boolean;
@@ -65,6 +65,7 @@ private:
 public:
   field_value();
   explicit field_value(const char *s);
+  explicit field_value(const std::string &s);
   explicit field_value(const bool b);
   explicit field_value(const char c);
   explicit field_value(const short s);
@@ -162,7 +163,7 @@ public:
   }
   }
 
-  void set_isNull(){is_null=true;}
+  void set_isNull(bool null=true){is_null=null;}
   void set_asString(const char *s);
   void set_asString(const std::string & s);
   void set_asBool(const bool b);
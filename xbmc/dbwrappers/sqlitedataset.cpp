@@ -156,6 +156,21 @@ const std::map<int, const char*> g_SqliteErrorStrings =
 #endif
 };
 #undef X
+
+/* puts a cached statement back into its initial state when it goes out of scope */
+class StatementReset
+{
+public:
+  explicit StatementReset(sqlite3_stmt *stmt) : m_stmt(stmt) {}
+  ~StatementReset()
+  {
+    sqlite3_reset(m_stmt);
+    sqlite3_clear_bindings(m_stmt);
+  }
+
+private:
+  sqlite3_stmt *m_stmt;
+};
 }
 
 namespace dbiplus {
@@ -205,10 +220,13 @@ static int busy_callback(void*, int busyCount)
 
 //************* SqliteDatabase implementation ***************
 
+const size_t SqliteDatabase::MAX_CACHED_STATEMENTS;
+
 SqliteDatabase::SqliteDatabase() {
 
   active = false;
   _in_transaction = false;    // for transaction
+  read_only = false;
 
   error = "Unknown database error";//S_NO_CONNECTION;
   host = "localhost";
@@ -297,11 +315,11 @@ int SqliteDatabase::connect(bool create) {
   try
   {
     disconnect();
-    int flags = SQLITE_OPEN_READWRITE;
-    if (create)
+    int flags = read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE;
+    if (create && !read_only)
       flags |= SQLITE_OPEN_CREATE;
     int errorCode = sqlite3_open_v2(db_fullpath.c_str(), &conn, flags, NULL);
-    if (create && errorCode == SQLITE_CANTOPEN)
+    if (create && !read_only && errorCode == SQLITE_CANTOPEN)
     {
       CLog::Log(LOGFATAL, "SqliteDatabase: can't open %s", db_fullpath.c_str());
       throw std::runtime_error("SqliteDatabase: can't open " + db_fullpath);
@@ -315,7 +333,7 @@ int SqliteDatabase::connect(bool create) {
       {
         throw DbErrors("%s", getErrorMsg());
       }
-      else if (sqlite3_db_readonly(conn, nullptr) == 1)
+      else if (!read_only && sqlite3_db_readonly(conn, nullptr) == 1)
       {
         CLog::Log(LOGFATAL, "SqliteDatabase: %s is read only", db_fullpath.c_str());
         throw std::runtime_error("SqliteDatabase: " + db_fullpath + " is read only");
@@ -352,10 +370,42 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clear_statements();
   sqlite3_close(conn);
   active = false;
 }
 
+sqlite3_stmt *SqliteDatabase::get_statement(const std::string &sql) {
+  auto it = stmt_index.find(sql);
+  if (it != stmt_index.end())
+  {
+    if (it->second != stmt_cache.begin())
+      stmt_cache.splice(stmt_cache.begin(), stmt_cache, it->second);
+    return it->second->second;
+  }
+
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+    throw DbErrors("%s", getErrorMsg());
+
+  stmt_cache.emplace_front(sql, stmt);
+  stmt_index[sql] = stmt_cache.begin();
+  if (stmt_cache.size() > MAX_CACHED_STATEMENTS)
+  {
+    stmt_index.erase(stmt_cache.back().first);
+    sqlite3_finalize(stmt_cache.back().second);
+    stmt_cache.pop_back();
+  }
+  return stmt;
+}
+
+void SqliteDatabase::clear_statements() {
+  for (const auto &i : stmt_cache)
+    sqlite3_finalize(i.second);
+  stmt_cache.clear();
+  stmt_index.clear();
+}
+
 int SqliteDatabase::create() {
   return connect(true);
 }
@@ -576,6 +626,7 @@ std::string SqliteDatabase::vprepare(const char *format, va_list args)
 //************* SqliteDataset implementation ***************
 
 SqliteDataset::SqliteDataset():Dataset() {
+  cursor = NULL;
   haveError = false;
   db = NULL;
   errmsg = NULL;
@@ -584,6 +635,7 @@ SqliteDataset::SqliteDataset():Dataset() {
 
 
 SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
+  cursor = NULL;
   haveError = false;
   db = newDb;
   errmsg = NULL;
@@ -591,6 +643,7 @@ SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
 }
 
  SqliteDataset::~SqliteDataset(){
+   close_cursor();
    if (errmsg) sqlite3_free(errmsg);
  }
 
@@ -715,6 +768,93 @@ bool SqliteDataset::dropIndex(const char *table, const char *index)
 }
 
 
+void SqliteDataset::bind_statement(sqlite3_stmt *stmt, const std::string &sql, const ParamValues &params) {
+  if (static_cast<size_t>(sqlite3_bind_parameter_count(stmt)) != params.size())
+    throw DbErrors("Expected %d parameters, got %u for query: %s", sqlite3_bind_parameter_count(stmt),
+                   static_cast<unsigned int>(params.size()), sql.c_str());
+
+  for (size_t i = 0; i < params.size(); i++)
+  {
+    const field_value &value = params[i];
+    const int index = static_cast<int>(i) + 1;
+    int res;
+    if (value.get_isNull())
+      res = sqlite3_bind_null(stmt, index);
+    else
+    {
+      switch (value.get_fType())
+      {
+      case ft_String:
+      case ft_Char:
+      case ft_WChar:
+      case ft_WideString:
+      case ft_Object:
+      {
+        const std::string str = value.get_asString();
+        res = sqlite3_bind_text(stmt, index, str.c_str(), str.size(), SQLITE_TRANSIENT);
+        break;
+      }
+      case ft_Float:
+      case ft_Double:
+      case ft_LongDouble:
+        res = sqlite3_bind_double(stmt, index, value.get_asDouble());
+        break;
+      default:
+        res = sqlite3_bind_int64(stmt, index, value.get_asInt64());
+        break;
+      }
+    }
+    if (db->setErr(res, sql.c_str()) != SQLITE_OK)
+      throw DbErrors("%s", db->getErrorMsg());
+  }
+}
+
+void SqliteDataset::read_rows(sqlite3_stmt *stmt) {
+  // column headers
+  const unsigned int numColumns = sqlite3_column_count(stmt);
+  result.record_header.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+    result.record_header[i].name = sqlite3_column_name(stmt, i);
+
+  // returned rows
+  while (sqlite3_step(stmt) == SQLITE_ROW)
+  { // have a row of data
+    sql_record *res = new sql_record;
+    read_row(stmt, *res);
+    result.records.push_back(res);
+  }
+}
+
+void SqliteDataset::read_row(sqlite3_stmt *stmt, sql_record &row) {
+  const unsigned int numColumns = sqlite3_column_count(stmt);
+  row.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    field_value &v = row[i];
+    v.set_isNull(false);
+    switch (sqlite3_column_type(stmt, i))
+    {
+    case SQLITE_INTEGER:
+      v.set_asInt64(sqlite3_column_int64(stmt, i));
+      break;
+    case SQLITE_FLOAT:
+      v.set_asDouble(sqlite3_column_double(stmt, i));
+      break;
+    case SQLITE_TEXT:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_BLOB:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_NULL:
+    default:
+      v.set_asString("");
+      v.set_isNull();
+      break;
+    }
+  }
+}
+
 int SqliteDataset::exec(const std::string &sql) {
   if (!handle()) throw DbErrors("No Database Connection");
   std::string qry = sql;
@@ -793,43 +933,7 @@ bool SqliteDataset::query(const std::string &query) {
   if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
     throw DbErrors("%s", db->getErrorMsg());
 
-  // column headers
-  const unsigned int numColumns = sqlite3_column_count(stmt);
-  result.record_header.resize(numColumns);
-  for (unsigned int i = 0; i < numColumns; i++)
-    result.record_header[i].name = sqlite3_column_name(stmt, i);
-
-  // returned rows
-  while (sqlite3_step(stmt) == SQLITE_ROW)
-  { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
-    for (unsigned int i = 0; i < numColumns; i++)
-    {
-      field_value &v = res->at(i);
-      switch (sqlite3_column_type(stmt, i))
-      {
-      case SQLITE_INTEGER:
-        v.set_asInt64(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        v.set_asDouble(sqlite3_column_double(stmt, i));
-        break;
-      case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_NULL:
-      default:
-        v.set_asString("");
-        v.set_isNull();
-        break;
-      }
-    }
-    result.records.push_back(res);
-  }
+  read_rows(stmt);
   if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
   {
     active = true;
@@ -843,6 +947,91 @@ bool SqliteDataset::query(const std::string &query) {
   }
 }
 
+bool SqliteDataset::query_prepared(const std::string &sql, const ParamValues &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+
+  close();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->get_statement(sql);
+  StatementReset reset(stmt);
+  bind_statement(stmt, sql, params);
+  read_rows(stmt);
+  // errors of the last step are reported by the reset
+  if (db->setErr(sqlite3_reset(stmt), sql.c_str()) != SQLITE_OK)
+    throw DbErrors("%s", db->getErrorMsg());
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+int SqliteDataset::exec_prepared(const std::string &sql, const ParamValues &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->get_statement(sql);
+  StatementReset reset(stmt);
+  bind_statement(stmt, sql, params);
+  int res;
+  while ((res = sqlite3_step(stmt)) == SQLITE_ROW)
+    ;
+  if (res != SQLITE_DONE)
+  {
+    db->setErr(sqlite3_reset(stmt), sql.c_str());
+    throw DbErrors("%s", db->getErrorMsg());
+  }
+  return SQLITE_OK;
+}
+
+bool SqliteDataset::open_cursor(const std::string &sql) {
+  if (!handle()) throw DbErrors("No Database Connection");
+
+  close();
+
+  // not taken from the statement cache, the sql of listings is rarely repeated
+  if (db->setErr(sqlite3_prepare_v2(handle(), sql.c_str(), -1, &cursor, NULL), sql.c_str()) != SQLITE_OK)
+  {
+    close_cursor();
+    throw DbErrors("%s", db->getErrorMsg());
+  }
+
+  const unsigned int numColumns = sqlite3_column_count(cursor);
+  result.record_header.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+    result.record_header[i].name = sqlite3_column_name(cursor, i);
+
+  active = true;
+  ds_state = dsSelect;
+  return true;
+}
+
+const sql_record *SqliteDataset::fetch_row() {
+  if (!cursor)
+    return NULL;
+
+  int res = sqlite3_step(cursor);
+  if (res == SQLITE_ROW)
+  {
+    read_row(cursor, cursor_row);
+    return &cursor_row;
+  }
+
+  // errors of the last step are reported by the finalize
+  const std::string sql = sqlite3_sql(cursor);
+  res = sqlite3_finalize(cursor);
+  cursor = NULL;
+  if (db->setErr(res, sql.c_str()) != SQLITE_OK)
+    throw DbErrors("%s", db->getErrorMsg());
+  return NULL;
+}
+
+void SqliteDataset::close_cursor() {
+  if (cursor)
+    sqlite3_finalize(cursor);
+  cursor = NULL;
+}
+
 void SqliteDataset::open(const std::string &sql) {
   set_select_sql(sql);
   open();
@@ -860,6 +1049,7 @@ void SqliteDataset::open() {
 
 void SqliteDataset::close() {
   Dataset::close();
+  close_cursor();
   result.clear();
   edit_object->clear();
   fields_object->clear();
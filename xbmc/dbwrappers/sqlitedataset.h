@@ -14,7 +14,11 @@
 
 #include "dataset.h"
 
+#include <list>
 #include <stdio.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 #include <sqlite3.h>
 
@@ -29,9 +33,20 @@ protected:
 /* connect descriptor */
   sqlite3 *conn;
   bool _in_transaction;
+  bool read_only;
   int last_err;
 
+/* prepared statements of this connection by sql text, most recently used first */
+  typedef std::list<std::pair<std::string, sqlite3_stmt*> > StatementList;
+  StatementList stmt_cache;
+  std::unordered_map<std::string, StatementList::iterator> stmt_index;
+/* finalizes all cached statements */
+  void clear_statements();
+
 public:
+/* statements kept per connection, the least recently used is finalized beyond that */
+  static const size_t MAX_CACHED_STATEMENTS = 64;
+
 /* default constructor */
   SqliteDatabase();
 /* destructor */
@@ -41,6 +56,14 @@ public:
 
 /* func. returns connection handle with SQLite-server */
   sqlite3 *getHandle() {  return conn; }
+/* opens the database read-only on the next connect, it has to exist then */
+  void setReadOnly(bool val) { read_only = val; }
+  bool isReadOnly() const { return read_only; }
+/* returns the prepared statement for sql, prepared on first use and kept for the
+   connection. The caller resets it when done, throws DbErrors if sql is invalid */
+  sqlite3_stmt *get_statement(const std::string &sql);
+/* number of statements in the cache */
+  size_t cached_statements() const { return stmt_cache.size(); }
 /* func. returns current status about SQLite-server connection */
   int status() override;
   int setErr(int err_code,const char * qry) override;
@@ -113,6 +136,19 @@ protected:
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
 
+/* Binds params to the ? placeholders of stmt */
+  void bind_statement(sqlite3_stmt *stmt, const std::string &sql, const ParamValues &params);
+/* Reads all rows of stmt into the result set */
+  void read_rows(sqlite3_stmt *stmt);
+/* Reads the current row of stmt into row, reusing its values */
+  void read_row(sqlite3_stmt *stmt, sql_record &row);
+
+/* statement and current row of the cursor */
+  sqlite3_stmt *cursor;
+  sql_record cursor_row;
+/* finalizes the statement of the cursor */
+  void close_cursor();
+
 public:
 /* constructor */
   SqliteDataset();
@@ -134,6 +170,12 @@ or insert() operations default = false) */
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+/* as query and exec, with a statement from the cache of the connection */
+  bool query_prepared(const std::string &sql, const ParamValues &params) override;
+  int  exec_prepared(const std::string &sql, const ParamValues &params) override;
+/* forward-only cursor, see Dataset */
+  bool open_cursor(const std::string &sql) override;
+  const sql_record *fetch_row() override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -0,0 +1,200 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/Database.h"
+#include "dbwrappers/dataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/URIUtils.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const char* const INSERT_ITEM = "INSERT INTO item (idItem, strName)";
+const char* const REPLACE_ITEM = "REPLACE INTO item (idItem, strName)";
+
+class CTestDatabase : public CDatabase
+{
+public:
+  bool Connect()
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    return CDatabase::Connect(GetBaseDBName(), settings, true);
+  }
+
+  std::string GetPath() const
+  {
+    return URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), GetBaseDBName());
+  }
+
+  int GetItemCount() { return std::stoi(GetSingleValue("SELECT COUNT(*) FROM item")); }
+
+  std::string GetItemName(int idItem)
+  {
+    return GetSingleValue(PrepareSQL("SELECT strName FROM item WHERE idItem = %i", idItem));
+  }
+
+protected:
+  void CreateTables() override
+  {
+    m_pDS->exec("CREATE TABLE item (idItem INTEGER PRIMARY KEY, strName TEXT)");
+  }
+  void CreateAnalytics() override {}
+  int GetSchemaVersion() const override { return 1; }
+  const char* GetBaseDBName() const override { return "TestDatabase.db"; }
+};
+}
+
+class TestDatabase : public ::testing::Test
+{
+protected:
+  CTestDatabase db;
+
+  void SetUp() override
+  {
+    XFILE::CFile::Delete(db.GetPath());
+    ASSERT_TRUE(db.Connect());
+  }
+
+  void TearDown() override
+  {
+    db.Close();
+    XFILE::CFile::Delete(db.GetPath());
+  }
+};
+
+TEST_F(TestDatabase, QueueInsertRowOutsideTransaction)
+{
+  EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, "1, 'a'"));
+  EXPECT_EQ(1, db.GetItemCount());
+
+  // a failing row is reported right away
+  EXPECT_FALSE(db.QueueInsertRow(INSERT_ITEM, "1, 'b'"));
+  EXPECT_EQ("a", db.GetItemName(1));
+}
+
+TEST_F(TestDatabase, QueueInsertRowKeys)
+{
+  db.BeginTransaction();
+  EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, "1, 'first'", "1"));
+  EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, "1, 'second'", "1"));
+  EXPECT_TRUE(db.QueueInsertRow(REPLACE_ITEM, "2, 'first'", "2"));
+  EXPECT_TRUE(db.QueueInsertRow(REPLACE_ITEM, "2, 'second'", "2"));
+  // rows without a key are told apart by their values
+  EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, "3, 'third'"));
+  EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, "3, 'third'"));
+
+  // queued rows are written on commit
+  EXPECT_EQ(0, db.GetItemCount());
+  EXPECT_TRUE(db.CommitTransaction());
+
+  EXPECT_EQ(3, db.GetItemCount());
+  EXPECT_EQ("first", db.GetItemName(1));
+  EXPECT_EQ("second", db.GetItemName(2));
+  EXPECT_EQ("third", db.GetItemName(3));
+}
+
+TEST_F(TestDatabase, FlushInsertRowsInChunks)
+{
+  db.BeginBatch(10);
+  for (int i = 1; i <= 450; i++)
+    EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, db.PrepareSQL("%i, 'item %i'", i, i)));
+  EXPECT_TRUE(db.CommitBatchItem());
+  EXPECT_TRUE(db.CommitBatch());
+
+  EXPECT_EQ(450, db.GetItemCount());
+  EXPECT_EQ(450u, db.GetBatchStats().rows);
+  EXPECT_EQ(3u, db.GetBatchStats().statements);
+  EXPECT_EQ(1u, db.GetBatchStats().items);
+  EXPECT_EQ(1u, db.GetBatchStats().commits);
+}
+
+TEST_F(TestDatabase, RollbackDropsQueue)
+{
+  db.BeginTransaction();
+  EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, "1, 'a'"));
+  db.RollbackTransaction();
+
+  db.BeginTransaction();
+  EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, "2, 'b'"));
+  EXPECT_TRUE(db.CommitTransaction());
+
+  EXPECT_EQ(1, db.GetItemCount());
+  EXPECT_EQ("b", db.GetItemName(2));
+}
+
+TEST_F(TestDatabase, BatchRollsBackSingleItem)
+{
+  db.BeginBatch(100);
+
+  db.BeginTransaction();
+  EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, "1, 'kept'"));
+  EXPECT_TRUE(db.CommitTransaction());
+  EXPECT_TRUE(db.CommitBatchItem());
+
+  // both the written and the queued rows of the item are rolled back
+  db.BeginTransaction();
+  EXPECT_TRUE(db.ExecuteQuery("INSERT INTO item (idItem, strName) VALUES (2, 'written')"));
+  EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, "3, 'queued'"));
+  db.RollbackTransaction();
+  EXPECT_TRUE(db.CommitBatchItem());
+
+  db.BeginTransaction();
+  EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, "4, 'kept'"));
+  EXPECT_TRUE(db.CommitTransaction());
+  EXPECT_TRUE(db.CommitBatchItem());
+
+  EXPECT_TRUE(db.CommitBatch());
+
+  EXPECT_EQ(2, db.GetItemCount());
+  EXPECT_EQ("kept", db.GetItemName(1));
+  EXPECT_EQ("kept", db.GetItemName(4));
+  EXPECT_EQ(3u, db.GetBatchStats().items);
+}
+
+TEST_F(TestDatabase, FailedFlushRollsBackTransaction)
+{
+  db.BeginTransaction();
+  EXPECT_TRUE(db.ExecuteQuery("INSERT INTO item (idItem, strName) VALUES (1, 'written')"));
+  EXPECT_TRUE(db.QueueInsertRow("INSERT INTO missing (idItem)", "2"));
+  EXPECT_FALSE(db.FlushInsertRows());
+  EXPECT_FALSE(db.CommitTransaction());
+
+  EXPECT_EQ(0, db.GetItemCount());
+}
+
+TEST_F(TestDatabase, FailedFlushRollsBackBatchItem)
+{
+  db.BeginBatch(100);
+
+  db.BeginTransaction();
+  EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, "1, 'kept'"));
+  EXPECT_TRUE(db.CommitTransaction());
+  EXPECT_TRUE(db.CommitBatchItem());
+
+  // the rows of the item can't be written when a nested transaction starts
+  db.BeginTransaction();
+  EXPECT_TRUE(db.ExecuteQuery("INSERT INTO item (idItem, strName) VALUES (2, 'written')"));
+  EXPECT_TRUE(db.QueueInsertRow("INSERT INTO missing (idItem)", "3"));
+  db.BeginTransaction();
+  EXPECT_TRUE(db.QueueInsertRow(INSERT_ITEM, "4, 'nested'"));
+  EXPECT_TRUE(db.CommitTransaction());
+  EXPECT_FALSE(db.CommitTransaction());
+  EXPECT_TRUE(db.CommitBatchItem());
+
+  EXPECT_TRUE(db.CommitBatch());
+
+  EXPECT_EQ(1, db.GetItemCount());
+  EXPECT_EQ("kept", db.GetItemName(1));
+}
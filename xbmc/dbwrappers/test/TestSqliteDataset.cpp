@@ -0,0 +1,290 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+class TestSqliteDataset : public ::testing::Test
+{
+protected:
+  SqliteDatabase db;
+  std::unique_ptr<Dataset> ds;
+
+  void SetUp() override
+  {
+    db.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    db.setDatabase("TestSqliteDataset");
+    XFILE::CFile::Delete(GetPath());
+    ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+
+    ds.reset(db.CreateDataset());
+    ds->exec("CREATE TABLE path (idPath INTEGER PRIMARY KEY, strPath TEXT, dRating REAL)");
+  }
+
+  void TearDown() override
+  {
+    ds.reset();
+    db.disconnect();
+    XFILE::CFile::Delete(GetPath());
+  }
+
+  std::string GetPath()
+  {
+    return URIUtils::AddFileToFolder(db.getHostName(), db.getDatabase());
+  }
+
+  void AddPaths(int count)
+  {
+    db.start_transaction();
+    for (int i = 0; i < count; i++)
+    {
+      ds->exec_prepared("INSERT INTO path (strPath, dRating) VALUES (?, ?)",
+                        {field_value("/music/artist's " + std::to_string(i) + "/"), field_value(i / 4.0)});
+    }
+    db.commit_transaction();
+  }
+};
+
+TEST_F(TestSqliteDataset, Prepared)
+{
+  AddPaths(10);
+
+  ASSERT_TRUE(ds->query_prepared("SELECT idPath, strPath, dRating FROM path WHERE strPath = ?",
+                                 {field_value("/music/artist's 3/")}));
+  ASSERT_EQ(1, ds->num_rows());
+  EXPECT_EQ(4, ds->fv("idPath").get_asInt());
+  EXPECT_EQ("/music/artist's 3/", ds->fv("strPath").get_asString());
+  EXPECT_EQ(0.75, ds->fv("dRating").get_asDouble());
+  ds->close();
+
+  // the same statement with another value, and a question mark that is no placeholder
+  ASSERT_TRUE(ds->query_prepared("SELECT strPath FROM path WHERE idPath > ? AND strPath <> '?' ORDER BY idPath",
+                                 {field_value(8)}));
+  ASSERT_EQ(2, ds->num_rows());
+  EXPECT_EQ("/music/artist's 8/", ds->fv(0).get_asString());
+  ds->close();
+}
+
+TEST_F(TestSqliteDataset, Null)
+{
+  field_value null;
+  null.set_isNull();
+  ds->exec_prepared("INSERT INTO path (strPath, dRating) VALUES (?, ?)", {field_value("/null/"), null});
+
+  ASSERT_TRUE(ds->query_prepared("SELECT dRating FROM path WHERE strPath = ?", {field_value("/null/")}));
+  ASSERT_EQ(1, ds->num_rows());
+  EXPECT_TRUE(ds->fv(0).get_isNull());
+  ds->close();
+}
+
+// backends without prepared statements get the values formatted into the sql
+TEST_F(TestSqliteDataset, Text)
+{
+  AddPaths(10);
+
+  ASSERT_TRUE(ds->Dataset::query_prepared("SELECT idPath FROM path WHERE strPath = ? AND dRating = ? AND strPath <> '?'",
+                                          {field_value("/music/artist's 5/"), field_value(1.25)}));
+  ASSERT_EQ(1, ds->num_rows());
+  EXPECT_EQ(6, ds->fv(0).get_asInt());
+  ds->close();
+
+  EXPECT_THROW(ds->Dataset::query_prepared("SELECT idPath FROM path WHERE idPath = ?", {}), DbErrors);
+}
+
+TEST_F(TestSqliteDataset, Errors)
+{
+  EXPECT_THROW(ds->query_prepared("SELECT idPath FROM path WHERE idPath = ?", {}), DbErrors);
+  EXPECT_THROW(ds->query_prepared("SELECT idPath FROM path", {field_value(1)}), DbErrors);
+  EXPECT_THROW(ds->query_prepared("SELECT nothing FROM path WHERE idPath = ?", {field_value(1)}), DbErrors);
+
+  // the statement is usable again after a failure
+  ds->exec_prepared("INSERT INTO path (idPath, strPath) VALUES (?, ?)", {field_value(1), field_value("/a/")});
+  EXPECT_THROW(ds->exec_prepared("INSERT INTO path (idPath, strPath) VALUES (?, ?)",
+                                 {field_value(1), field_value("/b/")}), DbErrors);
+  ds->exec_prepared("INSERT INTO path (idPath, strPath) VALUES (?, ?)", {field_value(2), field_value("/b/")});
+  ASSERT_TRUE(ds->query("SELECT COUNT(*) FROM path"));
+  EXPECT_EQ(2, ds->fv(0).get_asInt());
+  ds->close();
+}
+
+TEST_F(TestSqliteDataset, Cache)
+{
+  AddPaths(1);
+  const size_t cached = db.cached_statements();
+
+  for (int i = 0; i < 10; i++)
+  {
+    ds->query_prepared("SELECT strPath FROM path WHERE idPath = ?", {field_value(i)});
+    ds->close();
+  }
+  EXPECT_EQ(cached + 1, db.cached_statements());
+
+  for (size_t i = 0; i < SqliteDatabase::MAX_CACHED_STATEMENTS + 10; i++)
+  {
+    ds->query_prepared("SELECT strPath FROM path WHERE idPath = ? + " + std::to_string(i), {field_value(1)});
+    ds->close();
+  }
+  EXPECT_EQ(SqliteDatabase::MAX_CACHED_STATEMENTS, db.cached_statements());
+
+  // the cache goes with the connection
+  db.disconnect();
+  EXPECT_EQ(0u, db.cached_statements());
+}
+
+TEST_F(TestSqliteDataset, Cursor)
+{
+  AddPaths(100);
+  field_value null;
+  null.set_isNull();
+  ds->exec_prepared("INSERT INTO path (strPath, dRating) VALUES (?, ?)", {field_value("/null/"), null});
+
+  ASSERT_TRUE(ds->query("SELECT idPath, strPath, dRating FROM path ORDER BY idPath"));
+  std::vector<sql_record> stored;
+  for (; !ds->eof(); ds->next())
+    stored.push_back(*ds->get_sql_record());
+  ds->close();
+
+  ASSERT_TRUE(ds->open_cursor("SELECT idPath, strPath, dRating FROM path ORDER BY idPath"));
+  EXPECT_EQ("strPath", ds->get_result_set().record_header[1].name);
+  size_t rows = 0;
+  while (const sql_record* const record = ds->fetch_row())
+  {
+    ASSERT_LT(rows, stored.size());
+    ASSERT_EQ(3u, record->size());
+    for (unsigned int i = 0; i < 3; i++)
+    {
+      EXPECT_EQ(stored[rows][i].get_fType(), record->at(i).get_fType());
+      EXPECT_EQ(stored[rows][i].get_isNull(), record->at(i).get_isNull());
+      EXPECT_EQ(stored[rows][i].get_asString(), record->at(i).get_asString());
+    }
+    rows++;
+  }
+  EXPECT_EQ(stored.size(), rows);
+  EXPECT_EQ(nullptr, ds->fetch_row());
+
+  // other queries of the connection can run while the cursor is open
+  ASSERT_TRUE(ds->open_cursor("SELECT strPath FROM path WHERE dRating > 20 ORDER BY idPath"));
+  std::unique_ptr<Dataset> other(db.CreateDataset());
+  ASSERT_TRUE(other->query("SELECT COUNT(*) FROM path"));
+  EXPECT_EQ(101, other->fv(0).get_asInt());
+  other->close();
+  ASSERT_NE(nullptr, ds->fetch_row());
+
+  // closing ends the cursor
+  ds->close();
+  EXPECT_EQ(nullptr, ds->fetch_row());
+
+  EXPECT_THROW(ds->open_cursor("SELECT nothing FROM path"), DbErrors);
+  EXPECT_EQ(nullptr, ds->fetch_row());
+}
+
+// a reader on a database in WAL mode doesn't wait for the writer and sees committed rows only
+TEST_F(TestSqliteDataset, ReadOnly)
+{
+  ds->exec("PRAGMA journal_mode=WAL");
+  AddPaths(10);
+
+  SqliteDatabase reader;
+  reader.setHostName(db.getHostName());
+  reader.setDatabase("TestSqliteDataset");
+  reader.setReadOnly(true);
+  ASSERT_EQ(DB_CONNECTION_OK, reader.connect(true));
+  std::unique_ptr<Dataset> rds(reader.CreateDataset());
+
+  db.start_transaction();
+  ds->exec("INSERT INTO path (strPath) VALUES ('/uncommitted/')");
+  ASSERT_TRUE(rds->query("SELECT COUNT(*) FROM path"));
+  EXPECT_EQ(10, rds->fv(0).get_asInt());
+  rds->close();
+  db.commit_transaction();
+
+  ASSERT_TRUE(rds->query_prepared("SELECT COUNT(*) FROM path WHERE idPath > ?", {field_value(0)}));
+  EXPECT_EQ(11, rds->fv(0).get_asInt());
+  rds->close();
+
+  EXPECT_THROW(rds->exec("DELETE FROM path"), DbErrors);
+  rds.reset();
+  reader.disconnect();
+
+  // a missing database isn't created
+  reader.setDatabase("TestSqliteDatasetMissing");
+  EXPECT_NE(DB_CONNECTION_OK, reader.connect(true));
+}
+
+/* Not a correctness test, prints the time of lookups by path as text queries
+ * and as prepared statements. Disabled as it is slow, run with --gtest_also_run_disabled_tests.
+ */
+TEST_F(TestSqliteDataset, DISABLED_Benchmark)
+{
+  using Clock = std::chrono::steady_clock;
+  const int count = 20000;
+  AddPaths(count);
+  ds->exec("CREATE UNIQUE INDEX ix_path ON path (strPath)");
+
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < count; i++)
+  {
+    ds->query(db.prepare("SELECT idPath FROM path WHERE strPath = '%s'",
+                         ("/music/artist's " + std::to_string(i) + "/").c_str()));
+    ds->close();
+  }
+  double text = std::chrono::duration<double>(Clock::now() - start).count();
+
+  start = Clock::now();
+  for (int i = 0; i < count; i++)
+  {
+    ds->query_prepared("SELECT idPath FROM path WHERE strPath = ?",
+                       {field_value("/music/artist's " + std::to_string(i) + "/")});
+    ds->close();
+  }
+  double prepared = std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::cout << "TestSqliteDataset " << count << " lookups: text " << text * 1000 << " ms, prepared "
+            << prepared * 1000 << " ms" << std::endl;
+}
+
+/* Not a correctness test, prints the time of reading all rows into the result set
+ * and with a cursor. Disabled as it is slow, run with --gtest_also_run_disabled_tests.
+ */
+TEST_F(TestSqliteDataset, DISABLED_CursorBenchmark)
+{
+  using Clock = std::chrono::steady_clock;
+  AddPaths(100000);
+  const std::string sql = "SELECT idPath, strPath, dRating FROM path";
+
+  Clock::time_point start = Clock::now();
+  size_t length = 0;
+  ds->query(sql);
+  for (const sql_record* const record : ds->get_result_set().records)
+    length += record->at(1).get_asString().size();
+  ds->close();
+  double stored = std::chrono::duration<double>(Clock::now() - start).count();
+
+  start = Clock::now();
+  size_t cursorLength = 0;
+  ds->open_cursor(sql);
+  while (const sql_record* const record = ds->fetch_row())
+    cursorLength += record->at(1).get_asString().size();
+  ds->close();
+  double cursor = std::chrono::duration<double>(Clock::now() - start).count();
+
+  EXPECT_EQ(length, cursorLength);
+  std::cout << "TestSqliteDataset 100000 rows: result set " << stored * 1000 << " ms, cursor "
+            << cursor * 1000 << " ms" << std::endl;
+}
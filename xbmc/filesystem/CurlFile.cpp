@@ -249,6 +249,7 @@ CCurlFile::CReadState::CReadState()
   m_cancelled = false;
   m_bFirstLoop = true;
   m_sendRange = true;
+  m_rangeEnd = -1;
   m_bLastError = false;
   m_readBuffer = 0;
   m_isPaused = false;
@@ -307,6 +308,15 @@ bool CCurlFile::CReadState::Seek(int64_t pos)
 
 void CCurlFile::CReadState::SetResume(void)
 {
+  if (m_rangeEnd >= 0)
+  {
+    // bounded range request, see CCurlFile::SetRequestRange
+    std::string range = StringUtils::Format("%" PRId64 "-%" PRId64, m_filePos, m_rangeEnd);
+    g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RANGE, range.c_str());
+    g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RESUME_FROM_LARGE, static_cast<int64_t>(0));
+    return;
+  }
+
   /*
    * Explicitly set RANGE header when filepos=0 as some http servers require us to always send the range
    * request header. If we don't the server may provide different content causing seeking to fail.
@@ -377,6 +387,7 @@ void CCurlFile::CReadState::Disconnect()
   m_overflowSize = 0;
   m_filePos = 0;
   m_fileSize = 0;
+  m_rangeEnd = -1;
   m_bufferSize = 0;
   m_readBuffer = 0;
 
@@ -450,6 +461,8 @@ void CCurlFile::Close()
   m_opened = false;
   m_forWrite = false;
   m_inError = false;
+  m_rangeStart = 0;
+  m_rangeEnd = -1;
 }
 
 void CCurlFile::SetCommonOptions(CReadState* state, bool failOnError /* = true */)
@@ -1012,6 +1025,11 @@ bool CCurlFile::Open(const CURL& url)
   SetRequestHeaders(m_state);
   m_state->m_sendRange = m_seekable;
   m_state->m_bRetry = m_allowRetry;
+  if (m_rangeEnd >= 0)
+  {
+    m_state->m_filePos = m_rangeStart;
+    m_state->m_rangeEnd = m_rangeEnd;
+  }
 
   m_httpresponse = m_state->Connect(m_bufferSize);
 
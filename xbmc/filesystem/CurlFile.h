@@ -78,6 +78,15 @@ namespace XFILE
       void ClearRequestHeaders();
       void SetBufferSize(unsigned int size);
 
+      /*!
+       \brief Restrict the next Open() to the bytes [start, end] of the resource.
+       The range is dropped again on Close(). GetLength() reports end + 1.
+       \param start position of the first byte to fetch
+       \param end position of the last byte to fetch, inclusive
+       */
+      void SetRequestRange(int64_t start, int64_t end) { m_rangeStart = start; m_rangeEnd = end; }
+      long GetHttpResponseCode() const { return m_httpresponse; }
+
       const CHttpHeader& GetHttpHeader() const { return m_state->m_httpheader; }
       std::string GetURL(void);
       std::string GetRedirectURL();
@@ -110,6 +119,7 @@ namespace XFILE
           bool m_bFirstLoop;
           bool m_isPaused;
           bool m_sendRange;
+          int64_t m_rangeEnd; // last byte of a bounded range request, -1 if unbounded
           bool m_bLastError;
           bool m_bRetry;
 
@@ -150,6 +160,8 @@ namespace XFILE
       CReadState* m_oldState;
       unsigned int m_bufferSize;
       int64_t m_writeOffset = 0;
+      int64_t m_rangeStart = 0;
+      int64_t m_rangeEnd = -1;
 
       std::string m_url;
       std::string m_userAgent;
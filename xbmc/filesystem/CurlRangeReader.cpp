@@ -0,0 +1,338 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "CurlRangeReader.h"
+
+#include "CurlFile.h"
+#include "ServiceBroker.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <inttypes.h>
+#include <map>
+
+using namespace XFILE;
+
+namespace
+{
+// amount of data a worker reads from its connection before handing it out
+constexpr size_t FETCH_READ_SIZE = 64 * 1024;
+
+CCriticalSection hostConnectionsLock;
+std::map<std::string, unsigned int> hostConnections;
+}
+
+class CCurlRangeReader::CWorker : public CThread
+{
+public:
+  explicit CWorker(CCurlRangeReader& owner) : CThread("CurlRangeReader"), m_owner(owner) {}
+
+  //! abort the transfer in progress, the connection is reused for the next chunk otherwise
+  void CancelTransfer() { m_file.Cancel(); }
+
+protected:
+  void Process() override
+  {
+    while (!m_bStop && !m_owner.m_stop)
+    {
+      std::shared_ptr<Chunk> chunk = m_owner.TakeChunk();
+      if (chunk)
+        m_owner.FetchChunk(*chunk, m_file);
+      else
+        m_owner.m_chunkAvailable.WaitMSec(100);
+    }
+  }
+
+private:
+  CCurlRangeReader& m_owner;
+  CCurlFile m_file;
+};
+
+CCurlRangeReader::CCurlRangeReader(const CURL& url, int64_t fileSize, unsigned int chunkSize)
+  : m_url(url),
+    m_fileSize(fileSize),
+    m_chunkSize(std::max(chunkSize, 1u)),
+    m_stop(false),
+    m_rangeUnsupported(false)
+{
+}
+
+CCurlRangeReader::~CCurlRangeReader()
+{
+  Close();
+}
+
+bool CCurlRangeReader::Open(unsigned int connections, int64_t position)
+{
+  Close();
+
+  if (m_fileSize <= 0 || position < 0 || position > m_fileSize)
+    return false;
+
+  // the caller keeps its own stream to the host open, reserve a connection for it
+  const unsigned int hostLimit = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_curlRangeHostLimit;
+  unsigned int granted = AcquireConnections(m_url.GetHostName(), connections + 1, hostLimit);
+  if (granted < 3)
+  {
+    // a single range connection is better served by the plain stream
+    ReleaseConnections(m_url.GetHostName(), granted);
+    CLog::Log(LOGDEBUG, "CCurlRangeReader::Open - no connections left to %s", m_url.GetHostName().c_str());
+    return false;
+  }
+  granted--;
+
+  CLog::Log(LOGDEBUG, "CCurlRangeReader::Open - using %u connections for %s", granted, m_url.GetRedacted().c_str());
+
+  {
+    CSingleLock lock(m_critSection);
+    m_stop = false;
+    m_rangeUnsupported = false;
+    m_connections = granted;
+    m_position = position;
+    m_nextChunkStart = position;
+    FillWindow();
+  }
+
+  CSingleLock lock(m_workersSection);
+  for (unsigned int i = 0; i < granted; i++)
+  {
+    m_workers.emplace_back(new CWorker(*this));
+    m_workers.back()->Create();
+  }
+
+  return true;
+}
+
+void CCurlRangeReader::Close()
+{
+  if (m_connections == 0)
+    return;
+
+  m_stop = true;
+  {
+    CSingleLock lock(m_critSection);
+    ClearChunks();
+  }
+  m_chunkAvailable.Set();
+  m_dataAvailable.Set();
+
+  CancelTransfers();
+
+  {
+    CSingleLock lock(m_workersSection);
+    for (auto& worker : m_workers)
+      worker->StopThread(true);
+    m_workers.clear();
+  }
+
+  ReleaseConnections(m_url.GetHostName(), m_connections + 1);
+  m_connections = 0;
+}
+
+ssize_t CCurlRangeReader::Read(void* buffer, size_t size)
+{
+  CSingleLock lock(m_critSection);
+  while (!m_stop)
+  {
+    if (m_position >= m_fileSize)
+      return 0;
+
+    if (m_chunks.empty())
+      return -1;
+
+    Chunk& chunk = *m_chunks.front();
+    const size_t offset = static_cast<size_t>(m_position - chunk.start);
+    if (chunk.filled > offset)
+    {
+      const size_t count = std::min(size, chunk.filled - offset);
+      memcpy(buffer, chunk.data.data() + offset, count);
+      m_position += count;
+
+      if (offset + count == chunk.size)
+      {
+        m_chunks.pop_front();
+        FillWindow();
+      }
+      return static_cast<ssize_t>(count);
+    }
+
+    if (chunk.failed)
+      return -1;
+
+    lock.Leave();
+    m_dataAvailable.WaitMSec(100);
+    lock.Enter();
+  }
+
+  return -1;
+}
+
+int64_t CCurlRangeReader::Seek(int64_t position)
+{
+  if (position < 0 || position > m_fileSize)
+    return -1;
+
+  CSingleLock lock(m_critSection);
+
+  // keep the chunks behind the new position, they are fetched already
+  while (!m_chunks.empty() &&
+         m_chunks.front()->start + static_cast<int64_t>(m_chunks.front()->size) <= position)
+  {
+    m_chunks.front()->cancelled = true;
+    m_chunks.pop_front();
+  }
+
+  if (m_chunks.empty() || m_chunks.front()->start > position)
+  {
+    ClearChunks();
+    m_nextChunkStart = position;
+  }
+
+  m_position = position;
+  FillWindow();
+
+  return position;
+}
+
+void CCurlRangeReader::Cancel()
+{
+  m_stop = true;
+  m_chunkAvailable.Set();
+  m_dataAvailable.Set();
+
+  CancelTransfers();
+}
+
+void CCurlRangeReader::CancelTransfers()
+{
+  // CCurlFile::Cancel() waits for the worker to close its connection, which
+  // needs m_critSection, so it must not be held here
+  CSingleLock lock(m_workersSection);
+  for (auto& worker : m_workers)
+    worker->CancelTransfer();
+}
+
+unsigned int CCurlRangeReader::AcquireConnections(const std::string& hostName, unsigned int wanted, unsigned int limit)
+{
+  CSingleLock lock(hostConnectionsLock);
+  unsigned int& used = hostConnections[hostName];
+  const unsigned int granted = used < limit ? std::min(wanted, limit - used) : 0;
+  used += granted;
+  return granted;
+}
+
+void CCurlRangeReader::ReleaseConnections(const std::string& hostName, unsigned int count)
+{
+  CSingleLock lock(hostConnectionsLock);
+  auto it = hostConnections.find(hostName);
+  if (it == hostConnections.end())
+    return;
+
+  it->second -= std::min(count, it->second);
+  if (it->second == 0)
+    hostConnections.erase(it);
+}
+
+std::shared_ptr<CCurlRangeReader::Chunk> CCurlRangeReader::TakeChunk()
+{
+  CSingleLock lock(m_critSection);
+  auto it = std::find_if(m_chunks.begin(), m_chunks.end(),
+                         [](const std::shared_ptr<Chunk>& chunk) { return !chunk->taken; });
+  if (it == m_chunks.end())
+    return nullptr;
+
+  (*it)->taken = true;
+
+  // wake another worker if there is more to do
+  if (std::any_of(it + 1, m_chunks.end(), [](const std::shared_ptr<Chunk>& chunk) { return !chunk->taken; }))
+    m_chunkAvailable.Set();
+
+  return *it;
+}
+
+void CCurlRangeReader::FetchChunk(Chunk& chunk, CCurlFile& file)
+{
+  // the reader only looks at data once filled has moved past it
+  chunk.data.resize(chunk.size);
+
+  file.SetRequestRange(chunk.start, chunk.start + chunk.size - 1);
+
+  bool failed = false;
+  if (!file.Open(m_url))
+  {
+    CLog::Log(LOGERROR, "CCurlRangeReader::FetchChunk - failed to request range at %" PRId64, chunk.start);
+    failed = true;
+  }
+  else if (file.GetHttpResponseCode() != 206)
+  {
+    CLog::Log(LOGWARNING, "CCurlRangeReader::FetchChunk - server answered range request with %li, ranges not supported",
+              file.GetHttpResponseCode());
+    m_rangeUnsupported = true;
+    failed = true;
+  }
+
+  size_t filled = 0;
+  while (!failed)
+  {
+    ssize_t read = file.Read(chunk.data.data() + filled, std::min(chunk.size - filled, FETCH_READ_SIZE));
+
+    CSingleLock lock(m_critSection);
+    if (read <= 0)
+    {
+      if (!chunk.cancelled && !m_stop)
+        CLog::Log(LOGERROR, "CCurlRangeReader::FetchChunk - transfer of range at %" PRId64 " ended early", chunk.start);
+      failed = true;
+      break;
+    }
+
+    filled += read;
+    chunk.filled = filled;
+    m_dataAvailable.Set();
+
+    if (filled == chunk.size || chunk.cancelled || m_stop)
+      break;
+  }
+
+  file.Close();
+
+  if (failed)
+  {
+    CSingleLock lock(m_critSection);
+    chunk.failed = true;
+    m_dataAvailable.Set();
+  }
+}
+
+void CCurlRangeReader::FillWindow()
+{
+  bool added = false;
+  while (m_chunks.size() < 2 * m_connections && m_nextChunkStart < m_fileSize)
+  {
+    auto chunk = std::make_shared<Chunk>();
+    chunk->start = m_nextChunkStart;
+    chunk->size = static_cast<size_t>(std::min<int64_t>(m_chunkSize, m_fileSize - m_nextChunkStart));
+    m_nextChunkStart += chunk->size;
+    m_chunks.push_back(chunk);
+    added = true;
+  }
+
+  if (added)
+    m_chunkAvailable.Set();
+}
+
+void CCurlRangeReader::ClearChunks()
+{
+  for (auto& chunk : m_chunks)
+    chunk->cancelled = true;
+  m_chunks.clear();
+}
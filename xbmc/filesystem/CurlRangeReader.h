@@ -0,0 +1,136 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "PlatformDefs.h" // for ssize_t
+#include "URL.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace XFILE
+{
+class CCurlFile;
+
+/*!
+ \brief Sequential reader that fetches an HTTP resource over several connections.
+
+ The resource is split into chunks which are requested with bounded Range
+ requests by a set of worker threads, each with its own connection. Read()
+ hands out the data in order as soon as the chunk at the read position has
+ been filled far enough. At most twice as many chunks as connections are in
+ flight. The number of connections to a single host is limited over all
+ readers, see AcquireConnections(). The caller's own stream to the host is
+ counted against that limit while the reader is open.
+
+ If the server answers a range request with anything but 206 Partial Content,
+ Read() fails and IsRangeSupported() returns false, so the caller can fall back
+ to a single stream.
+ */
+class CCurlRangeReader
+{
+public:
+  static const unsigned int DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+  /*!
+   \param url location of the resource, http or https
+   \param fileSize size of the resource in bytes, must be known
+   \param chunkSize size of a single range request in bytes
+   */
+  CCurlRangeReader(const CURL& url, int64_t fileSize, unsigned int chunkSize = DEFAULT_CHUNK_SIZE);
+  ~CCurlRangeReader();
+
+  CCurlRangeReader(const CCurlRangeReader&) = delete;
+  CCurlRangeReader& operator=(const CCurlRangeReader&) = delete;
+
+  /*!
+   \brief Start fetching at the given position.
+   \param connections number of range connections to use
+   \param position position in the resource to start at
+   \return false if less than two range connections besides the caller's own
+           stream to the host are available
+   */
+  bool Open(unsigned int connections, int64_t position);
+  void Close();
+  bool IsOpen() const { return m_connections > 0; }
+
+  /*!
+   \brief Read the next bytes, blocks until data at the read position is available.
+   \return number of bytes read, 0 at the end of the resource or -1 on error
+   */
+  ssize_t Read(void* buffer, size_t size);
+
+  /*!
+   \brief Drop all pending chunks and continue fetching at the given position.
+   \return the new position or -1 if it is outside of the resource
+   */
+  int64_t Seek(int64_t position);
+  int64_t GetPosition() const { return m_position; }
+
+  /*!
+   \brief Make a blocking Read() return and abort the transfers in progress,
+          used when the caller is shutting down
+   */
+  void Cancel();
+
+  bool IsRangeSupported() const { return !m_rangeUnsupported; }
+
+  /*!
+   \brief Reserve connections to a host.
+   \param hostName name of the host
+   \param wanted number of connections the caller would like to use
+   \param limit maximum number of connections to the host over all callers
+   \return number of connections granted, may be 0
+   */
+  static unsigned int AcquireConnections(const std::string& hostName, unsigned int wanted, unsigned int limit);
+  static void ReleaseConnections(const std::string& hostName, unsigned int count);
+
+private:
+  class CWorker;
+
+  struct Chunk
+  {
+    int64_t start; //!< position of the first byte in the resource
+    size_t size; //!< number of bytes requested
+    std::vector<char> data;
+    size_t filled = 0; //!< bytes received so far
+    bool taken = false; //!< a worker is fetching the chunk
+    bool failed = false;
+    bool cancelled = false; //!< dropped by a seek or close
+  };
+
+  std::shared_ptr<Chunk> TakeChunk();
+  void FetchChunk(Chunk& chunk, CCurlFile& file);
+  void CancelTransfers();
+  void FillWindow();
+  void ClearChunks();
+
+  const CURL m_url;
+  const int64_t m_fileSize;
+  const size_t m_chunkSize;
+
+  CCriticalSection m_critSection;
+  CEvent m_chunkAvailable; //!< signaled to workers when there is a chunk to fetch
+  CEvent m_dataAvailable; //!< signaled to the reader when a chunk made progress
+  std::deque<std::shared_ptr<Chunk>> m_chunks; //!< in order, the front holds the read position
+  CCriticalSection m_workersSection; //!< guards m_workers, never taken while holding m_critSection
+  std::vector<std::unique_ptr<CWorker>> m_workers;
+  unsigned int m_connections = 0; //!< range connections, the caller's stream is reserved on top
+  int64_t m_position = 0;
+  int64_t m_nextChunkStart = 0;
+  std::atomic<bool> m_stop;
+  std::atomic<bool> m_rangeUnsupported;
+};
+
+}
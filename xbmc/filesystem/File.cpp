@@ -15,6 +15,7 @@
 #include "DirectoryCache.h"
 #include "FileCache.h"
 #include "FileFactory.h"
+#include "FilePrefetcher.h"
 #include "IFile.h"
 #include "PasswordManager.h"
 #include "Util.h"
@@ -282,6 +283,18 @@ bool CFile::Open(const CURL& file, const unsigned int flags)
         return false;
     }
 
+    // the player gets the cache of a prefetched playlist item unless it asked
+    // to bypass the cache or the cache was opened for another kind of read
+    if ((m_flags & READ_AUDIO_VIDEO) && !(m_flags & READ_NO_CACHE))
+    {
+      m_pFile = CFilePrefetcher::GetInstance().Take(url, m_flags);
+      if (m_pFile)
+      {
+        m_flags |= READ_CACHED;
+        return true;
+      }
+    }
+
     if (!(m_flags & READ_NO_CACHE))
     {
       const std::string pathToUrl(url.Get());
@@ -14,6 +14,8 @@
 #include "ServiceBroker.h"
 
 #include "CircularCache.h"
+#include "CurlRangeReader.h"
+#include "SegmentFileCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
@@ -140,7 +142,17 @@ bool CFileCache::Open(const CURL& url)
 
   if (!m_pCache)
   {
-    if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
+    const uint64_t segmentDiskSize = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheSegmentDiskSize;
+    if (segmentDiskSize > 0 && m_seekPossible > 0)
+    {
+      // Use sparse cache on disk, keeps ranges fetched before a seek
+      size_t cacheSize = static_cast<size_t>(std::min<uint64_t>(segmentDiskSize, SIZE_MAX));
+      if (m_flags & READ_MULTI_STREAM)
+        cacheSize /= 2;
+      m_pCache = std::unique_ptr<CSegmentFileCache>(new CSegmentFileCache(cacheSize)); // C++14 - Replace with std::make_unique
+      m_forwardCacheSize = cacheSize;
+    }
+    else if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
     {
       // Use cache on disk
       m_pCache = std::unique_ptr<CSimpleFileCache>(new CSimpleFileCache()); // C++14 - Replace with std::make_unique
@@ -179,6 +191,17 @@ bool CFileCache::Open(const CURL& url)
     }
   }
 
+  // fetch http sources over several connections if enabled
+  const int rangeConnections = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_curlRangeConnections;
+  if (rangeConnections > 1 && m_seekPossible > 0 && m_fileSize > 0 &&
+      (url.IsProtocol("http") || url.IsProtocol("https")))
+  {
+    const int chunkSize = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_curlRangeChunkSize;
+    m_rangeReader = std::unique_ptr<CCurlRangeReader>(new CCurlRangeReader(url, m_fileSize, chunkSize)); // C++14 - Replace with std::make_unique
+    if (!m_rangeReader->Open(rangeConnections, 0))
+      m_rangeReader.reset();
+  }
+
   // open cache strategy
   if (!m_pCache || m_pCache->Open() != CACHE_RC_OK)
   {
@@ -236,7 +259,7 @@ void CFileCache::Process()
       bool sourceSeekFailed = false;
       if (!cacheReachEOF)
       {
-        m_nSeekResult = m_source.Seek(cacheMaxPos, SEEK_SET);
+        m_nSeekResult = SeekSource(cacheMaxPos);
         if (m_nSeekResult != cacheMaxPos)
         {
           CLog::Log(LOGERROR,"CFileCache::Process - Error %d seeking. Seek returned %" PRId64, (int)GetLastError(), m_nSeekResult);
@@ -296,7 +319,7 @@ void CFileCache::Process()
 
     ssize_t iRead = 0;
     if (!cacheReachEOF)
-      iRead = m_source.Read(buffer.get(), maxWrite);
+      iRead = ReadSource(buffer.get(), maxWrite);
     if (iRead == 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
@@ -378,6 +401,22 @@ void CFileCache::Process()
 
     m_writePos += iTotalWrite;
 
+    // the cache may hold the data that follows already, e.g. when a gap between
+    // two cached ranges was filled. Continue the source behind it.
+    const int64_t cacheEndPos = m_pCache->CachedDataEndPos();
+    if (cacheEndPos > m_writePos)
+    {
+      if (SeekSource(cacheEndPos) != cacheEndPos)
+      {
+        CLog::Log(LOGERROR, "CFileCache::Process - Error %d seeking past cached data to %" PRId64, (int)GetLastError(), cacheEndPos);
+        m_seekPossible = m_source.IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
+        break; // while (!m_bStop)
+      }
+      m_writePos = cacheEndPos;
+      average.Reset(m_writePos, false);
+      limiter.Reset(m_writePos);
+    }
+
     // under estimate write rate by a second, to
     // avoid uncertainty at start of caching
     m_writeRateActual = average.Rate(m_writePos, 1000);
@@ -406,6 +445,35 @@ void CFileCache::Process()
   }
 }
 
+ssize_t CFileCache::ReadSource(char* buffer, size_t size)
+{
+  if (m_rangeReader && m_rangeReader->IsOpen())
+  {
+    ssize_t iRead = m_rangeReader->Read(buffer, size);
+    if (iRead >= 0 || m_bStop)
+      return iRead;
+
+    CLog::Log(LOGWARNING, "CFileCache::ReadSource - range requests failed%s, falling back to a single stream",
+              m_rangeReader->IsRangeSupported() ? "" : " (not supported by server)");
+
+    // the reader stays around until Close(), StopThread() may still cancel it
+    const int64_t position = m_rangeReader->GetPosition();
+    m_rangeReader->Close();
+    if (m_source.Seek(position, SEEK_SET) != position)
+      return -1;
+  }
+
+  return m_source.Read(buffer, size);
+}
+
+int64_t CFileCache::SeekSource(int64_t position)
+{
+  if (m_rangeReader && m_rangeReader->IsOpen())
+    return m_rangeReader->Seek(position);
+
+  return m_source.Seek(position, SEEK_SET);
+}
+
 void CFileCache::OnExit()
 {
   m_bStop = true;
@@ -537,6 +605,7 @@ void CFileCache::Close()
   if (m_pCache)
     m_pCache->Close();
 
+  m_rangeReader.reset();
   m_source.Close();
 }
 
@@ -555,6 +624,9 @@ void CFileCache::StopThread(bool bWait /*= true*/)
   m_bStop = true;
   //Process could be waiting for seekEvent
   m_seekEvent.Set();
+  //or for data from the range reader
+  if (m_rangeReader)
+    m_rangeReader->Cancel();
   CThread::StopThread(bWait);
 }
 
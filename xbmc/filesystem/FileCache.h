@@ -20,6 +20,8 @@
 namespace XFILE
 {
 
+  class CCurlRangeReader;
+
   class CFileCache : public IFile, public CThread
   {
   public:
@@ -55,7 +57,11 @@ namespace XFILE
     }
 
   private:
+    ssize_t ReadSource(char* buffer, size_t size);
+    int64_t SeekSource(int64_t position);
+
     std::unique_ptr<CCacheStrategy> m_pCache;
+    std::unique_ptr<CCurlRangeReader> m_rangeReader;
     int m_seekPossible;
     CFile m_source;
     std::string m_sourcePath;
@@ -0,0 +1,169 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FilePrefetcher.h"
+
+#include "FileCache.h"
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+using namespace XFILE;
+
+namespace
+{
+// the flags CFileCache buffers a file differently for
+constexpr unsigned int CACHE_FLAGS = READ_AUDIO_VIDEO | READ_MULTI_STREAM;
+}
+
+CFilePrefetcher& CFilePrefetcher::GetInstance()
+{
+  static CFilePrefetcher instance;
+  return instance;
+}
+
+void CFilePrefetcher::Prefetch(const CFileItem& item)
+{
+  const std::string& itemPath = item.GetDynPath();
+  if (!URIUtils::IsRemote(itemPath) || URIUtils::IsUPnP(itemPath) ||
+      item.IsPlugin() || item.IsStack() || item.IsPVR() || item.IsPlayList() ||
+      item.IsDiscImage() || item.IsDVDFile() || item.IsBDFile())
+    return;
+
+  // without a memory cache CFileCache would fetch the whole file to disk
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  if (advancedSettings->m_cacheMemSize == 0 && advancedSettings->m_cacheSegmentDiskSize == 0)
+    return;
+
+  // only prefetch what the player would open through the cache, see CDVDInputStreamFile::Open()
+  const unsigned int cacheBufferMode = advancedSettings->m_cacheBufferMode;
+  if (!((cacheBufferMode == CACHE_BUFFER_MODE_INTERNET && URIUtils::IsInternetStream(itemPath, true)) ||
+        (cacheBufferMode == CACHE_BUFFER_MODE_TRUE_INTERNET && URIUtils::IsInternetStream(itemPath, false)) ||
+        cacheBufferMode == CACHE_BUFFER_MODE_REMOTE || cacheBufferMode == CACHE_BUFFER_MODE_ALL))
+    return;
+
+  Prefetch(CURL(URIUtils::SubstitutePath(itemPath)).Get(), GetOpenFlags(item));
+}
+
+void CFilePrefetcher::Prefetch(const std::string& path, unsigned int flags)
+{
+  std::unique_ptr<CFileCache> oldFile;
+  unsigned int generation;
+  {
+    CSingleLock lock(m_critSection);
+    if (m_path == path && m_flags == flags)
+      return;
+
+    oldFile = std::move(m_file);
+    m_path = path;
+    m_flags = flags;
+    generation = ++m_generation;
+  }
+
+  // closing stops the fill thread, don't do that with the lock held
+  oldFile.reset();
+
+  CLog::Log(LOGDEBUG, "CFilePrefetcher::Prefetch - opening %s", CURL::GetRedacted(path).c_str());
+  CJobManager::GetInstance().Submit([this, path, flags, generation]() { Open(path, flags, generation); },
+                                    CJob::PRIORITY_NORMAL);
+}
+
+unsigned int CFilePrefetcher::GetOpenFlags(const CFileItem& item)
+{
+  unsigned int flags = READ_AUDIO_VIDEO | READ_CACHED;
+
+  const std::string& mimeType = item.GetMimeType();
+  if (mimeType == "video/mp4" ||
+      mimeType == "video/x-msvideo" ||
+      mimeType == "video/avi" ||
+      mimeType == "video/x-matroska" ||
+      mimeType == "video/x-matroska-3d")
+    flags |= READ_MULTI_STREAM;
+
+  return flags;
+}
+
+IFile* CFilePrefetcher::Take(const CURL& url, unsigned int flags)
+{
+  std::unique_ptr<CFileCache> oldFile;
+  {
+    CSingleLock lock(m_critSection);
+    if (m_path.empty() || m_path != url.Get())
+      return nullptr;
+
+    // if the item is still opening the caller opens it by itself, the
+    // prefetched file is dropped once it is ready. The path is kept so the
+    // item is not prefetched again while it is played.
+    m_generation++;
+
+    if ((flags & CACHE_FLAGS) == (m_flags & CACHE_FLAGS))
+    {
+      if (m_file)
+        CLog::Log(LOGDEBUG, "CFilePrefetcher::Take - using prefetched %s", url.GetRedacted().c_str());
+
+      return m_file.release();
+    }
+
+    if (m_file)
+      CLog::Log(LOGDEBUG, "CFilePrefetcher::Take - dropping %s prefetched with flags %x, opened with %x",
+                url.GetRedacted().c_str(), m_flags, flags);
+    oldFile = std::move(m_file);
+  }
+
+  // closing stops the fill thread, don't do that with the lock held
+  oldFile.reset();
+  return nullptr;
+}
+
+bool CFilePrefetcher::IsPrefetched(const CURL& url)
+{
+  CSingleLock lock(m_critSection);
+  return m_file && m_path == url.Get();
+}
+
+void CFilePrefetcher::Clear()
+{
+  std::unique_ptr<CFileCache> oldFile;
+  {
+    CSingleLock lock(m_critSection);
+    if (m_path.empty())
+      return;
+
+    oldFile = std::move(m_file);
+    m_path.clear();
+    m_generation++;
+  }
+}
+
+void CFilePrefetcher::Open(const std::string& path, unsigned int flags, unsigned int generation)
+{
+  {
+    CSingleLock lock(m_critSection);
+    if (generation != m_generation)
+      return;
+  }
+
+  std::unique_ptr<CFileCache> file(new CFileCache(flags)); // C++14 - Replace with std::make_unique
+  if (!file->Open(CURL(path)))
+  {
+    CLog::Log(LOGDEBUG, "CFilePrefetcher::Open - failed to open %s", CURL::GetRedacted(path).c_str());
+    return;
+  }
+
+  CSingleLock lock(m_critSection);
+  if (generation == m_generation)
+    m_file = std::move(file);
+
+  // a superseded file is closed when leaving, after the lock was released
+}
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <memory>
+#include <string>
+
+class CFileItem;
+class CURL;
+
+namespace XFILE
+{
+
+class CFileCache;
+class IFile;
+
+/*!
+ \brief Opens the next item to play ahead of time.
+
+ Prefetch() opens a remote item through a CFileCache in the background, with
+ the flags the player will open it with. The cache starts filling with the head
+ of the file right away and stops when its forward buffer is full. The first
+ audio/video open of the same path through CFile takes over the open cache
+ instead of going to the source, see Take(), unless it is opened with
+ READ_NO_CACHE or with flags the cache would have been opened differently for.
+ Only one item is prefetched at a time.
+ */
+class CFilePrefetcher
+{
+public:
+  static CFilePrefetcher& GetInstance();
+
+  /*!
+   \brief Start opening an item in the background, drops an earlier prefetch of another item.
+   Items that are not on a remote filesystem, that need to be resolved first or
+   that the cache buffer mode would not cache are ignored.
+   */
+  void Prefetch(const CFileItem& item);
+
+  /*!
+   \brief Start opening a path in the background with the given flags, without the checks of the item.
+   \param path the substituted url of the file
+   */
+  void Prefetch(const std::string& path, unsigned int flags);
+
+  /*!
+   \brief The flags the player opens an item with, see CDVDInputStreamFile::Open()
+   */
+  static unsigned int GetOpenFlags(const CFileItem& item);
+
+  /*!
+   \brief Hand out the prefetched file for a path.
+   \param url the substituted url of the file
+   \param flags the flags the caller opens the file with. If the cache was opened
+   with other flags that change how it buffers, the prefetched file is dropped.
+   \return the opened file, owned by the caller, or nullptr if the path was not prefetched
+   */
+  IFile* Take(const CURL& url, unsigned int flags);
+
+  /*!
+   \brief Whether the file of a path is open and waiting to be taken
+   */
+  bool IsPrefetched(const CURL& url);
+
+  /*!
+   \brief Drop the prefetched item, e.g. when playback was stopped
+   */
+  void Clear();
+
+private:
+  CFilePrefetcher() = default;
+  CFilePrefetcher(const CFilePrefetcher&) = delete;
+  CFilePrefetcher& operator=(const CFilePrefetcher&) = delete;
+
+  void Open(const std::string& path, unsigned int flags, unsigned int generation);
+
+  CCriticalSection m_critSection;
+  std::string m_path; //!< path prefetched last, empty if none
+  unsigned int m_flags = 0; //!< flags the file of m_path is opened with
+  std::unique_ptr<CFileCache> m_file; //!< the opened file, null while still opening
+  unsigned int m_generation = 0; //!< bumped whenever a pending open has to be dropped
+};
+
+}
@@ -30,7 +30,7 @@ std::string CDirectoryNodeAlbum::GetLocalizedName() const
   if (GetID() == -1)
     return g_localizeStrings.Get(15102); // All Albums
   CMusicDatabase db;
-  if (db.Open())
+  if (db.OpenForRead())
     return db.GetAlbumById(GetID());
   return "";
 }
@@ -38,7 +38,7 @@ std::string CDirectoryNodeAlbum::GetLocalizedName() const
 bool CDirectoryNodeAlbum::GetContent(CFileItemList& items) const
 {
   CMusicDatabase musicdatabase;
-  if (!musicdatabase.Open())
+  if (!musicdatabase.OpenForRead())
     return false;
 
   CQueryParams params;
@@ -34,7 +34,7 @@ std::string CDirectoryNodeAlbumRecentlyPlayed::GetLocalizedName() const
   if (GetID() == -1)
     return g_localizeStrings.Get(15102); // All Albums
   CMusicDatabase db;
-  if (db.Open())
+  if (db.OpenForRead())
     return db.GetAlbumById(GetID());
   return "";
 }
@@ -42,7 +42,7 @@ std::string CDirectoryNodeAlbumRecentlyPlayed::GetLocalizedName() const
 bool CDirectoryNodeAlbumRecentlyPlayed::GetContent(CFileItemList& items) const
 {
   CMusicDatabase musicdatabase;
-  if (!musicdatabase.Open())
+  if (!musicdatabase.OpenForRead())
     return false;
 
   VECALBUMS albums;
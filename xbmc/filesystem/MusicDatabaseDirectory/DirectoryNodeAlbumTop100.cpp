@@ -31,7 +31,7 @@ NODE_TYPE CDirectoryNodeAlbumTop100::GetChildType() const
 std::string CDirectoryNodeAlbumTop100::GetLocalizedName() const
 {
   CMusicDatabase db;
-  if (db.Open())
+  if (db.OpenForRead())
     return db.GetAlbumById(GetID());
   return "";
 }
@@ -39,7 +39,7 @@ std::string CDirectoryNodeAlbumTop100::GetLocalizedName() const
 bool CDirectoryNodeAlbumTop100::GetContent(CFileItemList& items) const
 {
   CMusicDatabase musicdatabase;
-  if (!musicdatabase.Open())
+  if (!musicdatabase.OpenForRead())
     return false;
 
   VECALBUMS albums;
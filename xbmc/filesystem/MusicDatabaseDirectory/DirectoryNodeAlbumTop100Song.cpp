@@ -21,7 +21,7 @@ CDirectoryNodeAlbumTop100Song::CDirectoryNodeAlbumTop100Song(const std::string&
 bool CDirectoryNodeAlbumTop100Song::GetContent(CFileItemList& items) const
 {
   CMusicDatabase musicdatabase;
-  if (!musicdatabase.Open())
+  if (!musicdatabase.OpenForRead())
     return false;
 
   std::string strBaseDir=BuildPath();
@@ -33,7 +33,7 @@ std::string CDirectoryNodeArtist::GetLocalizedName() const
   if (GetID() == -1)
     return g_localizeStrings.Get(15103); // All Artists
   CMusicDatabase db;
-  if (db.Open())
+  if (db.OpenForRead())
     return db.GetArtistById(GetID());
   return "";
 }
@@ -41,7 +41,7 @@ std::string CDirectoryNodeArtist::GetLocalizedName() const
 bool CDirectoryNodeArtist::GetContent(CFileItemList& items) const
 {
   CMusicDatabase musicdatabase;
-  if (!musicdatabase.Open())
+  if (!musicdatabase.OpenForRead())
     return false;
 
   CQueryParams params;
@@ -27,7 +27,7 @@ NODE_TYPE CDirectoryNodeGrouped::GetChildType() const
 std::string CDirectoryNodeGrouped::GetLocalizedName() const
 {
   CMusicDatabase db;
-  if (db.Open())
+  if (db.OpenForRead())
     return db.GetItemById(GetContentType(), GetID());
   return "";
 }
@@ -35,7 +35,7 @@ std::string CDirectoryNodeGrouped::GetLocalizedName() const
 bool CDirectoryNodeGrouped::GetContent(CFileItemList& items) const
 {
   CMusicDatabase musicdatabase;
-  if (!musicdatabase.Open())
+  if (!musicdatabase.OpenForRead())
     return false;
 
   return musicdatabase.GetItems(BuildPath(), GetContentType(), items);
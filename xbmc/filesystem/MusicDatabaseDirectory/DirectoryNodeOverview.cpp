@@ -61,7 +61,7 @@ std::string CDirectoryNodeOverview::GetLocalizedName() const
 bool CDirectoryNodeOverview::GetContent(CFileItemList& items) const
 {
   CMusicDatabase musicDatabase;
-  musicDatabase.Open();
+  musicDatabase.OpenForRead();
 
   bool hasSingles = (musicDatabase.GetSinglesCount() > 0);
   bool hasCompilations = (musicDatabase.GetCompilationAlbumsCount() > 0);
@@ -0,0 +1,467 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SegmentFileCache.h"
+
+#include "IFile.h"
+#include "SpecialProtocol.h"
+#include "URL.h"
+#include "Util.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#ifdef TARGET_POSIX
+#include "PlatformDefs.h"
+#include "platform/posix/ConvUtils.h"
+#endif
+#if defined(TARGET_POSIX)
+#include "platform/posix/filesystem/PosixFile.h"
+#define CacheLocalFile CPosixFile
+#elif defined(TARGET_WINDOWS)
+#include "platform/win32/filesystem/Win32File.h"
+#define CacheLocalFile CWin32File
+#endif // TARGET_WINDOWS
+
+#include <algorithm>
+
+using namespace XFILE;
+
+CSegmentFileCache::CSegmentFileCache(size_t maxSize, size_t segmentSize)
+  : m_cacheFileRead(new CacheLocalFile())
+  , m_cacheFileWrite(new CacheLocalFile())
+  , m_segmentSize(segmentSize)
+  , m_maxSlots(std::max<size_t>(maxSize / segmentSize, 2))
+{
+}
+
+CSegmentFileCache::~CSegmentFileCache()
+{
+  Close();
+  delete m_cacheFileRead;
+  delete m_cacheFileWrite;
+}
+
+int CSegmentFileCache::Open()
+{
+  Close();
+
+  CSingleLock lock(m_sync);
+
+  m_filename = CSpecialProtocol::TranslatePath(CUtil::GetNextFilename("special://temp/filecache%03d.cache", 999));
+  if (m_filename.empty())
+  {
+    CLog::LogF(LOGERROR, "unable to generate a new filename");
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  CURL fileURL(m_filename);
+
+  if (!m_cacheFileWrite->OpenForWrite(fileURL, false))
+  {
+    CLog::LogF(LOGERROR, "failed to create file \"%s\" for writing", m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  if (!m_cacheFileRead->Open(fileURL))
+  {
+    CLog::LogF(LOGERROR, "failed to open file \"%s\" for reading", m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  m_nReadPosition = 0;
+  m_nWritePosition = 0;
+
+  return CACHE_RC_OK;
+}
+
+void CSegmentFileCache::Close()
+{
+  CSingleLock lock(m_sync);
+
+  Clear();
+
+  m_cacheFileWrite->Close();
+  m_cacheFileRead->Close();
+
+  if (!m_filename.empty() && !m_cacheFileRead->Delete(CURL(m_filename)))
+    CLog::LogF(LOGWARNING, "failed to delete temporary file \"%s\"", m_filename.c_str());
+
+  m_filename.clear();
+}
+
+size_t CSegmentFileCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  CSingleLock lock(m_sync);
+
+  size_t freeSlots = GetFreeSlots();
+  size_t maxWrite = 0;
+  int64_t position = m_nWritePosition;
+
+  while (maxWrite < iRequestSize)
+  {
+    // stop in front of data that is cached already
+    if (maxWrite > 0 && IsCached(position))
+      break;
+
+    const int64_t index = position / m_segmentSize;
+    const size_t offset = position % m_segmentSize;
+
+    size_t chunk = std::min(iRequestSize - maxWrite, m_segmentSize - offset);
+
+    auto it = m_segments.find(index);
+    if (it == m_segments.end())
+    {
+      if (freeSlots == 0)
+        break;
+      freeSlots--;
+    }
+    else if (offset < it->second.begin)
+      chunk = std::min(chunk, it->second.begin - offset);
+
+    maxWrite += chunk;
+    position += chunk;
+  }
+
+  return maxWrite;
+}
+
+int CSegmentFileCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  CSingleLock lock(m_sync);
+
+  size_t written = 0;
+  while (written < iSize)
+  {
+    const int64_t index = m_nWritePosition / m_segmentSize;
+    const size_t offset = m_nWritePosition % m_segmentSize;
+    size_t chunk = std::min(iSize - written, m_segmentSize - offset);
+
+    Segment* segment = GetSegmentForWrite(index);
+    if (!segment)
+      break; // no room, the reader has to make progress first
+
+    const int64_t filePosition = static_cast<int64_t>(segment->slot) * m_segmentSize + offset;
+    if (m_cacheFileWrite->Seek(filePosition, SEEK_SET) != filePosition)
+    {
+      CLog::LogF(LOGERROR, "can't seek file");
+      return CACHE_RC_ERROR;
+    }
+
+    const char* data = pBuffer + written;
+    size_t remaining = chunk;
+    while (remaining > 0)
+    {
+      const ssize_t lastWritten = m_cacheFileWrite->Write(data, remaining);
+      if (lastWritten <= 0)
+      {
+        CLog::LogF(LOGERROR, "failed to write to file");
+        return CACHE_RC_ERROR;
+      }
+      data += lastWritten;
+      remaining -= lastWritten;
+    }
+
+    // extend the valid range if the new data touches it, replace it otherwise
+    if (offset <= segment->end && offset + chunk >= segment->begin)
+    {
+      segment->begin = std::min(segment->begin, offset);
+      segment->end = std::max(segment->end, offset + chunk);
+    }
+    else
+    {
+      segment->begin = offset;
+      segment->end = offset + chunk;
+    }
+    Touch(*segment);
+
+    m_nWritePosition += chunk;
+    written += chunk;
+  }
+
+  // a filled gap joins the write position with the range behind it, which
+  // doesn't have to be fetched again. The owner continues the source there,
+  // see CachedDataEndPos().
+  if (IsCached(m_nWritePosition))
+    m_nWritePosition = GetContiguousEnd(m_nWritePosition);
+
+  // when reader waits for data it will wait on the event.
+  if (written > 0)
+    m_hDataAvailEvent.Set();
+
+  return written;
+}
+
+int CSegmentFileCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  CSingleLock lock(m_sync);
+
+  const int64_t iAvailable = GetAvailableRead();
+  if (iAvailable <= 0)
+    return m_bEndOfInput ? 0 : CACHE_RC_WOULD_BLOCK;
+
+  const size_t toRead = (static_cast<int64_t>(iMaxSize) > iAvailable) ? static_cast<size_t>(iAvailable) : iMaxSize;
+
+  size_t readBytes = 0;
+  while (readBytes < toRead)
+  {
+    const int64_t index = m_nReadPosition / m_segmentSize;
+    const size_t offset = m_nReadPosition % m_segmentSize;
+    const size_t chunk = std::min(toRead - readBytes, m_segmentSize - offset);
+
+    // available data is always backed by segments
+    Segment& segment = m_segments.find(index)->second;
+
+    const int64_t filePosition = static_cast<int64_t>(segment.slot) * m_segmentSize + offset;
+    if (m_cacheFileRead->Seek(filePosition, SEEK_SET) != filePosition)
+    {
+      CLog::LogF(LOGERROR, "can't seek file");
+      return CACHE_RC_ERROR;
+    }
+
+    size_t remaining = chunk;
+    while (remaining > 0)
+    {
+      const ssize_t lastRead = m_cacheFileRead->Read(pBuffer + readBytes, remaining);
+      if (lastRead <= 0)
+      {
+        CLog::LogF(LOGERROR, "failed to read from file");
+        return CACHE_RC_ERROR;
+      }
+      m_nReadPosition += lastRead;
+      readBytes += lastRead;
+      remaining -= lastRead;
+    }
+    Touch(segment);
+  }
+
+  if (readBytes > 0)
+    m_space.Set();
+
+  return readBytes;
+}
+
+int64_t CSegmentFileCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  if (iMillis == 0 || IsEndOfInput())
+    return GetAvailableRead();
+
+  XbmcThreads::EndTime endTime(iMillis);
+  while (!IsEndOfInput())
+  {
+    int64_t iAvail = GetAvailableRead();
+    if (iAvail >= iMinAvail)
+      return iAvail;
+
+    if (!m_hDataAvailEvent.WaitMSec(endTime.MillisLeft()))
+      return CACHE_RC_TIMEOUT;
+  }
+  return GetAvailableRead();
+}
+
+int64_t CSegmentFileCache::Seek(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  int64_t nDiff = iFilePosition - m_nWritePosition;
+  if (nDiff > 500000)
+  {
+    CLog::Log(LOGDEBUG, "CSegmentFileCache::Seek - Attempt to seek past read data");
+    return CACHE_RC_ERROR;
+  }
+
+  if (nDiff > 0)
+  {
+    // close enough, wait for the writer to get there
+    XbmcThreads::EndTime endTime(5000);
+    while (m_nWritePosition < iFilePosition)
+    {
+      if (IsEndOfInput())
+        return CACHE_RC_ERROR;
+
+      lock.Leave();
+      bool signaled = m_hDataAvailEvent.WaitMSec(endTime.MillisLeft());
+      lock.Enter();
+
+      if (!signaled && m_nWritePosition < iFilePosition)
+      {
+        CLog::Log(LOGDEBUG, "CSegmentFileCache::Seek - Attempt to seek past read data");
+        return CACHE_RC_ERROR;
+      }
+    }
+  }
+
+  // only positions that are connected to the data being written can be read
+  // without seeking the source, anything else needs a reset
+  if (GetContiguousEnd(iFilePosition) < m_nWritePosition)
+    return CACHE_RC_ERROR;
+
+  m_nReadPosition = iFilePosition;
+  m_space.Set();
+
+  return iFilePosition;
+}
+
+bool CSegmentFileCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+
+  if (clearAnyway)
+    Clear();
+  else if (IsCachedPosition(iSourcePosition))
+  {
+    m_nReadPosition = iSourcePosition;
+    m_nWritePosition = GetContiguousEnd(iSourcePosition);
+    return false;
+  }
+
+  // segments fetched so far are kept for later seeks
+  m_nReadPosition = iSourcePosition;
+  m_nWritePosition = iSourcePosition;
+  return true;
+}
+
+void CSegmentFileCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_hDataAvailEvent.Set();
+}
+
+int64_t CSegmentFileCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  if (IsCachedPosition(iFilePosition))
+    return GetContiguousEnd(iFilePosition);
+  return iFilePosition;
+}
+
+int64_t CSegmentFileCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_nWritePosition;
+}
+
+bool CSegmentFileCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  // like the linear caches, the end of a cached range counts as cached
+  return iFilePosition == m_nWritePosition ||
+         IsCached(iFilePosition) ||
+         (iFilePosition > 0 && IsCached(iFilePosition - 1));
+}
+
+CCacheStrategy *CSegmentFileCache::CreateNew()
+{
+  return new CSegmentFileCache(m_maxSlots * m_segmentSize, m_segmentSize);
+}
+
+int64_t CSegmentFileCache::GetAvailableRead()
+{
+  CSingleLock lock(m_sync);
+  return GetContiguousEnd(m_nReadPosition) - m_nReadPosition;
+}
+
+int64_t CSegmentFileCache::GetContiguousEnd(int64_t iFilePosition) const
+{
+  int64_t index = iFilePosition / m_segmentSize;
+  size_t offset = iFilePosition % m_segmentSize;
+  int64_t end = iFilePosition;
+
+  for (auto it = m_segments.find(index); it != m_segments.end() && it->first == index; ++it, ++index)
+  {
+    const Segment& segment = it->second;
+    if (offset < segment.begin || offset > segment.end)
+      break;
+
+    end = index * m_segmentSize + segment.end;
+    if (segment.end < m_segmentSize)
+      break;
+
+    offset = 0;
+  }
+
+  return end;
+}
+
+bool CSegmentFileCache::IsCached(int64_t iFilePosition) const
+{
+  auto it = m_segments.find(iFilePosition / m_segmentSize);
+  if (it == m_segments.end())
+    return false;
+
+  const size_t offset = iFilePosition % m_segmentSize;
+  return offset >= it->second.begin && offset < it->second.end;
+}
+
+bool CSegmentFileCache::IsProtected(int64_t index) const
+{
+  // segments between reader and writer are still to be read
+  const int64_t first = std::min(m_nReadPosition, m_nWritePosition) / m_segmentSize;
+  const int64_t last = std::max(m_nReadPosition, m_nWritePosition) / m_segmentSize;
+  return index >= first && index <= last;
+}
+
+size_t CSegmentFileCache::GetFreeSlots() const
+{
+  size_t freeSlots = m_maxSlots - m_usedSlots;
+  for (const auto& segment : m_segments)
+  {
+    if (!IsProtected(segment.first))
+      freeSlots++;
+  }
+  return freeSlots;
+}
+
+CSegmentFileCache::Segment* CSegmentFileCache::GetSegmentForWrite(int64_t index)
+{
+  auto it = m_segments.find(index);
+  if (it != m_segments.end())
+    return &it->second;
+
+  size_t slot;
+  if (m_usedSlots < m_maxSlots)
+    slot = m_usedSlots++;
+  else
+  {
+    // drop the least recently used segment that isn't waiting to be read
+    auto victim = std::find_if(m_lru.rbegin(), m_lru.rend(), [this](int64_t i) { return !IsProtected(i); });
+    if (victim == m_lru.rend())
+      return nullptr;
+
+    auto old = m_segments.find(*victim);
+    slot = old->second.slot;
+    m_lru.erase(old->second.lru);
+    m_segments.erase(old);
+  }
+
+  m_lru.push_front(index);
+
+  Segment& segment = m_segments[index];
+  segment.slot = slot;
+  segment.begin = 0;
+  segment.end = 0;
+  segment.lru = m_lru.begin();
+  return &segment;
+}
+
+void CSegmentFileCache::Touch(Segment& segment)
+{
+  if (segment.lru != m_lru.begin())
+    m_lru.splice(m_lru.begin(), m_lru, segment.lru);
+}
+
+void CSegmentFileCache::Clear()
+{
+  m_segments.clear();
+  m_lru.clear();
+  m_usedSlots = 0;
+}
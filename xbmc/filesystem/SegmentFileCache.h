@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <list>
+#include <map>
+#include <string>
+
+namespace XFILE {
+
+class IFile;
+
+/*!
+ \brief Disk cache that keeps every range fetched from the source.
+
+ The source file is split into segments of a fixed size. Each cached segment
+ occupies one slot of a temporary file, together with the range of bytes
+ within the segment that is valid. Unlike CSimpleFileCache, a reset to an
+ uncached position keeps the data fetched so far, so seeking back to it later
+ does not fetch it again. When all slots are used the least recently used
+ segment outside of the window between read and write position is dropped.
+ */
+class CSegmentFileCache : public CCacheStrategy
+{
+public:
+  static const size_t DEFAULT_SEGMENT_SIZE = 512 * 1024;
+
+  /*!
+   \param maxSize maximum size of the cache file in bytes
+   \param segmentSize size of a segment in bytes
+   */
+  explicit CSegmentFileCache(size_t maxSize, size_t segmentSize = DEFAULT_SEGMENT_SIZE);
+  ~CSegmentFileCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *pBuffer, size_t iSize) override;
+  int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
+  void EndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+private:
+  struct Segment
+  {
+    size_t slot; //!< index of the slot in the cache file
+    size_t begin; //!< offset of the first valid byte in the segment
+    size_t end; //!< offset behind the last valid byte in the segment
+    std::list<int64_t>::iterator lru;
+  };
+
+  int64_t GetAvailableRead();
+  int64_t GetContiguousEnd(int64_t iFilePosition) const;
+  bool IsCached(int64_t iFilePosition) const;
+  bool IsProtected(int64_t index) const;
+  size_t GetFreeSlots() const;
+  Segment* GetSegmentForWrite(int64_t index);
+  void Touch(Segment& segment);
+  void Clear();
+
+  std::string m_filename;
+  IFile* m_cacheFileRead;
+  IFile* m_cacheFileWrite;
+  CEvent m_hDataAvailEvent;
+  CCriticalSection m_sync;
+
+  const size_t m_segmentSize;
+  const size_t m_maxSlots;
+  size_t m_usedSlots = 0; //!< slots of the cache file that were handed out so far
+  std::map<int64_t, Segment> m_segments; //!< cached segments by index in the source file
+  std::list<int64_t> m_lru; //!< segment indices, most recently used first
+
+  int64_t m_nReadPosition = 0;
+  int64_t m_nWritePosition = 0;
+};
+
+}
@@ -22,7 +22,7 @@ CDirectoryNodeEpisodes::CDirectoryNodeEpisodes(const std::string& strName, CDire
 bool CDirectoryNodeEpisodes::GetContent(CFileItemList& items) const
 {
   CVideoDatabase videodatabase;
-  if (!videodatabase.Open())
+  if (!videodatabase.OpenForRead())
     return false;
 
   CQueryParams params;
@@ -39,7 +39,7 @@ NODE_TYPE CDirectoryNodeGrouped::GetChildType() const
 std::string CDirectoryNodeGrouped::GetLocalizedName() const
 {
   CVideoDatabase db;
-  if (db.Open())
+  if (db.OpenForRead())
     return db.GetItemById(GetContentType(), GetID());
 
   return "";
@@ -48,7 +48,7 @@ std::string CDirectoryNodeGrouped::GetLocalizedName() const
 bool CDirectoryNodeGrouped::GetContent(CFileItemList& items) const
 {
   CVideoDatabase videodatabase;
-  if (!videodatabase.Open())
+  if (!videodatabase.OpenForRead())
     return false;
 
   CQueryParams params;
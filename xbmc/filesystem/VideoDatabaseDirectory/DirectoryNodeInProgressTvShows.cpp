@@ -26,7 +26,7 @@ NODE_TYPE CDirectoryNodeInProgressTvShows::GetChildType() const
 std::string CDirectoryNodeInProgressTvShows::GetLocalizedName() const
 {
   CVideoDatabase db;
-  if (db.Open())
+  if (db.OpenForRead())
     return db.GetTvShowTitleById(GetID());
   return "";
 }
@@ -34,7 +34,7 @@ std::string CDirectoryNodeInProgressTvShows::GetLocalizedName() const
 bool CDirectoryNodeInProgressTvShows::GetContent(CFileItemList& items) const
 {
   CVideoDatabase videodatabase;
-  if (!videodatabase.Open())
+  if (!videodatabase.OpenForRead())
     return false;
 
   bool bSuccess=videodatabase.GetInProgressTvShowsNav(BuildPath(), items);
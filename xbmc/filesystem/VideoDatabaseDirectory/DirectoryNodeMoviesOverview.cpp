@@ -62,7 +62,7 @@ bool CDirectoryNodeMoviesOverview::GetContent(CFileItemList& items) const
     if (i == 6)
     {
       CVideoDatabase db;
-      if (db.Open() && !db.HasSets())
+      if (db.OpenForRead() && !db.HasSets())
         continue;
     }
 
@@ -21,7 +21,7 @@ CDirectoryNodeRecentlyAddedEpisodes::CDirectoryNodeRecentlyAddedEpisodes(const s
 bool CDirectoryNodeRecentlyAddedEpisodes::GetContent(CFileItemList& items) const
 {
   CVideoDatabase videodatabase;
-  if (!videodatabase.Open())
+  if (!videodatabase.OpenForRead())
     return false;
 
   bool bSuccess=videodatabase.GetRecentlyAddedEpisodesNav(BuildPath(), items);
@@ -21,7 +21,7 @@ CDirectoryNodeRecentlyAddedMovies::CDirectoryNodeRecentlyAddedMovies(const std::
 bool CDirectoryNodeRecentlyAddedMovies::GetContent(CFileItemList& items) const
 {
   CVideoDatabase videodatabase;
-  if (!videodatabase.Open())
+  if (!videodatabase.OpenForRead())
     return false;
 
   bool bSuccess=videodatabase.GetRecentlyAddedMoviesNav(BuildPath(), items);
@@ -51,7 +51,7 @@ std::string CDirectoryNodeSeasons::GetLocalizedName() const
 bool CDirectoryNodeSeasons::GetContent(CFileItemList& items) const
 {
   CVideoDatabase videodatabase;
-  if (!videodatabase.Open())
+  if (!videodatabase.OpenForRead())
     return false;
 
   CQueryParams params;
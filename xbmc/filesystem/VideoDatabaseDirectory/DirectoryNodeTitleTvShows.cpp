@@ -27,7 +27,7 @@ NODE_TYPE CDirectoryNodeTitleTvShows::GetChildType() const
 std::string CDirectoryNodeTitleTvShows::GetLocalizedName() const
 {
   CVideoDatabase db;
-  if (db.Open())
+  if (db.OpenForRead())
     return db.GetTvShowTitleById(GetID());
   return "";
 }
@@ -35,7 +35,7 @@ std::string CDirectoryNodeTitleTvShows::GetLocalizedName() const
 bool CDirectoryNodeTitleTvShows::GetContent(CFileItemList& items) const
 {
   CVideoDatabase videodatabase;
-  if (!videodatabase.Open())
+  if (!videodatabase.OpenForRead())
     return false;
 
   CQueryParams params;
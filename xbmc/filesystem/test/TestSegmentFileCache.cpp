@@ -0,0 +1,173 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/SegmentFileCache.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+const size_t SEGMENT_SIZE = 1024;
+
+std::vector<char> MakeData(int64_t position, size_t size)
+{
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<char>((position + i) % 251);
+  return data;
+}
+
+void Write(CSegmentFileCache& cache, int64_t position, size_t size)
+{
+  std::vector<char> data = MakeData(position, size);
+  ASSERT_EQ(static_cast<int>(size), cache.WriteToCache(data.data(), size));
+}
+
+void ExpectRead(CSegmentFileCache& cache, int64_t position, size_t size)
+{
+  std::vector<char> expected = MakeData(position, size);
+  std::vector<char> buffer(size);
+  ASSERT_EQ(static_cast<int>(size), cache.ReadFromCache(buffer.data(), size));
+  EXPECT_EQ(expected, buffer);
+}
+}
+
+TEST(TestSegmentFileCache, ReadWrite)
+{
+  CSegmentFileCache cache(16 * SEGMENT_SIZE, SEGMENT_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Write(cache, 0, 3000);
+  EXPECT_EQ(3000, cache.CachedDataEndPos());
+  EXPECT_EQ(3000, cache.WaitForData(0, 0));
+  ExpectRead(cache, 0, 1500);
+  ExpectRead(cache, 1500, 1500);
+
+  char c;
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(&c, 1));
+  cache.EndOfInput();
+  EXPECT_EQ(0, cache.ReadFromCache(&c, 1));
+
+  cache.Close();
+}
+
+TEST(TestSegmentFileCache, KeepsRangesAcrossReset)
+{
+  CSegmentFileCache cache(16 * SEGMENT_SIZE, SEGMENT_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Write(cache, 0, 2500);
+
+  // far seek, the first range stays cached
+  EXPECT_TRUE(cache.Reset(10000, false));
+  Write(cache, 10000, 500);
+  EXPECT_TRUE(cache.IsCachedPosition(100));
+  EXPECT_TRUE(cache.IsCachedPosition(2500));
+  EXPECT_FALSE(cache.IsCachedPosition(5000));
+  EXPECT_TRUE(cache.IsCachedPosition(10200));
+  EXPECT_EQ(2500, cache.CachedDataEndPosIfSeekTo(100));
+  EXPECT_EQ(10500, cache.CachedDataEndPosIfSeekTo(10200));
+  EXPECT_EQ(5000, cache.CachedDataEndPosIfSeekTo(5000));
+
+  // the old range is not connected to the writer, a reset is needed
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(100));
+  EXPECT_EQ(10200, cache.Seek(10200));
+
+  // seek back, nothing has to be fetched again
+  EXPECT_FALSE(cache.Reset(100, false));
+  EXPECT_EQ(2500, cache.CachedDataEndPos());
+  ExpectRead(cache, 100, 2400);
+
+  // continue writing where the old range ended
+  Write(cache, 2500, 1000);
+  ExpectRead(cache, 2500, 1000);
+
+  cache.Close();
+}
+
+TEST(TestSegmentFileCache, MergesRanges)
+{
+  CSegmentFileCache cache(16 * SEGMENT_SIZE, SEGMENT_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  EXPECT_TRUE(cache.Reset(1500, false));
+  Write(cache, 1500, 1000);
+
+  // fill the gap in front, the ranges join
+  EXPECT_TRUE(cache.Reset(0, false));
+  Write(cache, 0, 1500);
+  EXPECT_EQ(2500, cache.CachedDataEndPosIfSeekTo(0));
+  ExpectRead(cache, 0, 2500);
+
+  cache.Close();
+}
+
+// once a gap is filled the writer continues behind the range that follows it
+TEST(TestSegmentFileCache, SkipsCachedRanges)
+{
+  CSegmentFileCache cache(16 * SEGMENT_SIZE, SEGMENT_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  EXPECT_TRUE(cache.Reset(3000, false));
+  Write(cache, 3000, 2000);
+
+  EXPECT_TRUE(cache.Reset(0, false));
+  EXPECT_EQ(3000U, cache.GetMaxWriteSize(8 * SEGMENT_SIZE));
+  Write(cache, 0, 2000);
+  EXPECT_EQ(2000, cache.CachedDataEndPos());
+  Write(cache, 2000, 1000);
+  EXPECT_EQ(5000, cache.CachedDataEndPos());
+  ExpectRead(cache, 0, 5000);
+
+  cache.Close();
+}
+
+TEST(TestSegmentFileCache, EvictsLeastRecentlyUsed)
+{
+  CSegmentFileCache cache(4 * SEGMENT_SIZE, SEGMENT_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Write(cache, 0, SEGMENT_SIZE);
+  EXPECT_TRUE(cache.Reset(10 * SEGMENT_SIZE, false));
+  Write(cache, 10 * SEGMENT_SIZE, SEGMENT_SIZE);
+  EXPECT_TRUE(cache.Reset(20 * SEGMENT_SIZE, false));
+  Write(cache, 20 * SEGMENT_SIZE, SEGMENT_SIZE);
+  EXPECT_TRUE(cache.Reset(30 * SEGMENT_SIZE, false));
+  Write(cache, 30 * SEGMENT_SIZE, SEGMENT_SIZE);
+
+  // all slots are used, the oldest segment has to go
+  EXPECT_TRUE(cache.Reset(40 * SEGMENT_SIZE, false));
+  Write(cache, 40 * SEGMENT_SIZE, SEGMENT_SIZE);
+  EXPECT_FALSE(cache.IsCachedPosition(100));
+  EXPECT_TRUE(cache.IsCachedPosition(10 * SEGMENT_SIZE + 100));
+
+  cache.Close();
+}
+
+TEST(TestSegmentFileCache, KeepsUnreadData)
+{
+  CSegmentFileCache cache(4 * SEGMENT_SIZE, SEGMENT_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Write(cache, 0, 4 * SEGMENT_SIZE);
+
+  // data that wasn't read yet is never dropped
+  EXPECT_EQ(0U, cache.GetMaxWriteSize(SEGMENT_SIZE));
+  char c;
+  EXPECT_EQ(0, cache.WriteToCache(&c, 1));
+
+  ExpectRead(cache, 0, SEGMENT_SIZE);
+  EXPECT_EQ(SEGMENT_SIZE, cache.GetMaxWriteSize(2 * SEGMENT_SIZE));
+
+  cache.Close();
+}
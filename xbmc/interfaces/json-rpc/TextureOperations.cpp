@@ -19,7 +19,7 @@ JSONRPC_STATUS CTextureOperations::GetTextures(const std::string &method, ITrans
   CFileItemList listItems;
 
   CTextureDatabase db;
-  if (!db.Open())
+  if (!db.OpenForRead())
     return InternalError;
 
   CDatabase::Filter dbFilter;
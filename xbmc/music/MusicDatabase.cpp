@@ -1100,14 +1100,14 @@ int CMusicDatabase::AddGenre(std::string& strGenre)
       return it->second;
 
 
-    strSQL=PrepareSQL("SELECT idGenre, strGenre FROM genre WHERE strGenre LIKE '%s'", strGenre.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "SELECT idGenre, strGenre FROM genre WHERE strGenre LIKE ?";
+    m_pDS->query_prepared(strSQL, {dbiplus::field_value(strGenre)});
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL=PrepareSQL("INSERT INTO genre (idGenre, strGenre) values( NULL, '%s' )", strGenre.c_str());
-      m_pDS->exec(strSQL);
+      strSQL = "INSERT INTO genre (idGenre, strGenre) values( NULL, ? )";
+      m_pDS->exec_prepared(strSQL, {dbiplus::field_value(strGenre)});
 
       int idGenre = (int)m_pDS->lastinsertid();
       m_genreCache.insert(std::pair<std::string, int>(strGenre, idGenre));
@@ -1124,7 +1124,7 @@ int CMusicDatabase::AddGenre(std::string& strGenre)
   }
   catch (...)
   {
-    CLog::Log(LOGERROR, "musicdatabase:unable to addgenre (%s)", strSQL.c_str());
+    CLog::Log(LOGERROR, "musicdatabase:unable to addgenre (%s) (%s)", strSQL.c_str(), strGenre.c_str());
   }
 
   return -1;
@@ -1592,23 +1592,23 @@ int CMusicDatabase::AddRole(const std::string &strRole)
       return -1;
     if (nullptr == m_pDS)
       return -1;
-    strSQL = PrepareSQL("SELECT idRole FROM role WHERE strRole LIKE '%s'", strRole.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "SELECT idRole FROM role WHERE strRole LIKE ?";
+    m_pDS->query_prepared(strSQL, {dbiplus::field_value(strRole)});
     if (m_pDS->num_rows() > 0)
       idRole = m_pDS->fv("idRole").get_asInt();
     m_pDS->close();
 
     if (idRole < 0)
     {
-      strSQL = PrepareSQL("INSERT INTO role (strRole) VALUES ('%s')", strRole.c_str());
-      m_pDS->exec(strSQL);
+      strSQL = "INSERT INTO role (strRole) VALUES (?)";
+      m_pDS->exec_prepared(strSQL, {dbiplus::field_value(strRole)});
       idRole = static_cast<int>(m_pDS->lastinsertid());
       m_pDS->close();
     }
   }
   catch (...)
   {
-    CLog::Log(LOGERROR, "musicdatabase:unable to AddRole (%s)", strSQL.c_str());
+    CLog::Log(LOGERROR, "musicdatabase:unable to AddRole (%s) (%s)", strSQL.c_str(), strRole.c_str());
   }
   return idRole;
 }
@@ -1621,10 +1621,9 @@ bool CMusicDatabase::AddSongArtist(int idArtist, int idSong, const std::string&
 
 bool CMusicDatabase::AddSongArtist(int idArtist, int idSong, int idRole, const std::string& strArtist, int iOrder)
 {
-  std::string strSQL;
-  strSQL = PrepareSQL("replace into song_artist (idArtist, idSong, idRole, strArtist, iOrder) values(%i,%i,%i,'%s',%i)",
-    idArtist, idSong, idRole, strArtist.c_str(), iOrder);
-  return ExecuteQuery(strSQL);
+  return QueueInsertRow("replace into song_artist (idArtist, idSong, idRole, strArtist, iOrder)",
+                        PrepareSQL("%i,%i,%i,'%s',%i", idArtist, idSong, idRole, strArtist.c_str(), iOrder),
+                        PrepareSQL("%i,%i,%i", idArtist, idSong, idRole));
 }
 
 int CMusicDatabase::AddSongContributor(int idSong, const std::string& strRole, const std::string& strArtist, const std::string &strSort)
@@ -1643,8 +1642,10 @@ int CMusicDatabase::AddSongContributor(int idSong, const std::string& strRole, c
     int idArtist = -1;
     // Add artist. As we only have name (no MBID) first try to identify artist from song
     // as they may have already been added with a different role (including MBID).
-    strSQL = PrepareSQL("SELECT idArtist FROM song_artist WHERE idSong = %i AND strArtist LIKE '%s' ", idSong, strArtist.c_str());
-    m_pDS->query(strSQL);
+    if (!FlushInsertRows())
+      return -1;
+    strSQL = "SELECT idArtist FROM song_artist WHERE idSong = ? AND strArtist LIKE ? ";
+    m_pDS->query_prepared(strSQL, {dbiplus::field_value(idSong), dbiplus::field_value(strArtist)});
     if (m_pDS->num_rows() > 0)
       idArtist = m_pDS->fv("idArtist").get_asInt();
     m_pDS->close();
@@ -1757,19 +1758,22 @@ bool CMusicDatabase::GetRolesByArtist(int idArtist, CFileItem* item)
 
 bool CMusicDatabase::DeleteSongArtistsBySong(int idSong)
 {
+  if (!FlushInsertRows())
+    return false;
   return ExecuteQuery(PrepareSQL("DELETE FROM song_artist WHERE idSong = %i", idSong));
 }
 
 bool CMusicDatabase::AddAlbumArtist(int idArtist, int idAlbum, std::string strArtist, int iOrder)
 {
-  std::string strSQL;
-  strSQL = PrepareSQL("replace into album_artist (idArtist, idAlbum, strArtist, iOrder) values(%i,%i,'%s',%i)",
-    idArtist, idAlbum, strArtist.c_str(), iOrder);
-  return ExecuteQuery(strSQL);
+  return QueueInsertRow("replace into album_artist (idArtist, idAlbum, strArtist, iOrder)",
+                        PrepareSQL("%i,%i,'%s',%i", idArtist, idAlbum, strArtist.c_str(), iOrder),
+                        PrepareSQL("%i,%i", idArtist, idAlbum));
 }
 
 bool CMusicDatabase::DeleteAlbumArtistsByAlbum(int idAlbum)
 {
+  if (!FlushInsertRows())
+    return false;
   return ExecuteQuery(PrepareSQL("DELETE FROM album_artist WHERE idAlbum = %i", idAlbum));
 }
 
@@ -1782,6 +1786,8 @@ bool CMusicDatabase::AddSongGenres(int idSong, const std::vector<std::string>& g
   try
   {
     // Clear current entries for song
+    if (!FlushInsertRows())
+      return false;
     strSQL = PrepareSQL("DELETE FROM song_genre WHERE idSong = %i", idSong);
     if (!ExecuteQuery(strSQL))
       return false;
@@ -1790,9 +1796,9 @@ bool CMusicDatabase::AddSongGenres(int idSong, const std::vector<std::string>& g
     for (auto &strGenre : modgenres)
     {
       int idGenre = AddGenre(strGenre); // Genre string trimed and matched case insensitively
-      strSQL = PrepareSQL("INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES(%i,%i,%i)",
-        idGenre, idSong, index++);
-      if (!ExecuteQuery(strSQL))
+      if (!QueueInsertRow("INSERT INTO song_genre (idGenre, idSong, iOrder)",
+                          PrepareSQL("%i,%i,%i", idGenre, idSong, index++),
+                          PrepareSQL("%i,%i", idGenre, idSong)))
         return false;
     }
     // Update concatenated genre string from the standardised genre values
@@ -2110,14 +2116,14 @@ int CMusicDatabase::AddPath(const std::string& strPath1)
     if (it != m_pathCache.end())
       return it->second;
 
-    strSQL=PrepareSQL( "select * from path where strPath='%s'", strPath.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "select * from path where strPath=?";
+    m_pDS->query_prepared(strSQL, {dbiplus::field_value(strPath)});
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into path (idPath, strPath) values( NULL, '%s' )", strPath.c_str());
-      m_pDS->exec(strSQL);
+      strSQL = "insert into path (idPath, strPath) values( NULL, ? )";
+      m_pDS->exec_prepared(strSQL, {dbiplus::field_value(strPath)});
 
       int idPath = (int)m_pDS->lastinsertid();
       m_pathCache.insert(std::pair<std::string, int>(strPath, idPath));
@@ -2133,7 +2139,7 @@ int CMusicDatabase::AddPath(const std::string& strPath1)
   }
   catch (...)
   {
-    CLog::Log(LOGERROR, "musicdatabase:unable to addpath (%s)", strSQL.c_str());
+    CLog::Log(LOGERROR, "musicdatabase:unable to addpath (%s) (%s)", strSQL.c_str(), strPath1.c_str());
   }
 
   return -1;
@@ -2424,9 +2430,10 @@ int CMusicDatabase::GetAlbumIdByPath(const std::string& strPath)
     if (nullptr == m_pDS)
       return false;
 
-    std::string strSQL = PrepareSQL("SELECT DISTINCT idAlbum FROM song JOIN path ON song.idPath = path.idPath WHERE path.strPath='%s'", strPath.c_str());
     // run query
-    if (!m_pDS->query(strSQL)) return false;
+    if (!m_pDS->query_prepared("SELECT DISTINCT idAlbum FROM song JOIN path ON song.idPath = path.idPath WHERE path.strPath=?",
+                               {dbiplus::field_value(strPath)}))
+      return false;
     int iRowsFound = m_pDS->num_rows();
 
     int idAlbum = -1; // If no album is found, or more than one album is found then -1 is returned
@@ -4791,6 +4798,25 @@ bool CMusicDatabase::GetSongsByWhere(const std::string &baseDir, const Filter &f
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "songview.*") + strSQLExtra;
 
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
+
+    if (DatabaseUtils::CanGetItemsFromCursor(sortDescription))
+    {
+      auto getItem = [&](const dbiplus::sql_record* const record)
+      {
+        CFileItemPtr item(new CFileItem);
+        GetFileItemFromDataset(record, item.get(), musicUrl);
+        return item;
+      };
+      const int start = items.Size();
+      if (!DatabaseUtils::GetItemsFromCursor(*m_pDS, strSQL, MediaTypeSong, sortDescription, getItem, total, items))
+        return false;
+
+      // HACK for sorting by database returned order
+      for (int i = start; i < items.Size(); i++)
+        items[i]->m_iprogramCount = i - start + 1;
+      return true;
+    }
+
     // run query
     if (!m_pDS->query(strSQL))
       return false;
@@ -9319,8 +9345,9 @@ int CMusicDatabase::GetSongIDFromPath(const std::string &filePath)
     SplitPath(filePath, strPath, strFileName);
     URIUtils::AddSlashAtEnd(strPath);
 
-    std::string sql = PrepareSQL("select idSong from song join path on song.idPath = path.idPath where song.strFileName='%s' and path.strPath='%s'", strFileName.c_str(), strPath.c_str());
-    if (!m_pDS->query(sql)) return -1;
+    if (!m_pDS->query_prepared("select idSong from song join path on song.idPath = path.idPath where song.strFileName=? and path.strPath=?",
+                               {dbiplus::field_value(strFileName), dbiplus::field_value(strPath)}))
+      return -1;
 
     if (m_pDS->num_rows() == 0)
     {
@@ -9342,7 +9369,11 @@ int CMusicDatabase::GetSongIDFromPath(const std::string &filePath)
 bool CMusicDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so reset the infomanager cache
+  {
+    // the count is updated once the batch is done
+    if (InBatch())
+      return true;
+    // number of items in the db has likely changed, so reset the infomanager cache
     CGUIComponent* gui = CServiceBroker::GetGUI();
     if (gui)
     {
@@ -10556,20 +10587,19 @@ void CMusicDatabase::SetArtForItem(int mediaId, const std::string &mediaType, co
     if (artType.find('.') != std::string::npos)
       return;
 
-    std::string sql = PrepareSQL("SELECT art_id FROM art WHERE media_id=%i AND media_type='%s' AND type='%s'", mediaId, mediaType.c_str(), artType.c_str());
-    m_pDS->query(sql);
+    m_pDS->query_prepared("SELECT art_id FROM art WHERE media_id=? AND media_type=? AND type=?",
+                          {dbiplus::field_value(mediaId), dbiplus::field_value(mediaType), dbiplus::field_value(artType)});
     if (!m_pDS->eof())
     { // update
       int artId = m_pDS->fv(0).get_asInt();
       m_pDS->close();
-      sql = PrepareSQL("UPDATE art SET url='%s' where art_id=%d", url.c_str(), artId);
-      m_pDS->exec(sql);
+      m_pDS->exec_prepared("UPDATE art SET url=? where art_id=?", {dbiplus::field_value(url), dbiplus::field_value(artId)});
     }
     else
     { // insert
       m_pDS->close();
-      sql = PrepareSQL("INSERT INTO art(media_id, media_type, type, url) VALUES (%d, '%s', '%s', '%s')", mediaId, mediaType.c_str(), artType.c_str(), url.c_str());
-      m_pDS->exec(sql);
+      m_pDS->exec_prepared("INSERT INTO art(media_id, media_type, type, url) VALUES (?, ?, ?, ?)",
+                           {dbiplus::field_value(mediaId), dbiplus::field_value(mediaType), dbiplus::field_value(artType), dbiplus::field_value(url)});
     }
   }
   catch (...)
@@ -10698,8 +10728,8 @@ bool CMusicDatabase::GetArtForItem(int mediaId, const std::string &mediaType, st
     if (nullptr == m_pDS2)
       return false; // using dataset 2 as we're likely called in loops on dataset 1
 
-    std::string sql = PrepareSQL("SELECT type,url FROM art WHERE media_id=%i AND media_type='%s'", mediaId, mediaType.c_str());
-    m_pDS2->query(sql);
+    m_pDS2->query_prepared("SELECT type,url FROM art WHERE media_id=? AND media_type=?",
+                           {dbiplus::field_value(mediaId), dbiplus::field_value(mediaType)});
     while (!m_pDS2->eof())
     {
       art.insert(std::make_pair(m_pDS2->fv(0).get_asString(), m_pDS2->fv(1).get_asString()));
@@ -10717,8 +10747,8 @@ bool CMusicDatabase::GetArtForItem(int mediaId, const std::string &mediaType, st
 
 std::string CMusicDatabase::GetArtForItem(int mediaId, const std::string &mediaType, const std::string &artType)
 {
-  std::string query = PrepareSQL("SELECT url FROM art WHERE media_id=%i AND media_type='%s' AND type='%s'", mediaId, mediaType.c_str(), artType.c_str());
-  return GetSingleValue(query, m_pDS2);
+  return GetSingleValue("SELECT url FROM art WHERE media_id=? AND media_type=? AND type=?",
+                        {dbiplus::field_value(mediaId), dbiplus::field_value(mediaType), dbiplus::field_value(artType)}, m_pDS2);
 }
 
 bool CMusicDatabase::RemoveArtForItem(int mediaId, const MediaType & mediaType, const std::string & artType)
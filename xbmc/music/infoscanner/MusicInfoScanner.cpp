@@ -62,6 +62,8 @@ using namespace MUSIC_GRABBER;
 using namespace ADDON;
 using KODI::UTILITY::CDigest;
 
+#define ALBUMS_PER_COMMIT 50
+
 CMusicInfoScanner::CMusicInfoScanner()
 : m_fileCountReader(this, "MusicFileCounter")
 {
@@ -76,6 +78,7 @@ CMusicInfoScanner::~CMusicInfoScanner() = default;
 void CMusicInfoScanner::Process()
 {
   m_bStop = false;
+  m_loudnessAnalyser.Reset();
   CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::AudioLibrary, "xbmc", "OnScanStarted");
   try
   {
@@ -439,6 +442,7 @@ void CMusicInfoScanner::Stop()
   if (m_bCanInterrupt)
     m_musicDatabase.Interrupt();
 
+  m_loudnessAnalyser.Stop();
   m_bStop = true;
 }
 
@@ -886,6 +890,10 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
   */
   FindArtForAlbums(albums, items.GetPath());
 
+  // Measure ReplayGain of songs that have none tagged, before they are stored
+  if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicLibraryAnalyseLoudness && !m_bStop)
+    m_loudnessAnalyser.Analyse(albums);
+
   /* Strategy: Having scanned tags and made a list of albums, add them to the library. Only then try
   to scrape additional album and artist information. Music is often tagged to a mixed standard
   - some albums have mbid tags, some don't. Once all the music files have been added to the library,
@@ -900,7 +908,9 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
 
   int numAdded = 0;
 
-  // Add all albums to the library, and hence any new song or album artists or other contributors
+  // Add all albums to the library, and hence any new song or album artists or other contributors.
+  // The tags are read already, so the albums are written in few transactions
+  m_musicDatabase.BeginBatch(ALBUMS_PER_COMMIT);
   for (auto& album : albums)
   {
     if (m_bStop)
@@ -912,10 +922,12 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
 
     album.strPath = strDirectory;
     m_musicDatabase.AddAlbum(album, m_idSourcePath);
+    m_musicDatabase.CommitBatchItem();
     m_albumsAdded.insert(album.idAlbum);
 
     numAdded += album.songs.size();
   }
+  m_musicDatabase.CommitBatch();
   return numAdded;
 }
 
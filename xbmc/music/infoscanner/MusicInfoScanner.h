@@ -11,6 +11,7 @@
 #include "InfoScanner.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
+#include "MusicLoudnessAnalyser.h"
 #include "music/MusicDatabase.h"
 #include "threads/IRunnable.h"
 #include "threads/Thread.h"
@@ -232,6 +233,7 @@ protected:
   int m_scanType = 0; // 0 - load from files, 1 - albums, 2 - artists
   int m_idSourcePath;
   CMusicDatabase m_musicDatabase;
+  CMusicLoudnessAnalyser m_loudnessAnalyser;
 
   std::set<int> m_albumsAdded;
 
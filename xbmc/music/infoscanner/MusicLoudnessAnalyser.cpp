@@ -0,0 +1,241 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "MusicLoudnessAnalyser.h"
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "cores/AudioEngine/Utils/AELoudness.h"
+#include "cores/paplayer/CodecFactory.h"
+#include "cores/paplayer/ICodec.h"
+#include "music/Song.h"
+#include "threads/Thread.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+using namespace MUSIC_INFO;
+
+namespace
+{
+const double REPLAY_GAIN_REFERENCE = -18.0; // LUFS
+const unsigned int DECODE_SIZE = 32768;
+
+//! interleaved samples of a codec to float, false for formats a codec doesn't output
+bool ToFloat(AEDataFormat format, const uint8_t* data, unsigned int samples, float* out)
+{
+  switch (format)
+  {
+    case AE_FMT_U8:
+      for (unsigned int i = 0; i < samples; i++)
+        out[i] = (data[i] - 128) / 128.0f;
+      return true;
+    case AE_FMT_S16NE:
+    {
+      const int16_t* in = reinterpret_cast<const int16_t*>(data);
+      for (unsigned int i = 0; i < samples; i++)
+        out[i] = in[i] / 32768.0f;
+      return true;
+    }
+    case AE_FMT_S32NE:
+    {
+      const int32_t* in = reinterpret_cast<const int32_t*>(data);
+      for (unsigned int i = 0; i < samples; i++)
+        out[i] = static_cast<float>(in[i] / 2147483648.0);
+      return true;
+    }
+    case AE_FMT_FLOAT:
+      memcpy(out, data, samples * sizeof(float));
+      return true;
+    case AE_FMT_DOUBLE:
+    {
+      const double* in = reinterpret_cast<const double*>(data);
+      for (unsigned int i = 0; i < samples; i++)
+        out[i] = static_cast<float>(in[i]);
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+}
+
+int CMusicLoudnessAnalyser::Analyse(VECALBUMS& albums, unsigned int threads)
+{
+  m_jobs.clear();
+  m_nextJob = 0;
+  if (m_bStop)
+    return 0;
+
+  for (auto& album : albums)
+  {
+    for (auto& song : album.songs)
+    {
+      if (song.replayGain.Get(ReplayGain::TRACK).Valid())
+        continue;
+      Job job;
+      job.song = &song;
+      m_jobs.push_back(std::move(job));
+    }
+  }
+  if (m_jobs.empty())
+    return 0;
+
+  if (!threads)
+  {
+    std::shared_ptr<CCPUInfo> cpuInfo = CServiceBroker::GetCPUInfo();
+    threads = cpuInfo ? std::max(cpuInfo->GetCPUCount(), 1) : 1;
+  }
+  threads = std::min(threads, static_cast<unsigned int>(m_jobs.size()));
+
+  std::vector<std::unique_ptr<CThread>> workers;
+  for (unsigned int i = 0; i < threads; i++)
+  {
+    workers.emplace_back(new CThread(this, "MusicLoudness"));
+    workers.back()->Create();
+    workers.back()->SetPriority(THREAD_PRIORITY_BELOW_NORMAL);
+  }
+  // wait for the workers to run out of songs
+  for (auto& worker : workers)
+    worker->StopThread(true);
+
+  int analysed = 0;
+  for (const auto& job : m_jobs)
+  {
+    if (job.success)
+      analysed++;
+  }
+
+  // album gain, if every song of the album got measured
+  auto job = m_jobs.begin();
+  for (auto& album : albums)
+  {
+    std::vector<double> blocks;
+    float peak = 0.0f;
+    bool complete = !album.songs.empty();
+    for (auto& song : album.songs)
+    {
+      if (job == m_jobs.end() || job->song != &song)
+      {
+        complete = false;
+        continue;
+      }
+      complete &= job->success;
+      blocks.insert(blocks.end(), job->blocks.begin(), job->blocks.end());
+      peak = std::max(peak, job->peak);
+      ++job;
+    }
+
+    if (!complete || album.songs.front().replayGain.Get(ReplayGain::ALBUM).Valid())
+      continue;
+
+    double loudness = CAELoudnessMeter::GetIntegratedLoudness(blocks);
+    if (std::isinf(loudness))
+      continue;
+
+    for (auto& song : album.songs)
+    {
+      song.replayGain.SetGain(ReplayGain::ALBUM, static_cast<float>(REPLAY_GAIN_REFERENCE - loudness));
+      song.replayGain.SetPeak(ReplayGain::ALBUM, peak);
+    }
+  }
+
+  m_jobs.clear();
+  return analysed;
+}
+
+void CMusicLoudnessAnalyser::Run()
+{
+  while (!m_bStop)
+  {
+    size_t index = m_nextJob++;
+    if (index >= m_jobs.size())
+      break;
+
+    Job& job = m_jobs[index];
+    job.success = AnalyseSong(job);
+  }
+}
+
+bool CMusicLoudnessAnalyser::AnalyseSong(Job& job)
+{
+  CSong& song = *job.song;
+  CFileItem item(song.strFileName, false);
+
+  std::unique_ptr<ICodec> codec(CodecFactory::CreateCodecDemux(item, 0));
+  if (!codec || !codec->Init(item, 0))
+  {
+    CLog::Log(LOGDEBUG, "CMusicLoudnessAnalyser::AnalyseSong - unable to open %s",
+              song.strFileName.c_str());
+    return false;
+  }
+
+  const AEAudioFormat& format = codec->m_format;
+  const unsigned int channels = format.m_channelLayout.Count();
+  const unsigned int bytesPerSample = codec->m_bitsPerSample >> 3;
+  if (format.m_dataFormat == AE_FMT_RAW || !channels || !bytesPerSample || !format.m_sampleRate)
+    return false;
+
+  // songs of a cue sheet are a part of the file
+  if (song.iStartOffset)
+    codec->Seek(song.iStartOffset);
+  int64_t framesLeft = -1;
+  if (song.iEndOffset > song.iStartOffset)
+    framesLeft = static_cast<int64_t>(song.iEndOffset - song.iStartOffset) * format.m_sampleRate / 1000;
+
+  CAELoudnessMeter meter(format.m_sampleRate, format.m_channelLayout);
+  std::vector<uint8_t> buffer(DECODE_SIZE - DECODE_SIZE % (bytesPerSample * channels));
+  std::vector<float> samples(buffer.size() / bytesPerSample);
+  while (framesLeft != 0)
+  {
+    if (m_bStop)
+      return false;
+
+    int size = 0;
+    int result = codec->ReadPCM(buffer.data(), static_cast<int>(buffer.size()), &size);
+    if (result == READ_ERROR)
+    {
+      CLog::Log(LOGDEBUG, "CMusicLoudnessAnalyser::AnalyseSong - error decoding %s",
+                song.strFileName.c_str());
+      return false;
+    }
+
+    unsigned int frames = size / (bytesPerSample * channels);
+    if (framesLeft > 0)
+    {
+      frames = static_cast<unsigned int>(std::min<int64_t>(frames, framesLeft));
+      framesLeft -= frames;
+    }
+    if (frames)
+    {
+      if (!ToFloat(format.m_dataFormat, buffer.data(), frames * channels, samples.data()))
+        return false;
+      meter.AddFrames(samples.data(), frames);
+    }
+
+    if (result == READ_EOF)
+      break;
+  }
+
+  double loudness = meter.GetIntegratedLoudness();
+  if (std::isinf(loudness))
+    return false;
+
+  job.blocks = meter.GetBlocks();
+  job.peak = meter.GetTruePeak();
+  song.replayGain.SetGain(ReplayGain::TRACK, static_cast<float>(REPLAY_GAIN_REFERENCE - loudness));
+  song.replayGain.SetPeak(ReplayGain::TRACK, job.peak);
+
+  CLog::Log(LOGDEBUG, "CMusicLoudnessAnalyser::AnalyseSong - %s: %.2f LUFS, true peak %.3f",
+            song.strFileName.c_str(), loudness, job.peak);
+  return true;
+}
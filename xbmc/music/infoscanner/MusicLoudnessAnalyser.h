@@ -0,0 +1,72 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "music/Album.h"
+#include "threads/IRunnable.h"
+
+#include <atomic>
+#include <vector>
+
+class CSong;
+
+namespace MUSIC_INFO
+{
+
+/*!
+ * \brief Computes ReplayGain for songs that don't carry it in their tags
+ *
+ * Songs are decoded with the paplayer codecs on a pool of worker threads and
+ * measured as of EBU R128. Gains are relative to the ReplayGain 2.0 reference
+ * of -18 LUFS, peaks are true peaks.
+ */
+class CMusicLoudnessAnalyser : public IRunnable
+{
+public:
+  CMusicLoudnessAnalyser() = default;
+
+  /*!
+   * \brief Analyse the songs of the albums that have no track gain
+   * Album gain is set too if all songs of an album were analysed and it had none.
+   * \param albums albums with their songs, gains are stored in the songs
+   * \param threads number of worker threads, 0 for one per cpu
+   * \return number of songs analysed
+   */
+  int Analyse(VECALBUMS& albums, unsigned int threads = 0);
+
+  /*!
+   * \brief Abort a running analysis, songs not analysed yet keep their gains
+   */
+  void Stop() { m_bStop = true; }
+
+  /*!
+   * \brief Clear a previous Stop(), to be called when a new scan starts
+   */
+  void Reset() { m_bStop = false; }
+
+  // implementation of IRunnable
+  void Run() override;
+
+private:
+  struct Job
+  {
+    CSong* song = nullptr;
+    std::vector<double> blocks; //!< gating blocks for the album loudness
+    float peak = 0.0f;
+    bool success = false;
+  };
+
+  bool AnalyseSong(Job& job);
+
+  std::vector<Job> m_jobs;
+  std::atomic<size_t> m_nextJob{0};
+  std::atomic<bool> m_bStop{false};
+};
+
+}
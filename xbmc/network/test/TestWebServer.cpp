@@ -14,21 +14,33 @@
 #include <stdlib.h>
 
 #include <gtest/gtest.h>
+#include "FileItem.h"
 #include "URL.h"
 #include "filesystem/CurlFile.h"
+#include "filesystem/CurlRangeReader.h"
 #include "filesystem/File.h"
+#include "filesystem/FileCache.h"
+#include "filesystem/FilePrefetcher.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPVfsHandler.h"
 #include "network/httprequesthandler/HTTPJsonRpcHandler.h"
+#include "ServiceBroker.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/MediaSourceSettings.h"
+#include "settings/SettingsComponent.h"
 #include "test/TestUtils.h"
+#include "threads/Event.h"
+#include "threads/SystemClock.h"
 #include "utils/JSONVariantParser.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 
+#include <chrono>
+#include <memory>
 #include <random>
+#include <thread>
 
 using namespace XFILE;
 
@@ -41,6 +53,82 @@ using namespace XFILE;
 #define TEST_FILES_HTML         TEST_FILES_DATA ".html"
 #define TEST_FILES_RANGES       TEST_FILES_DATA "-ranges.txt"
 
+#define TEST_URL_NO_RANGES      "noranges"
+#define TEST_URL_STALLED        "stalled"
+
+// serves the ranges test data and advertises ranges but ignores any Range
+// header, like some servers do
+class CTestNoRangesHandler : public IHTTPRequestHandler
+{
+public:
+  CTestNoRangesHandler() = default;
+
+  IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CTestNoRangesHandler(request); }
+  bool CanHandleRequest(const HTTPRequest &request) const override
+  {
+    return request.pathUrl.compare("/" TEST_URL_NO_RANGES) == 0;
+  }
+
+  int HandleRequest() override
+  {
+    m_response.type = HTTPMemoryDownloadNoFreeNoCopy;
+    m_response.status = MHD_HTTP_OK;
+    m_response.contentType = "text/plain";
+    m_response.totalLength = m_data.size();
+    AddResponseHeader(MHD_HTTP_HEADER_ACCEPT_RANGES, "bytes");
+    return MHD_YES;
+  }
+
+  HttpResponseRanges GetResponseData() const override
+  {
+    return HttpResponseRanges{ CHttpResponseRange(m_data.c_str(), m_data.size()) };
+  }
+
+protected:
+  explicit CTestNoRangesHandler(const HTTPRequest &request)
+    : IHTTPRequestHandler(request)
+  { }
+
+private:
+  const std::string m_data = TEST_FILES_DATA_RANGES;
+};
+
+// holds back the response until released, to test aborting transfers
+class CTestStalledHandler : public IHTTPRequestHandler
+{
+public:
+  CTestStalledHandler() = default;
+
+  IHTTPRequestHandler* Create(const HTTPRequest &request) const override
+  {
+    return new CTestStalledHandler(request, m_release);
+  }
+  bool CanHandleRequest(const HTTPRequest &request) const override
+  {
+    return request.pathUrl.compare("/" TEST_URL_STALLED) == 0;
+  }
+
+  int HandleRequest() override
+  {
+    m_release->WaitMSec(10000);
+
+    m_response.type = HTTPError;
+    m_response.status = MHD_HTTP_SERVICE_UNAVAILABLE;
+    return MHD_YES;
+  }
+
+  void Release() { m_release->Set(); }
+
+protected:
+  CTestStalledHandler(const HTTPRequest &request, const std::shared_ptr<CEvent>& release)
+    : IHTTPRequestHandler(request),
+      m_release(release)
+  { }
+
+private:
+  std::shared_ptr<CEvent> m_release = std::make_shared<CEvent>(true);
+};
+
 class TestWebServer : public testing::Test
 {
 protected:
@@ -69,6 +157,8 @@ protected:
     webserver.Start(webserverPort, "", "");
     webserver.RegisterRequestHandler(&m_jsonRpcHandler);
     webserver.RegisterRequestHandler(&m_vfsHandler);
+    webserver.RegisterRequestHandler(&m_noRangesHandler);
+    webserver.RegisterRequestHandler(&m_stalledHandler);
   }
 
   void TearDown() override
@@ -76,6 +166,8 @@ protected:
     if (webserver.IsStarted())
       webserver.Stop();
 
+    webserver.UnregisterRequestHandler(&m_stalledHandler);
+    webserver.UnregisterRequestHandler(&m_noRangesHandler);
     webserver.UnregisterRequestHandler(&m_vfsHandler);
     webserver.UnregisterRequestHandler(&m_jsonRpcHandler);
 
@@ -145,6 +237,18 @@ protected:
     return lastModified.IsValid();
   }
 
+  // waits for the background open of a prefetched file
+  bool WaitForPrefetch(const CURL& url)
+  {
+    for (int i = 0; i < 100; i++)
+    {
+      if (CFilePrefetcher::GetInstance().IsPrefetched(url))
+        return true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return false;
+  }
+
   void CheckHtmlTestFileResponse(const CCurlFile& curl)
   {
     // get the HTTP header details
@@ -342,6 +446,8 @@ protected:
   CWebServer webserver;
   CHTTPJsonRpcHandler m_jsonRpcHandler;
   CHTTPVfsHandler m_vfsHandler;
+  CTestNoRangesHandler m_noRangesHandler;
+  CTestStalledHandler m_stalledHandler;
   std::string baseUrl;
   std::string sourcePath;
   uint16_t webserverPort;
@@ -897,3 +1003,228 @@ TEST_F(TestWebServer, CanGetCachedRangedFileWithNewerIfRange)
   ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
   CheckRangesTestFileResponse(curl, result, ranges);
 }
+
+TEST_F(TestWebServer, CanOpenBoundedRange)
+{
+  const std::string rangedFileContent = TEST_FILES_DATA_RANGES;
+
+  CCurlFile curl;
+  curl.SetRequestRange(7, 12);
+  ASSERT_TRUE(curl.Open(CURL(GetUrlOfTestFile(TEST_FILES_RANGES))));
+  EXPECT_EQ(MHD_HTTP_PARTIAL_CONTENT, curl.GetHttpResponseCode());
+  EXPECT_EQ(7, curl.GetPosition());
+  EXPECT_EQ(13, curl.GetLength());
+
+  char buffer[32];
+  std::string result;
+  ssize_t read;
+  while ((read = curl.Read(buffer, sizeof(buffer))) > 0)
+    result.append(buffer, read);
+  EXPECT_EQ(0, read);
+  EXPECT_STREQ(rangedFileContent.substr(7, 6).c_str(), result.c_str());
+}
+
+TEST_F(TestWebServer, CanReadRangesOverSeveralConnections)
+{
+  const std::string rangedFileContent = TEST_FILES_DATA_RANGES;
+
+  // small chunks so that every connection fetches more than one range
+  CCurlRangeReader reader(CURL(GetUrlOfTestFile(TEST_FILES_RANGES)), rangedFileContent.size(), 3);
+  ASSERT_TRUE(reader.Open(3, 0));
+
+  char buffer[32];
+  std::string result;
+  ssize_t read;
+  while ((read = reader.Read(buffer, sizeof(buffer))) > 0)
+    result.append(buffer, read);
+  EXPECT_EQ(0, read);
+  EXPECT_TRUE(reader.IsRangeSupported());
+  EXPECT_STREQ(rangedFileContent.c_str(), result.c_str());
+}
+
+TEST_F(TestWebServer, CanSeekWhileReadingRanges)
+{
+  const std::string rangedFileContent = TEST_FILES_DATA_RANGES;
+
+  CCurlRangeReader reader(CURL(GetUrlOfTestFile(TEST_FILES_RANGES)), rangedFileContent.size(), 4);
+  ASSERT_TRUE(reader.Open(2, 0));
+
+  char buffer[32];
+  ASSERT_EQ(2, reader.Read(buffer, 2));
+  EXPECT_EQ(rangedFileContent.substr(0, 2), std::string(buffer, 2));
+
+  ASSERT_EQ(14, reader.Seek(14));
+  std::string result;
+  ssize_t read;
+  while ((read = reader.Read(buffer, sizeof(buffer))) > 0)
+    result.append(buffer, read);
+  EXPECT_STREQ(rangedFileContent.substr(14).c_str(), result.c_str());
+
+  EXPECT_EQ(-1, reader.Seek(rangedFileContent.size() + 1));
+}
+
+TEST_F(TestWebServer, LimitsRangeConnectionsPerHost)
+{
+  EXPECT_EQ(3u, CCurlRangeReader::AcquireConnections(WEBSERVER_HOST, 3, 4));
+  EXPECT_EQ(1u, CCurlRangeReader::AcquireConnections(WEBSERVER_HOST, 3, 4));
+  EXPECT_EQ(0u, CCurlRangeReader::AcquireConnections(WEBSERVER_HOST, 3, 4));
+  EXPECT_EQ(2u, CCurlRangeReader::AcquireConnections("otherhost", 2, 4));
+
+  CCurlRangeReader::ReleaseConnections(WEBSERVER_HOST, 3);
+  EXPECT_EQ(3u, CCurlRangeReader::AcquireConnections(WEBSERVER_HOST, 3, 4));
+
+  CCurlRangeReader::ReleaseConnections(WEBSERVER_HOST, 4);
+  CCurlRangeReader::ReleaseConnections("otherhost", 2);
+}
+
+TEST_F(TestWebServer, FallsBackWithoutRangeSupport)
+{
+  const std::string rangedFileContent = TEST_FILES_DATA_RANGES;
+  const CURL url(GetUrl(TEST_URL_NO_RANGES));
+
+  CCurlRangeReader reader(url, rangedFileContent.size(), 4);
+  ASSERT_TRUE(reader.Open(2, 0));
+
+  char buffer[32];
+  EXPECT_EQ(-1, reader.Read(buffer, sizeof(buffer)));
+  EXPECT_FALSE(reader.IsRangeSupported());
+  reader.Close();
+
+  // the cache continues on its own stream and still delivers all of the data
+  int& rangeConnections = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_curlRangeConnections;
+  const int oldRangeConnections = rangeConnections;
+  rangeConnections = 2;
+
+  CFileCache cache(READ_CACHED);
+  const bool opened = cache.Open(url);
+  rangeConnections = oldRangeConnections;
+  ASSERT_TRUE(opened);
+
+  std::string result;
+  ssize_t read;
+  while ((read = cache.Read(buffer, sizeof(buffer))) > 0)
+    result.append(buffer, read);
+  EXPECT_EQ(0, read);
+  EXPECT_STREQ(rangedFileContent.c_str(), result.c_str());
+  cache.Close();
+}
+
+TEST_F(TestWebServer, CancelAbortsRangeTransfers)
+{
+  CCurlRangeReader reader(CURL(GetUrl(TEST_URL_STALLED)), 20, 4);
+  ASSERT_TRUE(reader.Open(2, 0));
+
+  // give the workers time to send their requests
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  const unsigned int start = XbmcThreads::SystemClockMillis();
+  reader.Cancel();
+  reader.Close();
+  EXPECT_LT(XbmcThreads::SystemClockMillis() - start, 5000u);
+
+  m_stalledHandler.Release();
+}
+
+TEST_F(TestWebServer, CountsSourceStreamAgainstHostLimit)
+{
+  int& hostLimit = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_curlRangeHostLimit;
+  const int oldHostLimit = hostLimit;
+  hostLimit = 2;
+
+  // two range connections and the caller's stream do not fit
+  CCurlRangeReader reader(CURL(GetUrlOfTestFile(TEST_FILES_RANGES)), 20, 4);
+  EXPECT_FALSE(reader.Open(2, 0));
+  EXPECT_EQ(2u, CCurlRangeReader::AcquireConnections(WEBSERVER_HOST, 2, 2));
+  CCurlRangeReader::ReleaseConnections(WEBSERVER_HOST, 2);
+
+  hostLimit = 3;
+  ASSERT_TRUE(reader.Open(2, 0));
+  EXPECT_EQ(0u, CCurlRangeReader::AcquireConnections(WEBSERVER_HOST, 1, 3));
+  reader.Close();
+  EXPECT_EQ(3u, CCurlRangeReader::AcquireConnections(WEBSERVER_HOST, 3, 3));
+  CCurlRangeReader::ReleaseConnections(WEBSERVER_HOST, 3);
+
+  hostLimit = oldHostLimit;
+}
+
+TEST_F(TestWebServer, PrefetchedFileIsTakenByOpen)
+{
+  const std::string path = GetUrlOfTestFile(TEST_FILES_RANGES);
+  CFilePrefetcher& prefetcher = CFilePrefetcher::GetInstance();
+  prefetcher.Prefetch(path, READ_AUDIO_VIDEO | READ_CACHED);
+  ASSERT_TRUE(WaitForPrefetch(CURL(path)));
+
+  // give the cache time to read the small file, the source isn't needed after that
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  webserver.Stop();
+
+  CFile file;
+  ASSERT_TRUE(file.Open(path, READ_AUDIO_VIDEO));
+  EXPECT_FALSE(prefetcher.IsPrefetched(CURL(path)));
+
+  char buffer[32];
+  std::string result;
+  ssize_t read;
+  while ((read = file.Read(buffer, sizeof(buffer))) > 0)
+    result.append(buffer, read);
+  EXPECT_STREQ(TEST_FILES_DATA_RANGES, result.c_str());
+  file.Close();
+
+  // the path isn't prefetched again while it is played
+  prefetcher.Prefetch(path, READ_AUDIO_VIDEO | READ_CACHED);
+  EXPECT_EQ(nullptr, prefetcher.Take(CURL(path), READ_AUDIO_VIDEO));
+
+  prefetcher.Clear();
+}
+
+TEST_F(TestWebServer, PrefetchedFileNeedsMatchingFlags)
+{
+  CFileItem item(GetUrlOfTestFile(TEST_FILES_RANGES), false);
+  item.SetMimeType("video/mp4");
+  const unsigned int flags = CFilePrefetcher::GetOpenFlags(item);
+  EXPECT_EQ(READ_AUDIO_VIDEO | READ_CACHED | READ_MULTI_STREAM, flags);
+  item.SetMimeType("audio/flac");
+  EXPECT_EQ(READ_AUDIO_VIDEO | READ_CACHED, CFilePrefetcher::GetOpenFlags(item));
+
+  // a multi stream cache isn't handed to a plain read, it is dropped
+  const CURL url(item.GetPath());
+  CFilePrefetcher& prefetcher = CFilePrefetcher::GetInstance();
+  prefetcher.Prefetch(url.Get(), flags);
+  ASSERT_TRUE(WaitForPrefetch(url));
+  EXPECT_EQ(nullptr, prefetcher.Take(url, READ_AUDIO_VIDEO | READ_CACHED));
+  EXPECT_FALSE(prefetcher.IsPrefetched(url));
+  prefetcher.Clear();
+
+  // flags the cache doesn't depend on don't matter
+  prefetcher.Prefetch(url.Get(), flags);
+  ASSERT_TRUE(WaitForPrefetch(url));
+  std::unique_ptr<IFile> file(prefetcher.Take(url, READ_AUDIO_VIDEO | READ_MULTI_STREAM | READ_CHUNKED | READ_BITRATE));
+  ASSERT_NE(nullptr, file);
+
+  char buffer[32];
+  std::string result;
+  ssize_t read;
+  while ((read = file->Read(buffer, sizeof(buffer))) > 0)
+    result.append(buffer, read);
+  EXPECT_STREQ(TEST_FILES_DATA_RANGES, result.c_str());
+  file->Close();
+
+  prefetcher.Clear();
+}
+
+TEST_F(TestWebServer, ClearDropsPrefetchedFile)
+{
+  const CURL url(GetUrlOfTestFile(TEST_FILES_RANGES));
+  CFilePrefetcher& prefetcher = CFilePrefetcher::GetInstance();
+  prefetcher.Prefetch(url.Get(), READ_AUDIO_VIDEO | READ_CACHED);
+  ASSERT_TRUE(WaitForPrefetch(url));
+
+  prefetcher.Clear();
+  EXPECT_FALSE(prefetcher.IsPrefetched(url));
+  EXPECT_EQ(nullptr, prefetcher.Take(url, READ_AUDIO_VIDEO));
+
+  // local files aren't prefetched
+  const std::string localPath = URIUtils::AddFileToFolder(sourcePath, TEST_FILES_RANGES);
+  prefetcher.Prefetch(CFileItem(localPath, false));
+  EXPECT_EQ(nullptr, prefetcher.Take(CURL(localPath), READ_AUDIO_VIDEO));
+}
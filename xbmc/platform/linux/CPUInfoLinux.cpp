@@ -164,6 +164,22 @@ CCPUInfoLinux::CCPUInfoLinux()
 
     if (ecx & CPUID_00000001_ECX_SSE42)
       m_cpuFeatures |= CPU_FEATURE_SSE42;
+
+    // AVX also needs the OS to save the ymm registers
+    if ((ecx & CPUID_00000001_ECX_OSXSAVE) && (ecx & CPUID_00000001_ECX_AVX))
+    {
+      unsigned int xcr0;
+      unsigned int xcr0High;
+      __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+      if ((xcr0 & XCR0_SSE_AVX_STATE) == XCR0_SSE_AVX_STATE)
+      {
+        m_cpuFeatures |= CPU_FEATURE_AVX;
+
+        if (__get_cpuid_count(CPUID_INFOTYPE_STRUCTURED, 0, &eax, &ebx, &ecx, &edx) &&
+            (ebx & CPUID_00000007_EBX_AVX2))
+          m_cpuFeatures |= CPU_FEATURE_AVX2;
+      }
+    }
   }
 
   if (__get_cpuid(CPUID_INFOTYPE_EXTENDED_IMPLEMENTED, &eax, &eax, &ecx, &edx))
@@ -15,6 +15,8 @@
 #include "utils/SysfsUtils.h"
 #include "utils/Temperature.h"
 
+#include <intrin.h>
+
 #include <winrt/Windows.Foundation.Metadata.h>
 #include <winrt/Windows.System.Diagnostics.h>
 
@@ -60,6 +62,21 @@ CCPUInfoWin10::CCPUInfoWin10()
       m_cpuFeatures |= CPU_FEATURE_SSE4;
     if (CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_SSE42)
       m_cpuFeatures |= CPU_FEATURE_SSE42;
+
+    // AVX also needs the OS to save the ymm registers
+    if ((CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_OSXSAVE) &&
+        (CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_AVX) &&
+        (_xgetbv(0) & XCR0_SSE_AVX_STATE) == XCR0_SSE_AVX_STATE)
+    {
+      m_cpuFeatures |= CPU_FEATURE_AVX;
+
+      if (MaxStdInfoType >= static_cast<int>(CPUID_INFOTYPE_STRUCTURED))
+      {
+        __cpuidex(CPUInfo, CPUID_INFOTYPE_STRUCTURED, 0);
+        if (CPUInfo[CPUINFO_EBX] & CPUID_00000007_EBX_AVX2)
+          m_cpuFeatures |= CPU_FEATURE_AVX2;
+      }
+    }
   }
 
   __cpuid(CPUInfo, 0x80000000);
@@ -131,6 +131,12 @@ void CAdvancedSettings::Initialize()
   m_limiterHold = 0.025f;
   m_limiterRelease = 0.1f;
 
+  //period time in ms of sinks in low latency mode, 0 disables the mode
+  m_audioLowLatencyPeriod = 5;
+
+  //time in ms paplayer decodes the next track ahead for gapless playback
+  m_audioDecodeAheadTime = 2000;
+
   m_seekSteps = { 10, 30, 60, 180, 300, 600, 1800 };
 
   m_audioDefaultPlayer = "paplayer";
@@ -165,6 +171,9 @@ void CAdvancedSettings::Initialize()
   m_videoFpsDetect = 1;
   m_maxTempo = 1.55f;
   m_videoPreferStereoStream = false;
+  m_videoDemuxZeroCopy = true;
+  m_videoProbeCache = true;
+  m_videoPlayerTrace = false;
 
   m_videoDefaultLatency = 0.0;
 
@@ -287,6 +296,7 @@ void CAdvancedSettings::Initialize()
   m_iMusicLibraryRecentlyAddedItems = 25;
   m_strMusicLibraryAlbumFormat = "";
   m_prioritiseAPEv2tags = false;
+  m_musicLibraryAnalyseLoudness = false;
   m_musicItemSeparator = " / ";
   m_musicArtistSeparators = { ";", " feat. ", " ft. " };
   m_videoItemSeparator = " / ";
@@ -347,6 +357,9 @@ void CAdvancedSettings::Initialize()
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
   m_curlDisableHTTP2 = false;
+  m_curlRangeConnections = 0;
+  m_curlRangeHostLimit = 8;
+  m_curlRangeChunkSize = 1024 * 1024;
 
 #if defined(TARGET_DARWIN_EMBEDDED)
   m_startFullScreen = true;
@@ -382,10 +395,12 @@ void CAdvancedSettings::Initialize()
   m_bPVRTimeshiftSimpleOSD = true;
 
   m_cacheMemSize = 1024 * 1024 * 20;
+  m_cacheSegmentDiskSize = 0; // 0 disables the sparse on-disk cache
   m_cacheBufferMode = CACHE_BUFFER_MODE_INTERNET; // Default (buffer all internet streams/filesystems)
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  m_cachePrefetchNextTime = 0;
 
   m_addonPackageFolderSize = 200;
 
@@ -550,6 +565,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
     XMLUtils::GetFloat(pElement, "limiterhold", m_limiterHold, 0.0f, 100.0f);
     XMLUtils::GetFloat(pElement, "limiterrelease", m_limiterRelease, 0.001f, 100.0f);
+    XMLUtils::GetInt(pElement, "lowlatencyperiod", m_audioLowLatencyPeriod, 0, 50);
+    XMLUtils::GetInt(pElement, "decodeahead", m_audioDecodeAheadTime, 500, 30000);
   }
 
   pElement = pRootElement->FirstChildElement("x11");
@@ -699,6 +716,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "fpsdetect", m_videoFpsDetect, 0, 2);
     XMLUtils::GetFloat(pElement, "maxtempo", m_maxTempo, 1.5, 2.1);
     XMLUtils::GetBoolean(pElement, "preferstereostream", m_videoPreferStereoStream);
+    XMLUtils::GetBoolean(pElement, "demuxzerocopy", m_videoDemuxZeroCopy);
+    XMLUtils::GetBoolean(pElement, "probecache", m_videoProbeCache);
+    XMLUtils::GetBoolean(pElement, "playertrace", m_videoPlayerTrace);
 
     // Store global display latency settings
     TiXmlElement* pVideoLatency = pElement->FirstChildElement("latency");
@@ -743,6 +763,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   {
     XMLUtils::GetInt(pElement, "recentlyaddeditems", m_iMusicLibraryRecentlyAddedItems, 1, INT_MAX);
     XMLUtils::GetBoolean(pElement, "prioritiseapetags", m_prioritiseAPEv2tags);
+    XMLUtils::GetBoolean(pElement, "analyseloudness", m_musicLibraryAnalyseLoudness);
     XMLUtils::GetBoolean(pElement, "allitemsonbottom", m_bMusicLibraryAllItemsOnBottom);
     XMLUtils::GetBoolean(pElement, "cleanonupdate", m_bMusicLibraryCleanOnUpdate);
     XMLUtils::GetBoolean(pElement, "artistsortonupdate", m_bMusicLibraryArtistSortOnUpdate);
@@ -815,14 +836,19 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement, "disableipv6", m_curlDisableIPV6);
     XMLUtils::GetBoolean(pElement, "disablehttp2", m_curlDisableHTTP2);
+    XMLUtils::GetInt(pElement, "curlrangeconnections", m_curlRangeConnections, 0, 16);
+    XMLUtils::GetInt(pElement, "curlrangehostlimit", m_curlRangeHostLimit, 1, 64);
+    XMLUtils::GetInt(pElement, "curlrangechunksize", m_curlRangeChunkSize, 64 * 1024, 16 * 1024 * 1024);
   }
 
   pElement = pRootElement->FirstChildElement("cache");
   if (pElement)
   {
     XMLUtils::GetUInt(pElement, "memorysize", m_cacheMemSize);
+    XMLUtils::GetUInt64(pElement, "segmentdisksize", m_cacheSegmentDiskSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetUInt(pElement, "prefetchnexttime", m_cachePrefetchNextTime, 0, 600);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -131,6 +131,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_VideoPlayerIgnoreDTSinWAV;
     float m_limiterHold;
     float m_limiterRelease;
+    int m_audioLowLatencyPeriod;
+    int m_audioDecodeAheadTime;
 
     bool  m_omlSync = false;
 
@@ -175,6 +177,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int  m_videoFpsDetect;
     float m_maxTempo;
     bool m_videoPreferStereoStream = false;
+    bool m_videoDemuxZeroCopy = true;
+    bool m_videoProbeCache = true;
+    bool m_videoPlayerTrace = false; //!< trace VideoPlayer stages during playback and write them to special://temp on exit
 
     std::string m_videoDefaultPlayer;
     float m_videoPlayCountMinimumPercent;
@@ -245,6 +250,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bMusicLibraryArtistSortOnUpdate;
     std::string m_strMusicLibraryAlbumFormat;
     bool m_prioritiseAPEv2tags;
+    bool m_musicLibraryAnalyseLoudness;
     std::string m_musicItemSeparator;
     std::vector<std::string> m_musicArtistSeparators;
     std::string m_videoItemSeparator;
@@ -290,6 +296,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curlretries;
     bool m_curlDisableIPV6;
     bool m_curlDisableHTTP2;
+    int m_curlRangeConnections; // parallel range requests per cached http source, 0 disables them
+    int m_curlRangeHostLimit;
+    int m_curlRangeChunkSize;
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -327,8 +336,10 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemSize;
+    uint64_t m_cacheSegmentDiskSize;
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
+    unsigned int m_cachePrefetchNextTime; // seconds before the end of an item to open the next one, 0 disables it
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
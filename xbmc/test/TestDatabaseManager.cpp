@@ -0,0 +1,172 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DatabaseManager.h"
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+class TestDatabaseManager : public ::testing::Test
+{
+protected:
+  CDatabaseManager manager;
+  SqliteDatabase db;
+  std::unique_ptr<Dataset> ds;
+
+  void SetUp() override
+  {
+    db.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    db.setDatabase("TestDatabaseManager");
+    XFILE::CFile::Delete(GetPath());
+    ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+
+    ds.reset(db.CreateDataset());
+    ds->exec("CREATE TABLE path (idPath INTEGER PRIMARY KEY, strPath TEXT)");
+  }
+
+  void TearDown() override
+  {
+    ds.reset();
+    db.disconnect();
+    XFILE::CFile::Delete(GetPath());
+  }
+
+  std::string GetPath()
+  {
+    return URIUtils::AddFileToFolder(db.getHostName(), db.getDatabase());
+  }
+
+  std::unique_ptr<Database> Acquire()
+  {
+    return manager.AcquireReadConnection(db.getHostName(), db.getDatabase());
+  }
+
+  // the page cache size tells a pooled connection from a new one, these get 4096 pages
+  static void SetCacheSize(Database &reader, int pages)
+  {
+    std::unique_ptr<Dataset> rds(reader.CreateDataset());
+    rds->exec(StringUtils::Format("PRAGMA cache_size=%d", pages));
+  }
+
+  static int GetCacheSize(Database &reader)
+  {
+    std::unique_ptr<Dataset> rds(reader.CreateDataset());
+    if (!rds->query("SELECT cache_size FROM pragma_cache_size()"))
+      return -1;
+    int pages = rds->fv(0).get_asInt();
+    rds->close();
+    return pages;
+  }
+};
+
+TEST_F(TestDatabaseManager, ReusesIdleConnection)
+{
+  std::unique_ptr<Database> reader = Acquire();
+  ASSERT_NE(nullptr, reader);
+  EXPECT_EQ(4096, GetCacheSize(*reader));
+  SetCacheSize(*reader, 100);
+  const Database* const pooled = reader.get();
+  manager.ReleaseReadConnection(std::move(reader));
+
+  reader = Acquire();
+  ASSERT_NE(nullptr, reader);
+  EXPECT_EQ(pooled, reader.get());
+  EXPECT_EQ(100, GetCacheSize(*reader));
+
+  // a connection in use isn't handed out twice
+  std::unique_ptr<Database> other = Acquire();
+  ASSERT_NE(nullptr, other);
+  EXPECT_EQ(4096, GetCacheSize(*other));
+  manager.ReleaseReadConnection(std::move(other));
+  manager.ReleaseReadConnection(std::move(reader));
+
+  // idle connections of another database aren't used, a missing one isn't created
+  EXPECT_EQ(nullptr, manager.AcquireReadConnection(db.getHostName(), "TestDatabaseManagerMissing"));
+}
+
+TEST_F(TestDatabaseManager, KeepsFourIdleConnections)
+{
+  std::vector<std::unique_ptr<Database>> readers;
+  for (int i = 0; i < 5; i++)
+  {
+    readers.push_back(Acquire());
+    ASSERT_NE(nullptr, readers.back());
+    SetCacheSize(*readers.back(), 100 + i);
+  }
+  for (auto &reader : readers)
+    manager.ReleaseReadConnection(std::move(reader));
+  readers.clear();
+
+  // the first four are pooled, the fifth was disconnected
+  std::vector<int> pages;
+  for (int i = 0; i < 5; i++)
+  {
+    readers.push_back(Acquire());
+    ASSERT_NE(nullptr, readers.back());
+    pages.push_back(GetCacheSize(*readers.back()));
+  }
+  std::sort(pages.begin(), pages.end());
+  EXPECT_EQ(std::vector<int>({100, 101, 102, 103, 4096}), pages);
+
+  for (auto &reader : readers)
+    manager.ReleaseReadConnection(std::move(reader));
+}
+
+TEST_F(TestDatabaseManager, RollsBackOpenTransaction)
+{
+  std::unique_ptr<Database> reader = Acquire();
+  ASSERT_NE(nullptr, reader);
+  reader->start_transaction();
+  std::unique_ptr<Dataset> rds(reader->CreateDataset());
+  ASSERT_TRUE(rds->query("SELECT COUNT(*) FROM path"));
+  EXPECT_EQ(0, rds->fv(0).get_asInt());
+  rds->close();
+  rds.reset();
+  ASSERT_TRUE(reader->in_transaction());
+  const Database* const pooled = reader.get();
+  manager.ReleaseReadConnection(std::move(reader));
+
+  reader = Acquire();
+  ASSERT_NE(nullptr, reader);
+  EXPECT_EQ(pooled, reader.get());
+  ASSERT_FALSE(reader->in_transaction());
+
+  // the reader doesn't hold its lock any more, so the writer isn't blocked
+  ds->exec("INSERT INTO path (strPath) VALUES ('/music/')");
+  rds.reset(reader->CreateDataset());
+  ASSERT_TRUE(rds->query("SELECT COUNT(*) FROM path"));
+  EXPECT_EQ(1, rds->fv(0).get_asInt());
+  rds->close();
+  rds.reset();
+  manager.ReleaseReadConnection(std::move(reader));
+}
+
+TEST_F(TestDatabaseManager, InitializeClearsPool)
+{
+  std::unique_ptr<Database> reader = Acquire();
+  ASSERT_NE(nullptr, reader);
+  SetCacheSize(*reader, 100);
+  manager.ReleaseReadConnection(std::move(reader));
+
+  manager.Initialize();
+
+  reader = Acquire();
+  ASSERT_NE(nullptr, reader);
+  EXPECT_EQ(4096, GetCacheSize(*reader));
+  manager.ReleaseReadConnection(std::move(reader));
+}
@@ -0,0 +1,94 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "music/Album.h"
+#include "music/Song.h"
+#include "music/infoscanner/MusicLoudnessAnalyser.h"
+#include "test/TestUtils.h"
+#include "utils/CPUInfo.h"
+#include "utils/StringUtils.h"
+
+#include <chrono>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+//! every file is analysed this many times so short files give a stable rate
+const unsigned int REPEATS = 32;
+
+VECALBUMS MakeAlbums(const std::vector<std::string>& files)
+{
+  // one album per file, so album gain gets computed too
+  VECALBUMS albums;
+  for (const auto& file : files)
+  {
+    CAlbum album;
+    album.strAlbum = file;
+    for (unsigned int i = 0; i < REPEATS; i++)
+    {
+      CSong song;
+      song.strFileName = file;
+      album.songs.push_back(song);
+    }
+    albums.push_back(album);
+  }
+  return albums;
+}
+
+double Analyse(const std::vector<std::string>& files, unsigned int threads)
+{
+  VECALBUMS albums = MakeAlbums(files);
+  MUSIC_INFO::CMusicLoudnessAnalyser analyser;
+
+  auto start = std::chrono::steady_clock::now();
+  int analysed = analyser.Analyse(albums, threads);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_EQ(static_cast<int>(files.size() * REPEATS), analysed);
+  for (const auto& album : albums)
+  {
+    for (const auto& song : album.songs)
+    {
+      EXPECT_TRUE(song.replayGain.Get(ReplayGain::TRACK).Valid()) << song.strFileName;
+      EXPECT_TRUE(song.replayGain.Get(ReplayGain::ALBUM).Valid()) << song.strFileName;
+    }
+  }
+
+  double rate = seconds > 0.0 ? analysed / seconds : 0.0;
+  std::cout << StringUtils::Format("  %u thread(s): %d tracks in %.3fs, %.1f tracks/s", threads,
+                                   analysed, seconds, rate) << std::endl;
+  return rate;
+}
+}
+
+/* Measures ReplayGain of the same files with one and with all cpus and reports
+ * the throughput. More files can be given with the --add-benchmark-mediafile
+ * option of the testsuite program, they must be audio longer than 400 ms.
+ */
+TEST(TestMusicLoudnessBenchmark, TracksPerSecond)
+{
+  std::vector<std::string> files = CXBMCTestUtils::Instance().getBenchmarkMediaFiles();
+  files.insert(files.begin(), XBMC_REF_FILE_PATH("addons/resource.uisounds.kodi/resources/notify.wav"));
+
+  unsigned int cpus = 1;
+  std::shared_ptr<CCPUInfo> cpuInfo = CServiceBroker::GetCPUInfo();
+  if (cpuInfo && cpuInfo->GetCPUCount() > 1)
+    cpus = cpuInfo->GetCPUCount();
+
+  std::cout << "Loudness benchmark: " << files.size() * REPEATS << " tracks" << std::endl;
+  double single = Analyse(files, 1);
+  if (cpus > 1)
+  {
+    double parallel = Analyse(files, cpus);
+    if (single > 0.0)
+      std::cout << StringUtils::Format("  speedup: %.2fx", parallel / single) << std::endl;
+  }
+}
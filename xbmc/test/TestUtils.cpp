@@ -199,6 +199,11 @@ std::vector<std::string> &CXBMCTestUtils::getGUISettingsFiles()
   return GUISettingsFiles;
 }
 
+std::vector<std::string> &CXBMCTestUtils::getBenchmarkMediaFiles()
+{
+  return BenchmarkMediaFiles;
+}
+
 static const char usage[] =
 "Kodi Test Suite\n"
 "Usage: kodi-test [options]\n"
@@ -241,6 +246,9 @@ static const char usage[] =
 "    The variable should be a double type from 0.0 to 1.0. Values given\n"
 "    less than 0.0 are treated as 0.0. Values greater than 1.0 are treated\n"
 "    as 1.0. The default probability is 0.01.\n"
+"\n"
+"  --add-benchmark-mediafile [FILE]\n"
+"    Add a media file to be demuxed and decoded in the VideoPlayer benchmark.\n"
 ;
 
 void CXBMCTestUtils::ParseArgs(int argc, char **argv)
@@ -298,6 +306,10 @@ void CXBMCTestUtils::ParseArgs(int argc, char **argv)
       for (const auto& it : urls)
         GUISettingsFiles.push_back(it);
     }
+    else if (arg == "--add-benchmark-mediafile")
+    {
+      BenchmarkMediaFiles.emplace_back(argv[++i]);
+    }
     else if (arg == "--set-probability")
     {
       probability = atof(argv[++i]);
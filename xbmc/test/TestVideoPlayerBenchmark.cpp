@@ -0,0 +1,299 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "cores/VideoPlayer/DVDCodecs/Audio/DVDAudioCodecFFmpeg.h"
+#include "cores/VideoPlayer/DVDCodecs/DVDCodecs.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDDemuxers/DemuxPacketPool.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDFactoryInputStream.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStream.h"
+#include "cores/VideoPlayer/DVDStreamInfo.h"
+#include "cores/VideoPlayer/Process/ProcessInfo.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct BenchmarkResult
+{
+  uint64_t packets = 0;
+  uint64_t videoFrames = 0;
+  uint64_t audioFrames = 0; //!< decoded audio frames, i.e. decoder outputs
+  CDemuxPacketPool::Stats pool; //!< packet pool counters of the run
+  Clock::duration demuxTime{};
+  Clock::duration videoTime{};
+  Clock::duration audioTime{};
+  Clock::duration totalTime{};
+};
+
+double Seconds(Clock::duration duration)
+{
+  return std::chrono::duration<double>(duration).count();
+}
+
+/* Decoder of one stream, the output is dropped like a null renderer or
+ * null audio sink would do.
+ */
+class CStreamDecoder
+{
+public:
+  virtual ~CStreamDecoder() = default;
+  //! decode a packet, returns the number of frames output
+  virtual uint64_t Decode(DemuxPacket& packet) = 0;
+  //! return the frames the decoder still holds back
+  virtual uint64_t Drain() = 0;
+};
+
+class CVideoDecoder : public CStreamDecoder
+{
+public:
+  explicit CVideoDecoder(CProcessInfo& processInfo) : m_codec(processInfo) {}
+
+  bool Open(CDVDStreamInfo& hint)
+  {
+    CDVDCodecOptions options;
+    return m_codec.Open(hint, options);
+  }
+
+  uint64_t Decode(DemuxPacket& packet) override
+  {
+    uint64_t frames = 0;
+    while (!m_codec.AddData(packet))
+    {
+      uint64_t output = Output();
+      if (!output)
+        return frames; // decoder neither takes data nor outputs pictures, drop the packet
+      frames += output;
+    }
+    return frames + Output();
+  }
+
+  uint64_t Drain() override
+  {
+    m_codec.SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+    return Output();
+  }
+
+private:
+  uint64_t Output()
+  {
+    uint64_t frames = 0;
+    while (true)
+    {
+      CDVDVideoCodec::VCReturn ret = m_codec.GetPicture(&m_picture);
+      if (ret == CDVDVideoCodec::VC_PICTURE)
+        frames++;
+      else if (ret != CDVDVideoCodec::VC_NONE)
+        break;
+    }
+    return frames;
+  }
+
+  CDVDVideoCodecFFmpeg m_codec;
+  VideoPicture m_picture;
+};
+
+class CAudioDecoder : public CStreamDecoder
+{
+public:
+  explicit CAudioDecoder(CProcessInfo& processInfo) : m_codec(processInfo) {}
+
+  bool Open(CDVDStreamInfo& hint)
+  {
+    CDVDCodecOptions options;
+    return m_codec.Open(hint, options);
+  }
+
+  uint64_t Decode(DemuxPacket& packet) override
+  {
+    uint64_t frames = 0;
+    while (!m_codec.AddData(packet))
+    {
+      uint64_t output = Output();
+      if (!output)
+        return frames;
+      frames += output;
+    }
+    return frames + Output();
+  }
+
+  uint64_t Drain() override
+  {
+    // an empty packet makes ffmpeg return the delayed frames
+    DemuxPacketEntry packet;
+    m_codec.AddData(packet);
+    return Output();
+  }
+
+private:
+  uint64_t Output()
+  {
+    uint64_t frames = 0;
+    DVDAudioFrame frame;
+    do
+    {
+      m_codec.GetData(frame);
+      if (frame.nb_frames)
+        frames++;
+    } while (frame.nb_frames);
+    return frames;
+  }
+
+  CDVDAudioCodecFFmpeg m_codec;
+};
+
+bool RunBenchmark(const std::string& path, BenchmarkResult& result)
+{
+  CFileItem item(path, false);
+  std::shared_ptr<CDVDInputStream> input = CDVDFactoryInputStream::CreateInputStream(nullptr, item);
+  if (!input || !input->Open())
+    return false;
+
+  // packets come from a pool, like in the player
+  auto pool = std::make_shared<CDemuxPacketPool>();
+  CDVDDemuxFFmpeg demuxer;
+  demuxer.SetPacketPool(pool);
+  if (!demuxer.Open(input))
+    return false;
+
+  std::unique_ptr<CProcessInfo> processInfo(CProcessInfo::CreateInstance());
+  std::map<int, std::unique_ptr<CStreamDecoder>> decoders;
+  std::map<int, StreamType> types;
+
+  for (CDemuxStream* stream : demuxer.GetStreams())
+  {
+    CDVDStreamInfo hint(*stream, true);
+    hint.codecOptions = CODEC_FORCE_SOFTWARE;
+
+    if (stream->type == STREAM_VIDEO && !(stream->flags & AV_DISPOSITION_ATTACHED_PIC))
+    {
+      std::unique_ptr<CVideoDecoder> decoder(new CVideoDecoder(*processInfo)); // C++14 - Replace with std::make_unique
+      if (decoder->Open(hint))
+        decoders[stream->uniqueId] = std::move(decoder);
+    }
+    else if (stream->type == STREAM_AUDIO)
+    {
+      std::unique_ptr<CAudioDecoder> decoder(new CAudioDecoder(*processInfo)); // C++14 - Replace with std::make_unique
+      if (decoder->Open(hint))
+        decoders[stream->uniqueId] = std::move(decoder);
+    }
+    types[stream->uniqueId] = stream->type;
+  }
+
+  if (decoders.empty())
+    return false;
+
+  const CDemuxPacketPool::Stats poolBefore = pool->GetStats();
+  Clock::time_point start = Clock::now();
+
+  while (true)
+  {
+    Clock::time_point demuxStart = Clock::now();
+    DemuxPacket* packet = demuxer.Read();
+    result.demuxTime += Clock::now() - demuxStart;
+    if (!packet)
+      break;
+
+    result.packets++;
+    auto it = decoders.find(packet->iStreamId);
+    if (it != decoders.end())
+    {
+      Clock::time_point decodeStart = Clock::now();
+      uint64_t frames = it->second->Decode(*packet);
+      if (types[packet->iStreamId] == STREAM_VIDEO)
+      {
+        result.videoFrames += frames;
+        result.videoTime += Clock::now() - decodeStart;
+      }
+      else
+      {
+        result.audioFrames += frames;
+        result.audioTime += Clock::now() - decodeStart;
+      }
+    }
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+
+  for (auto& decoder : decoders)
+  {
+    Clock::time_point decodeStart = Clock::now();
+    uint64_t frames = decoder.second->Drain();
+    if (types[decoder.first] == STREAM_VIDEO)
+    {
+      result.videoFrames += frames;
+      result.videoTime += Clock::now() - decodeStart;
+    }
+    else
+    {
+      result.audioFrames += frames;
+      result.audioTime += Clock::now() - decodeStart;
+    }
+  }
+
+  result.totalTime = Clock::now() - start;
+
+  const CDemuxPacketPool::Stats poolAfter = pool->GetStats();
+  result.pool.hits = poolAfter.hits - poolBefore.hits;
+  result.pool.misses = poolAfter.misses - poolBefore.misses;
+  result.pool.oversized = poolAfter.oversized - poolBefore.oversized;
+  result.pool.recycled = poolAfter.recycled - poolBefore.recycled;
+  result.pool.dropped = poolAfter.dropped - poolBefore.dropped;
+  result.pool.cachedBytes = poolAfter.cachedBytes;
+  return true;
+}
+
+void PrintResult(const std::string& path, const BenchmarkResult& result)
+{
+  double total = Seconds(result.totalTime);
+  if (total <= 0.0)
+    total = 1e-9;
+
+  std::cout << "Benchmark: " << path << std::endl;
+  std::cout << StringUtils::Format("  packets: %llu (%.1f/s)", result.packets, result.packets / total) << std::endl;
+  std::cout << StringUtils::Format("  video frames: %llu (%.1f/s)", result.videoFrames, result.videoFrames / total) << std::endl;
+  std::cout << StringUtils::Format("  audio frames: %llu (%.1f/s)", result.audioFrames, result.audioFrames / total) << std::endl;
+  const uint64_t allocations = result.pool.misses + result.pool.oversized;
+  std::cout << StringUtils::Format("  packet allocations: %llu (%.3f per packet), pool hits %llu, recycled %llu, dropped %llu",
+                                   allocations, result.packets ? static_cast<double>(allocations) / result.packets : 0.0,
+                                   result.pool.hits, result.pool.recycled, result.pool.dropped) << std::endl;
+  std::cout << StringUtils::Format("  time: total %.3fs demux %.3fs video decode %.3fs audio decode %.3fs",
+                                   total, Seconds(result.demuxTime), Seconds(result.videoTime),
+                                   Seconds(result.audioTime)) << std::endl;
+}
+}
+
+/* Demuxes and decodes media files as fast as possible, without renderer or
+ * audio sink, and reports the throughput. More files can be given with the
+ * --add-benchmark-mediafile option of the testsuite program.
+ */
+TEST(TestVideoPlayerBenchmark, DemuxDecode)
+{
+  std::vector<std::string> files = CXBMCTestUtils::Instance().getBenchmarkMediaFiles();
+  files.insert(files.begin(), XBMC_REF_FILE_PATH("addons/resource.uisounds.kodi/resources/notify.wav"));
+
+  for (const auto& file : files)
+  {
+    BenchmarkResult result;
+    ASSERT_TRUE(RunBenchmark(file, result)) << "failed to open " << file;
+    EXPECT_GT(result.packets, 0u);
+    EXPECT_GT(result.videoFrames + result.audioFrames, 0u);
+    PrintResult(file, result);
+  }
+}
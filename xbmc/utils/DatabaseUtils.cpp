@@ -8,8 +8,11 @@
 
 #include "DatabaseUtils.h"
 
+#include "FileItem.h"
 #include "dbwrappers/dataset.h"
 #include "music/MusicDatabase.h"
+#include "threads/SystemClock.h"
+#include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
@@ -377,9 +380,8 @@ bool DatabaseUtils::GetDatabaseResults(const MediaType &mediaType, const FieldLi
     return false;
 
   std::vector<int> fieldIndexLookup;
-  fieldIndexLookup.reserve(fields.size());
-  for (FieldList::const_iterator it = fields.begin(); it != fields.end(); ++it)
-    fieldIndexLookup.push_back(GetFieldIndex(*it, mediaType));
+  if (!GetFieldIndexLookup(mediaType, fields, fieldIndexLookup))
+    return false;
 
   results.reserve(resultSet.records.size() + offset);
   for (unsigned int index = 0; index < resultSet.records.size(); index++)
@@ -387,62 +389,167 @@ bool DatabaseUtils::GetDatabaseResults(const MediaType &mediaType, const FieldLi
     DatabaseResult result;
     result[FieldRow] = index + offset;
 
-    unsigned int lookupIndex = 0;
-    for (FieldList::const_iterator it = fields.begin(); it != fields.end(); ++it)
-    {
-      int fieldIndex = fieldIndexLookup[lookupIndex++];
-      if (fieldIndex < 0)
-        return false;
+    if (!GetDatabaseResult(mediaType, fields, fieldIndexLookup, *resultSet.records[index], result))
+      return false;
+
+    results.push_back(result);
+  }
+
+  return true;
+}
+
+bool DatabaseUtils::GetFieldIndexLookup(const MediaType &mediaType, const FieldList &fields, std::vector<int> &fieldIndexLookup)
+{
+  fieldIndexLookup.clear();
+  fieldIndexLookup.reserve(fields.size());
+  for (FieldList::const_iterator it = fields.begin(); it != fields.end(); ++it)
+  {
+    int fieldIndex = GetFieldIndex(*it, mediaType);
+    if (fieldIndex < 0)
+      return false;
+    fieldIndexLookup.push_back(fieldIndex);
+  }
+
+  return true;
+}
 
-      std::pair<Field, CVariant> value;
-      value.first = *it;
-      if (!GetFieldValue(resultSet.records[index]->at(fieldIndex), value.second))
-        CLog::Log(LOGWARNING, "GetDatabaseResults: unable to retrieve value of field %s", resultSet.record_header[fieldIndex].name.c_str());
+bool DatabaseUtils::GetDatabaseResult(const MediaType &mediaType, const FieldList &fields, const std::vector<int> &fieldIndexLookup, const dbiplus::sql_record &record, DatabaseResult &result)
+{
+  if (fields.empty())
+    return true;
 
-      if (value.first == FieldYear &&
-         (mediaType == MediaTypeTvShow || mediaType == MediaTypeEpisode))
+  if (fieldIndexLookup.size() != fields.size())
+    return false;
+
+  unsigned int lookupIndex = 0;
+  for (FieldList::const_iterator it = fields.begin(); it != fields.end(); ++it)
+  {
+    int fieldIndex = fieldIndexLookup[lookupIndex++];
+    if (fieldIndex < 0 || static_cast<size_t>(fieldIndex) >= record.size())
+      return false;
+
+    std::pair<Field, CVariant> value;
+    value.first = *it;
+    if (!GetFieldValue(record.at(fieldIndex), value.second))
+      CLog::Log(LOGWARNING, "GetDatabaseResults: unable to retrieve value of field %d", *it);
+
+    if (value.first == FieldYear &&
+       (mediaType == MediaTypeTvShow || mediaType == MediaTypeEpisode))
+    {
+      CDateTime dateTime;
+      dateTime.SetFromDBDate(value.second.asString());
+      if (dateTime.IsValid())
       {
-        CDateTime dateTime;
-        dateTime.SetFromDBDate(value.second.asString());
-        if (dateTime.IsValid())
-        {
-          value.second.clear();
-          value.second = dateTime.GetYear();
-        }
+        value.second.clear();
+        value.second = dateTime.GetYear();
       }
-
-      result.insert(value);
     }
 
-    result[FieldMediaType] = mediaType;
-    if (mediaType == MediaTypeMovie || mediaType == MediaTypeVideoCollection ||
-        mediaType == MediaTypeTvShow || mediaType == MediaTypeMusicVideo)
-      result[FieldLabel] = result.at(FieldTitle).asString();
-    else if (mediaType == MediaTypeEpisode)
+    result.insert(value);
+  }
+
+  result[FieldMediaType] = mediaType;
+  if (mediaType == MediaTypeMovie || mediaType == MediaTypeVideoCollection ||
+      mediaType == MediaTypeTvShow || mediaType == MediaTypeMusicVideo)
+    result[FieldLabel] = result.at(FieldTitle).asString();
+  else if (mediaType == MediaTypeEpisode)
+  {
+    std::ostringstream label;
+    label << (int)(result.at(FieldSeason).asInteger() * 100 + result.at(FieldEpisodeNumber).asInteger());
+    label << ". ";
+    label << result.at(FieldTitle).asString();
+    result[FieldLabel] = label.str();
+  }
+  else if (mediaType == MediaTypeAlbum)
+    result[FieldLabel] = result.at(FieldAlbum).asString();
+  else if (mediaType == MediaTypeSong)
+  {
+    std::ostringstream label;
+    label << (int)result.at(FieldTrackNumber).asInteger();
+    label << ". ";
+    label << result.at(FieldTitle).asString();
+    result[FieldLabel] = label.str();
+  }
+  else if (mediaType == MediaTypeArtist)
+    result[FieldLabel] = result.at(FieldArtist).asString();
+
+  return true;
+}
+
+bool DatabaseUtils::CanGetItemsFromCursor(const SortDescription &sortDescription)
+{
+  return sortDescription.sortBy == SortByNone ||
+         (sortDescription.limitStart <= 0 && sortDescription.limitEnd <= 0);
+}
+
+bool DatabaseUtils::GetItemsFromCursor(dbiplus::Dataset &dataset, const std::string &sql, const MediaType &mediaType,
+                                       const SortDescription &sortDescription,
+                                       const std::function<std::shared_ptr<CFileItem>(const std::vector<dbiplus::field_value>* record)> &getItem,
+                                       int total, CFileItemList &items)
+{
+  unsigned int time = XbmcThreads::SystemClockMillis();
+  if (!dataset.open_cursor(sql))
+    return false;
+
+  const FieldList fields = SortUtils::GetDatabaseFieldsForSorting(sortDescription, mediaType);
+  std::vector<int> fieldIndexLookup;
+  if (!GetFieldIndexLookup(mediaType, fields, fieldIndexLookup))
+  {
+    dataset.close();
+    return false;
+  }
+
+  DatabaseResults results;
+  std::vector<CFileItemPtr> rowItems;
+  int rows = 0;
+  bool outOfMemory = false;
+  while (const dbiplus::sql_record* const record = dataset.fetch_row())
+  {
+    CFileItemPtr item;
+    try
     {
-      std::ostringstream label;
-      label << (int)(result.at(FieldSeason).asInteger() * 100 + result.at(FieldEpisodeNumber).asInteger());
-      label << ". ";
-      label << result.at(FieldTitle).asString();
-      result[FieldLabel] = label.str();
+      item = getItem(record);
     }
-    else if (mediaType == MediaTypeAlbum)
-      result[FieldLabel] = result.at(FieldAlbum).asString();
-    else if (mediaType == MediaTypeSong)
+    catch (...)
     {
-      std::ostringstream label;
-      label << (int)result.at(FieldTrackNumber).asInteger();
-      label << ". ";
-      label << result.at(FieldTitle).asString();
-      result[FieldLabel] = label.str();
+      outOfMemory = true;
+      break;
     }
-    else if (mediaType == MediaTypeArtist)
-      result[FieldLabel] = result.at(FieldArtist).asString();
+    rows++;
+    if (!item)
+      continue;
 
+    DatabaseResult result;
+    result[FieldRow] = static_cast<int>(rowItems.size());
+    if (!GetDatabaseResult(mediaType, fields, fieldIndexLookup, *record, result))
+    {
+      dataset.close();
+      return false;
+    }
     results.push_back(result);
+    rowItems.push_back(item);
   }
+  dataset.close();
+  if (outOfMemory)
+    CLog::Log(LOGERROR, "%s: out of memory loading query: %s", __FUNCTION__, sql.c_str());
+  else
+    CLog::Log(LOGDEBUG, LOGDATABASE, "%s took %d ms for %d items: %s", __FUNCTION__, XbmcThreads::SystemClockMillis() - time, rows, sql.c_str());
 
-  return true;
+  if (rows == 0)
+    return !outOfMemory;
+
+  // store the total value of items as a property
+  if (total < rows)
+    total = rows;
+  items.SetProperty("total", total);
+
+  SortUtils::SortFromResults(sortDescription, results);
+
+  items.Reserve(results.size());
+  for (const auto &i : results)
+    items.Add(rowItems[static_cast<size_t>(i.at(FieldRow).asInteger())]);
+
+  return !outOfMemory || !rowItems.empty();
 }
 
 std::string DatabaseUtils::BuildLimitClause(int end, int start /* = 0 */)
@@ -10,13 +10,17 @@
 
 #include "media/MediaType.h"
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+class CFileItem;
+class CFileItemList;
 class CVariant;
+struct SortDescription;
 
 namespace dbiplus
 {
@@ -159,6 +163,33 @@ public:
 
   static bool GetFieldValue(const dbiplus::field_value &fieldValue, CVariant &variantValue);
   static bool GetDatabaseResults(const MediaType &mediaType, const FieldList &fields, const std::unique_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results);
+  /*! \brief Gets the record indices of the given fields, once per query.
+   \return false if a field isn't part of the records of the media type
+   */
+  static bool GetFieldIndexLookup(const MediaType &mediaType, const FieldList &fields, std::vector<int> &fieldIndexLookup);
+  /*! \brief Gets the fields of a single record, e.g. a row read with a dataset cursor.
+   The caller sets FieldRow. The lookup comes from GetFieldIndexLookup().
+   */
+  static bool GetDatabaseResult(const MediaType &mediaType, const FieldList &fields, const std::vector<int> &fieldIndexLookup, const std::vector<dbiplus::field_value> &record, DatabaseResult &result);
+
+  /*! \brief Whether GetItemsFromCursor() can list a query sorted as described.
+   Unless sorting drops the rows past a limit every row becomes an item, so these can be read
+   with a cursor instead of storing the whole result set first.
+   */
+  static bool CanGetItemsFromCursor(const SortDescription &sortDescription);
+  /*! \brief Reads the rows of a query with a cursor and adds their items to the list, sorted as described.
+   \param dataset dataset to run the query on, it is closed when done
+   \param getItem creates the item of a row, a row without an item is skipped. If it throws, reading
+   stops and the items of the rows read so far are kept.
+   \param total number of items without the limit of the query, -1 if it isn't limited. Stored in the
+   "total" property of the list.
+   \return false if the query fails, or no item could be read before getItem threw. Database
+   errors are thrown by the dataset as with a query.
+   */
+  static bool GetItemsFromCursor(dbiplus::Dataset &dataset, const std::string &sql, const MediaType &mediaType,
+                                 const SortDescription &sortDescription,
+                                 const std::function<std::shared_ptr<CFileItem>(const std::vector<dbiplus::field_value>* record)> &getItem,
+                                 int total, CFileItemList &items);
 
   static std::string BuildLimitClause(int end, int start = 0);
 
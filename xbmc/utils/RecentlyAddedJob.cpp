@@ -14,6 +14,7 @@
 #include "guilib/GUIWindow.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/WindowIDs.h"
+#include "media/MediaType.h"
 #include "music/MusicDatabase.h"
 #include "music/MusicThumbLoader.h"
 #include "music/tags/MusicInfoTag.h"
@@ -330,19 +331,19 @@ bool CRecentlyAddedJob::UpdateTotal()
   if (items.Size() == 1 && items.Get(0)->HasProperty("total"))
     MusArtistTotals = items.Get(0)->GetProperty("total").asInteger();
 
-  int MusSongTotals   = atoi(musicdatabase.GetSingleValue("songview"       , "count(1)").c_str());
-  int MusAlbumTotals  = atoi(musicdatabase.GetSingleValue("songview"       , "count(distinct strAlbum)").c_str());
+  // the song and album totals count the tables, songview would join album and path for every song
+  int MusSongTotals   = atoi(musicdatabase.GetSingleValue("song"           , "count(1)").c_str());
+  int MusAlbumTotals  = atoi(musicdatabase.GetSingleValue("album"          , "count(distinct strAlbum)",
+                                                          "EXISTS (SELECT 1 FROM song WHERE song.idAlbum = album.idAlbum)").c_str());
   musicdatabase.Close();
 
-  videodatabase.Open();
-  int tvShowCount     = atoi(videodatabase.GetSingleValue("tvshow_view"     , "count(1)").c_str());
-  int movieTotals     = atoi(videodatabase.GetSingleValue("movie_view"      , "count(1)").c_str());
-  int movieWatched    = atoi(videodatabase.GetSingleValue("movie_view"      , "count(playCount)").c_str());
-  int MusVidTotals    = atoi(videodatabase.GetSingleValue("musicvideo_view" , "count(1)").c_str());
-  int MusVidWatched   = atoi(videodatabase.GetSingleValue("musicvideo_view" , "count(playCount)").c_str());
-  int EpWatched       = atoi(videodatabase.GetSingleValue("tvshow_view"     , "sum(watchedcount)").c_str());
-  int EpCount         = atoi(videodatabase.GetSingleValue("tvshow_view"     , "sum(totalcount)").c_str());
-  int TvShowsWatched  = atoi(videodatabase.GetSingleValue("tvshow_view"     , "sum(watchedcount = totalcount)").c_str());
+  int tvShowCount, TvShowsWatched, movieTotals, movieWatched;
+  int MusVidTotals, MusVidWatched, EpCount, EpWatched;
+  videodatabase.OpenForRead();
+  videodatabase.GetLibraryCount(MediaTypeTvShow, tvShowCount, TvShowsWatched);
+  videodatabase.GetLibraryCount(MediaTypeMovie, movieTotals, movieWatched);
+  videodatabase.GetLibraryCount(MediaTypeMusicVideo, MusVidTotals, MusVidWatched);
+  videodatabase.GetLibraryCount(MediaTypeEpisode, EpCount, EpWatched);
   videodatabase.Close();
 
   home->SetProperty("TVShows.Count"         , tvShowCount);
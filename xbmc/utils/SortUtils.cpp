@@ -795,14 +795,28 @@ void SortUtils::Sort(const SortDescription &sortDescription, SortItems& items)
 }
 
 bool SortUtils::SortFromDataset(const SortDescription &sortDescription, const MediaType &mediaType, const std::unique_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results)
+{
+  FieldList fields = GetDatabaseFieldsForSorting(sortDescription, mediaType);
+
+  if (!DatabaseUtils::GetDatabaseResults(mediaType, fields, dataset, results))
+    return false;
+
+  SortFromResults(sortDescription, results);
+
+  return true;
+}
+
+FieldList SortUtils::GetDatabaseFieldsForSorting(const SortDescription &sortDescription, const MediaType &mediaType)
 {
   FieldList fields;
   if (!DatabaseUtils::GetSelectFields(SortUtils::GetFieldsForSorting(sortDescription.sortBy), mediaType, fields))
     fields.clear();
 
-  if (!DatabaseUtils::GetDatabaseResults(mediaType, fields, dataset, results))
-    return false;
+  return fields;
+}
 
+void SortUtils::SortFromResults(const SortDescription &sortDescription, DatabaseResults &results)
+{
   SortDescription sorting = sortDescription;
   if (sortDescription.sortBy == SortByNone)
   {
@@ -811,8 +825,6 @@ bool SortUtils::SortFromDataset(const SortDescription &sortDescription, const Me
   }
 
   Sort(sorting, results);
-
-  return true;
 }
 
 const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
@@ -199,6 +199,10 @@ public:
   static void Sort(const SortDescription &sortDescription, DatabaseResults& items);
   static void Sort(const SortDescription &sortDescription, SortItems& items);
   static bool SortFromDataset(const SortDescription &sortDescription, const MediaType &mediaType, const std::unique_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results);
+  /*! \brief The fields DatabaseUtils::GetDatabaseResult has to get of each row for SortFromResults */
+  static FieldList GetDatabaseFieldsForSorting(const SortDescription &sortDescription, const MediaType &mediaType);
+  /*! \brief Sorts results gathered row by row, e.g. with a dataset cursor, like SortFromDataset */
+  static void SortFromResults(const SortDescription &sortDescription, DatabaseResults &results);
 
   static const Fields& GetFieldsForSorting(SortBy sortBy);
   static std::string RemoveArticles(const std::string &label);
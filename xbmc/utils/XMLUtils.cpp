@@ -29,6 +29,14 @@ bool XMLUtils::GetUInt(const TiXmlNode* pRootNode, const char* strTag, uint32_t&
   return true;
 }
 
+bool XMLUtils::GetUInt64(const TiXmlNode* pRootNode, const char* strTag, uint64_t& value)
+{
+  const TiXmlNode* pNode = pRootNode->FirstChild(strTag );
+  if (!pNode || !pNode->FirstChild()) return false;
+  value = strtoull(pNode->FirstChild()->Value(), nullptr, 10);
+  return true;
+}
+
 bool XMLUtils::GetUInt(const TiXmlNode* pRootNode, const char* strTag, uint32_t &value, const uint32_t min, const uint32_t max)
 {
   if (GetUInt(pRootNode, strTag, value))
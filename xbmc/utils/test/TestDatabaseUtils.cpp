@@ -6,13 +6,23 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include "FileItem.h"
 #include "dbwrappers/qry_dat.h"
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "music/MusicDatabase.h"
 #include "utils/DatabaseUtils.h"
+#include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "video/VideoDatabase.h"
 
+#include <algorithm>
+#include <memory>
+#include <new>
+
 #include <gtest/gtest.h>
 
 class TestDatabaseUtilsHelper
@@ -1343,6 +1353,119 @@ TEST(TestDatabaseUtils, GetFieldValue)
 //                                  DatabaseResults &results);
 // }
 
+TEST(TestDatabaseUtils, GetDatabaseResult)
+{
+  const int title = DatabaseUtils::GetFieldIndex(FieldTitle, MediaTypeSong);
+  const int track = DatabaseUtils::GetFieldIndex(FieldTrackNumber, MediaTypeSong);
+  const int year = DatabaseUtils::GetFieldIndex(FieldYear, MediaTypeSong);
+  dbiplus::sql_record record(std::max({ title, track, year }) + 1);
+  record[title].set_asString("Title");
+  record[track].set_asInt(3);
+  record[year].set_asInt(1999);
+
+  std::vector<int> lookup;
+  DatabaseResult result;
+  EXPECT_TRUE(DatabaseUtils::GetFieldIndexLookup(MediaTypeSong, FieldList(), lookup));
+  EXPECT_TRUE(DatabaseUtils::GetDatabaseResult(MediaTypeSong, FieldList(), lookup, record, result));
+  EXPECT_TRUE(result.empty());
+
+  FieldList fields = { FieldTitle, FieldTrackNumber, FieldYear };
+  EXPECT_TRUE(DatabaseUtils::GetFieldIndexLookup(MediaTypeSong, fields, lookup));
+  EXPECT_TRUE(DatabaseUtils::GetDatabaseResult(MediaTypeSong, fields, lookup, record, result));
+  EXPECT_EQ("Title", result[FieldTitle].asString());
+  EXPECT_EQ(1999, result[FieldYear].asInteger());
+  EXPECT_EQ("3. Title", result[FieldLabel].asString());
+  EXPECT_EQ(MediaTypeSong, result[FieldMediaType].asString());
+
+  // the record has as many values as fields, but not up to their indices
+  dbiplus::sql_record shortRecord(fields.size());
+  EXPECT_FALSE(DatabaseUtils::GetDatabaseResult(MediaTypeSong, fields, lookup, shortRecord, result));
+
+  // the lookup doesn't match the fields
+  EXPECT_FALSE(DatabaseUtils::GetDatabaseResult(MediaTypeSong, fields, std::vector<int>(), record, result));
+
+  // the field has no index
+  EXPECT_FALSE(DatabaseUtils::GetFieldIndexLookup(MediaTypeSong, { FieldTitle, FieldNone }, lookup));
+}
+
+TEST(TestDatabaseUtils, GetItemsFromCursor)
+{
+  dbiplus::SqliteDatabase db;
+  db.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+  db.setDatabase("TestDatabaseUtils");
+  const std::string path = URIUtils::AddFileToFolder(db.getHostName(), db.getDatabase());
+  XFILE::CFile::Delete(path);
+  ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+
+  std::unique_ptr<dbiplus::Dataset> ds(db.CreateDataset());
+  ds->exec("CREATE TABLE item (idItem INTEGER PRIMARY KEY, strLabel TEXT)");
+  for (int i = 1; i <= 5; i++)
+    ds->exec(StringUtils::Format("INSERT INTO item (idItem, strLabel) VALUES (%i, 'item %i')", i, i));
+
+  int throwAt = 0;
+  auto getItem = [&](const dbiplus::sql_record* const record)
+  {
+    CFileItemPtr item;
+    const int id = record->at(0).get_asInt();
+    if (id == throwAt)
+      throw std::bad_alloc();
+    // an item that isn't listed, e.g. a locked one
+    if (id != 3)
+      item.reset(new CFileItem(record->at(1).get_asString()));
+    return item;
+  };
+
+  SortDescription sorting;
+  EXPECT_TRUE(DatabaseUtils::CanGetItemsFromCursor(sorting));
+  sorting.limitEnd = 10;
+  EXPECT_TRUE(DatabaseUtils::CanGetItemsFromCursor(sorting));
+  sorting.sortBy = SortByTitle;
+  EXPECT_FALSE(DatabaseUtils::CanGetItemsFromCursor(sorting));
+  sorting = SortDescription();
+
+  CFileItemList items;
+  EXPECT_TRUE(DatabaseUtils::GetItemsFromCursor(*ds, "SELECT * FROM item ORDER BY idItem", MediaTypeNone,
+                                                sorting, getItem, -1, items));
+  ASSERT_EQ(4, items.Size());
+  EXPECT_EQ("item 1", items[0]->GetLabel());
+  EXPECT_EQ("item 2", items[1]->GetLabel());
+  EXPECT_EQ("item 4", items[2]->GetLabel());
+  EXPECT_EQ("item 5", items[3]->GetLabel());
+  EXPECT_EQ(5, items.GetProperty("total").asInteger());
+
+  // the total of a limited query is kept
+  items.Clear();
+  EXPECT_TRUE(DatabaseUtils::GetItemsFromCursor(*ds, "SELECT * FROM item ORDER BY idItem LIMIT 2", MediaTypeNone,
+                                                sorting, getItem, 5, items));
+  EXPECT_EQ(2, items.Size());
+  EXPECT_EQ(5, items.GetProperty("total").asInteger());
+
+  items.Clear();
+  EXPECT_TRUE(DatabaseUtils::GetItemsFromCursor(*ds, "SELECT * FROM item WHERE idItem > 5", MediaTypeNone,
+                                                sorting, getItem, -1, items));
+  EXPECT_TRUE(items.IsEmpty());
+
+  // the items read before running out of memory are kept
+  throwAt = 4;
+  EXPECT_TRUE(DatabaseUtils::GetItemsFromCursor(*ds, "SELECT * FROM item ORDER BY idItem", MediaTypeNone,
+                                                sorting, getItem, -1, items));
+  EXPECT_EQ(2, items.Size());
+
+  items.Clear();
+  throwAt = 1;
+  EXPECT_FALSE(DatabaseUtils::GetItemsFromCursor(*ds, "SELECT * FROM item ORDER BY idItem", MediaTypeNone,
+                                                 sorting, getItem, -1, items));
+  EXPECT_TRUE(items.IsEmpty());
+
+  // like a query, the cursor throws on errors
+  EXPECT_ANY_THROW(DatabaseUtils::GetItemsFromCursor(*ds, "SELECT * FROM missing", MediaTypeNone,
+                                                     sorting, getItem, -1, items));
+
+  ds.reset();
+  db.disconnect();
+  XFILE::CFile::Delete(path);
+}
+
 TEST(TestDatabaseUtils, BuildLimitClause)
 {
   std::string a = DatabaseUtils::BuildLimitClause(100);
@@ -36,6 +36,18 @@ TEST(TestXMLUtils, GetUInt)
   EXPECT_EQ(ref, val);
 }
 
+TEST(TestXMLUtils, GetUInt64)
+{
+  CXBMCTinyXML a;
+  uint64_t ref, val;
+
+  a.Parse(std::string("<root><node>8589934592</node></root>"));
+  EXPECT_TRUE(XMLUtils::GetUInt64(a.RootElement(), "node", val));
+
+  ref = 8589934592;
+  EXPECT_EQ(ref, val);
+}
+
 TEST(TestXMLUtils, GetLong)
 {
   CXBMCTinyXML a;
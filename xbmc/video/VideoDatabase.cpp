@@ -193,6 +193,12 @@ void CVideoDatabase::CreateTables()
 
   CLog::Log(LOGINFO, "create uniqueid table");
   m_pDS->exec("CREATE TABLE uniqueid (uniqueid_id INTEGER PRIMARY KEY, media_id INTEGER, media_type TEXT, value TEXT, type TEXT)");
+
+  CLog::Log(LOGINFO, "create librarycount table");
+  m_pDS->exec("CREATE TABLE librarycount (media_type TEXT, total INTEGER, watched INTEGER)");
+
+  CLog::Log(LOGINFO, "create tvshowcount table");
+  m_pDS->exec("CREATE TABLE tvshowcount (idShow INTEGER PRIMARY KEY, totalCount INTEGER, watchedCount INTEGER)");
 }
 
 void CVideoDatabase::CreateLinkIndex(const char *table)
@@ -285,6 +291,7 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM tag_link WHERE media_id=old.idMovie AND media_type='movie'; "
               "DELETE FROM rating WHERE media_id=old.idMovie AND media_type='movie'; "
               "DELETE FROM uniqueid WHERE media_id=old.idMovie AND media_type='movie'; "
+              "UPDATE librarycount SET total=total-1, watched=watched-(SELECT COUNT(playCount) FROM files WHERE idFile=old.idFile) WHERE media_type='movie'; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_tvshow AFTER DELETE ON tvshow FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idShow AND media_type='tvshow'; "
@@ -298,6 +305,8 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM tag_link WHERE media_id=old.idShow AND media_type='tvshow'; "
               "DELETE FROM rating WHERE media_id=old.idShow AND media_type='tvshow'; "
               "DELETE FROM uniqueid WHERE media_id=old.idShow AND media_type='tvshow'; "
+              "DELETE FROM tvshowcount WHERE idShow=old.idShow; "
+              "UPDATE librarycount SET total=total-1 WHERE media_type='tvshow'; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_musicvideo AFTER DELETE ON musicvideo FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
@@ -306,6 +315,7 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM studio_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
               "DELETE FROM art WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
               "DELETE FROM tag_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
+              "UPDATE librarycount SET total=total-1, watched=watched-(SELECT COUNT(playCount) FROM files WHERE idFile=old.idFile) WHERE media_type='musicvideo'; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_episode AFTER DELETE ON episode FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idEpisode AND media_type='episode'; "
@@ -314,6 +324,8 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM art WHERE media_id=old.idEpisode AND media_type='episode'; "
               "DELETE FROM rating WHERE media_id=old.idEpisode AND media_type='episode'; "
               "DELETE FROM uniqueid WHERE media_id=old.idEpisode AND media_type='episode'; "
+              "UPDATE librarycount SET total=total-1, watched=watched-(SELECT COUNT(playCount) FROM files WHERE idFile=old.idFile) WHERE media_type='episode'; "
+              "UPDATE tvshowcount SET totalCount=totalCount-1, watchedCount=watchedCount-(SELECT COUNT(playCount) FROM files WHERE idFile=old.idFile) WHERE idShow=old.idShow; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_season AFTER DELETE ON seasons FOR EACH ROW BEGIN "
               "DELETE FROM art WHERE media_id=old.idSeason AND media_type='season'; "
@@ -332,9 +344,60 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM settings WHERE idFile=old.idFile; "
               "DELETE FROM stacktimes WHERE idFile=old.idFile; "
               "DELETE FROM streamdetails WHERE idFile=old.idFile; "
+              "UPDATE librarycount SET watched=watched-(old.playCount IS NOT NULL)*(SELECT COUNT(1) FROM movie WHERE idFile=old.idFile) WHERE media_type='movie'; "
+              "UPDATE librarycount SET watched=watched-(old.playCount IS NOT NULL)*(SELECT COUNT(1) FROM episode WHERE idFile=old.idFile) WHERE media_type='episode'; "
+              "UPDATE librarycount SET watched=watched-(old.playCount IS NOT NULL)*(SELECT COUNT(1) FROM musicvideo WHERE idFile=old.idFile) WHERE media_type='musicvideo'; "
+              "UPDATE tvshowcount SET watchedCount=watchedCount-(old.playCount IS NOT NULL)*(SELECT COUNT(1) FROM episode WHERE episode.idFile=old.idFile AND episode.idShow=tvshowcount.idShow) "
+                "WHERE idShow IN (SELECT idShow FROM episode WHERE idFile=old.idFile); "
               "END");
 
+  // the library counts follow the media tables and the watched state of their files,
+  // MySQL allows one trigger per table and event so deletes extend the triggers above
+  m_pDS->exec("CREATE TRIGGER insert_movie AFTER INSERT ON movie FOR EACH ROW BEGIN "
+              "UPDATE librarycount SET total=total+1, watched=watched+(SELECT COUNT(playCount) FROM files WHERE idFile=new.idFile) WHERE media_type='movie'; "
+              "END");
+  m_pDS->exec("CREATE TRIGGER insert_tvshow AFTER INSERT ON tvshow FOR EACH ROW BEGIN "
+              "INSERT INTO tvshowcount (idShow, totalCount, watchedCount) VALUES (new.idShow, 0, 0); "
+              "UPDATE librarycount SET total=total+1 WHERE media_type='tvshow'; "
+              "END");
+  m_pDS->exec("CREATE TRIGGER insert_musicvideo AFTER INSERT ON musicvideo FOR EACH ROW BEGIN "
+              "UPDATE librarycount SET total=total+1, watched=watched+(SELECT COUNT(playCount) FROM files WHERE idFile=new.idFile) WHERE media_type='musicvideo'; "
+              "END");
+  m_pDS->exec("CREATE TRIGGER insert_episode AFTER INSERT ON episode FOR EACH ROW BEGIN "
+              "UPDATE librarycount SET total=total+1, watched=watched+(SELECT COUNT(playCount) FROM files WHERE idFile=new.idFile) WHERE media_type='episode'; "
+              "UPDATE tvshowcount SET totalCount=totalCount+1, watchedCount=watchedCount+(SELECT COUNT(playCount) FROM files WHERE idFile=new.idFile) WHERE idShow=new.idShow; "
+              "END");
+  // only changes of the watched state touch the counts, MySQL has no WHEN clause on triggers
+  m_pDS->exec(std::string("CREATE TRIGGER update_file AFTER UPDATE ON files FOR EACH ROW ") +
+              (m_sqlite ? "WHEN old.playCount IS NOT new.playCount BEGIN "
+                        : "BEGIN IF NOT (old.playCount <=> new.playCount) THEN ") +
+              "UPDATE librarycount SET watched=watched+((new.playCount IS NOT NULL)-(old.playCount IS NOT NULL))*(SELECT COUNT(1) FROM movie WHERE idFile=new.idFile) WHERE media_type='movie'; "
+              "UPDATE librarycount SET watched=watched+((new.playCount IS NOT NULL)-(old.playCount IS NOT NULL))*(SELECT COUNT(1) FROM episode WHERE idFile=new.idFile) WHERE media_type='episode'; "
+              "UPDATE librarycount SET watched=watched+((new.playCount IS NOT NULL)-(old.playCount IS NOT NULL))*(SELECT COUNT(1) FROM musicvideo WHERE idFile=new.idFile) WHERE media_type='musicvideo'; "
+              "UPDATE tvshowcount SET watchedCount=watchedCount+((new.playCount IS NOT NULL)-(old.playCount IS NOT NULL))*(SELECT COUNT(1) FROM episode WHERE episode.idFile=new.idFile AND episode.idShow=tvshowcount.idShow) "
+                "WHERE idShow IN (SELECT idShow FROM episode WHERE idFile=new.idFile); " +
+              (m_sqlite ? "END" : "END IF; END"));
+
   CreateViews();
+  RebuildLibraryCounts();
+}
+
+void CVideoDatabase::RebuildLibraryCounts()
+{
+  CLog::Log(LOGINFO, "%s - rebuilding library counts", __FUNCTION__);
+  m_pDS->exec("DELETE FROM librarycount");
+  for (const char* table : { "movie", "episode", "musicvideo" })
+    m_pDS->exec(PrepareSQL("INSERT INTO librarycount (media_type, total, watched) "
+                           "SELECT '%s', COUNT(1), COUNT(files.playCount) FROM %s LEFT JOIN files ON files.idFile=%s.idFile",
+                           table, table, table));
+  m_pDS->exec("INSERT INTO librarycount (media_type, total, watched) SELECT 'tvshow', COUNT(1), 0 FROM tvshow");
+
+  m_pDS->exec("DELETE FROM tvshowcount");
+  m_pDS->exec("INSERT INTO tvshowcount (idShow, totalCount, watchedCount) "
+              "SELECT tvshow.idShow, COUNT(episode.idEpisode), COUNT(files.playCount) FROM tvshow "
+              "LEFT JOIN episode ON episode.idShow=tvshow.idShow "
+              "LEFT JOIN files ON files.idFile=episode.idFile "
+              "GROUP BY tvshow.idShow");
 }
 
 void CVideoDatabase::CreateViews()
@@ -538,7 +601,6 @@ void CVideoDatabase::CreateViews()
 //********************************************************************************************************************************
 int CVideoDatabase::GetPathId(const std::string& strPath)
 {
-  std::string strSQL;
   try
   {
     int idPath=-1;
@@ -553,8 +615,7 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
-    strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
-    m_pDS->query(strSQL);
+    m_pDS->query_prepared("select idPath from path where strPath=?", {field_value(strPath1)});
     if (!m_pDS->eof())
       idPath = m_pDS->fv("path.idPath").get_asInt();
 
@@ -563,7 +624,7 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
   }
   catch (...)
   {
-    CLog::Log(LOGERROR, "%s unable to getpath (%s)", __FUNCTION__, strSQL.c_str());
+    CLog::Log(LOGERROR, "%s unable to getpath (%s)", __FUNCTION__, strPath.c_str());
   }
   return -1;
 }
@@ -1110,9 +1171,8 @@ int CVideoDatabase::GetFileId(const std::string& strFilenameAndPath)
     int idPath = GetPathId(strPath);
     if (idPath >= 0)
     {
-      std::string strSQL;
-      strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-      m_pDS->query(strSQL);
+      m_pDS->query_prepared("select idFile from files where strFileName=? and idPath=?",
+                            {field_value(strFileName), field_value(idPath)});
       if (m_pDS->num_rows() > 0)
       {
         int idFile = m_pDS->fv("files.idFile").get_asInt();
@@ -1728,8 +1788,9 @@ void CVideoDatabase::AddLinkToActor(int mediaId, const char *mediaType, int acto
 
   if (GetSingleValue(sql).empty())
   { // doesnt exists, add it
-    sql = PrepareSQL("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order) VALUES(%i,%i,'%s','%s',%i)", actorId, mediaId, mediaType, role.c_str(), order);
-    ExecuteQuery(sql);
+    QueueInsertRow("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order)",
+                   PrepareSQL("%i,%i,'%s','%s',%i", actorId, mediaId, mediaType, role.c_str(), order),
+                   PrepareSQL("%i,%i,'%s'", actorId, mediaId, mediaType));
   }
 }
 
@@ -1740,8 +1801,8 @@ void CVideoDatabase::AddToLinkTable(int mediaId, const std::string& mediaType, c
 
   if (GetSingleValue(sql).empty())
   { // doesnt exists, add it
-    sql = PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type) VALUES(%i,%i,'%s')", table.c_str(), key, valueId, mediaId, mediaType.c_str());
-    ExecuteQuery(sql);
+    QueueInsertRow(PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type)", table.c_str(), key),
+                   PrepareSQL("%i,%i,'%s'", valueId, mediaId, mediaType.c_str()));
   }
 }
 
@@ -1768,6 +1829,9 @@ void CVideoDatabase::AddLinksToItem(int mediaId, const std::string& mediaType, c
 
 void CVideoDatabase::UpdateLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
 {
+  // links queued before are written first, if they fail the item is rolled back on commit
+  if (!FlushInsertRows())
+    return;
   std::string sql = PrepareSQL("DELETE FROM %s_link WHERE media_id=%i AND media_type='%s'", field.c_str(), mediaId, mediaType.c_str());
   m_pDS->exec(sql);
 
@@ -1789,6 +1853,9 @@ void CVideoDatabase::AddActorLinksToItem(int mediaId, const std::string& mediaTy
 
 void CVideoDatabase::UpdateActorLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
 {
+  // links queued before are written first, if they fail the item is rolled back on commit
+  if (!FlushInsertRows())
+    return;
   std::string sql = PrepareSQL("DELETE FROM %s_link WHERE media_id=%i AND media_type='%s'", field.c_str(), mediaId, mediaType.c_str());
   m_pDS->exec(sql);
 
@@ -3024,33 +3091,38 @@ void CVideoDatabase::SetStreamDetailsForFileId(const CStreamDetails& details, in
     BeginTransaction();
     m_pDS->exec(PrepareSQL("DELETE FROM streamdetails WHERE idFile = %i", idFile));
 
+    // identical streams are separate rows, so every row gets a key of its own
+    int row = 0;
     for (int i=1; i<=details.GetVideoStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strVideoCodec, fVideoAspect, iVideoWidth, iVideoHeight, iVideoDuration, strStereoMode, strVideoLanguage) "
-        "VALUES (%i,%i,'%s',%f,%i,%i,%i,'%s','%s')",
-        idFile, (int)CStreamDetail::VIDEO,
-        details.GetVideoCodec(i).c_str(), details.GetVideoAspect(i),
-        details.GetVideoWidth(i), details.GetVideoHeight(i), details.GetVideoDuration(i),
-        details.GetStereoMode(i).c_str(),
-        details.GetVideoLanguage(i).c_str()));
+      QueueInsertRow("INSERT INTO streamdetails "
+        "(idFile, iStreamType, strVideoCodec, fVideoAspect, iVideoWidth, iVideoHeight, iVideoDuration, strStereoMode, strVideoLanguage)",
+        PrepareSQL("%i,%i,'%s',%f,%i,%i,%i,'%s','%s'",
+          idFile, (int)CStreamDetail::VIDEO,
+          details.GetVideoCodec(i).c_str(), details.GetVideoAspect(i),
+          details.GetVideoWidth(i), details.GetVideoHeight(i), details.GetVideoDuration(i),
+          details.GetStereoMode(i).c_str(),
+          details.GetVideoLanguage(i).c_str()),
+        std::to_string(row++));
     }
     for (int i=1; i<=details.GetAudioStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strAudioCodec, iAudioChannels, strAudioLanguage) "
-        "VALUES (%i,%i,'%s',%i,'%s')",
-        idFile, (int)CStreamDetail::AUDIO,
-        details.GetAudioCodec(i).c_str(), details.GetAudioChannels(i),
-        details.GetAudioLanguage(i).c_str()));
+      QueueInsertRow("INSERT INTO streamdetails "
+        "(idFile, iStreamType, strAudioCodec, iAudioChannels, strAudioLanguage)",
+        PrepareSQL("%i,%i,'%s',%i,'%s'",
+          idFile, (int)CStreamDetail::AUDIO,
+          details.GetAudioCodec(i).c_str(), details.GetAudioChannels(i),
+          details.GetAudioLanguage(i).c_str()),
+        std::to_string(row++));
     }
     for (int i=1; i<=details.GetSubtitleStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strSubtitleLanguage) "
-        "VALUES (%i,%i,'%s')",
-        idFile, (int)CStreamDetail::SUBTITLE,
-        details.GetSubtitleLanguage(i).c_str()));
+      QueueInsertRow("INSERT INTO streamdetails "
+        "(idFile, iStreamType, strSubtitleLanguage)",
+        PrepareSQL("%i,%i,'%s'",
+          idFile, (int)CStreamDetail::SUBTITLE,
+          details.GetSubtitleLanguage(i).c_str()),
+        std::to_string(row++));
     }
 
     // update the runtime information, if empty
@@ -3145,8 +3217,8 @@ void CVideoDatabase::GetBookMarksForFile(const std::string& strFilenameAndPath,
       if (nullptr == m_pDS)
         return;
 
-      std::string strSQL=PrepareSQL("select * from bookmark where idFile=%i and type=%i order by timeInSeconds", idFile, (int)type);
-      m_pDS->query( strSQL );
+      m_pDS->query_prepared("select * from bookmark where idFile=? and type=? order by timeInSeconds",
+                            {field_value(idFile), field_value(static_cast<int>(type))});
       while (!m_pDS->eof())
       {
         CBookmark bookmark;
@@ -3866,8 +3938,7 @@ bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
   std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
   try
   {
-    std::string strSQL = PrepareSQL("SELECT * FROM streamdetails WHERE idFile = %i", tag.m_iFileId);
-    pDS->query(strSQL);
+    pDS->query_prepared("SELECT * FROM streamdetails WHERE idFile = ?", {field_value(tag.m_iFileId)});
 
     while (!pDS->eof())
     {
@@ -4564,24 +4635,21 @@ void CVideoDatabase::SetArtForItem(int mediaId, const MediaType &mediaType, cons
     if (artType.find('.') != std::string::npos)
       return;
 
-    std::string sql = PrepareSQL("SELECT art_id,url FROM art WHERE media_id=%i AND media_type='%s' AND type='%s'", mediaId, mediaType.c_str(), artType.c_str());
-    m_pDS->query(sql);
+    m_pDS->query_prepared("SELECT art_id,url FROM art WHERE media_id=? AND media_type=? AND type=?",
+                          {field_value(mediaId), field_value(mediaType), field_value(artType)});
     if (!m_pDS->eof())
     { // update
       int artId = m_pDS->fv(0).get_asInt();
       std::string oldUrl = m_pDS->fv(1).get_asString();
       m_pDS->close();
       if (oldUrl != url)
-      {
-        sql = PrepareSQL("UPDATE art SET url='%s' where art_id=%d", url.c_str(), artId);
-        m_pDS->exec(sql);
-      }
+        m_pDS->exec_prepared("UPDATE art SET url=? where art_id=?", {field_value(url), field_value(artId)});
     }
     else
     { // insert
       m_pDS->close();
-      sql = PrepareSQL("INSERT INTO art(media_id, media_type, type, url) VALUES (%d, '%s', '%s', '%s')", mediaId, mediaType.c_str(), artType.c_str(), url.c_str());
-      m_pDS->exec(sql);
+      m_pDS->exec_prepared("INSERT INTO art(media_id, media_type, type, url) VALUES (?, ?, ?, ?)",
+                           {field_value(mediaId), field_value(mediaType), field_value(artType), field_value(url)});
     }
   }
   catch (...)
@@ -4599,8 +4667,8 @@ bool CVideoDatabase::GetArtForItem(int mediaId, const MediaType &mediaType, std:
     if (nullptr == m_pDS2)
       return false; // using dataset 2 as we're likely called in loops on dataset 1
 
-    std::string sql = PrepareSQL("SELECT type,url FROM art WHERE media_id=%i AND media_type='%s'", mediaId, mediaType.c_str());
-    m_pDS2->query(sql);
+    m_pDS2->query_prepared("SELECT type,url FROM art WHERE media_id=? AND media_type=?",
+                           {field_value(mediaId), field_value(mediaType)});
     while (!m_pDS2->eof())
     {
       art.insert(make_pair(m_pDS2->fv(0).get_asString(), m_pDS2->fv(1).get_asString()));
@@ -4618,8 +4686,8 @@ bool CVideoDatabase::GetArtForItem(int mediaId, const MediaType &mediaType, std:
 
 std::string CVideoDatabase::GetArtForItem(int mediaId, const MediaType &mediaType, const std::string &artType)
 {
-  std::string query = PrepareSQL("SELECT url FROM art WHERE media_id=%i AND media_type='%s' AND type='%s'", mediaId, mediaType.c_str(), artType.c_str());
-  return GetSingleValue(query, m_pDS2);
+  return GetSingleValue("SELECT url FROM art WHERE media_id=? AND media_type=? AND type=?",
+                        {field_value(mediaId), field_value(mediaType), field_value(artType)}, m_pDS2);
 }
 
 bool CVideoDatabase::RemoveArtForItem(int mediaId, const MediaType &mediaType, const std::string &artType)
@@ -5692,11 +5760,18 @@ void CVideoDatabase::UpdateTables(int iVersion)
     }
     m_pDS->close();
   }
+
+  if (iVersion < 117)
+  {
+    // filled by CreateAnalytics()
+    m_pDS->exec("CREATE TABLE librarycount (media_type TEXT, total INTEGER, watched INTEGER)");
+    m_pDS->exec("CREATE TABLE tvshowcount (idShow INTEGER PRIMARY KEY, totalCount INTEGER, watchedCount INTEGER)");
+  }
 }
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 116;
+  return 117;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -7275,6 +7350,30 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
+    auto getItem = [&](const dbiplus::sql_record* const record)
+    {
+      CFileItemPtr pItem;
+      CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
+      if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
+          g_passwordManager.bMasterUser                                   ||
+          g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
+      {
+        pItem.reset(new CFileItem(movie));
+
+        CVideoDbUrl itemUrl = videoUrl;
+        std::string path = StringUtils::Format("%i", movie.m_iDbId);
+        itemUrl.AppendPath(path);
+        pItem->SetPath(itemUrl.ToString());
+        pItem->SetDynPath(movie.m_strFileNameAndPath);
+
+        pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.GetPlayCount() > 0);
+      }
+      return pItem;
+    };
+
+    if (DatabaseUtils::CanGetItemsFromCursor(sortDescription))
+      return DatabaseUtils::GetItemsFromCursor(*m_pDS, strSQL, MediaTypeMovie, sortDescription, getItem, total, items);
+
     int iRowsFound = RunQuery(strSQL);
     if (iRowsFound <= 0)
       return iRowsFound == 0;
@@ -7298,22 +7397,9 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
       const dbiplus::sql_record* const record = data.at(targetRow);
 
-      CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
-      if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
-          g_passwordManager.bMasterUser                                   ||
-          g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
-      {
-        CFileItemPtr pItem(new CFileItem(movie));
-
-        CVideoDbUrl itemUrl = videoUrl;
-        std::string path = StringUtils::Format("%i", movie.m_iDbId);
-        itemUrl.AppendPath(path);
-        pItem->SetPath(itemUrl.ToString());
-        pItem->SetDynPath(movie.m_strFileNameAndPath);
-
-        pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.GetPlayCount() > 0);
+      CFileItemPtr pItem = getItem(record);
+      if (pItem)
         items.Add(pItem);
-      }
     }
 
     // cleanup
@@ -7514,36 +7600,16 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
-    if (iRowsFound <= 0)
-      return iRowsFound == 0;
-
-    // store the total value of items as a property
-    if (total < iRowsFound)
-      total = iRowsFound;
-    items.SetProperty("total", total);
-
-    DatabaseResults results;
-    results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeEpisode, m_pDS, results))
-      return false;
-
-    // get data from returned rows
-    items.Reserve(results.size());
     CLabelFormatter formatter("%H. %T", "");
-
-    const query_data &data = m_pDS->get_result_set().records;
-    for (const auto &i : results)
+    auto getItem = [&](const dbiplus::sql_record* const record)
     {
-      unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
-
+      CFileItemPtr pItem;
       CVideoInfoTag episode = GetDetailsForEpisode(record, getDetails);
       if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                     ||
           g_passwordManager.IsDatabasePathUnlocked(episode.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
       {
-        CFileItemPtr pItem(new CFileItem(episode));
+        pItem.reset(new CFileItem(episode));
         formatter.FormatLabel(pItem.get());
 
         int idEpisode = record->at(0).get_asInt();
@@ -7560,8 +7626,38 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
 
         pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, episode.GetPlayCount() > 0);
         pItem->m_dateTime = episode.m_firstAired;
-        items.Add(pItem);
       }
+      return pItem;
+    };
+
+    if (DatabaseUtils::CanGetItemsFromCursor(sorting))
+      return DatabaseUtils::GetItemsFromCursor(*m_pDS, strSQL, MediaTypeEpisode, sorting, getItem, total, items);
+
+    int iRowsFound = RunQuery(strSQL);
+    if (iRowsFound <= 0)
+      return iRowsFound == 0;
+
+    // store the total value of items as a property
+    if (total < iRowsFound)
+      total = iRowsFound;
+    items.SetProperty("total", total);
+
+    DatabaseResults results;
+    results.reserve(iRowsFound);
+    if (!SortUtils::SortFromDataset(sorting, MediaTypeEpisode, m_pDS, results))
+      return false;
+
+    // get data from returned rows
+    items.Reserve(results.size());
+    const query_data &data = m_pDS->get_result_set().records;
+    for (const auto &i : results)
+    {
+      unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
+      const dbiplus::sql_record* const record = data.at(targetRow);
+
+      CFileItemPtr pItem = getItem(record);
+      if (pItem)
+        items.Add(pItem);
     }
 
     // cleanup
@@ -7750,14 +7846,14 @@ bool CVideoDatabase::HasContent(VIDEODB_CONTENT_TYPE type)
     if (nullptr == m_pDS)
       return false;
 
-    std::string sql;
+    std::string mediaType;
     if (type == VIDEODB_CONTENT_MOVIES)
-      sql = "select count(1) from movie";
+      mediaType = MediaTypeMovie;
     else if (type == VIDEODB_CONTENT_TVSHOWS)
-      sql = "select count(1) from tvshow";
+      mediaType = MediaTypeTvShow;
     else if (type == VIDEODB_CONTENT_MUSICVIDEOS)
-      sql = "select count(1) from musicvideo";
-    m_pDS->query( sql );
+      mediaType = MediaTypeMusicVideo;
+    m_pDS->query(PrepareSQL("SELECT total FROM librarycount WHERE media_type='%s'", mediaType.c_str()));
 
     if (!m_pDS->eof())
       result = (m_pDS->fv(0).get_asInt() > 0);
@@ -7771,6 +7867,43 @@ bool CVideoDatabase::HasContent(VIDEODB_CONTENT_TYPE type)
   return result;
 }
 
+bool CVideoDatabase::GetLibraryCount(const std::string &mediaType, int &total, int &watched)
+{
+  total = watched = 0;
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    m_pDS->query(PrepareSQL("SELECT total, watched FROM librarycount WHERE media_type='%s'", mediaType.c_str()));
+    if (m_pDS->eof())
+    {
+      m_pDS->close();
+      return false;
+    }
+    total = m_pDS->fv(0).get_asInt();
+    watched = m_pDS->fv(1).get_asInt();
+    m_pDS->close();
+
+    // a tvshow is watched once all its episodes are, as in tvshow_view this includes shows without episodes
+    if (mediaType == MediaTypeTvShow)
+    {
+      m_pDS->query("SELECT COUNT(1) FROM tvshowcount WHERE watchedCount = totalCount");
+      if (!m_pDS->eof())
+        watched = m_pDS->fv(0).get_asInt();
+      m_pDS->close();
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, mediaType.c_str());
+  }
+  return false;
+}
+
 ScraperPtr CVideoDatabase::GetScraperForPath( const std::string& strPath )
 {
   SScanSettings settings;
@@ -9229,6 +9362,8 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
     sql = "DELETE FROM sets WHERE NOT EXISTS (SELECT 1 FROM movie WHERE movie.idSet = sets.idSet)";
     m_pDS->exec(sql);
 
+    RebuildLibraryCounts();
+
     CommitTransaction();
 
     if (handle)
@@ -10213,7 +10348,11 @@ void CVideoDatabase::InvalidatePathHash(const std::string& strPath)
 bool CVideoDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so recalculate
+  {
+    // the counts are updated once the batch is done
+    if (InBatch())
+      return true;
+    // number of items in the db has likely changed, so recalculate
     GUIINFO::CLibraryGUIInfo& guiInfo = CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider();
     guiInfo.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
     guiInfo.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
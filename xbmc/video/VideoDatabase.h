@@ -750,6 +750,15 @@ public:
 
   bool HasContent();
   bool HasContent(VIDEODB_CONTENT_TYPE type);
+
+  /*! \brief Get the number of items of a media type and how many of them are watched
+   The counts are kept up to date by triggers, a tvshow is watched when all its episodes are.
+   \param mediaType movie, tvshow, episode or musicvideo
+   \param total [out] the number of items
+   \param watched [out] the number of watched items
+   \return true if the counts were read, false otherwise
+   */
+  bool GetLibraryCount(const std::string &mediaType, int &total, int &watched);
   bool HasSets() const;
 
   void CleanDatabase(CGUIDialogProgressBarHandle* handle = NULL, const std::set<int>& paths = std::set<int>(), bool showProgress = true);
@@ -963,6 +972,11 @@ private:
    */
   virtual void CreateViews();
 
+  /*! \brief (Re)Build the librarycount and tvshowcount tables from the media tables,
+   afterwards the triggers keep them up to date
+   */
+  void RebuildLibraryCounts();
+
   /*! \brief Helper to get a database id given a query.
    Returns an integer, -1 if not found, and greater than 0 if found.
    \param query the SQL that will retrieve a database id.
@@ -26,6 +26,7 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "settings/lib/Setting.h"
+#include "threads/SingleLock.h"
 #include "utils/EmbeddedArt.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -41,6 +42,36 @@
 using namespace XFILE;
 using namespace VIDEO;
 
+namespace
+{
+bool CanExtractThumb(const CFileItem& item)
+{
+  if (item.IsLiveTV()
+  // Due to a pvr addon api design flaw (no support for multiple concurrent streams
+  // per addon instance), pvr recording thumbnail extraction does not work (reliably).
+  ||  URIUtils::IsPVRRecording(item.GetDynPath())
+  ||  URIUtils::IsUPnP(item.GetPath())
+  ||  URIUtils::IsBluray(item.GetPath())
+  ||  item.IsBDFile()
+  ||  item.IsDVD()
+  ||  item.IsDiscImage()
+  ||  item.IsDVDFile(false, true)
+  ||  item.IsInternetStream()
+  ||  item.IsDiscStub()
+  ||  item.IsPlayList())
+    return false;
+
+  // For HTTP/FTP we only allow extraction when on a LAN
+  if (URIUtils::IsRemote(item.GetPath()) &&
+     !URIUtils::IsOnLAN(item.GetPath())  &&
+     (URIUtils::IsFTP(item.GetPath())    ||
+      URIUtils::IsHTTP(item.GetPath())))
+    return false;
+
+  return true;
+}
+}
+
 CThumbExtractor::CThumbExtractor(const CFileItem& item,
                                  const std::string& listpath,
                                  bool thumb,
@@ -78,26 +109,7 @@ bool CThumbExtractor::operator==(const CJob* job) const
 
 bool CThumbExtractor::DoWork()
 {
-  if (m_item.IsLiveTV()
-  // Due to a pvr addon api design flaw (no support for multiple concurrent streams
-  // per addon instance), pvr recording thumbnail extraction does not work (reliably).
-  ||  URIUtils::IsPVRRecording(m_item.GetDynPath())
-  ||  URIUtils::IsUPnP(m_item.GetPath())
-  ||  URIUtils::IsBluray(m_item.GetPath())
-  ||  m_item.IsBDFile()
-  ||  m_item.IsDVD()
-  ||  m_item.IsDiscImage()
-  ||  m_item.IsDVDFile(false, true)
-  ||  m_item.IsInternetStream()
-  ||  m_item.IsDiscStub()
-  ||  m_item.IsPlayList())
-    return false;
-
-  // For HTTP/FTP we only allow extraction when on a LAN
-  if (URIUtils::IsRemote(m_item.GetPath()) &&
-     !URIUtils::IsOnLAN(m_item.GetPath())  &&
-     (URIUtils::IsFTP(m_item.GetPath())    ||
-      URIUtils::IsHTTP(m_item.GetPath())))
+  if (!CanExtractThumb(m_item))
     return false;
 
   bool result=false;
@@ -174,6 +186,44 @@ bool CThumbExtractor::DoWork()
   return false;
 }
 
+CBatchThumbExtractor::CBatchThumbExtractor(const CFileItem& item,
+                                           std::vector<CDVDFileInfo::ThumbRequest> requests)
+  : m_item(item), m_requests(std::move(requests))
+{
+  if (m_item.IsStack())
+    m_item.SetPath(CStackDirectory::GetFirstStackedFile(m_item.GetPath()));
+}
+
+bool CBatchThumbExtractor::DoWork()
+{
+  if (!CanExtractThumb(m_item))
+    return false;
+
+  CLog::Log(LOGDEBUG, "%s - trying to extract %u thumbs from video file %s", __FUNCTION__,
+            static_cast<unsigned int>(m_requests.size()), CURL::GetRedacted(m_item.GetPath()).c_str());
+
+  const unsigned int total = static_cast<unsigned int>(m_requests.size());
+  unsigned int finished = 0;
+  auto onFinished = [this, total, &finished](const CDVDFileInfo::ThumbRequest& request) {
+    unsigned int progress;
+    {
+      CSingleLock lock(m_finishedSection);
+      m_finished.push_back(static_cast<unsigned int>(&request - m_requests.data()));
+      progress = ++finished;
+    }
+    return !ShouldCancel(progress, total);
+  };
+  return CDVDFileInfo::ExtractThumbs(m_item, m_requests, onFinished) > 0;
+}
+
+std::vector<unsigned int> CBatchThumbExtractor::TakeFinished() const
+{
+  CSingleLock lock(m_finishedSection);
+  std::vector<unsigned int> finished;
+  finished.swap(m_finished);
+  return finished;
+}
+
 CVideoThumbLoader::CVideoThumbLoader() :
   CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
 {
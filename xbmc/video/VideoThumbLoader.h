@@ -10,6 +10,8 @@
 
 #include "FileItem.h"
 #include "ThumbLoader.h"
+#include "cores/VideoPlayer/DVDFileInfo.h"
+#include "threads/CriticalSection.h"
 #include "utils/JobManager.h"
 
 #include <map>
@@ -56,6 +58,45 @@ public:
   bool m_fillStreamDetails; ///< fill in stream details?
 };
 
+/*!
+ \ingroup thumbs,jobs
+ \brief Job extracting thumbs at several positions of one video file
+
+ The file is opened once and the thumbs are decoded in parallel, see
+ CDVDFileInfo::ExtractThumbs. Used for chapter thumbs.
+
+ \sa CThumbExtractor and CJob
+ */
+class CBatchThumbExtractor : public CJob
+{
+public:
+  CBatchThumbExtractor(const CFileItem& item, std::vector<CDVDFileInfo::ThumbRequest> requests);
+
+  /*!
+   \brief Work function that extracts the thumbs, succeeds if at least one was extracted.
+   */
+  bool DoWork() override;
+
+  const char* GetType() const override
+  {
+    return kJobTypeMediaFlags;
+  }
+
+  /*!
+   \brief Indices into m_requests of the requests finished since the last call.
+   Every finished request is reported with IJobCallback::OnJobProgress(), returning
+   true there skips the remaining requests.
+   */
+  std::vector<unsigned int> TakeFinished() const;
+
+  CFileItem m_item;
+  std::vector<CDVDFileInfo::ThumbRequest> m_requests; ///< positions and targets, extracted is set after DoWork
+
+private:
+  mutable CCriticalSection m_finishedSection;
+  mutable std::vector<unsigned int> m_finished;
+};
+
 class CVideoThumbLoader : public CThumbLoader, public CJobQueue
 {
 public:
@@ -37,6 +37,7 @@
 #include "view/ViewState.h"
 
 #include <string>
+#include <utility>
 #include <vector>
 
 using namespace KODI::MESSAGING;
@@ -260,7 +261,9 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     items.push_back(item);
   }
 
-  // add chapters if around
+  // add chapters if around, missing thumbs are extracted by a single job
+  std::vector<CDVDFileInfo::ThumbRequest> thumbRequests;
+  std::vector<unsigned int> thumbChapters;
   for (int i = 1; i <= g_application.GetAppPlayer().GetChapterCount(); ++i)
   {
     std::string chapterName;
@@ -283,10 +286,11 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
       item->SetArt("thumb", cachefile);
     else if (i > m_jobsStarted && CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTCHAPTERTHUMBS))
     {
-      CFileItem item(m_filePath, false);
-      CJob* job = new CThumbExtractor(item, m_filePath, true, chapterPath, pos * 1000, false);
-      AddJob(job);
-      m_mapJobsChapter[job] = i;
+      CDVDFileInfo::ThumbRequest request;
+      request.pos = pos * 1000;
+      request.url = chapterPath;
+      thumbRequests.push_back(request);
+      thumbChapters.push_back(i);
       m_jobsStarted++;
     }
 
@@ -296,6 +300,14 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     items.push_back(item);
   }
 
+  if (!thumbRequests.empty())
+  {
+    CFileItem item(m_filePath, false);
+    CJob* job = new CBatchThumbExtractor(item, std::move(thumbRequests));
+    m_mapJobsChapter[job] = std::move(thumbChapters);
+    AddJob(job);
+  }
+
   // sort items by resume point
   std::sort(items.begin(), items.end(), [](const CFileItemPtr &item1, const CFileItemPtr &item2) {
     return item1->GetProperty("resumepoint").asDouble() < item2->GetProperty("resumepoint").asDouble();
@@ -560,16 +572,28 @@ bool CGUIDialogVideoBookmarks::OnAddEpisodeBookmark()
 void CGUIDialogVideoBookmarks::OnJobComplete(unsigned int jobID,
                                              bool success, CJob* job)
 {
-  if (success && IsActive())
+  // the chapters were refreshed one by one while their thumbs were extracted
+  MAPJOBSCHAPS::iterator iter = m_mapJobsChapter.find(job);
+  if (iter != m_mapJobsChapter.end())
+    m_mapJobsChapter.erase(iter);
+
+  CJobQueue::OnJobComplete(jobID, success, job);
+}
+
+void CGUIDialogVideoBookmarks::OnJobProgress(unsigned int jobID, unsigned int progress,
+                                             unsigned int total, const CJob* job)
+{
+  MAPJOBSCHAPS::const_iterator iter = m_mapJobsChapter.find(const_cast<CJob*>(job));
+  if (iter == m_mapJobsChapter.end())
+    return;
+
+  const std::vector<unsigned int>& chapters = (*iter).second;
+  for (unsigned int request : static_cast<const CBatchThumbExtractor*>(job)->TakeFinished())
   {
-    MAPJOBSCHAPS::iterator iter = m_mapJobsChapter.find(job);
-    if (iter != m_mapJobsChapter.end())
+    if (request < chapters.size() && IsActive())
     {
-      unsigned int chapterIdx = (*iter).second;
-      CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
+      CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapters[request]);
       CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(m);
-      m_mapJobsChapter.erase(iter);
     }
   }
-  CJobQueue::OnJobComplete(jobID, success, job);
 }
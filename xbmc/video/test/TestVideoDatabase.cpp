@@ -0,0 +1,139 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "media/MediaType.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/URIUtils.h"
+#include "video/VideoDatabase.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const char* const DATABASE_NAME = "TestVideoDatabase.db";
+}
+
+class TestVideoDatabase : public ::testing::Test
+{
+protected:
+  CVideoDatabase db;
+
+  void SetUp() override
+  {
+    XFILE::CFile::Delete(GetPath());
+
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    ASSERT_TRUE(db.Connect(DATABASE_NAME, settings, true));
+  }
+
+  void TearDown() override
+  {
+    db.Close();
+    XFILE::CFile::Delete(GetPath());
+  }
+
+  std::string GetPath()
+  {
+    return URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), DATABASE_NAME);
+  }
+
+  void Execute(const std::string &sql)
+  {
+    ASSERT_TRUE(db.ExecuteQuery(sql)) << sql;
+  }
+
+  // compares the counts kept by the triggers with a count of the media tables
+  void ExpectCountsMatchRecount()
+  {
+    for (const char* table : { "movie", "episode", "musicvideo" })
+    {
+      const std::string recount = db.GetSingleValue(db.PrepareSQL(
+          "SELECT COUNT(1) || '/' || COUNT(files.playCount) FROM %s LEFT JOIN files ON files.idFile=%s.idFile",
+          table, table));
+      const std::string count = db.GetSingleValue(db.PrepareSQL(
+          "SELECT total || '/' || watched FROM librarycount WHERE media_type='%s'", table));
+      EXPECT_EQ(recount, count) << table;
+    }
+
+    EXPECT_EQ(db.GetSingleValue("SELECT COUNT(1) FROM tvshow"),
+              db.GetSingleValue("SELECT total FROM librarycount WHERE media_type='tvshow'"));
+
+    const std::string showRecount = db.GetSingleValue(
+        "SELECT group_concat(counts, ',') FROM (SELECT tvshow.idShow || ':' || COUNT(episode.idEpisode) || ':' || COUNT(files.playCount) AS counts "
+        "FROM tvshow LEFT JOIN episode ON episode.idShow=tvshow.idShow LEFT JOIN files ON files.idFile=episode.idFile "
+        "GROUP BY tvshow.idShow ORDER BY tvshow.idShow)");
+    const std::string showCount = db.GetSingleValue(
+        "SELECT group_concat(counts, ',') FROM (SELECT idShow || ':' || totalCount || ':' || watchedCount AS counts "
+        "FROM tvshowcount ORDER BY idShow)");
+    EXPECT_EQ(showRecount, showCount);
+
+    // as in tvshow_view a show without episodes counts as watched
+    int total, watched;
+    EXPECT_TRUE(db.GetLibraryCount(MediaTypeTvShow, total, watched));
+    EXPECT_EQ(std::to_string(total), db.GetSingleValue("SELECT COUNT(1) FROM tvshow"));
+    EXPECT_EQ(std::to_string(watched), db.GetSingleValue(
+        "SELECT COUNT(1) FROM tvshow WHERE "
+        "(SELECT COUNT(1) FROM episode WHERE episode.idShow=tvshow.idShow) = "
+        "(SELECT COUNT(files.playCount) FROM episode JOIN files ON files.idFile=episode.idFile WHERE episode.idShow=tvshow.idShow)"));
+  }
+};
+
+TEST_F(TestVideoDatabase, LibraryCountsFollowMediaTables)
+{
+  ExpectCountsMatchRecount();
+
+  // file 2 is watched, file 5 holds two episodes, show 3 has none
+  for (int idFile = 1; idFile <= 6; idFile++)
+    Execute(db.PrepareSQL("INSERT INTO files (idFile, idPath, strFilename, playCount) VALUES (%i, 1, 'file%i.mkv', %s)",
+                          idFile, idFile, idFile == 2 ? "1" : "NULL"));
+  Execute("INSERT INTO movie (idMovie, idFile) VALUES (1, 1)");
+  Execute("INSERT INTO movie (idMovie, idFile) VALUES (2, 2)");
+  Execute("INSERT INTO musicvideo (idMVideo, idFile) VALUES (1, 3)");
+  Execute("INSERT INTO tvshow (idShow) VALUES (1)");
+  Execute("INSERT INTO tvshow (idShow) VALUES (2)");
+  Execute("INSERT INTO tvshow (idShow) VALUES (3)");
+  Execute("INSERT INTO episode (idEpisode, idFile, idShow) VALUES (1, 4, 1)");
+  Execute("INSERT INTO episode (idEpisode, idFile, idShow) VALUES (2, 5, 1)");
+  Execute("INSERT INTO episode (idEpisode, idFile, idShow) VALUES (3, 5, 1)");
+  Execute("INSERT INTO episode (idEpisode, idFile, idShow) VALUES (4, 6, 2)");
+  ExpectCountsMatchRecount();
+
+  // watched
+  Execute("UPDATE files SET playCount=1 WHERE idFile IN (1, 3, 4, 5)");
+  ExpectCountsMatchRecount();
+
+  // played again and other columns don't change the watched state
+  Execute("UPDATE files SET playCount=playCount+1, lastPlayed='2020-01-01 00:00:00'");
+  ExpectCountsMatchRecount();
+
+  // unwatched
+  Execute("UPDATE files SET playCount=NULL WHERE idFile IN (2, 4)");
+  ExpectCountsMatchRecount();
+
+  // deleted
+  Execute("DELETE FROM movie WHERE idMovie=1");
+  Execute("DELETE FROM musicvideo WHERE idMVideo=1");
+  Execute("DELETE FROM episode WHERE idEpisode=3");
+  ExpectCountsMatchRecount();
+
+  // the file of an episode goes first
+  Execute("DELETE FROM files WHERE idFile=5");
+  Execute("DELETE FROM episode WHERE idEpisode=2");
+  ExpectCountsMatchRecount();
+
+  Execute("DELETE FROM episode WHERE idShow=2");
+  Execute("DELETE FROM tvshow WHERE idShow=2");
+  Execute("DELETE FROM files");
+  ExpectCountsMatchRecount();
+}